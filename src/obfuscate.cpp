@@ -27,4 +27,15 @@ namespace ithare {
 __declspec(allocate(".CRT$XIC")) static auto obfinit = obf::obf_preMain;
 #pragma data_seg()*/
 
+#else//_MSC_VER
+namespace ithare {
+	namespace obf {
+		static int obf_nInits = 0;
+
+		int obf_preMain(void) {//no PEB outside of Windows (yet?), so there is nothing to init
+			++obf_nInits;
+			return 0;
+		}
+	}//namespace obf
+}//namespace ithare
 #endif
\ No newline at end of file
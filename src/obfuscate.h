@@ -7,9 +7,29 @@
 //      i.e. OBF2() adds up to 10 CPU cycles, OBF3() - up to 30 CPU cycles, 
 //           and OBF5() - up to 300 CPU cycles
 //  1b. To obfuscate literals, use OBF?I() (for integral literals) and OBF?S() (for string literals)
+//      OBF?S() literals are limited to 32 chars, except for C++20 (see ITHARE_OBF_FIXED_STR)
+//      For hot paths, OBF?SL() gives the literal object, which decodes w/o heap allocation:
+//        value_to(buf), value_buf() (on-stack, wiped on destruction, exposes std::string_view), or std::ostream <<
+//  1c. To obfuscate arrays of integers, use OBF?A(type,N); its load_range()/store_range() are vectorized
+//  1d. For dynamic arrays, use OBF?V(type) - a vector of encoded values, stored as densely as plain ones
+//  1e. For hash maps with integral keys, use OBF?M(key,value) - lookups compare encoded keys, w/o decoding them;
+//      OBF?MV(key,value) encodes (integral) values too
+//  1f. For structs which are mostly read/written as a whole, use OBF?R(type1,type2,...) - a record of integral fields
+//      under one site, with load()/store() of all the fields in one vectorized pass and per-field get<I>()/set<I>()
+//  1g. To serialize obfuscated values, use obf_wire_writer<OBF?W(id)>/obf_wire_reader<OBF?W(id)> - values are transcoded
+//      from their in-memory encoding to the wire one (and back) w/o an intermediate plain buffer; id has to match on both ends,
+//      and write_fingerprint()/read_fingerprint() detect format mismatches
 //  2. compile your code without -DITHARE_OBF_SEED for debugging and during development
 //  3. compile with -DITHARE_OBF_SEED=0x<really-random-64-bit-seed>u64 for deployments (MSVC)
-//  3a. GCC/Clang are not supported (yet)
+//  3a. for GCC/Clang (C++17 or later): -DITHARE_OBF_SEED=0x<really-random-64-bit-seed>ULL
+//  4. optionally, to spend cycles where they're cheap: train with -DITHARE_OBF_PROFILE_TRAINING,
+//     then build with -DITHARE_OBF_PROFILE_HEADER (see "profile-guided per-site cycles" below)
+//  5. to find hot sites (with or without ITHARE_OBF_SEED): build with -DITHARE_OBF_ENABLE_SITE_STATS,
+//     and call ithare::obf::obf_site_stats_dump() (see "per-site stats" below)
+//  6. to see generated injection trees: build with -DITHARE_OBF_ENABLE_DBGPRINT, and use dbgPrint(),
+//     or ithare::obf::obf_json<decltype(site)>() for the same as a compile-time JSON string (see dbgJson() below)
+//  7. if obfuscated code takes too much of i-cache: build with -DITHARE_OBF_CODE_SIZE_BOUNDED and/or -DITHARE_OBF_MAX_TREES_PER_TYPE=N
+//     (see "code-size-bounded mode" below)
 
 #ifdef ITHARE_OBF_INTERNAL_DBG
 //enable assert() in Release
@@ -21,9 +41,33 @@
 #include <array>
 #include <assert.h>
 #include <type_traits>
+#include <utility>//std::index_sequence
 #include <atomic>//for ITHARE_OBF_STRICT_MT
-#include <string>//for dbgPrint() only
-#include <iostream>//for dbgPrint() only
+#include <string.h>//memcpy()
+#include <string>
+#include <string_view>//obf_str_buf<>
+#include <iostream>
+#include <vector>//obf_vector<>
+#include <iterator>//obf_index_iterator<>
+#include <unordered_map>//obf_unordered_map_dbg<>
+#include <tuple>//obf_record<>
+#ifdef ITHARE_OBF_PROFILE_TRAINING
+#define ITHARE_OBF_ENABLE_SITE_STATS//profile is written from per-site stats
+#ifndef ITHARE_OBF_PROFILE_OUTPUT
+#define ITHARE_OBF_PROFILE_OUTPUT "obf_profile.h"
+#endif
+#include <cmath>//std::sqrt() for per-site budgets, calculated on exit of the training build
+#endif
+#ifdef ITHARE_OBF_ENABLE_SITE_STATS
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#if !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>//__rdtsc()
+#endif
+#endif
 
 #ifdef ITHARE_OBF_INTERNAL_DBG // set of settings currently used for internal testing. DON'T rely on it!
 //#define ITHARE_OBF_ENABLE_DBGPRINT
@@ -53,1597 +97,6755 @@
 	//enables dbgPrint()
 #endif//ITHARE_OBF_INTERNAL_DBG
 
+#ifndef ITHARE_OBF_COMPILE_TIME_TESTS
+	//number of compile-time iterations of invariant self-tests in literal contexts (versions 4 and 7);
+	//  they consist of assert()s, so they can fail only without NDEBUG - and otherwise cost nothing but compile time;
+	//  hence 0 unless asked for (ITHARE_OBF_INTERNAL_DBG above, or var_ops_check in test/Linux/Makefile)
+#define ITHARE_OBF_COMPILE_TIME_TESTS 0
+#endif
+
 #ifdef _MSC_VER
 #pragma warning (disable:4307)
 #define ITHARE_OBF_FORCEINLINE __forceinline
 #define ITHARE_OBF_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__)//GCC and Clang
+#define ITHARE_OBF_FORCEINLINE inline __attribute__((always_inline))
+#define ITHARE_OBF_NOINLINE __attribute__((noinline))
 #else
-#error non-MSVC compilers are not supported (yet?)
+#error compilers other than MSVC, GCC, and Clang are not supported (yet?)
 #endif
 
-#ifdef ITHARE_OBF_SEED
+//SIMD: used ONLY by obf_array<> bulk operations (load_range()/store_range()), and by ITHARE_OBF_SIMD_STR_LITERALS
+//  SSE2 is a baseline for x64 (and for x86 compiled with /arch:SSE2), AVX2 is detected in runtime
+//  #define ITHARE_OBF_NO_SIMD to use scalar code only
+#if !defined(ITHARE_OBF_NO_SIMD) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define ITHARE_OBF_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>//__cpuid(), _xgetbv()
+	//MSVC allows to use AVX2 intrinsics within any function
+#define ITHARE_OBF_SIMD_INLINE __forceinline
+#define ITHARE_OBF_AVX2_INLINE __forceinline
+#define ITHARE_OBF_SIMD_ENTRY
+#define ITHARE_OBF_AVX2_ENTRY
+#else
+	//GCC/Clang allow AVX2 intrinsics only within target("avx2") functions, and won't always_inline them into anything else;
+	//  so generic kernels are merely inline, and are inlined into entry points by flatten
+#define ITHARE_OBF_SIMD_INLINE inline
+#define ITHARE_OBF_AVX2_INLINE inline __attribute__((target("avx2")))
+#define ITHARE_OBF_SIMD_ENTRY __attribute__((flatten))
+#define ITHARE_OBF_AVX2_ENTRY __attribute__((target("avx2"),flatten))
+#if !defined(__AVX2__) && !defined(__OPTIMIZE__)
+#define ITHARE_OBF_NO_AVX2//w/o optimizations, flatten is ignored, and passing __m256i to non-AVX2 functions breaks ABI
+#endif
+#endif
+#endif
+#if defined(ITHARE_OBF_SIMD) && defined(__GNUC__) && !defined(__clang__)
+	//generic SIMD kernels (ITHARE_OBF_SIMD_INLINE) are never called other than from within ITHARE_OBF_SIMD_ENTRY/ITHARE_OBF_AVX2_ENTRY,
+	//  and take/return vectors only by reference; still, their calls to obf_simd_avx2<> ops (which return __m256i) trigger -Wpsabi,
+	//  so it is ignored between ITHARE_OBF_SIMD_DIAGNOSTIC_PUSH and ITHARE_OBF_SIMD_DIAGNOSTIC_POP (around SIMD kernels)
+#define ITHARE_OBF_SIMD_DIAGNOSTIC_PUSH _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wpsabi\"")
+#define ITHARE_OBF_SIMD_DIAGNOSTIC_POP _Pragma("GCC diagnostic pop")
+#else
+#define ITHARE_OBF_SIMD_DIAGNOSTIC_PUSH
+#define ITHARE_OBF_SIMD_DIAGNOSTIC_POP
+#endif
 
-#ifndef ITHARE_OBF_SCALE//#define for libraries, using OBFN() macros; 
-				//  allows to promote/demote obfuscation scale of the whole library by ITHARE_OBF_SCALE
-				//  ITHARE_OBF_SCALE = 1 'converts' all OBF0()'s into OBF1()'s, and so on...
-				//  DOES NOT affect obfN<> without macros(!)
-#define ITHARE_OBF_SCALE 0
+//ITHARE_OBF_IS_CONSTANT_EVALUATED(): whether we're within compile-time evaluation; used by injections, which have literals
+//  (decoded in runtime) within - to use the plain constant instead, so that they can be evaluated at compile time
+//  in any context (see obf_var<>::encoded_literal); undefined if the compiler doesn't have it
+#if defined(__cpp_lib_is_constant_evaluated)
+#define ITHARE_OBF_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif (defined(__clang__) && __clang_major__ >= 9) || (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define ITHARE_OBF_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+//C++20 class-type template parameters: OBF?S() takes string literal as a whole (as obf_fixed_str<>),
+//  so there is no limit on its length, and no 33-char ITHARE_OBFS_HELPER expansion at each use
+//  #define ITHARE_OBF_NO_FIXED_STR to use char-by-char obf_str_literal<> regardless
+//  ITHARE_OBF_SIMD_STR_LITERALS (<=32 chars) is implemented only for obf_str_literal<>, so it disables ITHARE_OBF_FIXED_STR too
+#if !defined(ITHARE_OBF_NO_FIXED_STR) && !defined(ITHARE_OBF_SIMD_STR_LITERALS) && defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+#define ITHARE_OBF_FIXED_STR
+#endif
+
+//per-thread state of literal contexts (ObfLiteralContext_version<5>) is padded to a whole cache line,
+//  so it never shares one with anything else
+//  #define ITHARE_OBF_NO_THREAD_LOCAL to disable such contexts (say, for DLLs loaded via LoadLibrary() on pre-Vista Windows)
+#ifndef ITHARE_OBF_CACHE_LINE_SIZE
+#define ITHARE_OBF_CACHE_LINE_SIZE 64
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>//__stosb(), _AddressOfReturnAddress()
 #endif
 namespace ithare {
 namespace obf {
-	//NAMESPACE POLICIES:
-	//  EVERYTHING goes into ithare::obf namespace - except for #defines
-	//  ALL #defines are prefixed with ITHARE_OBF_
-	//    THE ONLY exception is OBF0()...OBF6() macros
-	//      These can be disabled using ITHARE_OBF_NO_SHORT_DEFINES macro 
-	//        If disabling - use equivalent ITHARE_OBF0()...ITHARE_OBF6()
-
-	using OBFSEED = uint64_t;
-	using OBFCYCLES = int32_t;//signed!
+	//helpers which are the same with and without ITHARE_OBF_SEED
+
+	//obf_wipe(): overwrites decoded plaintext, in a way which is not optimized out as a dead store
+	ITHARE_OBF_FORCEINLINE void obf_wipe(void* p, size_t n) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		__stosb((unsigned char*)p, 0, n);//same as RtlSecureZeroMemory()
+#elif defined(__GNUC__)
+		memset(p, 0, n);
+		__asm__ __volatile__("" : : "r"(p) : "memory");//pretends to read *p, so memset() is not a dead store
+#else
+		volatile char* q = (volatile char*)p;
+		for (size_t i = 0; i < n; ++i)
+			q[i] = 0;
+#endif
+	}
 
-	//POTENTIALLY user-modifiable constexpr function:
-	constexpr OBFCYCLES obf_exp_cycles(int exp) {
-		if (exp < 0)
-			return 0;
-		OBFCYCLES ret = 1;
-		if (exp & 1) {
-			ret *= 3;
-			exp -= 1;
-		}
-		assert((exp & 1) == 0);
-		exp >>= 1;
-		for (int i = 0; i < exp; ++i)
-			ret *= 10;
+	//obf_opaque(): returns x, but the optimizer can't know it; as a result, it can't fold x into whatever-it-is-used-for
+	//  with GCC/Clang, x stays in a register and there are no extra instructions at all;
+	//  MSVC has no inline asm on x64, so x makes a round trip via a volatile on stack (one store-to-load forwarding)
+	template<class T>
+	ITHARE_OBF_FORCEINLINE T obf_opaque(T x) {
+#if defined(__GNUC__)
+		__asm__("" : "+r"(x));
+		return x;
+#else
+		volatile T ret = x;
 		return ret;
+#endif
 	}
 
-	//helper constexpr functions
-	constexpr size_t obf_strlen(const char* s) {
-		for (size_t ret = 0; ; ++ret, ++s)
-			if (*s == 0)
-				return ret;
+	//obf_opaque_zero(): returns 0, computed as (r*(r+1))&1 from a register r nobody can resolve statically
+	//  unlike obf_opaque(C), which a decompiler propagating constants through registers folds right back into C,
+	//  there is no constant to propagate here: with GCC/Clang, r is whatever happens to be in the register asm("") picked;
+	//  with MSVC, it is the address of the return address; folding the result to 0 requires knowing that r*(r+1) is even
+	template<class T>
+	ITHARE_OBF_FORCEINLINE T obf_opaque_zero() {
+#if defined(__GNUC__)
+		unsigned r;
+		__asm__("" : "=r"(r));
+#elif defined(_MSC_VER)
+		unsigned r = unsigned(uintptr_t(_AddressOfReturnAddress()));
+#else
+		volatile unsigned vr = 0;
+		unsigned r = vr;
+#endif
+		return T((r * (r + 1u)) & 1u);
 	}
 
-	constexpr OBFSEED obf_compile_time_prng(OBFSEED seed, int iteration) {
-		static_assert(sizeof(OBFSEED) == 8);
-		assert(iteration > 0);
-		OBFSEED ret = seed;
-		for (int i = 0; i < iteration; ++i) {
-			ret = UINT64_C(6364136223846793005) * ret + UINT64_C(1442695040888963407);//linear congruential one; TODO: replace with something crypto-strength for production use
+	//obf_wipe_guard: obf_wipe()s caller-provided buffer when going out of scope, e.g.
+	//  char buf[64]; obf_wipe_guard guard(buf); OBF3SL("secret").value_to(buf);
+	class obf_wipe_guard {
+	public:
+		ITHARE_OBF_FORCEINLINE obf_wipe_guard(void* p_, size_t n_) : p(p_), n(n_) {}
+		template<size_t N>
+		ITHARE_OBF_FORCEINLINE explicit obf_wipe_guard(char(&buf)[N]) : p(buf), n(N) {}
+		obf_wipe_guard(const obf_wipe_guard&) = delete;
+		obf_wipe_guard& operator =(const obf_wipe_guard&) = delete;
+		ITHARE_OBF_FORCEINLINE ~obf_wipe_guard() {
+			obf_wipe(p, n);
 		}
-		return ret;
-	}
 
-	constexpr OBFSEED obf_seed_from_file_line_counter(const char* file, int line, int counter) {
-		OBFSEED ret = ITHARE_OBF_SEED ^ line ^ counter;
-		for (const char* p = file; *p; ++p)//effectively djb2 by Dan Bernstein, albeit with different initializer
-			ret = ((ret << 5) + ret) + *p;
-		return obf_compile_time_prng(ret, 1);//to reduce ill effects from a low-quality PRNG
-	}
+	private:
+		void* p;
+		size_t n;
+	};
 
-	template<class T, size_t N>
-	constexpr T obf_compile_time_approximation(T x, std::array<T, N> xref, std::array<T, N> yref) {
-		for (size_t i = 0; i < N - 1; ++i) {
-			T x0 = xref[i];
-			T x1 = xref[i + 1];
-			if (x >= x0 && x < x1) {
-				T y0 = yref[i];
-				T y1 = yref[i + 1];
-				return uint64_t(y0 + double(x - x0)*double(y1 - y0) / double(x1 - x0));
-			}
+	//obf_str_buf: fixed-capacity on-stack decoded string, returned by value_buf() of string literals;
+	//  wiped in destructor, so it is non-copyable (and is returned w/o copying due to C++17 guaranteed copy elision)
+	template<size_t Cap>
+	class obf_str_buf {
+	public:
+		template<class Literal>
+		ITHARE_OBF_FORCEINLINE explicit obf_str_buf(const Literal& lit) : n(lit.value_to(buf, Cap)) {}
+		obf_str_buf(const obf_str_buf&) = delete;
+		obf_str_buf& operator =(const obf_str_buf&) = delete;
+		ITHARE_OBF_FORCEINLINE ~obf_str_buf() {
+			obf_wipe(buf, Cap);
 		}
-	}
 
-	constexpr uint64_t obf_sqrt_very_rough_approximation(uint64_t x0) {
-		std::array<uint64_t, 64> xref = {};
-		std::array<uint64_t, 64> yref = {};
-		for (size_t i = 1; i < 64; ++i) {
-			uint64_t x = UINT64_C(1) << (i - 1);
-			xref[i] = x * x;
-			yref[i] = x;
+		ITHARE_OBF_FORCEINLINE const char* data() const {
+			return buf;
+		}
+		ITHARE_OBF_FORCEINLINE const char* c_str() const {
+			return buf;
+		}
+		ITHARE_OBF_FORCEINLINE size_t size() const {
+			return n;
+		}
+		ITHARE_OBF_FORCEINLINE std::string_view view() const {
+			return std::string_view(buf, n);
+		}
+		ITHARE_OBF_FORCEINLINE operator std::string_view() const {
+			return view();
 		}
-		return obf_compile_time_approximation(x0, xref, yref);
-	}
 
-	template<class MAX>
-	constexpr MAX obf_weak_random(OBFSEED seed, MAX n) {
-		assert(n > 0);
-		OBFSEED hi = seed >> (sizeof(OBFSEED) * 4);
-		return  hi % n;//biased, but for our purposes will do
-	}
+	private:
+		char buf[Cap];
+		size_t n;
+	};
 
-	template<size_t N>
-	constexpr size_t obf_random_from_list(OBFSEED seed, std::array<size_t, N> weights) {
-		//returns index in weights
-		size_t totalWeight = 0;
-		for (size_t i = 0; i < weights.size(); ++i)
-			totalWeight += weights[i];
-		assert(totalWeight > 0);
-		size_t refWeight = obf_weak_random(seed, totalWeight);
-		assert(refWeight < totalWeight);
-		for (size_t i = 0; i < weights.size(); ++i) {
-			if (refWeight < weights[i])
-				return i;
-			refWeight -= weights[i];
-		}
-		assert(false);
+	template<size_t Cap>
+	std::ostream& operator <<(std::ostream& os, const obf_str_buf<Cap>& s) {
+		return os.write(s.data(), std::streamsize(s.size()));
 	}
 
-	//OBF_CONST_X: constants to be used throughout this particular build
-	template<class T, size_t N>
-	constexpr size_t obf_find_idx_in_array(std::array<T, N> arr, T value) {
-		for (size_t i = 0; i < N; ++i) {
-			if (arr[i] == value)
-				return i;
-		}
-		return size_t(-1);
+	//obf_expr: lazy result of binary arithmetic on obf_var (expression templates), so that for a+b*c-d
+	//  each operand is decoded once, the whole expression is calculated in plain, and only assignment to obf_var pays an injection
+	//  each node is converted to its T (T_ of the left-most obf_var), so results are the same as if intermediate results were obf_var<T_>s
+	//  operands are held by value (same as eager obf_var results, later modifications of operands don't affect the expression)
+	template<class T2>
+	ITHARE_OBF_FORCEINLINE constexpr T2 obf_expr_value(T2 t) {//raw operand; obf_var, obf_literal, and obf_expr have their own overloads
+		return t;
 	}
 
-	template<size_t N>
-	constexpr uint8_t obf_const_x(OBFSEED seed, std::array<uint8_t, N> excluded) {
-		std::array<uint8_t, 6> candidates = { 3,5,7,15,25,31 };//only odd, to allow using the same set of constants in mul-by-odd injections
-		std::array<size_t, 6> weights = { 100,100,100,100,100,100 };
-		for (size_t i = 0; i < N; ++i) {
-			size_t found = obf_find_idx_in_array(candidates, excluded[i]);
-			if (found != size_t(-1))
-				weights[found] = 0;
-		}
-		size_t idx2 = obf_random_from_list(seed, weights);
-		return candidates[idx2];
-	}
+	struct obf_expr_add {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a + b; }
+	};
+	struct obf_expr_sub {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a - b; }
+	};
+	struct obf_expr_mul {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a * b; }
+	};
+	struct obf_expr_div {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a / b; }
+	};
+	struct obf_expr_mod {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a % b; }
+	};
+	struct obf_expr_and {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a & b; }
+	};
+	struct obf_expr_or {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a | b; }
+	};
+	struct obf_expr_xor {//also used for ~x, as x ^ ~T(0)
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a ^ b; }
+	};
+	struct obf_expr_shl {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a << b; }
+	};
+	struct obf_expr_shr {
+		template<class A, class B>
+		ITHARE_OBF_FORCEINLINE constexpr static auto apply(A a, B b) { return a >> b; }
+	};
 
-	//XOR-ed constants are merely random numbers with no special meaning
-	constexpr std::array<uint8_t, 0> obf_const_A_excluded = {};
-	constexpr uint8_t OBF_CONST_A = obf_const_x(obf_compile_time_prng(ITHARE_OBF_SEED^UINT64_C(0xcec4b8ea4b89a1a9),1), obf_const_A_excluded);
-	constexpr std::array<uint8_t, 1> obf_const_B_excluded = { OBF_CONST_A };
-	constexpr uint8_t OBF_CONST_B = obf_const_x(obf_compile_time_prng(ITHARE_OBF_SEED^UINT64_C(0x5eec23716fa1d0aa),1), obf_const_B_excluded);
-	constexpr std::array<uint8_t, 2> obf_const_C_excluded = { OBF_CONST_A, OBF_CONST_B };
-	constexpr uint8_t OBF_CONST_C = obf_const_x(obf_compile_time_prng(ITHARE_OBF_SEED^UINT64_C(0xfb2de18f982a2d55),1), obf_const_C_excluded);
+	template<class T, class Op, class L, class R>
+	class obf_expr {
+		static_assert(std::is_integral<T>::value);
 
-	template<class T, size_t N>
-	constexpr T obf_random_const(OBFSEED seed, std::array<T, N> lst) {
-		return lst[obf_weak_random(seed, N)];
-	}
+	public:
+		ITHARE_OBF_FORCEINLINE constexpr obf_expr(const L& l_, const R& r_) : l(l_), r(r_) {
+		}
+		ITHARE_OBF_FORCEINLINE T value() const {
+			return T(Op::apply(obf_expr_value(l), obf_expr_value(r)));
+		}
+		ITHARE_OBF_FORCEINLINE operator T() const { return value(); }
+		ITHARE_OBF_FORCEINLINE constexpr const L& left() const { return l; }//for obf_var<>::expr_injection()
+		ITHARE_OBF_FORCEINLINE constexpr const R& right() const { return r; }
 
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_add, obf_expr, T2> operator +(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_sub, obf_expr, T2> operator -(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_mul, obf_expr, T2> operator *(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_div, obf_expr, T2> operator /(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_mod, obf_expr, T2> operator %(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_and, obf_expr, T2> operator &(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_or, obf_expr, T2> operator |(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_xor, obf_expr, T2> operator ^(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_shl, obf_expr, T2> operator <<(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_shr, obf_expr, T2> operator >>(T2 t) const { return { *this, t }; }
+		ITHARE_OBF_FORCEINLINE obf_expr<T, obf_expr_xor, obf_expr, T> operator ~() const { return { *this, T(~T(0)) }; }
 
-	struct ObfDescriptor {
-		bool is_recursive;
-		OBFCYCLES min_cycles;
-		size_t weight;
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator <(T2 t) const { return value() < obf_expr_value(t); }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator >(T2 t) const { return value() > obf_expr_value(t); }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator ==(T2 t) const { return value() == obf_expr_value(t); }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator !=(T2 t) const { return value() != obf_expr_value(t); }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator <=(T2 t) const { return value() <= obf_expr_value(t); }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator >=(T2 t) const { return value() >= obf_expr_value(t); }
 
-		constexpr ObfDescriptor(bool is_recursive_, OBFCYCLES min_cycles_, size_t weight_)
-			: is_recursive(is_recursive_), min_cycles(min_cycles_), weight(weight_) {
-		}
+	private:
+		L l;
+		R r;
 	};
 
-	template<size_t N>
-	constexpr size_t obf_random_obf_from_list(OBFSEED seed, OBFCYCLES cycles, std::array<ObfDescriptor, N> descr,size_t exclude_version=size_t(-1)) {
-		//returns index in descr
-		size_t sz = descr.size();
-		std::array<size_t, N> nr_weights = {};
-		std::array<size_t, N> r_weights = {};
-		size_t sum_r = 0;
-		size_t sum_nr = 0;
-		for (size_t i = 0; i < sz; ++i) {
-			if (i != exclude_version && cycles >= descr[i].min_cycles)
-				if (descr[i].is_recursive) {
-					r_weights[i] = descr[i].weight;
-					sum_r += r_weights[i];
-				}
-				else {
-					nr_weights[i] = descr[i].weight;
-					sum_nr += nr_weights[i];
-				}
-		}
-		if (sum_r)
-			return obf_random_from_list(seed, r_weights);
-		else {
-			assert(sum_nr > 0);
-			return obf_random_from_list(seed, nr_weights);
-		}
+	template<class T, class Op, class L, class R>
+	ITHARE_OBF_FORCEINLINE T obf_expr_value(const obf_expr<T, Op, L, R>& e) {
+		return e.value();
 	}
 
+#ifdef ITHARE_OBF_FIXED_STR
+	//obf_fixed_str: string literal usable as a template parameter
 	template<size_t N>
-	constexpr std::array<OBFCYCLES, N> obf_random_split(OBFSEED seed, OBFCYCLES cycles, std::array<ObfDescriptor, N> elements) {
-		//size_t totalWeight = 0;
-		assert(cycles >= 0);
-		OBFCYCLES mins = 0;
-		for (size_t i = 0; i < N; ++i) {
-			assert(elements[i].min_cycles==0);//mins NOT to be used within calls to obf_random_split 
-											  //  (it not a problem with this function, but they tend to cause WAY too much trouble in injection_version<> code
-			mins += elements[i].min_cycles;
-			//totalWeight += elements[i].weight;
-		}
-		OBFCYCLES leftovers = cycles - mins;
-		assert(leftovers >= 0);
-		std::array<OBFCYCLES, N> ret = {};
-		size_t totalWeight = 0;
-		for (size_t i = 0; i < N; ++i) {
-			if (elements[i].weight > 0)
-				ret[i] = OBFCYCLES(obf_weak_random(obf_compile_time_prng(seed, int(i + 1)), elements[i].weight)) + 1;//'+1' is to avoid "all-zeros" case
-			else
-				ret[i] = 0;
-			totalWeight += ret[i];
+	struct obf_fixed_str {
+		char data[N] = {};
+
+		constexpr obf_fixed_str(const char(&s)[N]) {
+			for (size_t i = 0; i < N; ++i)
+				data[i] = s[i];
 		}
-		size_t totalWeight2 = 0;
-		double q = double(leftovers) / double(totalWeight);
-		for (size_t i = 0; i < N; ++i) {
-			ret[i] = elements[i].min_cycles+OBFCYCLES(double(ret[i]) * double(q));
-			assert(ret[i] >= elements[i].min_cycles);
-			totalWeight2 += ret[i];
+		constexpr size_t size() const {//same as obf_strlen(data): up to the first '\0'
+			for (size_t ret = 0; ret < N; ++ret)
+				if (data[ret] == 0)
+					return ret;
+			return N;
 		}
-		assert(OBFCYCLES(totalWeight2) <= mins + leftovers);
-		return ret;
-	}
-
-	//type helpers
-	//obf_half_size_int<>
-	//TODO: obf_traits<>, including obf_traits<>::half_size_int
-	template<class T>
-	struct obf_half_size_int;
+	};
+#endif
 
-	template<>
-	struct obf_half_size_int<uint16_t> {
-		using value_type = uint8_t;
+	//ObfSiteLocation: poor man's C++20 std::source_location; captured by a defaulted constructor parameter,
+	//  so it is the location of the code which constructs the object (for OBF?I()/OBF?S() - the very site, for OBF?() vars - the declaration)
+	struct ObfSiteLocation {
+		const char* file = nullptr;
+		int line = 0;
+#ifdef ITHARE_OBF_ENABLE_SITE_STATS
+		static constexpr ObfSiteLocation current(const char* file_ = __builtin_FILE(), int line_ = __builtin_LINE()) {
+			return ObfSiteLocation{ file_, line_ };
+		}
+#endif
 	};
+	enum class ObfSiteKind { var, literal, str_literal, array, vector, map, record };//for per-site stats
 
-	template<>
-	struct obf_half_size_int<int16_t> {
-		using value_type = int8_t;
-	};
-
-	template<>
-	struct obf_half_size_int<uint32_t> {
-		using value_type = uint16_t;
-	};
-
-	template<>
-	struct obf_half_size_int<int32_t> {
-		using value_type = int16_t;
-	};
+#ifdef ITHARE_OBF_ENABLE_SITE_STATS
+#define ITHARE_OBF_SITE_LOC_PARAM0 ithare::obf::ObfSiteLocation obf_site_loc = ithare::obf::ObfSiteLocation::current()
+#define ITHARE_OBF_SITE_LOC_PARAM , ITHARE_OBF_SITE_LOC_PARAM0
+#define ITHARE_OBF_SITE_LOC obf_site_loc
+#else
+#define ITHARE_OBF_SITE_LOC_PARAM0
+#define ITHARE_OBF_SITE_LOC_PARAM
+#define ITHARE_OBF_SITE_LOC ithare::obf::ObfSiteLocation()
+#endif
 
-	template<>
-	struct obf_half_size_int<uint64_t> {
-		using value_type = uint32_t;
-	};
+#ifdef ITHARE_OBF_ENABLE_SITE_STATS
+	//per-site stats: encodes (injections) and decodes (surjections) of each obf_var<>/obf_literal<>/obf_str_literal<>/obf_array<> site
+	//  (for the same without ITHARE_OBF_SEED - of each obf_var_dbg<>/obf_literal_dbg<>/obf_str_literal_dbg<> site,
+	//  so that hot sites can be found before obfuscation is enabled)
+	//  with ITHARE_OBF_SEED, a site is a type (i.e. its seed); without it - a location (file:line, as captured by ObfSiteLocation)
+	//  counters are thread_local and are updated with relaxed non-RMW ops (each has a single writer), so there is no cache line bouncing;
+	//    counters of exited threads are folded into per-site totals
+	//  #define ITHARE_OBF_SITE_STATS_SAMPLE_SHIFT N to time every 2^N-th decode of each site (per thread) with TSC (clock_gettime() on non-x86)
+	//  obf_site_stats_dump() reports all the sites, hottest first; obf_site_stats_dump_json() - the same as JSON,
+	//    with each tree as dbgJson() (the same as obf_json<>()) if ITHARE_OBF_ENABLE_DBGPRINT is defined
+	//NOT for production builds: it exposes site locations (and injection trees, if ITHARE_OBF_ENABLE_DBGPRINT is defined too)
+#ifndef ITHARE_OBF_SITE_STATS_MAX_SITES
+#define ITHARE_OBF_SITE_STATS_MAX_SITES 65536//encodes/decodes of sites beyond this number are not counted
+#endif
 
-	template<>
-	struct obf_half_size_int<int64_t> {
-		using value_type = int32_t;
+	struct ObfSiteCounters {
+		std::atomic<uint64_t> injections = { 0 };
+		std::atomic<uint64_t> surjections = { 0 };
+		std::atomic<uint64_t> samples = { 0 };//timed decodes
+		std::atomic<uint64_t> ticks = { 0 };//total for timed decodes
 	};
 
-	//forward declarations
-	struct ObfDefaultInjectionContext {
-		static constexpr size_t exclude_version = size_t(-1);
+	struct ObfSiteInfo {
+		static constexpr size_t npos = size_t(-1);
+
+		ObfSiteKind kind;
+		size_t size;//sizeof(T) for integers, length for strings
+		uint64_t seed;//0 without ITHARE_OBF_SEED
+		int32_t cycles;//as declared; 0 without ITHARE_OBF_SEED
+		int32_t site_cycles;//as used (see obf_site_cycles()); 0 without ITHARE_OBF_SEED
+		int level;//OBF level corresponding to cycles; -1 if unknown
+		void(*print_tree)(std::ostream&);//nullptr if not available
+		const char* json;//dbgJson() of the tree (see obf_json<>()), nullptr if not available
+		std::atomic<const char*> file = { nullptr };
+		std::atomic<int> line = { 0 };
+		std::atomic<size_t> index = { npos };
+		ObfSiteCounters totals;//of exited threads
+
+		constexpr ObfSiteInfo(ObfSiteKind kind_, size_t size_, uint64_t seed_, int32_t cycles_, int32_t site_cycles_, int level_, void(*print_tree_)(std::ostream&), const char* json_)
+			: kind(kind_), size(size_), seed(seed_), cycles(cycles_), site_cycles(site_cycles_), level(level_), print_tree(print_tree_), json(json_) {
+		}
 	};
-	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles,class InjectionContext>
-	class obf_injection;
-	template<class T, T C, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_literal_ctx;
-	template<class T_, T_ C_, OBFSEED seed, OBFCYCLES cycles>
-	class obf_literal;
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-	//dbgPrint helpers
-	template<class T>
-	std::string obf_dbgPrintT() {
-		return std::string("T(sizeof=") + std::to_string(sizeof(T)) + ")";
+	ITHARE_OBF_FORCEINLINE void obf_site_count(std::atomic<uint64_t>& c, uint64_t n) {//single writer, so no RMW is necessary
+		c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
 	}
 
-	template<class T>
-	struct ObfPrintC {
-		using type = T;
-	};
-	template<>
-	struct ObfPrintC<uint8_t> {
-		using type = int;
-	};
-
-	template<class T>
-	typename ObfPrintC<T>::type obf_dbgPrintC(T c) {
-		return ObfPrintC<T>::type(c);
+	ITHARE_OBF_FORCEINLINE uint64_t obf_site_ticks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
 	}
+	inline const char* obf_site_ticks_unit() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return "TSC ticks";
+#else
+		return "ns";
 #endif
+	}
 
-	//ObfRecursiveContext
-	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	struct ObfRecursiveContext;
-
-	//injection-with-constant - building block both for injections and for literals
-	template <size_t which, class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version;
-
-	//version 0: identity
-	template<class Context>
-	struct obf_injection_version0_descr {
-		//cannot make it a part of class obf_injection_version<0, T, C, seed, cycles>,
-		//  as it would cause infinite recursion in template instantiation
-		static constexpr OBFCYCLES own_min_injection_cycles = 0;
-		static constexpr OBFCYCLES own_min_surjection_cycles = 0;
-		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr = ObfDescriptor(false, own_min_cycles, 1);
-	};
+	class ObfSiteThreadCounters;
 
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<0, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
+	class ObfSiteRegistry {
+	public:
+		struct Entry {
+			const ObfSiteInfo* site;
+			const char* file;
+			int line;
+			uint64_t injections;
+			uint64_t surjections;
+			uint64_t samples;
+			uint64_t ticks;
+		};
 
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version0_descr<Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
+		static ObfSiteRegistry& instance() {
+			static ObfSiteRegistry registry;
+			return registry;
+		}
 
-	public:
-		using return_type = T;
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			return Context::final_injection(x);
+		size_t add(ObfSiteInfo* site) {
+			std::lock_guard<std::mutex> lock(mx);
+			size_t ret = site->index.load(std::memory_order_relaxed);
+			if (ret == ObfSiteInfo::npos) {
+				ret = sites.size();
+				sites.push_back(site);
+				site->index.store(ret, std::memory_order_release);
+			}
+			return ret;
 		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
-			return Context::final_surjection(y);
+		void locate(ObfSiteInfo& site, ObfSiteLocation loc) {//first location wins
+			std::lock_guard<std::mutex> lock(mx);
+			if (!site.file.load(std::memory_order_relaxed) && loc.file) {
+				site.line.store(loc.line, std::memory_order_relaxed);
+				site.file.store(loc.file, std::memory_order_release);
+			}
+		}
+		ObfSiteInfo* dbg_site(ObfSiteKind kind, size_t size, ObfSiteLocation loc) {//for _dbg classes: one site per (kind,size,file,line)
+			std::lock_guard<std::mutex> lock(mx);
+			for (const std::unique_ptr<ObfSiteInfo>& s : dbgSites) {
+				if (s->kind == kind && s->size == size && s->line.load(std::memory_order_relaxed) == loc.line &&
+					strcmp(s->file.load(std::memory_order_relaxed), loc.file ? loc.file : "") == 0)
+					return s.get();
+			}
+			dbgSites.emplace_back(new ObfSiteInfo(kind, size, 0, 0, 0, -1, nullptr, nullptr));
+			ObfSiteInfo* ret = dbgSites.back().get();
+			ret->line.store(loc.line, std::memory_order_relaxed);
+			ret->file.store(loc.file ? loc.file : "", std::memory_order_relaxed);
+			ret->index.store(sites.size(), std::memory_order_release);
+			sites.push_back(ret);
+			return ret;
 		}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0,const char* prefix="") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<0/*identity*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: availCycles=" << availCycles << std::endl;
-			Context::dbgPrint(offset + 1);
+		void add_thread(ObfSiteThreadCounters* t) {
+			std::lock_guard<std::mutex> lock(mx);
+			threads.push_back(t);
+		}
+		inline void remove_thread(ObfSiteThreadCounters* t);//folds its counters into totals
+
+		inline std::vector<Entry> snapshot();//hottest first
+		inline void dump(std::ostream& os);
+		inline void dump_json(std::ostream& os);
+#ifdef ITHARE_OBF_PROFILE_TRAINING
+		inline bool write_profile(const char* path);
+		~ObfSiteRegistry() {
+			if (!write_profile(ITHARE_OBF_PROFILE_OUTPUT))
+				std::cerr << "obf: cannot write profile to " << ITHARE_OBF_PROFILE_OUTPUT << std::endl;
 		}
 #endif
-	};
 
-	//version 1: add mod 2^n
-	template<class Context>
-	struct obf_injection_version1_descr {
-		static constexpr OBFCYCLES own_min_injection_cycles = 1;
-		static constexpr OBFCYCLES own_min_surjection_cycles = 1;
-		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, own_min_cycles, 100);
+	private:
+		ObfSiteRegistry() = default;
+
+		std::mutex mx;
+		std::vector<ObfSiteInfo*> sites;//index is ObfSiteInfo::index
+		std::vector<ObfSiteThreadCounters*> threads;//alive ones
+		std::vector<std::unique_ptr<ObfSiteInfo>> dbgSites;
 	};
 
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<1, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
+	class ObfSiteThreadCounters {
+		static constexpr size_t chunk_size = 256;
+		static constexpr size_t n_chunks = (ITHARE_OBF_SITE_STATS_MAX_SITES + chunk_size - 1) / chunk_size;
+		std::atomic<ObfSiteCounters*> chunks[n_chunks] = {};//allocated on first use by the owning thread, read by anybody (under registry lock)
+		ObfSiteCounters overflow;
+
 	public:
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version1_descr<Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
+		ObfSiteThreadCounters() {
+			ObfSiteRegistry::instance().add_thread(this);
+		}
+		ObfSiteThreadCounters(const ObfSiteThreadCounters&) = delete;
+		ObfSiteThreadCounters& operator =(const ObfSiteThreadCounters&) = delete;
+		~ObfSiteThreadCounters() {
+			ObfSiteRegistry::instance().remove_thread(this);
+			for (std::atomic<ObfSiteCounters*>& c : chunks)
+				delete[] c.load(std::memory_order_relaxed);
+		}
 
-		struct RecursiveInjectionContext {
-			static constexpr size_t exclude_version = 1;
-		};
+		ITHARE_OBF_FORCEINLINE ObfSiteCounters& at(size_t index) {
+			if (index >= n_chunks * chunk_size)
+				return overflow;
+			ObfSiteCounters* c = chunks[index / chunk_size].load(std::memory_order_relaxed);
+			if (!c) {
+				c = new ObfSiteCounters[chunk_size];
+				chunks[index / chunk_size].store(c, std::memory_order_release);
+			}
+			return c[index % chunk_size];
+		}
+		const ObfSiteCounters* find(size_t index) const {//nullptr if not counted (yet)
+			if (index >= n_chunks * chunk_size)
+				return nullptr;
+			const ObfSiteCounters* c = chunks[index / chunk_size].load(std::memory_order_acquire);
+			return c ? &c[index % chunk_size] : nullptr;
+		}
+	};
 
-		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), availCycles+Context::context_cycles,RecursiveInjectionContext>;
-		using return_type = typename RecursiveInjection::return_type;
-		static constexpr std::array<T, 5> consts = { 0,1,OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
-		constexpr static T C = obf_random_const<T>(obf_compile_time_prng(seed, 2), consts);
-		static constexpr bool neg = C == 0 ? true : obf_weak_random(obf_compile_time_prng(seed, 3),2) == 0;
-		using ST = typename std::make_signed<T>::type;
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			if constexpr(neg) {
-				ST sx = ST(x);
-				return RecursiveInjection::injection(T(-sx) + C);
+	inline void ObfSiteRegistry::remove_thread(ObfSiteThreadCounters* t) {
+		std::lock_guard<std::mutex> lock(mx);
+		for (ObfSiteInfo* s : sites) {
+			const ObfSiteCounters* c = t->find(s->index.load(std::memory_order_relaxed));
+			if (c) {
+				s->totals.injections.fetch_add(c->injections.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				s->totals.surjections.fetch_add(c->surjections.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				s->totals.samples.fetch_add(c->samples.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				s->totals.ticks.fetch_add(c->ticks.load(std::memory_order_relaxed), std::memory_order_relaxed);
 			}
-			else
-				return RecursiveInjection::injection(x + C);
 		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
-			T yy = RecursiveInjection::surjection(y) - C;
-			if constexpr(neg) {
-				ST syy = ST(yy);
-				return T(-syy);
+		threads.erase(std::remove(threads.begin(), threads.end(), t), threads.end());
+	}
+
+	inline std::vector<ObfSiteRegistry::Entry> ObfSiteRegistry::snapshot() {
+		std::vector<Entry> ret;
+		{
+			std::lock_guard<std::mutex> lock(mx);
+			for (ObfSiteInfo* s : sites) {
+				Entry e = { s, s->file.load(std::memory_order_acquire), s->line.load(std::memory_order_relaxed),
+					s->totals.injections.load(std::memory_order_relaxed), s->totals.surjections.load(std::memory_order_relaxed),
+					s->totals.samples.load(std::memory_order_relaxed), s->totals.ticks.load(std::memory_order_relaxed) };
+				for (ObfSiteThreadCounters* t : threads) {
+					const ObfSiteCounters* c = t->find(s->index.load(std::memory_order_relaxed));
+					if (c) {
+						e.injections += c->injections.load(std::memory_order_relaxed);
+						e.surjections += c->surjections.load(std::memory_order_relaxed);
+						e.samples += c->samples.load(std::memory_order_relaxed);
+						e.ticks += c->ticks.load(std::memory_order_relaxed);
+					}
+				}
+				ret.push_back(e);
 			}
-			else
-				return yy;
 		}
+		std::stable_sort(ret.begin(), ret.end(), [](const Entry& a, const Entry& b) {
+			return a.injections + a.surjections > b.injections + b.surjections;
+		});
+		return ret;
+	}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<1/*add mod 2^N*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: C=" << obf_dbgPrintC(C) << " neg=" << neg << std::endl;
-			RecursiveInjection::dbgPrint(offset + 1);
+	constexpr const char* const obf_site_kinds[] = { "obf_var", "obf_literal", "obf_str_literal", "obf_array", "obf_vector", "obf_unordered_map", "obf_record" };
+
+	inline double obf_site_timer_overhead() {//of obf_site_ticks() itself, to be subtracted from samples
+		double ret = 1e30;
+		for (int i = 0; i < 1000; ++i) {
+			uint64_t t0 = obf_site_ticks();
+			uint64_t t1 = obf_site_ticks();
+			ret = std::min(ret, double(t1 - t0));
 		}
-#endif
-	};
+		return ret;
+	}
 
-	//helper for Feistel-like: randomized_non_reversible_function 
-	template<size_t which, class T, OBFSEED seed, OBFCYCLES cycles>
-	struct obf_randomized_non_reversible_function_version;
-	//IMPORTANT: Feistel-like non-reversible functions SHOULD be short, to avoid creating code 'signatures'
-	//  Therefore, currently we're NOT using any recursions here
+	inline void ObfSiteRegistry::dump(std::ostream& os) {
+		std::vector<Entry> entries = snapshot();
+		uint64_t totalInj = 0, totalSurj = 0;
+		for (const Entry& e : entries) {
+			totalInj += e.injections;
+			totalSurj += e.surjections;
+		}
+		double overhead = obf_site_timer_overhead();
+		os << "obf site stats: " << entries.size() << " site(s), " << totalInj << " encode(s), " << totalSurj << " decode(s)";
+#ifdef ITHARE_OBF_SITE_STATS_SAMPLE_SHIFT
+		os << "; every 2^" << ITHARE_OBF_SITE_STATS_SAMPLE_SHIFT << "-th decode is timed, in " << obf_site_ticks_unit() << " (net of " << overhead << " for the timer itself)";
+#endif
+		os << std::endl;
+		for (const Entry& e : entries) {
+			const ObfSiteInfo& s = *e.site;
+			os << (e.file ? e.file : "?") << ":" << e.line << ": " << obf_site_kinds[int(s.kind)] << "<size=" << s.size << ">";
+			if (s.level >= 0)
+				os << " OBF" << s.level << " cycles=" << s.cycles << " site_cycles=" << s.site_cycles << " seed=" << s.seed;
+			os << ": encodes=" << e.injections << " decodes=" << e.surjections;
+			if (e.samples)
+				os << " decode=" << std::max(0., double(e.ticks) / double(e.samples) - overhead) << " (" << e.samples << " samples)";
+			os << std::endl;
+			if (s.print_tree)
+				s.print_tree(os);
+		}
+	}
 
-	struct obf_randomized_non_reversible_function_version0_descr {
-		static constexpr ObfDescriptor descr = ObfDescriptor(false, 0, 100);
-	};
+	inline void obf_site_json_string(std::ostream& os, const char* s) {
+		os << '"';
+		for (; *s; ++s) {
+			if (*s == '"' || *s == '\\')
+				os << '\\' << *s;
+			else if ((unsigned char)*s < 0x20)
+				os << "\\u00" << "0123456789abcdef"[(*s >> 4) & 0xf] << "0123456789abcdef"[*s & 0xf];
+			else
+				os << *s;
+		}
+		os << '"';
+	}
 
-	template<class T, OBFSEED seed, OBFCYCLES cycles>
-	struct obf_randomized_non_reversible_function_version<0, T, seed, cycles> {
-		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
-			return x;
+	//same as dump(), as JSON: {"sites":[...]}, hottest first; "tree" is obf_json<>() of the site (null if not available)
+	inline void ObfSiteRegistry::dump_json(std::ostream& os) {
+		std::vector<Entry> entries = snapshot();
+		double overhead = obf_site_timer_overhead();
+		os << "{\"ticks_unit\":";
+		obf_site_json_string(os, obf_site_ticks_unit());
+		os << ",\"sites\":[";
+		for (size_t i = 0; i < entries.size(); ++i) {
+			const Entry& e = entries[i];
+			const ObfSiteInfo& s = *e.site;
+			os << (i ? ",\n" : "\n") << "{\"kind\":\"" << obf_site_kinds[int(s.kind)] << "\",\"size\":" << s.size << ",\"file\":";
+			obf_site_json_string(os, e.file ? e.file : "");
+			os << ",\"line\":" << e.line;
+			if (s.level >= 0) {
+				char seed[2 + 16 + 1];
+				snprintf(seed, sizeof(seed), "0x%016" PRIx64, s.seed);
+				os << ",\"level\":" << s.level << ",\"cycles\":" << s.cycles << ",\"site_cycles\":" << s.site_cycles << ",\"seed\":\"" << seed << "\"";
+			}
+			os << ",\"encodes\":" << e.injections << ",\"decodes\":" << e.surjections << ",\"samples\":" << e.samples;
+			if (e.samples)
+				os << ",\"decode_ticks\":" << std::max(0., double(e.ticks) / double(e.samples) - overhead);
+			os << ",\"tree\":" << (s.json ? s.json : "null") << "}";
 		}
+		os << "\n]}" << std::endl;
+	}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_randomized_non_reversible_function<0/*identity*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">" << std::endl;
+	inline ObfSiteCounters& obf_site_counters(ObfSiteInfo& site) {
+		static thread_local ObfSiteThreadCounters counters;
+		size_t index = site.index.load(std::memory_order_acquire);
+		if (index == ObfSiteInfo::npos)
+			index = ObfSiteRegistry::instance().add(&site);
+		return counters.at(index);
+	}
+
+	class ObfSiteDecodeTimer {
+		ObfSiteCounters& c;
+		uint64_t t0;
+	public:
+		ITHARE_OBF_FORCEINLINE explicit ObfSiteDecodeTimer(ObfSiteCounters& c_) : c(c_), t0(obf_site_ticks()) {
+		}
+		ObfSiteDecodeTimer(const ObfSiteDecodeTimer&) = delete;
+		ObfSiteDecodeTimer& operator =(const ObfSiteDecodeTimer&) = delete;
+		ITHARE_OBF_FORCEINLINE ~ObfSiteDecodeTimer() {
+			obf_site_count(c.ticks, obf_site_ticks() - t0);
+			obf_site_count(c.samples, 1);
 		}
-#endif		
 	};
 
-	struct obf_randomized_non_reversible_function_version1_descr {
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, 3, 100);
-	};
+	template<class F>
+	ITHARE_OBF_FORCEINLINE auto obf_site_decode(ObfSiteCounters& c, F f, uint64_t n) {
+		uint64_t before = c.surjections.load(std::memory_order_relaxed);
+		obf_site_count(c.surjections, n);
+#ifdef ITHARE_OBF_SITE_STATS_SAMPLE_SHIFT
+		if (((before + n) >> (ITHARE_OBF_SITE_STATS_SAMPLE_SHIFT)) != (before >> (ITHARE_OBF_SITE_STATS_SAMPLE_SHIFT))) {
+			ObfSiteDecodeTimer timer(c);//approximate: TSC reads are not serializing
+			return f();
+		}
+#else
+		(void)before;
+#endif
+		return f();
+	}
 
-	template<class T, OBFSEED seed, OBFCYCLES cycles>
-	struct obf_randomized_non_reversible_function_version<1,T,seed,cycles> {
-		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
-			return x*x;
+	//stats of _dbg classes (without ITHARE_OBF_SEED) - by location
+	inline ObfSiteInfo& obf_dbg_site_info(ObfSiteKind kind, size_t size, ObfSiteLocation loc) {
+		struct Cached {
+			ObfSiteKind kind;
+			size_t size;
+			ObfSiteLocation loc;
+			ObfSiteInfo* site;
+		};
+		static thread_local std::vector<Cached> cache;//most recent first, to avoid going to registry (and its mutex) on each and every decode
+		for (size_t i = 0; i < cache.size(); ++i) {
+			if (cache[i].loc.file == loc.file && cache[i].loc.line == loc.line && cache[i].kind == kind && cache[i].size == size) {
+				if (i > 0)
+					std::swap(cache[i], cache[i / 2]);
+				return *cache[i / 2].site;
+			}
 		}
+		Cached c = { kind, size, loc, ObfSiteRegistry::instance().dbg_site(kind, size, loc) };
+		cache.push_back(c);
+		return *c.site;
+	}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_randomized_non_reversible_function<1/*x^2*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">" << std::endl;
+	inline void obf_site_stats_dump(std::ostream& os = std::cout) {
+		ObfSiteRegistry::instance().dump(os);
+	}
+	inline void obf_site_stats_dump_json(std::ostream& os = std::cout) {
+		ObfSiteRegistry::instance().dump_json(os);
+	}
+#endif//ITHARE_OBF_ENABLE_SITE_STATS
+
+	//obf_dbg_site: base of _dbg classes, which holds site location for per-site stats (and is empty otherwise)
+	template<ObfSiteKind kind, size_t size>
+	class obf_dbg_site {
+	public:
+#ifdef ITHARE_OBF_ENABLE_SITE_STATS
+		constexpr obf_dbg_site(ObfSiteLocation loc_) : loc(loc_) {
+		}
+		constexpr obf_dbg_site(const obf_dbg_site&) = default;
+		obf_dbg_site& operator =(const obf_dbg_site&) {//assignment changes value, not the site
+			return *this;
 		}
-#endif		
-	};
 
-	struct obf_randomized_non_reversible_function_version2_descr {
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, 7, 100);
-	};
+	protected:
+		void encoded(uint64_t n = 1) const {
+			obf_site_count(obf_site_counters(obf_dbg_site_info(kind, size, loc)).injections, n);
+		}
+		template<class F>
+		auto decode(F f, uint64_t n = 1) const {
+			return obf_site_decode(obf_site_counters(obf_dbg_site_info(kind, size, loc)), f, n);
+		}
 
-	template<class T, OBFSEED seed, OBFCYCLES cycles>
-	struct obf_randomized_non_reversible_function_version<2, T, seed, cycles> {
-		using ST = typename std::make_signed<T>::type;
-		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
-			ST sx = ST(x);
-			return T(sx < 0 ? -sx : sx);
+	private:
+		ObfSiteLocation loc;
+#else
+		constexpr obf_dbg_site(ObfSiteLocation) {
 		}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_randomized_non_reversible_function<2/*abs*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">" << std::endl;
+	protected:
+		ITHARE_OBF_FORCEINLINE void encoded(uint64_t = 1) const {
 		}
-#endif		
+		template<class F>
+		ITHARE_OBF_FORCEINLINE auto decode(F f, uint64_t = 1) const {
+			return f();
+		}
+#endif
 	};
 
-	template<size_t N>
-	constexpr OBFCYCLES obf_max_min_descr(std::array<ObfDescriptor,N> descr) {
-		OBFCYCLES ret = 0;
-		for (size_t i = 0; i < N; ++i) {
-			OBFCYCLES mn = descr[i].min_cycles;
-			if (ret < mn)
-				ret = mn;
+	//obf_hash_mix(): SplitMix64 finalizer, for hashing encoded values (which are no better distributed than the original ones,
+	//  as many injections are affine), and for obf_var_dbg<>'s plain ones the same way
+	ITHARE_OBF_FORCEINLINE constexpr uint64_t obf_hash_mix(uint64_t x) {
+		x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+		x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+		return x ^ (x >> 31);
+	}
+
+	//obf_index_iterator: random-access iterator over a container w/o addressable elements (obf_vector<>, obf_vector_dbg<>)
+	//  *it is c[i] - i.e. a decoded value for const Container, and a proxy (Container::reference) otherwise
+	template<class Container, class Value>
+	class obf_index_iterator {
+		template<class, class>
+		friend class obf_index_iterator;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = Value;
+		using difference_type = ptrdiff_t;
+		using reference = decltype(std::declval<Container&>()[size_t(0)]);
+		using pointer = void;
+
+		constexpr obf_index_iterator() : c(nullptr), i(0) {
 		}
+		constexpr obf_index_iterator(Container* c_, size_t i_) : c(c_), i(i_) {
+		}
+		template<class Container2, class = typename std::enable_if<std::is_same<const Container2, Container>::value && !std::is_same<Container2, Container>::value>::type>
+		constexpr obf_index_iterator(const obf_index_iterator<Container2, Value>& other) : c(other.c), i(other.i) {//iterator -> const_iterator
+		}
+
+		ITHARE_OBF_FORCEINLINE reference operator *() const { return (*c)[i]; }
+		ITHARE_OBF_FORCEINLINE reference operator [](difference_type n) const { return (*c)[i + n]; }
+
+		ITHARE_OBF_FORCEINLINE obf_index_iterator& operator ++() { ++i; return *this; }
+		ITHARE_OBF_FORCEINLINE obf_index_iterator& operator --() { --i; return *this; }
+		ITHARE_OBF_FORCEINLINE obf_index_iterator operator ++(int) { obf_index_iterator ret = *this; ++i; return ret; }
+		ITHARE_OBF_FORCEINLINE obf_index_iterator operator --(int) { obf_index_iterator ret = *this; --i; return ret; }
+		ITHARE_OBF_FORCEINLINE obf_index_iterator& operator +=(difference_type n) { i += n; return *this; }
+		ITHARE_OBF_FORCEINLINE obf_index_iterator& operator -=(difference_type n) { i -= n; return *this; }
+		ITHARE_OBF_FORCEINLINE obf_index_iterator operator +(difference_type n) const { return obf_index_iterator(c, i + n); }
+		ITHARE_OBF_FORCEINLINE obf_index_iterator operator -(difference_type n) const { return obf_index_iterator(c, i - n); }
+		ITHARE_OBF_FORCEINLINE friend obf_index_iterator operator +(difference_type n, const obf_index_iterator& it) { return it + n; }
+		ITHARE_OBF_FORCEINLINE difference_type operator -(const obf_index_iterator& other) const { return difference_type(i - other.i); }
+
+		ITHARE_OBF_FORCEINLINE bool operator ==(const obf_index_iterator& other) const { return i == other.i; }
+		ITHARE_OBF_FORCEINLINE bool operator !=(const obf_index_iterator& other) const { return i != other.i; }
+		ITHARE_OBF_FORCEINLINE bool operator <(const obf_index_iterator& other) const { return i < other.i; }
+		ITHARE_OBF_FORCEINLINE bool operator >(const obf_index_iterator& other) const { return i > other.i; }
+		ITHARE_OBF_FORCEINLINE bool operator <=(const obf_index_iterator& other) const { return i <= other.i; }
+		ITHARE_OBF_FORCEINLINE bool operator >=(const obf_index_iterator& other) const { return i >= other.i; }
+
+		size_t index() const { return i; }
+
+	private:
+		Container* c;
+		size_t i;
+	};
+
+	//wire serialization: obf_wire_writer<Wire>/obf_wire_reader<Wire> move obf_var<>s, obf_record<>s (and plain integers)
+	//  to/from a byte buffer in Wire format (see OBF?W()); each obfuscated value is transcoded between its in-memory encoding
+	//  and Wire's one within a single inlined expression, w/o an intermediate buffer of plain values
+	//  (the plain value is still there in between, and the compiler MAY spill it to the stack, same as for any value())
+	//  values go one after another, little-endian, w/o padding; write()/read() with several arguments do bounds
+	//  and size calculations once per batch (with offsets known at compile time), write_n()/read_n() - once per array
+	template<class U>
+	ITHARE_OBF_FORCEINLINE void obf_wire_store_le(uint8_t* p, U w) {
+		static_assert(std::is_unsigned<U>::value);
+		for (size_t i = 0; i < sizeof(U); ++i)//optimized into a single store on little-endian targets
+			p[i] = uint8_t(w >> (i * 8));
+	}
+	template<class U>
+	ITHARE_OBF_FORCEINLINE U obf_wire_load_le(const uint8_t* p) {
+		static_assert(std::is_unsigned<U>::value);
+		U ret = 0;
+		for (size_t i = 0; i < sizeof(U); ++i)
+			ret |= U(U(p[i]) << (i * 8));
 		return ret;
 	}
 
-	template<class T, OBFSEED seed, OBFCYCLES cycles>
-	struct obf_randomized_non_reversible_function {
-		constexpr static std::array<ObfDescriptor, 3> descr{
-			obf_randomized_non_reversible_function_version0_descr::descr,
-			obf_randomized_non_reversible_function_version1_descr::descr,
-			obf_randomized_non_reversible_function_version2_descr::descr,
-		};
-		constexpr static size_t max_cycles_that_make_sense = obf_max_min_descr(descr);
-		constexpr static size_t which = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
-		using FType = obf_randomized_non_reversible_function_version<which, T, seed, cycles>;
-		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
-			return FType()(x);
+	template<class X>
+	constexpr size_t obf_wire_size() {
+		if constexpr(std::is_integral<X>::value)
+			return sizeof(X);
+		else
+			return X::wire_size;
+	}
+	template<class Wire, class X>
+	ITHARE_OBF_FORCEINLINE void obf_wire_store(uint8_t* p, const X& x) {
+		if constexpr(std::is_integral<X>::value)
+			Wire::template store<typename std::make_unsigned<X>::type>(p, typename std::make_unsigned<X>::type(x));
+		else
+			x.template wire_store<Wire>(p);
+	}
+	template<class Wire, class X>
+	ITHARE_OBF_FORCEINLINE void obf_wire_load(const uint8_t* p, X& x) {
+		if constexpr(std::is_integral<X>::value)
+			x = X(Wire::template load<typename std::make_unsigned<X>::type>(p));
+		else
+			x.template wire_load<Wire>(p);
+	}
+
+	template<class Wire>
+	class obf_wire_writer {
+	public:
+		explicit obf_wire_writer(std::vector<uint8_t>& buf_) : buf(buf_) {
 		}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_randomized_non_reversible_function<" << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: which=" << which << std::endl;
-			FType::dbgPrint(offset + 1);
+		template<class... X>
+		ITHARE_OBF_FORCEINLINE void write(const X&... x) {
+			uint8_t* p = grow((obf_wire_size<X>() + ...));
+			((obf_wire_store<Wire>(p, x), p += obf_wire_size<X>()), ...);
 		}
-#endif		
+		//format fingerprint (see obf_wire<>), normally the very first thing in the stream
+		void write_fingerprint() {
+			obf_wire_store_le(grow(sizeof(uint64_t)), uint64_t(Wire::fingerprint));
+		}
+		template<class X>
+		void write_n(const X* x, size_t n) {
+			uint8_t* p = grow(n * obf_wire_size<X>());
+			for (size_t i = 0; i < n; ++i, p += obf_wire_size<X>())
+				obf_wire_store<Wire>(p, x[i]);
+		}
+
+	private:
+		uint8_t* grow(size_t sz) {
+			size_t at = buf.size();
+			buf.resize(at + sz);
+			return buf.data() + at;
+		}
+
+		std::vector<uint8_t>& buf;
 	};
 
-	//version 2: kinda-Feistel round
-	template<class T, class Context>
-	struct obf_injection_version2_descr {
-		static constexpr OBFCYCLES own_min_injection_cycles = 7;
-		static constexpr OBFCYCLES own_min_surjection_cycles = 7;
-		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr =
-			sizeof(T) > 1 ?
-			ObfDescriptor(true, own_min_cycles, 100) :
-			ObfDescriptor(false, 0, 0);
-	};
-
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<2, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
+	template<class Wire>
+	class obf_wire_reader {
 	public:
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version2_descr<T,Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
-		constexpr static std::array<ObfDescriptor, 2> split {
-			ObfDescriptor(true,0,100),//f() 
-			ObfDescriptor(true,0,100)//RecursiveInjection
-		};
-		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
-		static constexpr OBFCYCLES cycles_f0 = splitCycles[0];
-		static constexpr OBFCYCLES cycles_rInj0 = splitCycles[1];
-		static_assert(cycles_f0 + cycles_rInj0 <= availCycles);
-
-		//doesn't make sense to use more than max_cycles_that_make_sense cycles for f...
-		static constexpr OBFCYCLES max_cycles_that_make_sense = obf_randomized_non_reversible_function<T, 0, 0>::max_cycles_that_make_sense;
-		static constexpr OBFCYCLES delta_f = cycles_f0 > max_cycles_that_make_sense ? cycles_f0 - max_cycles_that_make_sense : 0;
-		static constexpr OBFCYCLES cycles_f = cycles_f0 - delta_f;
-		static constexpr OBFCYCLES cycles_rInj = cycles_rInj0 + delta_f;
-		static_assert(cycles_f + cycles_rInj <= availCycles);
-
-		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles_rInj+ Context::context_cycles,ObfDefaultInjectionContext>;
-		using return_type = typename RecursiveInjection::return_type;
-
-		using halfT = typename obf_half_size_int<T>::value_type;
-		using FType = obf_randomized_non_reversible_function<halfT, obf_compile_time_prng(seed, 3), cycles_f>;
+		obf_wire_reader(const uint8_t* p_, size_t sz) : p(p_), end(p_ + sz) {
+		}
+		explicit obf_wire_reader(const std::vector<uint8_t>& buf) : obf_wire_reader(buf.data(), buf.size()) {
+		}
 
-		constexpr static int halfTBits = sizeof(halfT) * 8;
-		//constexpr static T mask = ((T)1 << halfTBits) - 1;
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			T lo = x >> halfTBits;
-			//T hi = (x & mask) + f((halfT)lo);
-			T hi = x + f((halfT)lo);
-			return RecursiveInjection::injection((hi << halfTBits) + lo);
+		//on overrun, leaves x... intact, returns false, and fails all further reads
+		template<class... X>
+		ITHARE_OBF_FORCEINLINE bool read(X&... x) {
+			if (!take((obf_wire_size<X>() + ...)))
+				return false;
+			const uint8_t* q = p - (obf_wire_size<X>() + ...);
+			((obf_wire_load<Wire>(q, x), q += obf_wire_size<X>()), ...);
+			return true;
 		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y_) {
-			T y = RecursiveInjection::surjection(y_);
-			halfT hi = y >> halfTBits;
-			T lo = y;
-			//T z = (hi - f((halfT)lo)) & mask;
-			halfT z = (hi - f((halfT)lo));
-			return z + (lo << halfTBits);
+		//false (failing all further reads) if the stream was written in a different format (or is too short)
+		bool read_fingerprint() {
+			if (!take(sizeof(uint64_t)) || obf_wire_load_le<uint64_t>(p - sizeof(uint64_t)) != Wire::fingerprint) {
+				p = end;
+				return false;
+			}
+			return true;
+		}
+		template<class X>
+		bool read_n(X* x, size_t n) {
+			if (n > remaining() / obf_wire_size<X>() || !take(n * obf_wire_size<X>())) {
+				p = end;
+				return false;
+			}
+			const uint8_t* q = p - n * obf_wire_size<X>();
+			for (size_t i = 0; i < n; ++i, q += obf_wire_size<X>())
+				obf_wire_load<Wire>(q, x[i]);
+			return true;
 		}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<2/*kinda-Feistel*/,"<<obf_dbgPrintT<T>()<<"," << seed << "," << cycles << ">:" 
-				" availCycles=" << availCycles << " cycles_f=" << cycles_f << " cycles_rInj=" << cycles_rInj << std::endl;
-			//auto splitCyclesRT = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
-			//std::cout << std::string(offset, ' ') << " f():" << std::endl;
-			FType::dbgPrint(offset + 1,"f():");
-			//std::cout << std::string(offset, ' ') << " Recursive:" << std::endl;
-			RecursiveInjection::dbgPrint(offset + 1,"Recursive:");
+		size_t remaining() const {
+			return size_t(end - p);
 		}
-#endif
 
 	private:
-		ITHARE_OBF_FORCEINLINE static constexpr halfT f(halfT x) {
-			return FType()(x);
+		bool take(size_t sz) {
+			if (sz > remaining()) {
+				p = end;
+				return false;
+			}
+			p += sz;
+			return true;
 		}
-	};
 
-	//version 3: split-join
-	template<class T,class Context>
-	struct obf_injection_version3_descr {
-		static constexpr OBFCYCLES own_min_injection_cycles = 7;
-		static constexpr OBFCYCLES own_min_surjection_cycles = 7;
-		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr =
-			sizeof(T) > 1 ?
-			ObfDescriptor(true, own_min_cycles, 100) :
-			ObfDescriptor(false, 0, 0);
+		const uint8_t* p;
+		const uint8_t* end;
 	};
+}//namespace obf
+}//namespace ithare
 
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<3, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-	public:
-		//TODO:split-join based on union
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version3_descr<T, Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
-
-		using halfT = typename obf_half_size_int<T>::value_type;
-		constexpr static int halfTBits = sizeof(halfT) * 8;
+#ifdef ITHARE_OBF_SEED
 
-		constexpr static std::array<ObfDescriptor, 3> split{
-			ObfDescriptor(true,0,200),//RecursiveInjection
-			ObfDescriptor(true,0,100),//LoInjection
-			ObfDescriptor(true,0,100),//HiInjection
-		};
-		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
-		static constexpr OBFCYCLES cycles_rInj = splitCycles[0];
-		static constexpr OBFCYCLES cycles_lo = splitCycles[1];
-		static constexpr OBFCYCLES cycles_hi = splitCycles[2];
-		static_assert(cycles_rInj + cycles_lo + cycles_hi <= availCycles);
+#ifndef ITHARE_OBF_SCALE//#define for libraries, using OBFN() macros; 
+				//  allows to promote/demote obfuscation scale of the whole library by ITHARE_OBF_SCALE
+				//  ITHARE_OBF_SCALE = 1 'converts' all OBF0()'s into OBF1()'s, and so on...
+				//  DOES NOT affect obfN<> without macros(!)
+#define ITHARE_OBF_SCALE 0
+#endif
+namespace ithare {
+namespace obf {
+	//NAMESPACE POLICIES:
+	//  EVERYTHING goes into ithare::obf namespace - except for #defines
+	//  ALL #defines are prefixed with ITHARE_OBF_
+	//    THE ONLY exception is OBF0()...OBF6() macros
+	//      These can be disabled using ITHARE_OBF_NO_SHORT_DEFINES macro 
+	//        If disabling - use equivalent ITHARE_OBF0()...ITHARE_OBF6()
 
-		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles_rInj+ Context::context_cycles, ObfDefaultInjectionContext>;
-		using return_type = typename RecursiveInjection::return_type;
+	using OBFSEED = uint64_t;
+	using OBFCYCLES = int32_t;//signed!
 
-		constexpr static std::array<ObfDescriptor, 2> splitLo {
-			ObfDescriptor(true,0,100),//Context
-			ObfDescriptor(true,0,100)//Injection
-		};
-		static constexpr auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 2), cycles_lo, splitLo);
-		static constexpr OBFCYCLES cycles_loCtx = splitCyclesLo[0];
-		static constexpr OBFCYCLES cycles_loInj = splitCyclesLo[1];
-		static_assert(cycles_loCtx + cycles_loInj <= cycles_lo);
-		using LoContext = typename ObfRecursiveContext < halfT, Context, obf_compile_time_prng(seed, 3), cycles_loCtx>::intermediate_context_type;
-		using LoInjection = obf_injection<halfT, LoContext, obf_compile_time_prng(seed, 4), cycles_loInj+LoContext::context_cycles, ObfDefaultInjectionContext>;
-		static_assert(sizeof(LoInjection::return_type) == sizeof(halfT));//bijections ONLY; TODO: enforce
+	//POTENTIALLY user-modifiable constexpr function:
+	constexpr OBFCYCLES obf_exp_cycles(int exp) {
+		if (exp < 0)
+			return 0;
+		OBFCYCLES ret = 1;
+		if (exp & 1) {
+			ret *= 3;
+			exp -= 1;
+		}
+		assert((exp & 1) == 0);
+		exp >>= 1;
+		for (int i = 0; i < exp; ++i)
+			ret *= 10;
+		return ret;
+	}
 
-		constexpr static std::array<ObfDescriptor, 2> splitHi{
-			ObfDescriptor(true,0,100),//Context
-			ObfDescriptor(true,0,100)//Injection
-		};
-		static constexpr auto splitCyclesHi = obf_random_split(obf_compile_time_prng(seed, 5), cycles_hi, splitHi);
-		static constexpr OBFCYCLES cycles_hiCtx = splitCyclesHi[0];
-		static constexpr OBFCYCLES cycles_hiInj = splitCyclesHi[1];
-		static_assert(cycles_hiCtx + cycles_hiInj <= cycles_hi);
-		using HiContext = typename ObfRecursiveContext<halfT, Context, obf_compile_time_prng(seed, 6), cycles_hiCtx>::intermediate_context_type;
-		using HiInjection = obf_injection<halfT, HiContext, obf_compile_time_prng(seed, 7), cycles_hiInj+HiContext::context_cycles, ObfDefaultInjectionContext>;
-		static_assert(sizeof(HiInjection::return_type) == sizeof(halfT));//bijections ONLY; TODO: enforce
+	//helper constexpr functions
+	constexpr size_t obf_strlen(const char* s) {
+		for (size_t ret = 0; ; ++ret, ++s)
+			if (*s == 0)
+				return ret;
+	}
 
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			halfT lo = x >> halfTBits;
-			typename LoInjection::return_type lo1 = LoInjection::injection(lo);
-			lo = halfT(lo1);// *reinterpret_cast<halfT*>(&lo1);//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
-			halfT hi = (halfT)x;
-			typename HiInjection::return_type hi1 = HiInjection::injection(hi);
-			hi = halfT(hi1);// *reinterpret_cast<halfT*>(&hi1);//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
-			return RecursiveInjection::injection((T(hi) << halfTBits) + T(lo));
-		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y_) {
-			auto y = RecursiveInjection::surjection(y_);
-			halfT hi0 = y >> halfTBits;
-			halfT lo0 = (halfT)y;
-			halfT hi = HiInjection::surjection(/* *reinterpret_cast<typename HiInjection::return_type*>(&hi0)*/typename HiInjection::return_type(hi0));//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
-			halfT lo = LoInjection::surjection(/**reinterpret_cast<typename LoInjection::return_type*>(&lo0)*/ typename LoInjection::return_type(lo0));//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
-			return T(hi) + (T(lo) << halfTBits);
+	//compile-time PRNG; called LOTS of times while instantiating injections, so it MUST be O(1) in iteration
+	//  what got faster to compile (GCC 12, test/compiletime/prng_bench.py): TUs with OBF sites, by ~1.1-1.2x, and anything which asks
+	//    for a large 'iteration' (the old LCG looped 'iteration' times, hitting constexpr step limits, MSVC's in particular);
+	//    a synthetic constexpr workload of many small-'iteration' calls is ~1.5x SLOWER (0.65x): GCC's evaluator cost is dominated
+	//    by the number of calls rather than by arithmetic, and the library's own iterations are mostly 1-3
+	//  ITHARE_OBF_COMPAT_LCG_PRNG switches back to the old LCG stream (via jump-ahead), to compare the two generators;
+	//    it does NOT reproduce the code older versions generated from the same ITHARE_OBF_SEED: obf_random_split()
+	//    and obf_compile_time_approximation() are integer-only now (and round differently), and there are more
+	//    injection versions and literal contexts to choose from
+	constexpr OBFSEED obf_lcg_jump(OBFSEED seed, uint64_t n) {
+		//equivalent to applying linear congruential x=A*x+C n times, in O(log n) (along the lines of F.Brown, "Random Number Generation with Arbitrary Stride")
+		OBFSEED mul = 1, add = 0;
+		OBFSEED curMul = UINT64_C(6364136223846793005), curAdd = UINT64_C(1442695040888963407);
+		while (n) {
+			if (n & 1) {
+				mul *= curMul;
+				add = add * curMul + curAdd;
+			}
+			curAdd = (curMul + 1) * curAdd;
+			curMul *= curMul;
+			n >>= 1;
 		}
+		return mul * seed + add;
+	}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<3/*split-join*/,"<<obf_dbgPrintT<T>()<<"," << seed << "," << cycles << ">" << std::endl;
-			//std::cout << std::string(offset, ' ') << " Lo:" << std::endl;
-			LoInjection::dbgPrint(offset + 1,"Lo:");
-			//std::cout << std::string(offset, ' ') << " Hi:" << std::endl;
-			HiInjection::dbgPrint(offset + 1,"Hi:");
-			//std::cout << std::string(offset, ' ') << " Recursive:" << std::endl;
-			RecursiveInjection::dbgPrint(offset + 1,"Recursive:");
-		}
+	constexpr OBFSEED obf_compile_time_prng(OBFSEED seed, int iteration) {
+		static_assert(sizeof(OBFSEED) == 8);
+		assert(iteration > 0);
+#ifdef ITHARE_OBF_COMPAT_LCG_PRNG//the same stream as older versions of the library (but NOT the same code, see above)
+		return obf_lcg_jump(seed, uint64_t(iteration));//linear congruential one
+#else
+		//counter-based: iteration-th element of the stream is SplitMix64 finalizer over (seed + iteration*golden_gamma), no loops;
+		//  NB: finalizer is intentionally inlined here - for constexpr evaluators, number of calls matters a lot more than number of operations
+		//  TODO: replace with something crypto-strength for production use
+		OBFSEED x = seed + uint64_t(iteration) * UINT64_C(0x9e3779b97f4a7c15);
+		x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+		x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+		return x ^ (x >> 31);
 #endif
-	};
-	
-	//version 4: multiply by odd
-	template< class T >
-	constexpr T obf_mul_inverse_mod2n(T num) {//extended GCD, intended to be used in compile-time only
-											  //by Dmytro Ivanchykhin
-		assert(num & 1);
-		T num0 = num;
-		T x = 0, lastx = 1, y = 1, lasty = 0;
-		T q=0, temp1=0, temp2=0, temp3=0;
-		T mod = 0;
-
-		// zero step: do some tricks to avoid overflowing
-		// note that initially mod is power of 2 that does not fit to T
-		if (num == T(mod - T(1)))
-			return num;
-		q = T((T(mod - num)) / num) + T(1);
-		temp1 = (T(T(T(mod - T(2))) % num) + T(2)) % num;
-		mod = num;
-		num = temp1;
-
-		temp2 = x;
-		x = lastx - T(q * x);
-		lastx = temp2;
-
-		temp3 = y;
-		y = lasty - T(q * y);
-		lasty = temp3;
+	}
 
-		while (num != 0) {
-			q = mod / num;
-			temp1 = mod % num;
-			mod = num;
-			num = temp1;
+	constexpr OBFSEED obf_seed_from_file_line_counter(const char* file, int line, int counter) {
+		OBFSEED ret = ITHARE_OBF_SEED ^ line ^ counter;
+		for (const char* p = file; *p; ++p)//effectively djb2 by Dan Bernstein, albeit with different initializer
+			ret = ((ret << 5) + ret) + *p;
+		return obf_compile_time_prng(ret, 1);//to reduce ill effects from a low-quality PRNG
+	}
 
-			temp2 = x;
-			x = lastx - T(q * x);
-			lastx = temp2;
+	constexpr uint64_t obf_mul_div(uint64_t a, uint64_t b, uint64_t c) {
+		//integer-only floor(a*b/c), w/o overflowing on a*b; result MUST fit into 64 bits
+		assert(c > 0);
+		if (a == 0 || b <= UINT64_C(0xFFFFFFFFFFFFFFFF) / a)
+			return a * b / c;//fast path: no overflow (which is by far the most common case)
+		uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+		uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+		uint64_t lolo = aLo * bLo;
+		uint64_t mid1 = aHi * bLo + (lolo >> 32);
+		uint64_t mid2 = aLo * bHi + (mid1 & 0xFFFFFFFF);
+		uint64_t hi = aHi * bHi + (mid1 >> 32) + (mid2 >> 32);
+		uint64_t lo = (mid2 << 32) | (lolo & 0xFFFFFFFF);
+		assert(hi < c);
+		uint64_t rem = hi;
+		uint64_t ret = 0;
+		for (int i = 63; i >= 0; --i) {//restoring division of (rem:lo) by c, bit by bit
+			bool carry = (rem >> 63) != 0;
+			rem = (rem << 1) | ((lo >> i) & 1);
+			ret <<= 1;
+			if (carry || rem >= c) {
+				rem -= c;
+				ret |= 1;
+			}
+		}
+		return ret;
+	}
 
-			temp3 = y;
-			y = lasty - T(q * y);
-			lasty = temp3;
+	template<class T, size_t N>
+	constexpr T obf_compile_time_approximation(T x, std::array<T, N> xref, std::array<T, N> yref) {
+		//piecewise-linear, integer-only
+		for (size_t i = 0; i < N - 1; ++i) {
+			T x0 = xref[i];
+			T x1 = xref[i + 1];
+			if (x >= x0 && x < x1) {
+				T y0 = yref[i];
+				T y1 = yref[i + 1];
+				assert(y1 >= y0);
+				return T(y0 + obf_mul_div(uint64_t(x - x0), uint64_t(y1 - y0), uint64_t(x1 - x0)));
+			}
 		}
-		assert(T(num0*lasty) == T(1));
-		return lasty;
+		assert(x >= xref[N - 1]);
+		return yref[N - 1];
 	}
 
-	template<class Context>
-	struct obf_injection_version4_descr {
-		static constexpr OBFCYCLES own_min_injection_cycles = 3 + Context::literal_cycles;
-		static constexpr OBFCYCLES own_min_surjection_cycles = 3;
-		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, own_min_cycles, 100);
-	};
+	constexpr uint64_t obf_sqrt_very_rough_approximation(uint64_t x0) {
+		std::array<uint64_t, 34> xref = {};
+		std::array<uint64_t, 34> yref = {};
+		for (size_t i = 1; i < 33; ++i) {
+			uint64_t x = UINT64_C(1) << (i - 1);
+			xref[i] = x * x;
+			yref[i] = x;
+		}
+		xref[33] = UINT64_C(0xFFFFFFFFFFFFFFFF);
+		yref[33] = UINT64_C(0xFFFFFFFF);
+		return obf_compile_time_approximation(x0, xref, yref);
+	}
 
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<4, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version4_descr<Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
+	template<class MAX>
+	constexpr MAX obf_weak_random(OBFSEED seed, MAX n) {
+		assert(n > 0);
+		OBFSEED hi = seed >> (sizeof(OBFSEED) * 4);
+		return  hi % n;//biased, but for our purposes will do
+	}
 
-		struct RecursiveInjectionContext {
-			static constexpr size_t exclude_version = 4;
-		};
+	template<size_t N>
+	constexpr size_t obf_random_from_list(OBFSEED seed, std::array<size_t, N> weights) {
+		//returns index in weights
+		size_t totalWeight = 0;
+		for (size_t i = 0; i < weights.size(); ++i)
+			totalWeight += weights[i];
+		assert(totalWeight > 0);
+		size_t refWeight = obf_weak_random(seed, totalWeight);
+		assert(refWeight < totalWeight);
+		for (size_t i = 0; i < weights.size(); ++i) {
+			if (refWeight < weights[i])
+				return i;
+			refWeight -= weights[i];
+		}
+		assert(false);
+	}
 
-	public:
-		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), availCycles+Context::context_cycles,RecursiveInjectionContext>;
-		using return_type = typename RecursiveInjection::return_type;
-		//constexpr static T C = (T)(obf_gen_const<T>(obf_compile_time_prng(seed, 2)) | 1);
-		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
-		constexpr static T C = obf_random_const<T>(obf_compile_time_prng(seed, 2), consts);
-		static_assert((C & 1) == 1);
-		constexpr static T CINV = obf_mul_inverse_mod2n(C);
-		static_assert((T)(C*CINV) == (T)1);
+	//OBF_CONST_X: constants to be used throughout this particular build
+	template<class T, size_t N>
+	constexpr size_t obf_find_idx_in_array(std::array<T, N> arr, T value) {
+		for (size_t i = 0; i < N; ++i) {
+			if (arr[i] == value)
+				return i;
+		}
+		return size_t(-1);
+	}
 
-		using literal = typename Context::template literal<T, CINV, obf_compile_time_prng(seed, 3)>::type;
+	template<size_t N>
+	constexpr uint8_t obf_const_x(OBFSEED seed, std::array<uint8_t, N> excluded) {
+		std::array<uint8_t, 6> candidates = { 3,5,7,15,25,31 };//only odd, to allow using the same set of constants in mul-by-odd injections
+		std::array<size_t, 6> weights = { 100,100,100,100,100,100 };
+		for (size_t i = 0; i < N; ++i) {
+			size_t found = obf_find_idx_in_array(candidates, excluded[i]);
+			if (found != size_t(-1))
+				weights[found] = 0;
+		}
+		size_t idx2 = obf_random_from_list(seed, weights);
+		return candidates[idx2];
+	}
 
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			return RecursiveInjection::injection(x * literal().value());//using CINV in injection to hide literals a bit better...
+	//XOR-ed constants are merely random numbers with no special meaning
+	constexpr std::array<uint8_t, 0> obf_const_A_excluded = {};
+	constexpr uint8_t OBF_CONST_A = obf_const_x(obf_compile_time_prng(ITHARE_OBF_SEED^UINT64_C(0xcec4b8ea4b89a1a9),1), obf_const_A_excluded);
+	constexpr std::array<uint8_t, 1> obf_const_B_excluded = { OBF_CONST_A };
+	constexpr uint8_t OBF_CONST_B = obf_const_x(obf_compile_time_prng(ITHARE_OBF_SEED^UINT64_C(0x5eec23716fa1d0aa),1), obf_const_B_excluded);
+	constexpr std::array<uint8_t, 2> obf_const_C_excluded = { OBF_CONST_A, OBF_CONST_B };
+	constexpr uint8_t OBF_CONST_C = obf_const_x(obf_compile_time_prng(ITHARE_OBF_SEED^UINT64_C(0xfb2de18f982a2d55),1), obf_const_C_excluded);
+
+	template<class T, size_t N>
+	constexpr T obf_random_const(OBFSEED seed, std::array<T, N> lst) {
+		return lst[obf_weak_random(seed, N)];
+	}
+
+
+	struct ObfDescriptor {
+		bool is_recursive;
+		OBFCYCLES min_cycles;
+		size_t weight;
+
+		constexpr ObfDescriptor(bool is_recursive_, OBFCYCLES min_cycles_, size_t weight_)
+			: is_recursive(is_recursive_), min_cycles(min_cycles_), weight(weight_) {
 		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
-			return RecursiveInjection::surjection(y) * C;
+	};
+
+	template<size_t N>
+	constexpr size_t obf_random_obf_from_list(OBFSEED seed, OBFCYCLES cycles, std::array<ObfDescriptor, N> descr,size_t exclude_version=size_t(-1)) {
+		//returns index in descr
+		size_t sz = descr.size();
+		std::array<size_t, N> nr_weights = {};
+		std::array<size_t, N> r_weights = {};
+		size_t sum_r = 0;
+		size_t sum_nr = 0;
+		for (size_t i = 0; i < sz; ++i) {
+			if (i != exclude_version && cycles >= descr[i].min_cycles) {
+				if (descr[i].is_recursive) {
+					r_weights[i] = descr[i].weight;
+					sum_r += r_weights[i];
+				}
+				else {
+					nr_weights[i] = descr[i].weight;
+					sum_nr += nr_weights[i];
+				}
+			}
+		}
+		if (sum_r)
+			return obf_random_from_list(seed, r_weights);
+		else {
+			assert(sum_nr > 0);
+			return obf_random_from_list(seed, nr_weights);
 		}
+	}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<4/*mul odd mod 2^N*/,"<<obf_dbgPrintT<T>()<<"," << seed << "," << cycles << ">: C=" << obf_dbgPrintC(C) << " CINV=" << obf_dbgPrintC(CINV) << std::endl;
-			//std::cout << std::string(offset, ' ') << " literal:" << std::endl;
-			literal::dbgPrint(offset + 1,"literal:");
-			//std::cout << std::string(offset, ' ') << " Recursive:" << std::endl;
-			RecursiveInjection::dbgPrint(offset + 1,"Recursive:");
+	template<size_t N>
+	constexpr std::array<OBFCYCLES, N> obf_random_split(OBFSEED seed, OBFCYCLES cycles, std::array<ObfDescriptor, N> elements) {
+		//size_t totalWeight = 0;
+		assert(cycles >= 0);
+		OBFCYCLES mins = 0;
+		for (size_t i = 0; i < N; ++i) {
+			assert(elements[i].min_cycles==0);//mins NOT to be used within calls to obf_random_split 
+											  //  (it not a problem with this function, but they tend to cause WAY too much trouble in injection_version<> code
+			mins += elements[i].min_cycles;
+			//totalWeight += elements[i].weight;
+		}
+		OBFCYCLES leftovers = cycles - mins;
+		assert(leftovers >= 0);
+		std::array<OBFCYCLES, N> ret = {};
+		size_t totalWeight = 0;
+		for (size_t i = 0; i < N; ++i) {
+			if (elements[i].weight > 0)
+				ret[i] = OBFCYCLES(obf_weak_random(obf_compile_time_prng(seed, int(i + 1)), elements[i].weight)) + 1;//'+1' is to avoid "all-zeros" case
+			else
+				ret[i] = 0;
+			totalWeight += ret[i];
+		}
+		if (totalWeight == 0)
+			return ret;
+		size_t totalWeight2 = 0;
+		for (size_t i = 0; i < N; ++i) {
+			ret[i] = elements[i].min_cycles+OBFCYCLES(uint64_t(ret[i]) * uint64_t(leftovers) / uint64_t(totalWeight));//integer-only; can't overflow as both are 32-bit
+			assert(ret[i] >= elements[i].min_cycles);
+			totalWeight2 += ret[i];
+		}
+		assert(OBFCYCLES(totalWeight2) <= mins + leftovers);
+		return ret;
+	}
+
+	//cycle costs of building blocks (injection versions, literal contexts, non-reversible functions)
+	//  default ones below are rough estimates; to use costs measured on the build machine:
+	//    - build and run test/calibrate/obf_calibrate.cpp, redirecting its output to a file (say, obf_cycle_costs.h)
+	//    - compile your project with -DITHARE_OBF_CYCLE_COSTS_HEADER="\"obf_cycle_costs.h\""
+	//  measured costs take precedence over defaults; whatever is missing from the generated header falls back to defaults
+	enum class ObfCycleCostKind { injection_version, literal_context, non_reversible_function };
+
+	struct ObfCycleCost {
+		ObfCycleCostKind kind;
+		size_t which;
+		size_t sz;//sizeof(T); 0 means 'any size'
+		OBFCYCLES injection;
+		OBFCYCLES surjection;//for literal contexts and non-reversible functions, ONLY surjection is used
+
+		constexpr ObfCycleCost(ObfCycleCostKind kind_, size_t which_, size_t sz_, OBFCYCLES injection_, OBFCYCLES surjection_)
+			: kind(kind_), which(which_), sz(sz_), injection(injection_), surjection(surjection_) {
 		}
-#endif
 	};
 
-	//version 5: split (w/o join)
-	template<class T, class Context>
-	struct obf_injection_version5_descr {
-		static constexpr OBFCYCLES own_min_injection_cycles = 3;
-		static constexpr OBFCYCLES own_min_surjection_cycles = 3;
-		static constexpr OBFCYCLES own_min_cycles = 2*Context::context_cycles /* have to allocate context_cycles for BOTH branches */ + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr =
-			sizeof(T) > 1 ?
-			ObfDescriptor(true, own_min_cycles, 100) :
-			ObfDescriptor(false, 0, 0);
+	constexpr ObfCycleCost obf_default_cycle_costs[] = {
+		ObfCycleCost(ObfCycleCostKind::injection_version, 0, 0, 0, 0),//identity
+		ObfCycleCost(ObfCycleCostKind::injection_version, 1, 0, 1, 1),//add mod 2^N
+		ObfCycleCost(ObfCycleCostKind::injection_version, 2, 0, 7, 7),//kinda-Feistel, excluding f()
+		ObfCycleCost(ObfCycleCostKind::injection_version, 3, 0, 7, 7),//split-join
+		ObfCycleCost(ObfCycleCostKind::injection_version, 4, 0, 3, 3),//mul odd mod 2^N, excluding literal
+		ObfCycleCost(ObfCycleCostKind::injection_version, 5, 0, 3, 3),//split
+		ObfCycleCost(ObfCycleCostKind::injection_version, 6, 0, 3, 3),//injection(halfT)
+		ObfCycleCost(ObfCycleCostKind::injection_version, 7, 0, 1, 1),//xor
+
+		ObfCycleCost(ObfCycleCostKind::literal_context, 0, 0, 0, 0),//identity
+		ObfCycleCost(ObfCycleCostKind::literal_context, 1, 0, 0, 6),//global volatile
+		ObfCycleCost(ObfCycleCostKind::literal_context, 2, 0, 0, 20),//func with aliased pointers
+		ObfCycleCost(ObfCycleCostKind::literal_context, 3, 0, 0, 10),//PEB
+		ObfCycleCost(ObfCycleCostKind::literal_context, 4, 0, 0, 100),//global volatile var-with-invariant
+			//yes, it is up 100+ cycles now (due to worst-case MT caching issues)
+		ObfCycleCost(ObfCycleCostKind::literal_context, 5, 0, 0, 8),//thread_local var-with-invariant
+		ObfCycleCost(ObfCycleCostKind::literal_context, 6, 0, 0, 3),//masked var-with-invariant
+		ObfCycleCost(ObfCycleCostKind::literal_context, 7, 0, 0, 6),//multiply-high var-with-invariant
+		ObfCycleCost(ObfCycleCostKind::literal_context, 8, 0, 0, 7),//Montgomery-style var-with-invariant (incl. mix() of the state, both ways)
+		ObfCycleCost(ObfCycleCostKind::literal_context, 9, 0, 0, 5),//addend XOR-ed with obf_opaque_zero()
+		ObfCycleCost(ObfCycleCostKind::literal_context, 10, 0, 0, 8),//odd multiplier XOR-ed with obf_opaque_zero()
+
+		ObfCycleCost(ObfCycleCostKind::non_reversible_function, 0, 0, 0, 0),//identity
+		ObfCycleCost(ObfCycleCostKind::non_reversible_function, 1, 0, 3, 3),//x^2
+		ObfCycleCost(ObfCycleCostKind::non_reversible_function, 2, 0, 7, 7),//abs
 	};
 
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<5, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-	public:
-		using halfT = typename obf_half_size_int<T>::value_type;
-		constexpr static int halfTBits = sizeof(halfT) * 8;
+#ifdef ITHARE_OBF_CYCLE_COSTS_HEADER
+	constexpr ObfCycleCost obf_measured_cycle_costs[] = {
+#include ITHARE_OBF_CYCLE_COSTS_HEADER
+	};
+#endif
 
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version5_descr<T,Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
+	template<size_t N>
+	constexpr const ObfCycleCost* obf_find_cycle_cost(const ObfCycleCost (&costs)[N], ObfCycleCostKind kind, size_t which, size_t sz) {
+		for (size_t i = 0; i < N; ++i) {
+			if (costs[i].kind == kind && costs[i].which == which && (costs[i].sz == sz || costs[i].sz == 0))
+				return &costs[i];
+		}
+		return nullptr;
+	}
 
-		constexpr static std::array<ObfDescriptor, 2> split{
-			ObfDescriptor(true,0,100),//LoInjection
-			ObfDescriptor(true,0,100),//HiInjection
-		};
-		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
-		static constexpr OBFCYCLES cycles_lo = splitCycles[0];
-		static constexpr OBFCYCLES cycles_hi = splitCycles[1];
-		static_assert(cycles_lo + cycles_hi <= availCycles);
+	constexpr ObfCycleCost obf_cycle_cost(ObfCycleCostKind kind, size_t which, size_t sz) {
+#ifdef ITHARE_OBF_CYCLE_COSTS_HEADER
+		const ObfCycleCost* measured = obf_find_cycle_cost(obf_measured_cycle_costs, kind, which, sz);
+		if (measured)
+			return *measured;
+#endif
+		const ObfCycleCost* dflt = obf_find_cycle_cost(obf_default_cycle_costs, kind, which, sz);
+		assert(dflt);
+		return *dflt;
+	}
 
-		constexpr static std::array<ObfDescriptor, 2> splitLo{
-			ObfDescriptor(true,0,100),//Context
-			ObfDescriptor(true,0,100)//Injection
-		};
-		static constexpr auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 2), cycles_lo, splitLo);
-		static constexpr OBFCYCLES cycles_loCtx = splitCyclesLo[0];
-		static constexpr OBFCYCLES cycles_loInj = splitCyclesLo[1];
-		static_assert(cycles_loCtx + cycles_loInj <= cycles_lo);
-		using RecursiveLoContext = typename ObfRecursiveContext<halfT, Context, obf_compile_time_prng(seed, 3), cycles_loCtx+Context::context_cycles>::recursive_context_type;
-		using RecursiveInjectionLo = obf_injection<halfT, RecursiveLoContext, obf_compile_time_prng(seed, 4), cycles_loInj+ RecursiveLoContext::context_cycles,ObfDefaultInjectionContext>;
+	//the same w/o ITHARE_OBF_CYCLE_COSTS_HEADER, for trees which MUST be the same for all the builds (wire formats, see obf_wire<>);
+	//  literal contexts are not allowed in such trees (their costs, and even their implementations, depend on the compiler)
+	constexpr ObfCycleCost obf_fixed_cycle_cost(ObfCycleCostKind kind, size_t which, size_t sz) {
+		assert(kind != ObfCycleCostKind::literal_context);
+		const ObfCycleCost* dflt = obf_find_cycle_cost(obf_default_cycle_costs, kind, which, sz);
+		assert(dflt);
+		return *dflt;
+	}
 
-		constexpr static std::array<ObfDescriptor, 2> splitHi{
-			ObfDescriptor(true,0,100),//Context
-			ObfDescriptor(true,0,100)//Injection
-		};
-		static constexpr auto splitCyclesHi = obf_random_split(obf_compile_time_prng(seed, 5), cycles_hi, splitHi);
-		static constexpr OBFCYCLES cycles_hiCtx = splitCyclesHi[0];
-		static constexpr OBFCYCLES cycles_hiInj = splitCyclesHi[1];
-		static_assert(cycles_hiCtx + cycles_hiInj <= cycles_hi);
-		using RecursiveHiContext = typename ObfRecursiveContext<halfT, Context, obf_compile_time_prng(seed, 6), cycles_hiCtx+Context::context_cycles>::recursive_context_type;
-		using RecursiveInjectionHi = obf_injection < halfT, RecursiveHiContext, obf_compile_time_prng(seed, 7), cycles_hiInj+ RecursiveHiContext::context_cycles,ObfDefaultInjectionContext > ;
+	constexpr OBFCYCLES obf_max_cycle_cost(ObfCycleCostKind kind, size_t sz) {
+		OBFCYCLES ret = 0;
+		for (size_t which = 0; ; ++which) {
+			const ObfCycleCost* dflt = obf_find_cycle_cost(obf_default_cycle_costs, kind, which, sz);
+			if (!dflt)
+				return ret;
+			OBFCYCLES c = obf_cycle_cost(kind, which, sz).surjection;
+			if (c > ret)
+				ret = c;
+		}
+	}
 
-		struct return_type {
-			typename RecursiveInjectionLo::return_type lo;
-			typename RecursiveInjectionHi::return_type hi;
+	//profile-guided per-site cycles
+	//  sites are keyed by their seeds (for OBF?() macros - the ones from obf_seed_from_file_line_counter()):
+	//    - build with -DITHARE_OBF_PROFILE_TRAINING, and run it over a representative workload;
+	//      on exit, it writes per-site execution counts, and per-site cycles for the profiled build,
+	//      to ITHARE_OBF_PROFILE_OUTPUT (by default - "obf_profile.h")
+	//    - build with -DITHARE_OBF_PROFILE_HEADER="\"obf_profile.h\"" and the SAME ITHARE_OBF_SEED as the training build
+	//      (with a different seed, no sites will match, so the profile will be silently ignored)
+	//  each profiled site then gets cycles ~ cycles/sqrt(count) (i.e. one OBF level down for each 10x of executions),
+	//    scaled so that estimated overhead SUM(count*cycles) is ITHARE_OBF_PROFILE_OVERHEAD_PERCENT of the unprofiled one,
+	//    and clamped to within ITHARE_OBF_PROFILE_MAX_LEVELS OBF levels of the site's own cycles
+	//    (if the floors alone exceed the target, all the profiled sites simply go to their floors)
+	//  sites executed zero times in training go up by ITHARE_OBF_PROFILE_MAX_LEVELS; sites missing from profile keep their cycles
+	//  all of it is calculated by the training build (on exit, in runtime), so ITHARE_OBF_PROFILE_OVERHEAD_PERCENT and
+	//    ITHARE_OBF_PROFILE_MAX_LEVELS are training-build settings; the profiled build merely looks sites up (binary search by seed)
+	//  training counts are per-site stats (see ITHARE_OBF_ENABLE_SITE_STATS), i.e. encodes+decodes
+	//  profiled are obf_var<>, obf_literal<>, and obf_array<>; string literals are not (yet?)
+#if defined(ITHARE_OBF_PROFILE_TRAINING) && defined(ITHARE_OBF_PROFILE_HEADER)
+#error ITHARE_OBF_PROFILE_TRAINING and ITHARE_OBF_PROFILE_HEADER are mutually exclusive
+#endif
+#if defined(ITHARE_OBF_PROFILE_HEADER) && (defined(ITHARE_OBF_PROFILE_OVERHEAD_PERCENT) || defined(ITHARE_OBF_PROFILE_MAX_LEVELS))
+#error ITHARE_OBF_PROFILE_OVERHEAD_PERCENT and ITHARE_OBF_PROFILE_MAX_LEVELS are applied by the training build (see above)
+#endif
+#ifndef ITHARE_OBF_PROFILE_OVERHEAD_PERCENT
+#define ITHARE_OBF_PROFILE_OVERHEAD_PERCENT 100//100 means 'redistribute cycles, keeping overall overhead the same'
+#endif
+#ifndef ITHARE_OBF_PROFILE_MAX_LEVELS
+#define ITHARE_OBF_PROFILE_MAX_LEVELS 2
+#endif
 
-			constexpr return_type(halfT lo_, halfT hi_)
-				: lo(lo_), hi(hi_) {
-			}
-			constexpr return_type(T x) 
-			: lo(halfT(x)), hi(halfT(x>>halfTBits)){
-			}
-			constexpr operator T() {
-				halfT lo1 = halfT(lo);
-				halfT hi1 = halfT(hi);
-				return ( T(hi1) << halfTBits ) + T(lo1);
-			}
+	struct ObfSiteProfile {
+		OBFSEED seed;
+		OBFCYCLES cycles;//site's own cycles in the training build
+		uint64_t count;
+		OBFCYCLES profiled_cycles;//as calculated by the training build
+
+		constexpr ObfSiteProfile(OBFSEED seed_, OBFCYCLES cycles_, uint64_t count_, OBFCYCLES profiled_cycles_)
+			: seed(seed_), cycles(cycles_), count(count_), profiled_cycles(profiled_cycles_) {
+		}
+	};
+
+#ifdef ITHARE_OBF_PROFILE_TRAINING
+	//per-site cycles for the profiled build; plain doubles, as it runs once, on exit of the training build
+	inline void obf_profile_calc_cycles(std::vector<ObfSiteProfile>& sites) {
+		double maxFactor = double(obf_exp_cycles(ITHARE_OBF_PROFILE_MAX_LEVELS));
+		auto siteCycles = [maxFactor](const ObfSiteProfile& p, double scale) {
+			double hi = double(p.cycles) * maxFactor;
+			if (p.count == 0)
+				return hi;
+			double ret = double(p.cycles) * scale / std::sqrt(double(p.count));
+			double lo = double(p.cycles) / maxFactor;
+			return ret < lo ? lo : ret > hi ? hi : ret;
 		};
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			return_type ret{ RecursiveInjectionLo::injection((halfT)x), RecursiveInjectionHi::injection(x >> halfTBits) };
+		auto overhead = [&sites, &siteCycles](double scale) {
+			double ret = 0;
+			for (const ObfSiteProfile& p : sites)
+				ret += double(p.count) * siteCycles(p, scale);
 			return ret;
+		};
+
+		//largest scale for which estimated overhead is still within target; overhead is monotonic in scale, so it is a bisection
+		double target = 0;
+		double maxSqrt = 0;
+		for (const ObfSiteProfile& p : sites) {
+			target += double(p.count) * double(p.cycles);
+			maxSqrt = std::max(maxSqrt, std::sqrt(double(p.count)));
 		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y_) {
-			halfT hi = RecursiveInjectionHi::surjection(y_.hi);
-			halfT lo = RecursiveInjectionLo::surjection(y_.lo);
-			return (T)lo + ((T)hi << halfTBits);
+		target = target * ITHARE_OBF_PROFILE_OVERHEAD_PERCENT / 100;
+		double lo = 0, hi = maxSqrt * maxFactor;//at hi, all the sites are at their ceilings
+		double scale = hi;
+		if (overhead(hi) > target) {
+			for (int i = 0; i < 48; ++i) {
+				double mid = (lo + hi) / 2;
+				if (overhead(mid) <= target)
+					lo = mid;
+				else
+					hi = mid;
+			}
+			scale = lo;
+		}
+		for (ObfSiteProfile& p : sites) {
+			double c = siteCycles(p, scale) + 0.5;
+			p.profiled_cycles = c >= double(INT32_MAX / 2) ? INT32_MAX / 2 : OBFCYCLES(c);
 		}
+	}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<5/*split*/,"<<obf_dbgPrintT<T>()<<"," << seed << "," << cycles << ">" << std::endl;
-			//std::cout << std::string(offset, ' ') << " Lo:" << std::endl;
-			RecursiveInjectionLo::dbgPrint(offset + 1,"Lo:");
-			//std::cout << std::string(offset, ' ') << " Hi:" << std::endl;
-			RecursiveInjectionHi::dbgPrint(offset + 1,"Hi:");
+	inline bool ObfSiteRegistry::write_profile(const char* path) {
+		std::vector<ObfSiteProfile> sites;
+		for (const Entry& e : snapshot()) {
+			if (e.site->level >= 0)//only seeded sites can be profiled
+				sites.push_back(ObfSiteProfile(e.site->seed, e.site->cycles, e.injections + e.surjections, e.site->cycles));
 		}
+		std::sort(sites.begin(), sites.end(), [](const ObfSiteProfile& a, const ObfSiteProfile& b) { return a.seed < b.seed; });
+		obf_profile_calc_cycles(sites);
+		FILE* f = fopen(path, "w");
+		if (!f)
+			return false;
+		fprintf(f, "//%s: GENERATED by ITHARE_OBF_PROFILE_TRAINING build, DO NOT EDIT\n", path);
+		fprintf(f, "//  to be used as -DITHARE_OBF_PROFILE_HEADER, with the same ITHARE_OBF_SEED (see obfuscate.h)\n");
+		fprintf(f, "//  ITHARE_OBF_PROFILE_OVERHEAD_PERCENT=%d, ITHARE_OBF_PROFILE_MAX_LEVELS=%d\n", int(ITHARE_OBF_PROFILE_OVERHEAD_PERCENT), int(ITHARE_OBF_PROFILE_MAX_LEVELS));
+		fprintf(f, "//  ObfSiteProfile(seed, cycles, count, profiled_cycles), sorted by seed\n");
+		for (const ObfSiteProfile& p : sites)
+			fprintf(f, "ObfSiteProfile(UINT64_C(0x%016" PRIx64 "), %d, UINT64_C(%" PRIu64 "), %d),\n", p.seed, int(p.cycles), p.count, int(p.profiled_cycles));
+		return fclose(f) == 0;
+	}
 #endif
+
+#ifdef ITHARE_OBF_PROFILE_HEADER
+	constexpr ObfSiteProfile obf_site_profiles[] = {
+		ObfSiteProfile(0, 0, 0, 0),//dummy, so that an empty profile still compiles; NOT a site
+#include ITHARE_OBF_PROFILE_HEADER
 	};
+	constexpr size_t obf_site_profiles_n = sizeof(obf_site_profiles) / sizeof(obf_site_profiles[0]);
 
-	//version 6: injection over lower half /*CHEAP!*/
-	template<class T, class Context>
-	struct obf_injection_version6_descr {
-		static constexpr OBFCYCLES own_min_injection_cycles = 3;
-		static constexpr OBFCYCLES own_min_surjection_cycles = 3;
-		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr =
-			sizeof(T) > 1 ?
-			ObfDescriptor(true, own_min_cycles, 100/*it's cheap, but doesn't obfuscate the whole thing well => let's use it mostly for lower-cycle stuff*/) :
-			ObfDescriptor(false, 0, 0);
-	};
+	constexpr bool obf_site_profiles_sorted() {
+		for (size_t i = 2; i < obf_site_profiles_n; ++i) {
+			if (!(obf_site_profiles[i - 1].seed < obf_site_profiles[i].seed))
+				return false;
+		}
+		return true;
+	}
+	static_assert(obf_site_profiles_sorted(), "ITHARE_OBF_PROFILE_HEADER: sites have to be sorted by seed (re-run the training build)");
+
+	constexpr const ObfSiteProfile* obf_find_site_profile(OBFSEED seed) {
+		size_t lo = 1, hi = obf_site_profiles_n;
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			if (obf_site_profiles[mid].seed < seed)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo < obf_site_profiles_n && obf_site_profiles[lo].seed == seed ? &obf_site_profiles[lo] : nullptr;
+	}
+#endif
 
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<6, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-	public:
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version6_descr<T,Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
+	constexpr OBFCYCLES obf_site_cycles(OBFSEED seed, OBFCYCLES cycles) {
+#ifdef ITHARE_OBF_PROFILE_HEADER
+		const ObfSiteProfile* p = obf_find_site_profile(seed);
+		if (!p)
+			return cycles;
+		if (cycles == p->cycles || p->cycles <= 0)
+			return p->profiled_cycles;
+		uint64_t ret = uint64_t(p->profiled_cycles) * uint64_t(cycles) / uint64_t(p->cycles);//same ratio, if cycles have changed since training
+		return ret >= uint64_t(INT32_MAX / 2) ? INT32_MAX / 2 : OBFCYCLES(ret);
+#else
+		(void)seed;
+		return cycles;
+#endif
+	}
 
-		struct RecursiveInjectionContext {
-			static constexpr size_t exclude_version = 6;
-		};
-		using halfT = typename obf_half_size_int<T>::value_type;
+	//code-size-bounded mode
+	//  normally, each use of obf_var<>/obf_literal<>/obf_str_literal<> inlines its whole injection and surjection trees
+	//    (ITHARE_OBF_FORCEINLINE all the way down); for a large program, it can push real hot code out of L1i
+	//  -DITHARE_OBF_CODE_SIZE_BOUNDED outlines trees of the sites (or, for string literals, of their chunks) with more than
+	//    ITHARE_OBF_INLINE_BUDGET cycles into functions shared by all the uses of the site, which the compiler inlines back
+	//    if there is only one use (see obf_outlined_injection<>)
+	//    (cycles are the only per-site cost estimate we have, and tree size grows with them)
+	//    NB: it is the whole tree of a site which is outlined, not its subtrees: subtrees of different sites are different
+	//      instantiations (seeds and contexts differ all the way down), so there would be nothing to share between sites,
+	//      and within a site, subtrees are used once per tree; it is ITHARE_OBF_MAX_TREES_PER_TYPE which makes trees shared
+	//  -DITHARE_OBF_MAX_TREES_PER_TYPE=N (with or without ITHARE_OBF_CODE_SIZE_BOUNDED) makes all the sites with the same
+	//    type and OBF level share at most N distinct trees: seeds of the trees are quantized to N values,
+	//    and site cycles are rounded down to an OBF level (which matters only with ITHARE_OBF_PROFILE_HEADER);
+	//    then sites share the very same instantiations (and outlined functions), and what remains is left to identical-code folding
+	//  the price is a call per encode/decode of outlined sites, and less diversity with ITHARE_OBF_MAX_TREES_PER_TYPE
+	//  sites are still distinct for everything else (incl. per-site stats and profiles)
+#ifndef ITHARE_OBF_INLINE_BUDGET
+#define ITHARE_OBF_INLINE_BUDGET 30//OBF3()
+#endif
+#ifdef ITHARE_OBF_MAX_TREES_PER_TYPE
+	static_assert(ITHARE_OBF_MAX_TREES_PER_TYPE > 0);
+#endif
 
-		constexpr static std::array<ObfDescriptor, 2> split{
-			ObfDescriptor(true,0,200),//RecursiveInjection
-			ObfDescriptor(true,0,100),//LoInjection
-		};
-		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
-		static constexpr OBFCYCLES cycles_rInj = splitCycles[0];
-		static constexpr OBFCYCLES cycles_lo = splitCycles[1];
-		static_assert(cycles_rInj + cycles_lo <= availCycles);
+	constexpr OBFSEED obf_tree_seed(OBFSEED site_seed) {
+#ifdef ITHARE_OBF_MAX_TREES_PER_TYPE
+		return obf_compile_time_prng(ITHARE_OBF_SEED ^ UINT64_C(0x6c8e9cf570932bd5), 1 + int(site_seed % uint64_t(ITHARE_OBF_MAX_TREES_PER_TYPE)));
+#else
+		return site_seed;
+#endif
+	}
+	constexpr OBFCYCLES obf_tree_cycles(OBFCYCLES site_cycles) {
+#ifdef ITHARE_OBF_MAX_TREES_PER_TYPE
+		if (site_cycles < obf_exp_cycles(0))
+			return site_cycles;
+		int level = 0;
+		while (obf_exp_cycles(level + 1) <= site_cycles)
+			++level;
+		return obf_exp_cycles(level);
+#else
+		return site_cycles;
+#endif
+	}
+	constexpr bool obf_tree_inlined(OBFCYCLES cycles) {
+#ifdef ITHARE_OBF_CODE_SIZE_BOUNDED
+		return cycles <= ITHARE_OBF_INLINE_BUDGET;
+#else
+		(void)cycles;
+		return true;
+#endif
+	}
 
-		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles_rInj + Context::context_cycles, ObfDefaultInjectionContext>;
-		using return_type = typename RecursiveInjection::return_type;
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+	//dbgJson(): machine-readable counterpart of dbgPrint(), constexpr - so that the tree of a site is available
+	//  as a compile-time string (obf_json<Site>()), without running anything
+	//  each node is {"node":...,<node-specific fields>,<resources>,"children":[...]}, where
+	//    "cycles" is what the node got, and "min_cycles" - its declared minimum (own_min_cycles of the version, or context_cycles)
+	//    resources (ObfJsonResources) are per-node, without children; the root object gets their "total" over the whole tree
+	//    literal contexts report theirs from their own resources() (the flat leaves of obf_flat_injection<> ask the same context)
+	//  seeds and constants are hex strings (JSON numbers don't hold 64 bits for most of the consumers)
+	struct ObfJsonResources {//run-time costs of surjection() other than cycles
+		int loads = 0;//memory loads (incl. stack round-trips)
+		int calls = 0;//non-inlined calls
+		size_t global_bytes = 0;//global state
+		size_t tls_bytes = 0;//thread_local state (per thread)
+	};
 
+	class ObfJsonWriter {
+		static constexpr size_t max_depth = 2048;//OBF6 chains over 8-bit types go several hundred injections deep, 2 levels each
 	public:
-		constexpr static std::array<ObfDescriptor, 2> splitLo{
-			ObfDescriptor(true,0,100),//Context
-			ObfDescriptor(true,0,100)//Injection
-		};
-		static constexpr auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 3), cycles_lo, splitLo);
-		static constexpr OBFCYCLES cycles_loCtx = splitCyclesLo[0];
-		static constexpr OBFCYCLES cycles_loInj = splitCyclesLo[1];
-		static_assert(cycles_loCtx + cycles_loInj <= cycles_lo);
-		using LoContext = typename ObfRecursiveContext < halfT, Context, obf_compile_time_prng(seed, 4), cycles_loCtx>::intermediate_context_type;
-		using LoInjection = obf_injection<halfT, LoContext, obf_compile_time_prng(seed, 5), cycles_loInj + LoContext::context_cycles, ObfDefaultInjectionContext>;
-		static_assert(sizeof(LoInjection::return_type) == sizeof(halfT));//bijections ONLY; TODO: enforce
+		constexpr ObfJsonWriter(char* buf_, size_t cap_)//buf_ == nullptr: count chars only
+			: buf(buf_), cap(cap_) {
+		}
+		constexpr size_t size() const {
+			return len;
+		}
 
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			halfT lo0 = halfT(x);
-			typename LoInjection::return_type lo1 = LoInjection::injection(lo0);
-			//halfT lo = *reinterpret_cast<halfT*>(&lo1);//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
-			halfT lo = halfT(lo1);
-			return RecursiveInjection::injection(x - T(lo0) + lo);
+		constexpr void begin(const char* kind, const char* role = "") {
+			assert(depth < max_depth);
+			separator();
+			put('{');
+			has_children[depth++] = false;
+			first = true;
+			string("node", kind);
+			if (*role)
+				string("role", role);
 		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type yy) {
-			T y = RecursiveInjection::surjection(yy);
-			halfT lo0 = halfT(y);
-			halfT lo = LoInjection::surjection(/* *reinterpret_cast<typename LoInjection::return_type*>(&lo0)*/ typename LoInjection::return_type(lo0));//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
-			return y - T(lo0) + lo;
+		constexpr void children() {
+			assert(depth > 0 && !has_children[depth - 1]);
+			separator();
+			put("\"children\":[");
+			has_children[depth - 1] = true;
+			first = true;
+		}
+		constexpr void end() {
+			assert(depth > 0);
+			if (has_children[--depth]) {
+				put(']');
+				first = false;
+			}
+			if (depth == 0)
+				put_resources("total", tot);
+			put('}');
+			first = false;
 		}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<6/*injection(halfT)*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">" << std::endl;
-			LoInjection::dbgPrint(offset + 1, "Lo:");
-			RecursiveInjection::dbgPrint(offset + 1, "Recursive:");
+		constexpr void number(const char* key, int64_t v) {
+			put_key(key);
+			if (v < 0) {
+				put('-');
+				put_uint(uint64_t(0) - uint64_t(v));
+			}
+			else
+				put_uint(uint64_t(v));
+		}
+		constexpr void unumber(const char* key, uint64_t v) {
+			put_key(key);
+			put_uint(v);
+		}
+		constexpr void boolean(const char* key, bool v) {
+			put_key(key);
+			put(v ? "true" : "false");
+		}
+		constexpr void hex(const char* key, uint64_t v) {
+			put_key(key);
+			put("\"0x");
+			for (int i = 60; i >= 0; i -= 4)
+				put("0123456789abcdef"[(v >> i) & 0xf]);
+			put('"');
+		}
+		constexpr void string(const char* key, const char* s, size_t n = size_t(-1)) {
+			put_key(key);
+			put('"');
+			for (size_t i = 0; i < n && s[i]; ++i) {
+				char c = s[i];
+				if (c == '"' || c == '\\') {
+					put('\\');
+					put(c);
+				}
+				else if ((unsigned char)c < 0x20) {
+					put("\\u00");
+					put("0123456789abcdef"[(c >> 4) & 0xf]);
+					put("0123456789abcdef"[c & 0xf]);
+				}
+				else
+					put(c);
+			}
+			put('"');
+		}
+		constexpr void resources(ObfJsonResources r) {
+			number("loads", r.loads);
+			number("calls", r.calls);
+			unumber("global_bytes", r.global_bytes);
+			unumber("tls_bytes", r.tls_bytes);
+			tot.loads += r.loads;
+			tot.calls += r.calls;
+			tot.global_bytes += r.global_bytes;
+			tot.tls_bytes += r.tls_bytes;
 		}
-#endif
-	};
 
-	#if 0 //COMMENTED OUT - TOO OBVIOUS IN DECOMPILE :-(
-	//version 7: 1-bit rotation 
-	template<class Context>
-	struct obf_injection_version7_descr {
-		static constexpr OBFCYCLES own_min_injection_cycles = 5;//relying on compiler generating cmovns etc.
-		static constexpr OBFCYCLES own_min_surjection_cycles = 5;//relying on compiler generating cmovns etc.
-		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, own_min_cycles, 100);
+	private:
+		constexpr void put(char c) {
+			if (buf && len < cap)
+				buf[len] = c;
+			++len;
+		}
+		constexpr void put(const char* s) {
+			for (; *s; ++s)
+				put(*s);
+		}
+		constexpr void put_uint(uint64_t v) {
+			char digits[20] = {};
+			int n = 0;
+			do {
+				digits[n++] = char('0' + v % 10);
+				v /= 10;
+			} while (v);
+			while (n)
+				put(digits[--n]);
+		}
+		constexpr void separator() {
+			if (!first)
+				put(',');
+			first = false;
+		}
+		constexpr void put_key(const char* key) {
+			separator();
+			put('"');
+			put(key);
+			put("\":");
+		}
+		constexpr void put_resources(const char* key, ObfJsonResources r) {
+			put_key(key);
+			put('{');
+			first = true;
+			number("loads", r.loads);
+			number("calls", r.calls);
+			unumber("global_bytes", r.global_bytes);
+			unumber("tls_bytes", r.tls_bytes);
+			put('}');
+			first = false;
+		}
+
+		char* buf;
+		size_t cap;
+		size_t len = 0;
+		bool first = true;//no separator before the next item in current object/array
+		size_t depth = 0;
+		bool has_children[max_depth] = {};
+		ObfJsonResources tot = {};
 	};
 
-	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_injection_version<7, T, Context, seed, cycles> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-	public:
-		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version7_descr<Context>::own_min_cycles;
-		static_assert(availCycles >= 0);
+	//obf_json<Node>(): dbgJson() of Node (obf_var<>, obf_literal<>, obf_str_literal<>, obf_array<>, or any node of their trees)
+	//  as a compile-time string
+	template<class Node>
+	constexpr size_t obf_json_size() {
+		ObfJsonWriter w(nullptr, 0);
+		Node::dbgJson(w);
+		return w.size();
+	}
+	template<size_t N>
+	struct ObfJsonChars {
+		char data[N + 1] = {};
+	};
+	template<class Node, size_t N>
+	constexpr ObfJsonChars<N> obf_json_chars() {
+		ObfJsonChars<N> ret;
+		ObfJsonWriter w(ret.data, N);
+		Node::dbgJson(w);
+		return ret;
+	}
+	template<class Node>
+	struct obf_json_str {
+		static constexpr size_t size = obf_json_size<Node>();
+		static constexpr ObfJsonChars<size> chars = obf_json_chars<Node, size>();
+	};
+	template<class Node>
+	constexpr std::string_view obf_json() {
+		return std::string_view(obf_json_str<Node>::chars.data, obf_json_str<Node>::size);
+	}
+#endif
 
-		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), availCycles + Context::context_cycles, ObfDefaultInjectionContext>;
-		using return_type = typename RecursiveInjection::return_type;
-		using ST = typename std::make_signed<T>::type;
-		static constexpr T highbit = T(1) << (sizeof(T) * 8 - 1);
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			if ((x % 2) == 0)
-				x = x >> 1;
-			else
-				x = ( x >> 1 ) + highbit;
-			return RecursiveInjection::injection(x);
-		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
-			T yy = RecursiveInjection::surjection(y);
-			ST syy = ST(yy);
-			if (syy < 0)
-				return yy + yy + 1;
-			else
-				return yy+yy;
-		}
+	//per-site stats of seeded classes (see ITHARE_OBF_ENABLE_SITE_STATS); Site is the class itself
+#ifdef ITHARE_OBF_ENABLE_SITE_STATS
+	constexpr int obf_cycles_level(OBFCYCLES cycles) {//inverse of obf_exp_cycles()
+		int ret = 0;
+		while (obf_exp_cycles(ret) < cycles)
+			++ret;
+		return ret;
+	}
 
+	template<class Site, ObfSiteKind kind, size_t size, OBFSEED seed, OBFCYCLES cycles, OBFCYCLES site_cycles>
+	struct obf_site_stats {
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<7/*1-bit rotation*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">" << std::endl;
-			RecursiveInjection::dbgPrint(offset + 1);
+		static void print_tree(std::ostream& os) {
+			std::streambuf* prev = std::cout.rdbuf(os.rdbuf());//dbgPrint() knows only about std::cout
+			Site::dbgPrint(1);
+			std::cout.rdbuf(prev);
 		}
+		static constexpr void(*tree)(std::ostream&) = print_tree;
+		static constexpr const char* json = obf_json<Site>().data();
+#else
+		static constexpr void(*tree)(std::ostream&) = nullptr;
+		static constexpr const char* json = nullptr;
 #endif
-	};
-#endif//#if 0
-
-	//obf_injection: combining obf_injection_version
-	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles,class InjectionContext>
-	class obf_injection {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		constexpr static std::array<ObfDescriptor, 7> descr{
-			obf_injection_version0_descr<Context>::descr,
-			obf_injection_version1_descr<Context>::descr,
-			obf_injection_version2_descr<T,Context>::descr,
-			obf_injection_version3_descr<T,Context>::descr,
-			obf_injection_version4_descr<Context>::descr,
-			obf_injection_version5_descr<T,Context>::descr,
-			obf_injection_version6_descr<T,Context>::descr,
-			//obf_injection_version7_descr<Context>::descr,
+		static inline ObfSiteInfo info = { kind, size, seed, cycles, site_cycles, obf_cycles_level(cycles), tree, json };//constant-initialized, so early hits are not lost
+		struct Registration {
+			Registration() {
+				ObfSiteRegistry::instance().add(&info);
+			}
 		};
-		constexpr static size_t which = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr,InjectionContext::exclude_version);
-		static_assert(which >= 0 && which < descr.size());
-		using WhichType = obf_injection_version<which, T, Context, seed, cycles>;
+		static inline Registration registration;//so that sites with no encodes/decodes are reported too
 
-	public:
-		using return_type = typename WhichType::return_type;
-		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
-			return WhichType::injection(x);
+		static void locate(ObfSiteLocation loc) {
+			(void)&registration;
+			if (!info.file.load(std::memory_order_relaxed))
+				ObfSiteRegistry::instance().locate(info, loc);
 		}
-		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
-			return WhichType::surjection(y);
+		ITHARE_OBF_FORCEINLINE static void encoded(uint64_t n = 1) {
+			(void)&registration;
+			obf_site_count(obf_site_counters(info).injections, n);
 		}
-
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			size_t dbgWhich = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
-			std::cout << std::string(offset, ' ') << prefix << "obf_injection<"<<obf_dbgPrintT<T>()<<"," << seed << "," << cycles << ">: which=" << which << " dbgWhich=" << dbgWhich << std::endl;
-			//std::cout << std::string(offset, ' ') << " Context:" << std::endl;
-			Context::dbgPrint(offset + 1,"Context:");
-			//std::cout << std::string(offset, ' ') << " Version:" << std::endl;
-			WhichType::dbgPrint(offset + 1);
+		template<class F>
+		ITHARE_OBF_FORCEINLINE static auto decode(F f, uint64_t n = 1) {
+			(void)&registration;
+			return obf_site_decode(obf_site_counters(info), f, n);
+		}
+	};
+#else
+	template<class Site, ObfSiteKind kind, size_t size, OBFSEED seed, OBFCYCLES cycles, OBFCYCLES site_cycles>
+	struct obf_site_stats {
+		ITHARE_OBF_FORCEINLINE static void locate(ObfSiteLocation) {
+		}
+		ITHARE_OBF_FORCEINLINE static void encoded(uint64_t = 1) {
 		}
+		template<class F>
+		ITHARE_OBF_FORCEINLINE static auto decode(F f, uint64_t = 1) {
+			return f();
+		}
+	};
 #endif
+
+	//type helpers
+	//obf_half_size_int<>
+	//TODO: obf_traits<>, including obf_traits<>::half_size_int
+	template<class T>
+	struct obf_half_size_int;
+
+	template<>
+	struct obf_half_size_int<uint16_t> {
+		using value_type = uint8_t;
 	};
 
-	//ObfLiteralContext
-	template<size_t which, class T, OBFSEED seed>
-	struct ObfLiteralContext_version;
-	//forward declaration:
+	template<>
+	struct obf_half_size_int<int16_t> {
+		using value_type = int8_t;
+	};
+
+	template<>
+	struct obf_half_size_int<uint32_t> {
+		using value_type = uint16_t;
+	};
+
+	template<>
+	struct obf_half_size_int<int32_t> {
+		using value_type = int16_t;
+	};
+
+	template<>
+	struct obf_half_size_int<uint64_t> {
+		using value_type = uint32_t;
+	};
+
+	template<>
+	struct obf_half_size_int<int64_t> {
+		using value_type = int32_t;
+	};
+
+	//forward declarations
+	struct ObfDefaultInjectionContext {
+		static constexpr size_t exclude_version = size_t(-1);
+	};
+	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles,class InjectionContext>
+	class obf_injection;
+	template<class T, T C, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_literal_ctx;
+	template<class T_, T_ C_, OBFSEED seed, OBFCYCLES cycles>
+	class obf_literal;
 	template<class T, OBFSEED seed, OBFCYCLES cycles>
-	class ObfLiteralContext;
+	struct ObfVarContext;
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+	//dbgPrint helpers
+	template<class T>
+	std::string obf_dbgPrintT() {
+		return std::string("T(sizeof=") + std::to_string(sizeof(T)) + ")";
+	}
+
+	template<class T>
+	struct ObfPrintC {
+		using type = T;
+	};
+	template<>
+	struct ObfPrintC<uint8_t> {
+		using type = int;
+	};
+
+	template<class T>
+	typename ObfPrintC<T>::type obf_dbgPrintC(T c) {
+		return typename ObfPrintC<T>::type(c);
+	}
+
+	//ObfDbgVersion: what both dbgPrint() and dbgJson() of a version (obf_injection_version<>,
+	//  obf_randomized_non_reversible_function_version<>, ObfLiteralContext_version<>) start with; each version returns it from its dbgVersion()
+	struct ObfDbgVersion {
+		const char* node;
+		int version;
+		const char* name;
+		size_t size;
+		OBFSEED seed;
+		OBFCYCLES cycles;//-1 for literal contexts (they cost a fixed context_cycles)
+		OBFCYCLES min_cycles;
+	};
+
+	template<class T>
+	std::ostream& obf_dbgPrintVersion(size_t offset, const char* prefix, const ObfDbgVersion& v) {//the rest of the line is up to the caller
+		std::cout << std::string(offset, ' ') << prefix << v.node << "<" << v.version << "/*" << v.name << "*/," << obf_dbgPrintT<T>() << "," << v.seed;
+		if (v.cycles >= 0)
+			std::cout << "," << v.cycles;
+		return std::cout << ">";
+	}
+	constexpr void obf_dbgJsonVersion(ObfJsonWriter& w, const char* role, const ObfDbgVersion& v) {//opens the node; the rest of it is up to the caller
+		w.begin(v.node, role);
+		w.number("version", v.version);
+		w.string("name", v.name);
+		w.number("size", int64_t(v.size));
+		w.hex("seed", v.seed);
+		if (v.cycles >= 0)
+			w.number("cycles", v.cycles);
+		w.number("min_cycles", v.min_cycles);
+	}
+#endif
+
+	//ObfRecursiveContext
+	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	struct ObfRecursiveContext;
+
+	//ObfAffine: for injections which happen to be affine mod 2^N (i.e. injection(x) == a*x+b for ALL x, with a odd),
+	//  describes a and b, allowing some arithmetic directly on the injected ('encoded') value:
+	//    injection(x+k) == injection(x) + a*k
+	//    injection(x*k) == (injection(x)-b)*k + b
+	//  versions 0 (as described by the context's final_affine()), 1 (add), and 4 (mul by odd) preserve affinity; all the others break it
+	template<class T>
+	struct ObfAffine {
+		static_assert(std::is_unsigned<T>::value);
+		using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned, T>::type;//avoiding promotion to signed int
+
+		bool is_affine = false;
+		T a = 1;
+		T b = 0;
+
+		constexpr ObfAffine compose(ObfAffine inner) const {//(*this)(inner(x))
+			if (!is_affine || !inner.is_affine)
+				return ObfAffine();
+			return ObfAffine{ true, T(U(a) * U(inner.a)), T(U(a) * U(inner.b) + U(b)) };
+		}
+		ITHARE_OBF_FORCEINLINE constexpr T encoded_add(T y, T k) const {
+			return T(U(y) + U(a) * U(k));
+		}
+		ITHARE_OBF_FORCEINLINE constexpr T encoded_sub(T y, T k) const {
+			return T(U(y) - U(a) * U(k));
+		}
+		ITHARE_OBF_FORCEINLINE constexpr T encoded_mul(T y, T k) const {
+			return T((U(y) - U(b)) * U(k) + U(b));
+		}
+	};
+
+	//ObfXorMask: same thing for injections which are injection(x) == x^mask for ALL x; for them,
+	//    injection(x^k) == injection(x)^k
+	//    injection(~x) == ~injection(x)
+	//  only versions 0 (with identity context) and 7 (xor) preserve it
+	template<class T>
+	struct ObfXorMask {
+		static_assert(std::is_unsigned<T>::value);
+		bool is_xor = false;
+		T mask = 0;
+
+		constexpr ObfXorMask compose(ObfXorMask inner) const {//(*this)(inner(x))
+			if (!is_xor || !inner.is_xor)
+				return ObfXorMask();
+			return ObfXorMask{ true, T(mask ^ inner.mask) };
+		}
+	};
+
+	//injection-with-constant - building block both for injections and for literals
+	//  each version provides (in addition to injection()/surjection()) affine() and xor_mask() - see ObfAffine and ObfXorMask above
+	template <size_t which, class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version;
+
+	//version 0: identity
+	template<class T, class Context>
+	struct obf_injection_version0_descr {
+		//cannot make it a part of class obf_injection_version<0, T, C, seed, cycles>,
+		//  as it would cause infinite recursion in template instantiation
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 0, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr = ObfDescriptor(false, own_min_cycles, 1);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<0, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version0_descr<T,Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+	public:
+		using return_type = T;
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			return Context::final_injection(x);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			return Context::final_surjection(y);
+		}
+		constexpr static ObfAffine<T> affine() {
+			return Context::final_affine();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {//an affine a*x+b is also a xor mask only when it is an identity
+			constexpr ObfAffine<T> aff = Context::final_affine();
+			return aff.is_affine && aff.a == 1 && aff.b == 0 ? ObfXorMask<T>{ true, 0 } : ObfXorMask<T>();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 0, "identity", sizeof(T), seed, cycles, obf_injection_version0_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0,const char* prefix="") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": availCycles=" << availCycles << std::endl;
+			Context::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.resources(ObfJsonResources());
+			w.children();
+			Context::dbgJson(w, "Context");
+			w.end();
+		}
+#endif
+	};
+
+	//version 1: add mod 2^n
+	template<class T, class Context>
+	struct obf_injection_version1_descr {
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 1, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, own_min_cycles, 100);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<1, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+	public:
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version1_descr<T,Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+		struct RecursiveInjectionContext {
+			static constexpr size_t exclude_version = 1;
+		};
+
+		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), availCycles+Context::context_cycles,RecursiveInjectionContext>;
+		using return_type = typename RecursiveInjection::return_type;
+		static constexpr std::array<T, 5> consts = { 0,1,OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		constexpr static T C = obf_random_const<T>(obf_compile_time_prng(seed, 2), consts);
+		static constexpr bool neg = C == 0 ? true : obf_weak_random(obf_compile_time_prng(seed, 3),2) == 0;
+		using ST = typename std::make_signed<T>::type;
+		using U = typename ObfAffine<T>::U;//negating as unsigned: -ST(x) overflows for the minimal ST
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			if constexpr(neg)
+				return RecursiveInjection::injection(T(U(0) - U(x)) + C);
+			else
+				return RecursiveInjection::injection(x + C);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			T yy = RecursiveInjection::surjection(y) - C;
+			if constexpr(neg)
+				return T(U(0) - U(yy));
+			else
+				return yy;
+		}
+		constexpr static ObfAffine<T> affine() {
+			return RecursiveInjection::affine().compose(ObfAffine<T>{ true, neg ? T(-ST(1)) : T(1), C });
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return ObfXorMask<T>();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 1, "add mod 2^N", sizeof(T), seed, cycles, obf_injection_version1_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": C=" << obf_dbgPrintC(C) << " neg=" << neg << std::endl;
+			RecursiveInjection::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("C", C);
+			w.boolean("neg", neg);
+			w.resources(ObfJsonResources());
+			w.children();
+			RecursiveInjection::dbgJson(w, "Recursive");
+			w.end();
+		}
+#endif
+	};
+
+	//helper for Feistel-like: randomized_non_reversible_function 
+	template<size_t which, class T, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_randomized_non_reversible_function_version;
+	//IMPORTANT: Feistel-like non-reversible functions SHOULD be short, to avoid creating code 'signatures'
+	//  Therefore, currently we're NOT using any recursions here
+
+	template<class T>
+	struct obf_randomized_non_reversible_function_version0_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(false, obf_cycle_cost(ObfCycleCostKind::non_reversible_function, 0, sizeof(T)).surjection, 100);
+	};
+
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_randomized_non_reversible_function_version<0, T, seed, cycles> {
+		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
+			return x;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_randomized_non_reversible_function_version", 0, "identity", sizeof(T), seed, cycles, obf_randomized_non_reversible_function_version0_descr<T>::descr.min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << std::endl;
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.resources(ObfJsonResources());
+			w.end();
+		}
+#endif		
+	};
+
+	template<class T>
+	struct obf_randomized_non_reversible_function_version1_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::non_reversible_function, 1, sizeof(T)).surjection, 100);
+	};
+
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_randomized_non_reversible_function_version<1,T,seed,cycles> {
+		using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned, T>::type;//avoiding promotion to signed int
+		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
+			return T(U(x)*U(x));
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_randomized_non_reversible_function_version", 1, "x^2", sizeof(T), seed, cycles, obf_randomized_non_reversible_function_version1_descr<T>::descr.min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << std::endl;
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.resources(ObfJsonResources());
+			w.end();
+		}
+#endif		
+	};
+
+	template<class T>
+	struct obf_randomized_non_reversible_function_version2_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::non_reversible_function, 2, sizeof(T)).surjection, 100);
+	};
+
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_randomized_non_reversible_function_version<2, T, seed, cycles> {
+		using ST = typename std::make_signed<T>::type;
+		using U = typename ObfAffine<T>::U;//as in obf_injection_version<1>
+		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
+			ST sx = ST(x);
+			return sx < 0 ? T(U(0) - U(x)) : x;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_randomized_non_reversible_function_version", 2, "abs", sizeof(T), seed, cycles, obf_randomized_non_reversible_function_version2_descr<T>::descr.min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << std::endl;
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.resources(ObfJsonResources());
+			w.end();
+		}
+#endif		
+	};
+
+	template<size_t N>
+	constexpr OBFCYCLES obf_max_min_descr(std::array<ObfDescriptor,N> descr) {
+		OBFCYCLES ret = 0;
+		for (size_t i = 0; i < N; ++i) {
+			OBFCYCLES mn = descr[i].min_cycles;
+			if (ret < mn)
+				ret = mn;
+		}
+		return ret;
+	}
+
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_randomized_non_reversible_function {
+		constexpr static std::array<ObfDescriptor, 3> descr{
+			obf_randomized_non_reversible_function_version0_descr<T>::descr,
+			obf_randomized_non_reversible_function_version1_descr<T>::descr,
+			obf_randomized_non_reversible_function_version2_descr<T>::descr,
+		};
+		constexpr static size_t max_cycles_that_make_sense = obf_max_min_descr(descr);
+		constexpr static size_t which = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
+		using FType = obf_randomized_non_reversible_function_version<which, T, seed, cycles>;
+		constexpr ITHARE_OBF_FORCEINLINE T operator()(T x) {
+			return FType()(x);
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_randomized_non_reversible_function<" << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: which=" << which << std::endl;
+			FType::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_randomized_non_reversible_function", role);
+			w.number("size", sizeof(T));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.unumber("which", which);
+			w.number("min_cycles", descr[which].min_cycles);
+			w.resources(ObfJsonResources());
+			w.children();
+			FType::dbgJson(w);
+			w.end();
+		}
+#endif		
+	};
+
+	//version 2: kinda-Feistel round
+	template<class T, class Context>
+	struct obf_injection_version2_descr {
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 2, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr =
+			sizeof(T) > 1 ?
+			ObfDescriptor(true, own_min_cycles, 100) :
+			ObfDescriptor(false, 0, 0);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<2, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+	public:
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version2_descr<T,Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+		constexpr static std::array<ObfDescriptor, 2> split {
+			ObfDescriptor(true,0,100),//f() 
+			ObfDescriptor(true,0,100)//RecursiveInjection
+		};
+		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+		static constexpr OBFCYCLES cycles_f0 = splitCycles[0];
+		static constexpr OBFCYCLES cycles_rInj0 = splitCycles[1];
+		static_assert(cycles_f0 + cycles_rInj0 <= availCycles);
+
+		//doesn't make sense to use more than max_cycles_that_make_sense cycles for f...
+		static constexpr OBFCYCLES max_cycles_that_make_sense = obf_randomized_non_reversible_function<typename obf_half_size_int<T>::value_type, 0, 0>::max_cycles_that_make_sense;
+		static constexpr OBFCYCLES delta_f = cycles_f0 > max_cycles_that_make_sense ? cycles_f0 - max_cycles_that_make_sense : 0;
+		static constexpr OBFCYCLES cycles_f = cycles_f0 - delta_f;
+		static constexpr OBFCYCLES cycles_rInj = cycles_rInj0 + delta_f;
+		static_assert(cycles_f + cycles_rInj <= availCycles);
+
+		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles_rInj+ Context::context_cycles,ObfDefaultInjectionContext>;
+		using return_type = typename RecursiveInjection::return_type;
+
+		using halfT = typename obf_half_size_int<T>::value_type;
+		using FType = obf_randomized_non_reversible_function<halfT, obf_compile_time_prng(seed, 3), cycles_f>;
+
+		constexpr static int halfTBits = sizeof(halfT) * 8;
+		//constexpr static T mask = ((T)1 << halfTBits) - 1;
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			T lo = x >> halfTBits;
+			//T hi = (x & mask) + f((halfT)lo);
+			T hi = x + f((halfT)lo);
+			return RecursiveInjection::injection((hi << halfTBits) + lo);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y_) {
+			T y = RecursiveInjection::surjection(y_);
+			halfT hi = y >> halfTBits;
+			T lo = y;
+			//T z = (hi - f((halfT)lo)) & mask;
+			halfT z = (hi - f((halfT)lo));
+			return z + (lo << halfTBits);
+		}
+		constexpr static ObfAffine<T> affine() {//not affine
+			return ObfAffine<T>();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return ObfXorMask<T>();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 2, "kinda-Feistel", sizeof(T), seed, cycles, obf_injection_version2_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ":" 
+				" availCycles=" << availCycles << " cycles_f=" << cycles_f << " cycles_rInj=" << cycles_rInj << std::endl;
+			//auto splitCyclesRT = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+			//std::cout << std::string(offset, ' ') << " f():" << std::endl;
+			FType::dbgPrint(offset + 1,"f():");
+			//std::cout << std::string(offset, ' ') << " Recursive:" << std::endl;
+			RecursiveInjection::dbgPrint(offset + 1,"Recursive:");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.number("cycles_f", cycles_f);
+			w.number("cycles_rInj", cycles_rInj);
+			w.resources(ObfJsonResources());
+			w.children();
+			FType::dbgJson(w, "f");
+			RecursiveInjection::dbgJson(w, "Recursive");
+			w.end();
+		}
+#endif
+
+	private:
+		ITHARE_OBF_FORCEINLINE static constexpr halfT f(halfT x) {
+			return FType()(x);
+		}
+	};
+
+	//version 3: split-join
+	template<class T,class Context>
+	struct obf_injection_version3_descr {
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 3, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr =
+			sizeof(T) > 1 ?
+			ObfDescriptor(true, own_min_cycles, 100) :
+			ObfDescriptor(false, 0, 0);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<3, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+	public:
+		//TODO:split-join based on union
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version3_descr<T, Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+		using halfT = typename obf_half_size_int<T>::value_type;
+		constexpr static int halfTBits = sizeof(halfT) * 8;
+
+		constexpr static std::array<ObfDescriptor, 3> split{
+			ObfDescriptor(true,0,200),//RecursiveInjection
+			ObfDescriptor(true,0,100),//LoInjection
+			ObfDescriptor(true,0,100),//HiInjection
+		};
+		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+		static constexpr OBFCYCLES cycles_rInj = splitCycles[0];
+		static constexpr OBFCYCLES cycles_lo = splitCycles[1];
+		static constexpr OBFCYCLES cycles_hi = splitCycles[2];
+		static_assert(cycles_rInj + cycles_lo + cycles_hi <= availCycles);
+
+		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles_rInj+ Context::context_cycles, ObfDefaultInjectionContext>;
+		using return_type = typename RecursiveInjection::return_type;
+
+		constexpr static std::array<ObfDescriptor, 2> splitLo {
+			ObfDescriptor(true,0,100),//Context
+			ObfDescriptor(true,0,100)//Injection
+		};
+		static constexpr auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 2), cycles_lo, splitLo);
+		static constexpr OBFCYCLES cycles_loCtx = splitCyclesLo[0];
+		static constexpr OBFCYCLES cycles_loInj = splitCyclesLo[1];
+		static_assert(cycles_loCtx + cycles_loInj <= cycles_lo);
+		using LoContext = typename ObfRecursiveContext < halfT, Context, obf_compile_time_prng(seed, 3), cycles_loCtx>::intermediate_context_type;
+		using LoInjection = obf_injection<halfT, LoContext, obf_compile_time_prng(seed, 4), cycles_loInj+LoContext::context_cycles, ObfDefaultInjectionContext>;
+		static_assert(sizeof(typename LoInjection::return_type) == sizeof(halfT));//bijections ONLY; TODO: enforce
+
+		constexpr static std::array<ObfDescriptor, 2> splitHi{
+			ObfDescriptor(true,0,100),//Context
+			ObfDescriptor(true,0,100)//Injection
+		};
+		static constexpr auto splitCyclesHi = obf_random_split(obf_compile_time_prng(seed, 5), cycles_hi, splitHi);
+		static constexpr OBFCYCLES cycles_hiCtx = splitCyclesHi[0];
+		static constexpr OBFCYCLES cycles_hiInj = splitCyclesHi[1];
+		static_assert(cycles_hiCtx + cycles_hiInj <= cycles_hi);
+		using HiContext = typename ObfRecursiveContext<halfT, Context, obf_compile_time_prng(seed, 6), cycles_hiCtx>::intermediate_context_type;
+		using HiInjection = obf_injection<halfT, HiContext, obf_compile_time_prng(seed, 7), cycles_hiInj+HiContext::context_cycles, ObfDefaultInjectionContext>;
+		static_assert(sizeof(typename HiInjection::return_type) == sizeof(halfT));//bijections ONLY; TODO: enforce
+
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			halfT lo = x >> halfTBits;
+			typename LoInjection::return_type lo1 = LoInjection::injection(lo);
+			lo = halfT(lo1);// *reinterpret_cast<halfT*>(&lo1);//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
+			halfT hi = (halfT)x;
+			typename HiInjection::return_type hi1 = HiInjection::injection(hi);
+			hi = halfT(hi1);// *reinterpret_cast<halfT*>(&hi1);//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
+			return RecursiveInjection::injection((T(hi) << halfTBits) + T(lo));
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y_) {
+			auto y = RecursiveInjection::surjection(y_);
+			halfT hi0 = y >> halfTBits;
+			halfT lo0 = (halfT)y;
+			halfT hi = HiInjection::surjection(/* *reinterpret_cast<typename HiInjection::return_type*>(&hi0)*/typename HiInjection::return_type(hi0));//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
+			halfT lo = LoInjection::surjection(/**reinterpret_cast<typename LoInjection::return_type*>(&lo0)*/ typename LoInjection::return_type(lo0));//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
+			return T(hi) + (T(lo) << halfTBits);
+		}
+		constexpr static ObfAffine<T> affine() {//not affine
+			return ObfAffine<T>();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return ObfXorMask<T>();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 3, "split-join", sizeof(T), seed, cycles, obf_injection_version3_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << std::endl;
+			//std::cout << std::string(offset, ' ') << " Lo:" << std::endl;
+			LoInjection::dbgPrint(offset + 1,"Lo:");
+			//std::cout << std::string(offset, ' ') << " Hi:" << std::endl;
+			HiInjection::dbgPrint(offset + 1,"Hi:");
+			//std::cout << std::string(offset, ' ') << " Recursive:" << std::endl;
+			RecursiveInjection::dbgPrint(offset + 1,"Recursive:");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.number("cycles_lo", cycles_lo);
+			w.number("cycles_hi", cycles_hi);
+			w.number("cycles_rInj", cycles_rInj);
+			w.resources(ObfJsonResources());
+			w.children();
+			LoInjection::dbgJson(w, "Lo");
+			HiInjection::dbgJson(w, "Hi");
+			RecursiveInjection::dbgJson(w, "Recursive");
+			w.end();
+		}
+#endif
+	};
+	
+	//version 4: multiply by odd
+	template< class T >
+	constexpr T obf_mul_inverse_mod2n(T num) {//extended GCD, intended to be used in compile-time only
+											  //by Dmytro Ivanchykhin
+		using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned, T>::type;//avoiding promotion to signed int
+		assert(num & 1);
+		T num0 = num;
+		T x = 0, lastx = 1, y = 1, lasty = 0;
+		T q=0, temp1=0, temp2=0, temp3=0;
+		T mod = 0;
+
+		// zero step: do some tricks to avoid overflowing
+		// note that initially mod is power of 2 that does not fit to T
+		if (num == T(mod - T(1)))
+			return num;
+		q = T((T(mod - num)) / num) + T(1);
+		temp1 = (T(T(T(mod - T(2))) % num) + T(2)) % num;
+		mod = num;
+		num = temp1;
+
+		temp2 = x;
+		x = lastx - T(U(q) * U(x));
+		lastx = temp2;
+
+		temp3 = y;
+		y = lasty - T(U(q) * U(y));
+		lasty = temp3;
+
+		while (num != 0) {
+			q = mod / num;
+			temp1 = mod % num;
+			mod = num;
+			num = temp1;
+
+			temp2 = x;
+			x = lastx - T(U(q) * U(x));
+			lastx = temp2;
+
+			temp3 = y;
+			y = lasty - T(U(q) * U(y));
+			lasty = temp3;
+		}
+		assert(T(U(num0)*U(lasty)) == T(1));
+		(void)num0;//used only in assert()
+		return lasty;
+	}
+
+	template<class T, class Context>
+	struct obf_injection_version4_descr {
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 4, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection + Context::literal_cycles;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, own_min_cycles, 100);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<4, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned, T>::type;//avoiding promotion to signed int
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version4_descr<T,Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+		struct RecursiveInjectionContext {
+			static constexpr size_t exclude_version = 4;
+		};
+
+	public:
+		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), availCycles+Context::context_cycles,RecursiveInjectionContext>;
+		using return_type = typename RecursiveInjection::return_type;
+		//constexpr static T C = (T)(obf_gen_const<T>(obf_compile_time_prng(seed, 2)) | 1);
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		constexpr static T C = obf_random_const<T>(obf_compile_time_prng(seed, 2), consts);
+		static_assert((C & 1) == 1);
+		constexpr static T CINV = obf_mul_inverse_mod2n(C);
+		static_assert((T)(C*CINV) == (T)1);
+
+		using literal = typename Context::template literal<T, CINV, obf_compile_time_prng(seed, 3)>::type;
+
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+			if (ITHARE_OBF_IS_CONSTANT_EVALUATED())
+				return RecursiveInjection::injection(T(U(x) * U(CINV)));
+#endif
+			return RecursiveInjection::injection(T(U(x) * U(literal().value())));//using CINV in injection to hide literals a bit better...
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			return T(U(RecursiveInjection::surjection(y)) * U(C));
+		}
+		constexpr static ObfAffine<T> affine() {
+			return RecursiveInjection::affine().compose(ObfAffine<T>{ true, CINV, 0 });
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return ObfXorMask<T>();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 4, "mul odd mod 2^N", sizeof(T), seed, cycles, obf_injection_version4_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": C=" << obf_dbgPrintC(C) << " CINV=" << obf_dbgPrintC(CINV) << std::endl;
+			//std::cout << std::string(offset, ' ') << " literal:" << std::endl;
+			literal::dbgPrint(offset + 1,"literal:");
+			//std::cout << std::string(offset, ' ') << " Recursive:" << std::endl;
+			RecursiveInjection::dbgPrint(offset + 1,"Recursive:");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("C", C);
+			w.hex("CINV", CINV);
+			w.resources(ObfJsonResources());
+			w.children();
+			literal::dbgJson(w, "literal");
+			RecursiveInjection::dbgJson(w, "Recursive");
+			w.end();
+		}
+#endif
+	};
+
+	//version 5: split (w/o join)
+	struct ObfPiecewise {//tag: return_type of version 5 from its already-injected halves (see obf_vector_columns<>, obf_encoded_ops<>)
+	};
+
+	template<class T, class Context>
+	struct obf_injection_version5_descr {
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 5, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = 2*Context::context_cycles /* have to allocate context_cycles for BOTH branches */ + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr =
+			sizeof(T) > 1 ?
+			ObfDescriptor(true, own_min_cycles, 100) :
+			ObfDescriptor(false, 0, 0);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<5, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+	public:
+		using halfT = typename obf_half_size_int<T>::value_type;
+		constexpr static int halfTBits = sizeof(halfT) * 8;
+
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version5_descr<T,Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+		constexpr static std::array<ObfDescriptor, 2> split{
+			ObfDescriptor(true,0,100),//LoInjection
+			ObfDescriptor(true,0,100),//HiInjection
+		};
+		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+		static constexpr OBFCYCLES cycles_lo = splitCycles[0];
+		static constexpr OBFCYCLES cycles_hi = splitCycles[1];
+		static_assert(cycles_lo + cycles_hi <= availCycles);
+
+		constexpr static std::array<ObfDescriptor, 2> splitLo{
+			ObfDescriptor(true,0,100),//Context
+			ObfDescriptor(true,0,100)//Injection
+		};
+		static constexpr auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 2), cycles_lo, splitLo);
+		static constexpr OBFCYCLES cycles_loCtx = splitCyclesLo[0];
+		static constexpr OBFCYCLES cycles_loInj = splitCyclesLo[1];
+		static_assert(cycles_loCtx + cycles_loInj <= cycles_lo);
+		using RecursiveLoContext = typename ObfRecursiveContext<halfT, Context, obf_compile_time_prng(seed, 3), cycles_loCtx+Context::context_cycles>::recursive_context_type;
+		using RecursiveInjectionLo = obf_injection<halfT, RecursiveLoContext, obf_compile_time_prng(seed, 4), cycles_loInj+ RecursiveLoContext::context_cycles,ObfDefaultInjectionContext>;
+
+		constexpr static std::array<ObfDescriptor, 2> splitHi{
+			ObfDescriptor(true,0,100),//Context
+			ObfDescriptor(true,0,100)//Injection
+		};
+		static constexpr auto splitCyclesHi = obf_random_split(obf_compile_time_prng(seed, 5), cycles_hi, splitHi);
+		static constexpr OBFCYCLES cycles_hiCtx = splitCyclesHi[0];
+		static constexpr OBFCYCLES cycles_hiInj = splitCyclesHi[1];
+		static_assert(cycles_hiCtx + cycles_hiInj <= cycles_hi);
+		using RecursiveHiContext = typename ObfRecursiveContext<halfT, Context, obf_compile_time_prng(seed, 6), cycles_hiCtx+Context::context_cycles>::recursive_context_type;
+		using RecursiveInjectionHi = obf_injection < halfT, RecursiveHiContext, obf_compile_time_prng(seed, 7), cycles_hiInj+ RecursiveHiContext::context_cycles,ObfDefaultInjectionContext > ;
+
+		struct return_type {
+			typename RecursiveInjectionLo::return_type lo;
+			typename RecursiveInjectionHi::return_type hi;
+
+			constexpr return_type(halfT lo_, halfT hi_)
+				: lo(lo_), hi(hi_) {
+			}
+			constexpr return_type(ObfPiecewise, const typename RecursiveInjectionLo::return_type& lo_, const typename RecursiveInjectionHi::return_type& hi_)
+				: lo(lo_), hi(hi_) {
+			}
+			constexpr return_type(T x) 
+			: lo(halfT(x)), hi(halfT(x>>halfTBits)){
+			}
+			constexpr operator T() {
+				halfT lo1 = halfT(lo);
+				halfT hi1 = halfT(hi);
+				return ( T(hi1) << halfTBits ) + T(lo1);
+			}
+		};
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			return_type ret{ RecursiveInjectionLo::injection((halfT)x), RecursiveInjectionHi::injection(x >> halfTBits) };
+			return ret;
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y_) {
+			halfT hi = RecursiveInjectionHi::surjection(y_.hi);
+			halfT lo = RecursiveInjectionLo::surjection(y_.lo);
+			return (T)lo + ((T)hi << halfTBits);
+		}
+		constexpr static ObfAffine<T> affine() {//not affine
+			return ObfAffine<T>();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return ObfXorMask<T>();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 5, "split", sizeof(T), seed, cycles, obf_injection_version5_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << std::endl;
+			//std::cout << std::string(offset, ' ') << " Lo:" << std::endl;
+			RecursiveInjectionLo::dbgPrint(offset + 1,"Lo:");
+			//std::cout << std::string(offset, ' ') << " Hi:" << std::endl;
+			RecursiveInjectionHi::dbgPrint(offset + 1,"Hi:");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.number("cycles_lo", cycles_lo);
+			w.number("cycles_hi", cycles_hi);
+			w.resources(ObfJsonResources());
+			w.children();
+			RecursiveInjectionLo::dbgJson(w, "Lo");
+			RecursiveInjectionHi::dbgJson(w, "Hi");
+			w.end();
+		}
+#endif
+	};
+
+	//version 6: injection over lower half /*CHEAP!*/
+	template<class T, class Context>
+	struct obf_injection_version6_descr {
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 6, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr =
+			sizeof(T) > 1 ?
+			ObfDescriptor(true, own_min_cycles, 100/*it's cheap, but doesn't obfuscate the whole thing well => let's use it mostly for lower-cycle stuff*/) :
+			ObfDescriptor(false, 0, 0);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<6, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+	public:
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version6_descr<T,Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+		struct RecursiveInjectionContext {
+			static constexpr size_t exclude_version = 6;
+		};
+		using halfT = typename obf_half_size_int<T>::value_type;
+
+		constexpr static std::array<ObfDescriptor, 2> split{
+			ObfDescriptor(true,0,200),//RecursiveInjection
+			ObfDescriptor(true,0,100),//LoInjection
+		};
+		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+		static constexpr OBFCYCLES cycles_rInj = splitCycles[0];
+		static constexpr OBFCYCLES cycles_lo = splitCycles[1];
+		static_assert(cycles_rInj + cycles_lo <= availCycles);
+
+		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles_rInj + Context::context_cycles, ObfDefaultInjectionContext>;
+		using return_type = typename RecursiveInjection::return_type;
+
+	public:
+		constexpr static std::array<ObfDescriptor, 2> splitLo{
+			ObfDescriptor(true,0,100),//Context
+			ObfDescriptor(true,0,100)//Injection
+		};
+		static constexpr auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 3), cycles_lo, splitLo);
+		static constexpr OBFCYCLES cycles_loCtx = splitCyclesLo[0];
+		static constexpr OBFCYCLES cycles_loInj = splitCyclesLo[1];
+		static_assert(cycles_loCtx + cycles_loInj <= cycles_lo);
+		using LoContext = typename ObfRecursiveContext < halfT, Context, obf_compile_time_prng(seed, 4), cycles_loCtx>::intermediate_context_type;
+		using LoInjection = obf_injection<halfT, LoContext, obf_compile_time_prng(seed, 5), cycles_loInj + LoContext::context_cycles, ObfDefaultInjectionContext>;
+		static_assert(sizeof(typename LoInjection::return_type) == sizeof(halfT));//bijections ONLY; TODO: enforce
+
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			halfT lo0 = halfT(x);
+			typename LoInjection::return_type lo1 = LoInjection::injection(lo0);
+			//halfT lo = *reinterpret_cast<halfT*>(&lo1);//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
+			halfT lo = halfT(lo1);
+			return RecursiveInjection::injection(x - T(lo0) + lo);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type yy) {
+			T y = RecursiveInjection::surjection(yy);
+			halfT lo0 = halfT(y);
+			halfT lo = LoInjection::surjection(/* *reinterpret_cast<typename LoInjection::return_type*>(&lo0)*/ typename LoInjection::return_type(lo0));//relies on static_assert(sizeof(return_type)==sizeof(halfT)) above
+			return y - T(lo0) + lo;
+		}
+		constexpr static ObfAffine<T> affine() {//not affine
+			return ObfAffine<T>();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return ObfXorMask<T>();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 6, "injection(halfT)", sizeof(T), seed, cycles, obf_injection_version6_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << std::endl;
+			LoInjection::dbgPrint(offset + 1, "Lo:");
+			RecursiveInjection::dbgPrint(offset + 1, "Recursive:");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.number("cycles_lo", cycles_lo);
+			w.number("cycles_rInj", cycles_rInj);
+			w.resources(ObfJsonResources());
+			w.children();
+			LoInjection::dbgJson(w, "Lo");
+			RecursiveInjection::dbgJson(w, "Recursive");
+			w.end();
+		}
+#endif
+	};
+
+	//version 7: xor with constant
+	template<class T, class Context>
+	struct obf_injection_version7_descr {
+		static constexpr ObfCycleCost cost = obf_cycle_cost(ObfCycleCostKind::injection_version, 7, sizeof(T));
+		static constexpr OBFCYCLES own_min_injection_cycles = cost.injection;
+		static constexpr OBFCYCLES own_min_surjection_cycles = cost.surjection;
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, own_min_cycles, 100);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<7, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version7_descr<T, Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+		struct RecursiveInjectionContext {
+			static constexpr size_t exclude_version = 7;
+		};
+
+	public:
+		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), availCycles + Context::context_cycles, RecursiveInjectionContext>;
+		using return_type = typename RecursiveInjection::return_type;
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		constexpr static T C = obf_random_const<T>(obf_compile_time_prng(seed, 2), consts);
+
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			return RecursiveInjection::injection(T(x ^ C));
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			return T(RecursiveInjection::surjection(y) ^ C);
+		}
+		constexpr static ObfAffine<T> affine() {
+			return ObfAffine<T>();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return RecursiveInjection::xor_mask().compose(ObfXorMask<T>{ true, C });
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "obf_injection_version", 7, "xor", sizeof(T), seed, cycles, obf_injection_version7_descr<T, Context>::own_min_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": C=" << obf_dbgPrintC(C) << std::endl;
+			RecursiveInjection::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("C", C);
+			w.resources(ObfJsonResources());
+			w.children();
+			RecursiveInjection::dbgJson(w, "Recursive");
+			w.end();
+		}
+#endif
+	};
+
+	#if 0 //COMMENTED OUT - TOO OBVIOUS IN DECOMPILE :-(
+	//version 8: 1-bit rotation 
+	template<class Context>
+	struct obf_injection_version8_descr {
+		static constexpr OBFCYCLES own_min_injection_cycles = 5;//relying on compiler generating cmovns etc.
+		static constexpr OBFCYCLES own_min_surjection_cycles = 5;//relying on compiler generating cmovns etc.
+		static constexpr OBFCYCLES own_min_cycles = Context::context_cycles + Context::calc_cycles(own_min_injection_cycles, own_min_surjection_cycles);
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, own_min_cycles, 100);
+	};
+
+	template <class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_injection_version<8, T, Context, seed, cycles> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+	public:
+		static constexpr OBFCYCLES availCycles = cycles - obf_injection_version8_descr<Context>::own_min_cycles;
+		static_assert(availCycles >= 0);
+
+		using RecursiveInjection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), availCycles + Context::context_cycles, ObfDefaultInjectionContext>;
+		using return_type = typename RecursiveInjection::return_type;
+		using ST = typename std::make_signed<T>::type;
+		static constexpr T highbit = T(1) << (sizeof(T) * 8 - 1);
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			if ((x % 2) == 0)
+				x = x >> 1;
+			else
+				x = ( x >> 1 ) + highbit;
+			return RecursiveInjection::injection(x);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			T yy = RecursiveInjection::surjection(y);
+			ST syy = ST(yy);
+			if (syy < 0)
+				return yy + yy + 1;
+			else
+				return yy+yy;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_injection_version<8/*1-bit rotation*/," << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">" << std::endl;
+			RecursiveInjection::dbgPrint(offset + 1);
+		}
+#endif
+	};
+#endif//#if 0
+
+	//obf_injection: combining obf_injection_version
+	//IMPORTANT: ANY CHANGES TO INJECTION VERSIONS (and to the way they pick seeds/cycles) MUST BE MIRRORED in obf_flat_expand()
+	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles,class InjectionContext>
+	class obf_injection {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		constexpr static std::array<ObfDescriptor, 8> descr{
+			obf_injection_version0_descr<T,Context>::descr,
+			obf_injection_version1_descr<T,Context>::descr,
+			obf_injection_version2_descr<T,Context>::descr,
+			obf_injection_version3_descr<T,Context>::descr,
+			obf_injection_version4_descr<T,Context>::descr,
+			obf_injection_version5_descr<T,Context>::descr,
+			obf_injection_version6_descr<T,Context>::descr,
+			obf_injection_version7_descr<T,Context>::descr,
+			//obf_injection_version8_descr<Context>::descr,
+		};
+		constexpr static size_t which = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr,InjectionContext::exclude_version);
+		static_assert(which >= 0 && which < descr.size());
+		using WhichType = obf_injection_version<which, T, Context, seed, cycles>;
+
+	public:
+		using return_type = typename WhichType::return_type;
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			return WhichType::injection(x);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			return WhichType::surjection(y);
+		}
+		constexpr static ObfAffine<T> affine() {
+			return WhichType::affine();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return WhichType::xor_mask();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			size_t dbgWhich = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
+			std::cout << std::string(offset, ' ') << prefix << "obf_injection<"<<obf_dbgPrintT<T>()<<"," << seed << "," << cycles << ">: which=" << which << " dbgWhich=" << dbgWhich << std::endl;
+			//std::cout << std::string(offset, ' ') << " Context:" << std::endl;
+			Context::dbgPrint(offset + 1,"Context:");
+			//std::cout << std::string(offset, ' ') << " Version:" << std::endl;
+			WhichType::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			//Context is not a child here: it is executed only by version 0 at the leaves (and is a child of those)
+			w.begin("obf_injection", role);
+			w.number("size", sizeof(T));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.unumber("which", which);
+			w.number("min_cycles", descr[which].min_cycles);
+			w.resources(ObfJsonResources());
+			w.children();
+			WhichType::dbgJson(w);
+			w.end();
+		}
+#endif
+	};
+
+	//ObfLiteralContext
+	template<size_t which, class T, OBFSEED seed>
+	struct ObfLiteralContext_version;
+	//forward declaration:
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	class ObfLiteralContext;
+
+	//version 0: identity
+	template<class T>
+	struct obf_literal_context_version0_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(false, obf_cycle_cost(ObfCycleCostKind::literal_context, 0, sizeof(T)).surjection, 1);
+	};
+
+	template<class T,OBFSEED seed>
+	struct ObfLiteralContext_version<0,T,seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version0_descr<T>::descr.min_cycles;
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x;
+		}
+		static constexpr ObfAffine<T> final_affine() {//final_injection(x) == a*x+b for ALL x; used by obf_injection_version<0>::affine()/xor_mask()
+			return ObfAffine<T>{ true, 1, 0 };
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr T final_surjection(T y) {
+			return y;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 0, "identity", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return ObfJsonResources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	};
+
+	//version 1: global volatile constant
+	template<class T>
+	struct obf_literal_context_version1_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 1, sizeof(T)).surjection, 100);
+	};
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<1,T,seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version1_descr<T>::descr.min_cycles;
+
+		//static constexpr T CC = obf_gen_const<T>(obf_compile_time_prng(seed, 1));
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		constexpr static T CC = obf_random_const<T>(obf_compile_time_prng(seed, 1), consts);
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + CC;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, CC };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			return y - c;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 1, "global volatile", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << obf_dbgPrintC(CC) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson(): a load of the global volatile
+			ObfJsonResources ret;
+			ret.loads = 1;
+			ret.global_bytes = sizeof(T);
+			return ret;
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	private:
+		static volatile T c;
+	};
+
+	template<class T, OBFSEED seed>
+	volatile T ObfLiteralContext_version<1, T, seed>::c = CC;
+
+	//version 2: aliased pointers
+	template<class T>
+	struct obf_literal_context_version2_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 2, sizeof(T)).surjection, 100);
+	};
+
+	template<class T>//TODO: randomize contents of the function
+	ITHARE_OBF_NOINLINE T obf_aliased_zero(T* x, T* y) {
+		*x = 0;
+		*y = 1;
+		return *x;
+	}
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<2,T,seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version2_descr<T>::descr.min_cycles;
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, 0 };
+		}
+		ITHARE_OBF_FORCEINLINE static /*non-constexpr*/ T final_surjection(T y) {
+			T x, yy;
+			T z = obf_aliased_zero(&x, &yy);
+			return y - z;
+		}
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 2, "func with aliased pointers", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ":" << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson(): obf_aliased_zero(), reading back from stack
+			ObfJsonResources ret;
+			ret.loads = 1;
+			ret.calls = 1;
+			return ret;
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	};
+
+	//version 3: Windows/PEB
+	template<class T>
+	struct obf_literal_context_version3_descr {
+#if defined(_MSC_VER) && defined(ITHARE_OBF_INIT) && !defined(ITHARE_OBF_NO_ANTI_DEBUG)
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 3, sizeof(T)).surjection, 100);
+#else
+		static constexpr ObfDescriptor descr = ObfDescriptor(false, 0, 0);
+#endif
+	};
+
+#ifdef _MSC_VER
+	extern volatile uint8_t* obf_peb;
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<3,T,seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version3_descr<T>::descr.min_cycles;
+
+		//static constexpr T CC = obf_gen_const<T>(obf_compile_time_prng(seed, 1));
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		constexpr static T CC = obf_random_const<T>(obf_compile_time_prng(seed, 1), consts);
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + CC;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, CC };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+#ifdef ITHARE_OBF_DEBUG_ANTI_DEBUG_ALWAYS_FALSE
+			return y - CC;
+#else
+			return y - CC * (1 + obf_peb[2]);
+#endif
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 3, "PEB", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << obf_dbgPrintC(CC) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson(): obf_peb, then PEB itself
+			ObfJsonResources ret;
+			ret.loads = 2;
+			ret.global_bytes = sizeof(void*);
+			return ret;
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	};
+#endif
+
+	//invariant x%MOD == CC, shared by var-with-invariant contexts (versions 4 and 5):
+	//  c starts from CC0, and is advanced as c=(c+DELTA)%DELTAMOD, which keeps the invariant
+	template<class T, OBFSEED seed>
+	struct obf_literal_context_invariant {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		static constexpr T PREMODRNDCONST = obf_random_const<T>(obf_compile_time_prng(seed, 2), consts);//TODO: check which constants we want
+		static constexpr T PREMODMASK = (T(1) << (sizeof(T) * 4)) - 1;
+		static constexpr T PREMOD = PREMODRNDCONST & PREMODMASK;
+		static constexpr T MOD = PREMOD == 0 ? 100 : PREMOD;//remapping 'bad value' 0 to 'something'
+		static constexpr T CC = obf_weak_random(obf_compile_time_prng(seed, 2),MOD);
+
+		static constexpr T MAXMUL1 = T(-1)/MOD;
+		static constexpr auto MAXMUL1_ADJUSTED0 = obf_sqrt_very_rough_approximation(MAXMUL1);
+		static_assert(MAXMUL1_ADJUSTED0 < T(-1));
+		static constexpr T MAXMUL1_ADJUSTED = (T)MAXMUL1_ADJUSTED0;
+		static constexpr T MUL1 = MAXMUL1 > 2 ? 1+obf_weak_random(obf_compile_time_prng(seed, 2), MAXMUL1_ADJUSTED) : 1;
+		static constexpr T DELTA = MUL1 * MOD;
+		static_assert(DELTA / MUL1 == MOD);//overflow check
+
+		static constexpr T MAXMUL2 = T(-1) / DELTA;
+		static constexpr T MUL2 = MAXMUL2 > 2 ? 1+obf_weak_random(obf_compile_time_prng(seed, 3), MAXMUL2) : 1;
+		static constexpr T DELTAMOD = MUL2 * MOD;
+		static_assert(DELTAMOD / MUL2 == MOD);//overflow check
+
+		static constexpr T PREMUL3 = obf_weak_random(obf_compile_time_prng(seed, 3), MUL2);
+		static constexpr T MUL3 = PREMUL3 > 0 ? PREMUL3 : 1;
+		static constexpr T CC0 = ( CC + MUL3 * MOD ) % DELTAMOD;
+
+		static_assert((CC0 + DELTA) % MOD == CC);
+		static constexpr bool test_n_iterations(T x, int n) {
+			assert(x%MOD == CC);
+			if (n == 0)
+				return true;
+			T newC = (x + DELTA) % DELTAMOD;
+			assert(newC%MOD == CC);
+			return test_n_iterations(newC,n-1);
+		}
+		static_assert(test_n_iterations(CC0, ITHARE_OBF_COMPILE_TIME_TESTS));//test only
+	};
+
+	//version 4: global var-with-invariant
+	template<class T>
+	struct obf_literal_context_version4_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 4, sizeof(T)).surjection, 100);
+			//see version 5 for a thread_local one
+	};
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<4, T, seed> : obf_literal_context_invariant<T, seed> {
+		using Invariant = obf_literal_context_invariant<T, seed>;
+		using Invariant::CC;
+		using Invariant::MOD;
+		using Invariant::DELTA;
+		using Invariant::DELTAMOD;
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version4_descr<T>::descr.min_cycles;
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + CC;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, CC };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			//{MT-related:
+			T newC = (c+DELTA)%DELTAMOD;
+			c = newC;
+			//}MT-related
+			assert(c%MOD == CC);
+			return y - (c%MOD);
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 4, "global volatile var-with-invariant", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << obf_dbgPrintC(CC) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson(): a load of the global var-with-invariant
+			ObfJsonResources ret;
+			ret.loads = 1;
+			ret.global_bytes = sizeof(T);
+			return ret;
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	private:
+#ifdef ITHARE_OBF_STRICT_MT
+		static std::atomic<T> c;
+#else
+		static volatile T c;
+#endif
+	};
+
+#ifdef ITHARE_OBF_STRICT_MT
+	template<class T, OBFSEED seed>
+	std::atomic<T> ObfLiteralContext_version<4, T, seed>::c = Invariant::CC0;
+#else
+	template<class T, OBFSEED seed>
+	volatile T ObfLiteralContext_version<4, T, seed>::c = Invariant::CC0;
+#endif
+
+	//run-time state of var-with-invariant contexts (versions 5-8): one S per context per thread, padded to a whole cache line,
+	//  or, under ITHARE_OBF_NO_THREAD_LOCAL, one global S per context
+	//  Owner::C0 is an initial value of the state
+	template<class S, class Owner>
+	struct obf_literal_context_state {
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfJsonResources resources() {//of a load(), for dbgJson() of the owner
+			ObfJsonResources ret;
+			ret.loads = 1;
+#ifndef ITHARE_OBF_NO_THREAD_LOCAL
+			ret.tls_bytes = sizeof(Padded);
+#else
+			ret.global_bytes = sizeof(S);
+#endif
+			return ret;
+		}
+#endif
+
+#ifndef ITHARE_OBF_NO_THREAD_LOCAL
+		ITHARE_OBF_FORCEINLINE static S load() {
+			return tls.c;
+		}
+		ITHARE_OBF_FORCEINLINE static void store(S c) {
+			tls.c = c;
+		}
+	private:
+		struct alignas(ITHARE_OBF_CACHE_LINE_SIZE) Padded {
+			volatile S c;
+		};
+		static thread_local Padded tls;//constant-initialized, so access doesn't go via TLS init wrappers
+#else
+		//each of the values ever stored satisfies the invariant on its own, so racing load()-store() pairs are ok
+		//  (and relaxed atomics are enough under ITHARE_OBF_STRICT_MT)
+		ITHARE_OBF_FORCEINLINE static S load() {
+#ifdef ITHARE_OBF_STRICT_MT
+			return c.load(std::memory_order_relaxed);
+#else
+			return c;
+#endif
+		}
+		ITHARE_OBF_FORCEINLINE static void store(S c_) {
+#ifdef ITHARE_OBF_STRICT_MT
+			c.store(c_, std::memory_order_relaxed);
+#else
+			c = c_;
+#endif
+		}
+	private:
+#ifdef ITHARE_OBF_STRICT_MT
+		static std::atomic<S> c;
+#else
+		static volatile S c;
+#endif
+#endif
+	};
+
+#ifndef ITHARE_OBF_NO_THREAD_LOCAL
+	template<class S, class Owner>
+	thread_local typename obf_literal_context_state<S, Owner>::Padded obf_literal_context_state<S, Owner>::tls = { Owner::C0 };
+#elif defined(ITHARE_OBF_STRICT_MT)
+	template<class S, class Owner>
+	std::atomic<S> obf_literal_context_state<S, Owner>::c(Owner::C0);
+#else
+	template<class S, class Owner>
+	volatile S obf_literal_context_state<S, Owner>::c = Owner::C0;
+#endif
+
+	//version 5: thread_local var-with-invariant
+	//  same invariant as version 4, but each thread advances its own c; it means no cache line bouncing between cores
+	//  under MT (and no need for atomics even under ITHARE_OBF_STRICT_MT), so it is cheap enough for all the levels of obfuscation
+	template<class T>
+	struct obf_literal_context_version5_descr {
+#ifndef ITHARE_OBF_NO_THREAD_LOCAL
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 5, sizeof(T)).surjection, 100);
+#else
+		static constexpr ObfDescriptor descr = ObfDescriptor(false, 0, 0);//would be the same as version 4
+#endif
+	};
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<5, T, seed> : obf_literal_context_invariant<T, seed> {
+		using Invariant = obf_literal_context_invariant<T, seed>;
+		using Invariant::CC;
+		using Invariant::MOD;
+		using Invariant::DELTA;
+		using Invariant::DELTAMOD;
+		static constexpr T C0 = Invariant::CC0;
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version5_descr<T>::descr.min_cycles;
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + CC;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, CC };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			T newC = (State::load()+DELTA)%DELTAMOD;
+			State::store(newC);
+			assert(newC%MOD == CC);
+			return y - (newC%MOD);
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 5, "thread_local var-with-invariant", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << obf_dbgPrintC(CC) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return State::resources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	private:
+		using State = obf_literal_context_state<T, ObfLiteralContext_version>;
+	};
+
+	//versions 6-8: division-free var-with-invariant
+	//  versions 4-5 advance and check their invariant with '%'; compilers usually do turn '%' by a constant into multiplications,
+	//  but not in every build mode, and a decompiler shows it as a plain '%' anyway;
+	//  the contexts below use only adds, masks and multiplications, with all the magic numbers being random per context
+
+	//version 6: masked var-with-invariant
+	//  invariant: (c & MASK) == CC; advanced as c += DELTA, where (DELTA & MASK) == 0
+	//  cheapest of all, but low bits of c in memory are always the same
+	template<class T>
+	struct obf_literal_context_version6_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 6, sizeof(T)).surjection, 100);
+	};
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<6, T, seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+
+		static constexpr int SHIFT = sizeof(T) * 4;
+		static constexpr T MASK = (T(1) << SHIFT) - 1;
+		static constexpr T CC = T(obf_weak_random(obf_compile_time_prng(seed, 2), uint64_t(MASK) + 1));
+		static constexpr T DELTA = T(T(1 + obf_weak_random(obf_compile_time_prng(seed, 3), uint64_t(MASK))) << SHIFT);
+		static constexpr T C0 = T(CC | T(obf_weak_random(obf_compile_time_prng(seed, 4), uint64_t(MASK) + 1) << SHIFT));
+		static_assert((DELTA & MASK) == 0 && DELTA != 0);
+		static_assert((C0 & MASK) == CC);
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version6_descr<T>::descr.min_cycles;
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + CC;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, CC };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			T newC = T(State::load() + DELTA);
+			State::store(newC);
+			assert((newC & MASK) == CC);
+			return y - T(newC & MASK);
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 6, "masked var-with-invariant", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << obf_dbgPrintC(CC) << " DELTA=" << obf_dbgPrintC(DELTA) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return State::resources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.hex("DELTA", DELTA);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	private:
+		using State = obf_literal_context_state<T, ObfLiteralContext_version>;
+	};
+
+	//version 7: multiply-high var-with-invariant
+	//  same invariant as version 4 (c % MOD == CC), but with c < 2^31 held in uint32_t (regardless of T), so that:
+	//  - it is advanced with a conditional subtraction instead of %DELTAMOD
+	//  - c % MOD is calculated as c - MOD * ((c * M) >> L), with M being a rounded-up 2^L/MOD (Granlund-Montgomery);
+	//    it is exact for all c < 2^31 as long as M*MOD - 2^L <= 2^(L-31), and c*M still fits into uint64_t
+	template<class T>
+	struct obf_literal_context_version7_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 7, sizeof(T)).surjection, 100);
+	};
+
+	constexpr int obf_ceil_log2(uint64_t x) {
+		int ret = 0;
+		while ((UINT64_C(1) << ret) < x)
+			++ret;
+		return ret;
+	}
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<7, T, seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+
+		static constexpr int NBITS = 31;
+		static constexpr uint32_t MOD = 0x100 + uint32_t(obf_weak_random(obf_compile_time_prng(seed, 2), uint32_t(0x7f00)));
+		static constexpr uint32_t CC = uint32_t(obf_weak_random(obf_compile_time_prng(seed, 3), MOD));
+		static constexpr uint32_t MUL2 = 2 + uint32_t(obf_weak_random(obf_compile_time_prng(seed, 4), (UINT32_C(1) << (NBITS - 1)) / MOD - 2));
+		static constexpr uint32_t DELTAMOD = MUL2 * MOD;
+		static_assert(DELTAMOD <= (UINT32_C(1) << (NBITS - 1)));//c + DELTA < 2^NBITS
+		static constexpr uint32_t DELTA = MOD * (1 + uint32_t(obf_weak_random(obf_compile_time_prng(seed, 5), MUL2 - 1)));
+		static_assert(DELTA < DELTAMOD);
+		static constexpr uint32_t C0 = CC + MOD * uint32_t(obf_weak_random(obf_compile_time_prng(seed, 6), MUL2));
+
+		static constexpr int L = NBITS + obf_ceil_log2(MOD);
+		static constexpr uint64_t M = ((UINT64_C(1) << L) + MOD - 1) / MOD;
+		static_assert(M * MOD - (UINT64_C(1) << L) <= (UINT64_C(1) << (L - NBITS)));
+		static_assert(M <= UINT64_MAX / (UINT64_C(1) << NBITS));
+
+		ITHARE_OBF_FORCEINLINE static constexpr uint32_t mod(uint32_t c) {
+			return c - MOD * uint32_t((uint64_t(c) * M) >> L);
+		}
+		static constexpr bool test_n_iterations(uint32_t x, int n) {
+			assert(x < DELTAMOD && mod(x) == CC && x % MOD == CC);
+			if (n == 0)
+				return true;
+			uint32_t newC = x + DELTA;
+			newC -= newC >= DELTAMOD ? DELTAMOD : 0;
+			return test_n_iterations(newC, n - 1);
+		}
+		static_assert(test_n_iterations(C0, ITHARE_OBF_COMPILE_TIME_TESTS));//test only
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version7_descr<T>::descr.min_cycles;
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + T(CC);
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, T(CC) };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			uint32_t newC = State::load() + DELTA;
+			newC -= newC >= DELTAMOD ? DELTAMOD : 0;
+			State::store(newC);
+			assert(mod(newC) == CC);
+			return y - T(mod(newC));
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 7, "multiply-high var-with-invariant", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << CC << " MOD=" << MOD << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return State::resources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.hex("MOD", MOD);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	private:
+		using State = obf_literal_context_state<uint32_t, ObfLiteralContext_version>;
+	};
+
+	//version 8: Montgomery-style var-with-invariant
+	//  invariant: ((c * INV) & MASK) == CC, where INV is an inverse of random odd MUL modulo 2^N;
+	//  c = MUL * x, where (x & MASK) == CC, is advanced as c += MUL * DELTA0, where (DELTA0 & MASK) == 0
+	//  lower half of c alone would be as constant as in version 6 (it is (MUL * CC) & MASK), so memory holds mix(c) = c ^ (c >> SHIFT):
+	//  with DELTA0 >> SHIFT being odd, higher half of c goes through all its values (so each of its bits flips sooner or later),
+	//  and lower half of mix(c) is the constant xor-ed with it; i.e. unlike version 6, none of the bits in memory stay the same
+	template<class T>
+	struct obf_literal_context_version8_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 8, sizeof(T)).surjection, 100);
+	};
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<8, T, seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned, T>::type;//avoiding promotion to signed int
+
+		static constexpr int SHIFT = sizeof(T) * 4;
+		static constexpr T MASK = (T(1) << SHIFT) - 1;
+		static constexpr T CC = T(obf_weak_random(obf_compile_time_prng(seed, 2), uint64_t(MASK) + 1));
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		static constexpr T MUL = T(obf_random_const<T>(obf_compile_time_prng(seed, 3), consts) | T(T(obf_weak_random(obf_compile_time_prng(seed, 4), uint64_t(MASK) + 1)) << SHIFT));
+		static_assert((MUL & 1) == 1);
+		static constexpr T INV = obf_mul_inverse_mod2n(MUL);
+		static_assert(T(U(MUL) * U(INV)) == 1);
+		static constexpr T DELTA = T(U(MUL) * U(T(T(1 | obf_weak_random(obf_compile_time_prng(seed, 5), uint64_t(MASK) + 1)) << SHIFT)));
+		static_assert(((DELTA >> SHIFT) & 1) == 1);
+		static constexpr T CINIT = T(U(MUL) * U(T(CC | T(obf_weak_random(obf_compile_time_prng(seed, 6), uint64_t(MASK) + 1) << SHIFT))));
+		static_assert(T(U(CINIT) * U(INV) & MASK) == CC);
+		static_assert(T(U(T(CINIT + DELTA)) * U(INV) & MASK) == CC);
+		ITHARE_OBF_FORCEINLINE static constexpr T mix(T c) {//self-inverse, as higher half stays the same
+			return T(c ^ (c >> SHIFT));
+		}
+		static_assert(mix(mix(CINIT)) == CINIT);
+		static constexpr T C0 = mix(CINIT);//initial state (see obf_literal_context_state<>)
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version8_descr<T>::descr.min_cycles;
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + CC;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, CC };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			T newC = T(mix(State::load()) + DELTA);
+			State::store(mix(newC));
+			T x = T(U(newC) * U(INV) & MASK);
+			assert(x == CC);
+			return y - x;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 8, "Montgomery-style var-with-invariant", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << obf_dbgPrintC(CC) << " MUL=" << obf_dbgPrintC(MUL) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return State::resources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.hex("MUL", MUL);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	private:
+		using State = obf_literal_context_state<T, ObfLiteralContext_version>;
+	};
+
+	//versions 9-10: register-level constants, XOR-ed with obf_opaque_zero(); no memory accesses, no calls
+	//  neither the optimizer nor a decompiler propagating constants through registers can fold the constant into the literal,
+	//  as long as it doesn't know that r*(r+1) is even; still, it is a single well-known opaque predicate,
+	//  so they're weaker than versions 1-8 against a human (or a pattern-matching deobfuscator)
+	//  hence weight 10 (vs 100 for versions 1-8): they're the pick when cycles are too few for anything else,
+	//  and a rare one otherwise
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+	constexpr ObfJsonResources obf_opaque_resources() {//of obf_opaque_zero(), for dbgJson() of versions 9-10
+		ObfJsonResources ret;
+#if !defined(__GNUC__) && !defined(_MSC_VER)
+		ret.loads = 1;
+#endif
+		return ret;
+	}
+#endif
+
+	//version 9: opaque addend
+	template<class T>
+	struct obf_literal_context_version9_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 9, sizeof(T)).surjection, 10);
+	};
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<9, T, seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version9_descr<T>::descr.min_cycles;
+
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		constexpr static T CC = obf_random_const<T>(obf_compile_time_prng(seed, 1), consts);
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x + CC;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, CC };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			return y - (CC ^ obf_opaque_zero<T>());
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 9, "opaque addend", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": CC=" << obf_dbgPrintC(CC) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return obf_opaque_resources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("CC", CC);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	};
+
+	//version 10: opaque odd multiplier
+	template<class T>
+	struct obf_literal_context_version10_descr {
+		static constexpr ObfDescriptor descr = ObfDescriptor(true, obf_cycle_cost(ObfCycleCostKind::literal_context, 10, sizeof(T)).surjection, 10);
+	};
+
+	template<class T, OBFSEED seed>
+	struct ObfLiteralContext_version<10, T, seed> {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned, T>::type;//avoiding promotion to signed int
+		constexpr static OBFCYCLES context_cycles = obf_literal_context_version10_descr<T>::descr.min_cycles;
+
+		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+		constexpr static T MUL = obf_random_const<T>(obf_compile_time_prng(seed, 1), consts);
+		static_assert((MUL & 1) == 1);
+		constexpr static T INV = obf_mul_inverse_mod2n(MUL);
+		static_assert(T(U(MUL) * U(INV)) == 1);
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return T(U(x) * U(INV));
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, INV, 0 };
+		}
+		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
+			return T(U(y) * U(MUL ^ obf_opaque_zero<T>()));
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfDbgVersion dbgVersion() {
+			return { "ObfLiteralContext_version", 10, "opaque odd multiplier", sizeof(T), seed, -1, context_cycles };
+		}
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			obf_dbgPrintVersion<T>(offset, prefix, dbgVersion()) << ": MUL=" << obf_dbgPrintC(MUL) << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return obf_opaque_resources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			obf_dbgJsonVersion(w, role, dbgVersion());
+			w.hex("MUL", MUL);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	};
+
+	//ObfZeroLiteralContext
+	template<class T>
+	struct ObfZeroLiteralContext {
+		//same as ObfLiteralContext_version<0,...> but with additional stuff to make it suitable for use as Context parameter to injections
+		constexpr static OBFCYCLES context_cycles = 0;
+		constexpr static OBFCYCLES calc_cycles(OBFCYCLES inj, OBFCYCLES surj) {
+			return surj;//for literals, ONLY surjection costs apply in runtime (as injection applies in compile-time)
+		}
+		constexpr static OBFCYCLES literal_cycles = 0;
+		template<class T2, T2 C, OBFSEED seed2>
+		struct literal {
+			using type = obf_literal_ctx<T2, C, ObfZeroLiteralContext<T2>, seed2, literal_cycles>;
+		};
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, 0 };
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr T final_surjection(T y) {
+			return y;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "ObfZeroContext<" << obf_dbgPrintT<T>() << ">" << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return ObfJsonResources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("ObfZeroLiteralContext", role);
+			w.number("size", sizeof(T));
+			w.number("min_cycles", context_cycles);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	};
+	template<class T, class T0, OBFSEED seed, OBFCYCLES cycles>
+	struct ObfRecursiveContext<T, ObfZeroLiteralContext<T0>, seed, cycles> {
+		using recursive_context_type = ObfZeroLiteralContext<T>;
+		using intermediate_context_type = ObfZeroLiteralContext<T>;
+	};
+
+	//ObfLiteralContext
+	template<class T>
+	constexpr std::array<ObfDescriptor, 11> obf_literal_context_descr() {
+		return {
+			obf_literal_context_version0_descr<T>::descr,
+			obf_literal_context_version1_descr<T>::descr,
+			obf_literal_context_version2_descr<T>::descr,
+			obf_literal_context_version3_descr<T>::descr,
+			obf_literal_context_version4_descr<T>::descr,
+			obf_literal_context_version5_descr<T>::descr,
+			obf_literal_context_version6_descr<T>::descr,
+			obf_literal_context_version7_descr<T>::descr,
+			obf_literal_context_version8_descr<T>::descr,
+			obf_literal_context_version9_descr<T>::descr,
+			obf_literal_context_version10_descr<T>::descr,
+		};
+	}
+
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	class ObfLiteralContext {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		constexpr static std::array<ObfDescriptor, 11> descr = obf_literal_context_descr<T>();
+		constexpr static size_t which = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
+		using WhichType = ObfLiteralContext_version<which, T, seed>;
+
+	public:
+		constexpr static OBFCYCLES context_cycles = WhichType::context_cycles;
+		constexpr static OBFCYCLES calc_cycles(OBFCYCLES inj, OBFCYCLES surj) {
+			return surj;//for literals, ONLY surjection costs apply in runtime (as injection applies in compile-time)
+		}
+
+		constexpr static OBFCYCLES literal_cycles = 0;
+		template<class T2, T2 C, OBFSEED seed2>
+		struct literal {
+			using type = obf_literal_ctx<T2, C, ObfZeroLiteralContext<T2>, seed2, literal_cycles>;
+		};
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return WhichType::final_injection(x);
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return WhichType::final_affine();
+		}
+		ITHARE_OBF_FORCEINLINE static /*non-constexpr*/ T final_surjection(T y) {
+			return WhichType::final_surjection(y);
+		}
+
+
+	public:
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			size_t dbgWhich = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
+			std::cout << std::string(offset, ' ') << prefix << "ObfLiteralContext<" << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: which=" << which << " dbgWhich=" << dbgWhich << std::endl;
+			WhichType::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("ObfLiteralContext", role);
+			w.number("size", sizeof(T));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.unumber("which", which);
+			w.number("min_cycles", context_cycles);
+			w.resources(ObfJsonResources());
+			w.children();
+			WhichType::dbgJson(w);
+			w.end();
+		}
+#endif
+	};
+
+	template<class T, class T0, OBFSEED seed, OBFSEED seed0, OBFCYCLES cycles0,OBFCYCLES cycles>
+	struct ObfRecursiveContext<T, ObfLiteralContext<T0, seed0,cycles0>, seed, cycles> {
+		using recursive_context_type = ObfLiteralContext<T, obf_compile_time_prng(seed, 1),cycles>;//@@
+		using intermediate_context_type = ObfLiteralContext<T, obf_compile_time_prng(seed, 2), cycles>;//whenever cycles is low (which is very often), will fallback to version0
+	};
+
+	//obf_flat_injection: alternative engine for the very same injection trees as obf_injection<> generates;
+	//  instead of instantiating obf_injection<>/obf_injection_version<> per tree node, the tree is computed
+	//  by constexpr functions into a flat plan (array of nodes, grouped into chains),
+	//  and then evaluated by folding over the nodes of each chain
+	//  - identical sub-chains within the plan are stored (and instantiated) only once ('hash-consing')
+	//  - runtime building blocks (add, Feistel, leaf contexts) are keyed by their parameters only, so they're shared across all the plans
+	//  for the same seed, results (including layout of return_type) are bit-for-bit identical to obf_injection<>
+	//  enabled for all the user-level classes with ITHARE_OBF_FLAT_INJECTIONS (see obf_root_injection below)
+	template<size_t sz>
+	struct obf_flat_uint;
+	template<>
+	struct obf_flat_uint<1> {
+		using type = uint8_t;
+	};
+	template<>
+	struct obf_flat_uint<2> {
+		using type = uint16_t;
+	};
+	template<>
+	struct obf_flat_uint<4> {
+		using type = uint32_t;
+	};
+	template<>
+	struct obf_flat_uint<8> {
+		using type = uint64_t;
+	};
+
+	enum class ObfFlatContextKind { zero, literal, var };//ObfZeroLiteralContext, ObfLiteralContext, ObfVarContext
+	struct ObfFlatContext {
+		ObfFlatContextKind kind = ObfFlatContextKind::zero;
+		OBFSEED seed = 0;
+		OBFCYCLES cycles = 0;
+	};
+
+	template<class Context>
+	struct obf_flat_context_of;
+	template<class T>
+	struct obf_flat_context_of<ObfZeroLiteralContext<T>> {
+		static constexpr ObfFlatContext value = { ObfFlatContextKind::zero, 0, 0 };
+	};
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_flat_context_of<ObfLiteralContext<T, seed, cycles>> {
+		static constexpr ObfFlatContext value = { ObfFlatContextKind::literal, seed, cycles };
+	};
+	template<class T, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_flat_context_of<ObfVarContext<T, seed, cycles>> {
+		static constexpr ObfFlatContext value = { ObfFlatContextKind::var, seed, cycles };
+	};
+
+	constexpr std::array<ObfDescriptor, 11> obf_flat_literal_context_descr(size_t sz) {
+		switch (sz) {
+			case 1: return obf_literal_context_descr<uint8_t>();
+			case 2: return obf_literal_context_descr<uint16_t>();
+			case 4: return obf_literal_context_descr<uint32_t>();
+			default: assert(sz == 8); return obf_literal_context_descr<uint64_t>();
+		}
+	}
+
+	constexpr std::array<ObfDescriptor, 3> obf_flat_non_reversible_function_descr(size_t sz, bool fixed_costs) {
+		if (fixed_costs) {//same as obf_randomized_non_reversible_function<>::descr, but with obf_fixed_cycle_cost()
+			return std::array<ObfDescriptor, 3>{
+				ObfDescriptor(false, obf_fixed_cycle_cost(ObfCycleCostKind::non_reversible_function, 0, sz).surjection, 100),
+				ObfDescriptor(true, obf_fixed_cycle_cost(ObfCycleCostKind::non_reversible_function, 1, sz).surjection, 100),
+				ObfDescriptor(true, obf_fixed_cycle_cost(ObfCycleCostKind::non_reversible_function, 2, sz).surjection, 100),
+			};
+		}
+		switch (sz) {
+			case 1: return obf_randomized_non_reversible_function<uint8_t, 0, 0>::descr;
+			case 2: return obf_randomized_non_reversible_function<uint16_t, 0, 0>::descr;
+			case 4: return obf_randomized_non_reversible_function<uint32_t, 0, 0>::descr;
+			default: assert(sz == 8); return obf_randomized_non_reversible_function<uint64_t, 0, 0>::descr;
+		}
+	}
+
+	constexpr uint64_t obf_flat_mul_inverse_mod2n(size_t sz, uint64_t c) {
+		switch (sz) {
+			case 1: return obf_mul_inverse_mod2n(uint8_t(c));
+			case 2: return obf_mul_inverse_mod2n(uint16_t(c));
+			case 4: return obf_mul_inverse_mod2n(uint32_t(c));
+			default: assert(sz == 8); return obf_mul_inverse_mod2n(uint64_t(c));
+		}
+	}
+
+	constexpr uint64_t obf_flat_truncate(size_t sz, uint64_t c) {
+		return sz >= 8 ? c : c & ((UINT64_C(1) << (sz * 8)) - 1);
+	}
+
+	//value-level equivalents of Context::context_cycles, calc_cycles(), literal_cycles, literal<>, and ObfRecursiveContext<>
+	constexpr size_t obf_flat_literal_context_which(size_t sz, ObfFlatContext ctx) {
+		assert(ctx.kind == ObfFlatContextKind::literal);
+		return obf_random_obf_from_list(obf_compile_time_prng(ctx.seed, 1), ctx.cycles, obf_flat_literal_context_descr(sz));
+	}
+	constexpr OBFCYCLES obf_flat_context_cycles(size_t sz, ObfFlatContext ctx) {
+		if (ctx.kind == ObfFlatContextKind::literal)
+			return obf_flat_literal_context_descr(sz)[obf_flat_literal_context_which(sz, ctx)].min_cycles;
+		return 0;
+	}
+	constexpr OBFCYCLES obf_flat_calc_cycles(ObfFlatContext ctx, OBFCYCLES inj, OBFCYCLES surj) {
+		return ctx.kind == ObfFlatContextKind::var ? inj + surj : surj;
+	}
+	constexpr OBFCYCLES obf_flat_literal_cycles(size_t sz, ObfFlatContext ctx) {
+		if (ctx.kind == ObfFlatContextKind::var)
+			return std::min(ctx.cycles / 2, obf_max_cycle_cost(ObfCycleCostKind::literal_context, sz) / 2);
+		return 0;
+	}
+	constexpr ObfFlatContext obf_flat_literal_literal_context(size_t sz, ObfFlatContext ctx) {
+		if (ctx.kind == ObfFlatContextKind::var)
+			return ObfFlatContext{ ObfFlatContextKind::literal, ctx.seed, obf_flat_literal_cycles(sz, ctx) };
+		return ObfFlatContext{};
+	}
+	constexpr ObfFlatContext obf_flat_recursive_context(ObfFlatContext ctx, OBFSEED seed, OBFCYCLES cycles, bool intermediate) {
+		switch (ctx.kind) {
+			case ObfFlatContextKind::literal: return ObfFlatContext{ ObfFlatContextKind::literal, obf_compile_time_prng(seed, intermediate ? 2 : 1), cycles };
+			case ObfFlatContextKind::var: return ObfFlatContext{ ObfFlatContextKind::var, seed, cycles };
+			default: return ObfFlatContext{};
+		}
+	}
+
+	//value-level equivalents of obf_injection_versionN_descr<>::own_min_cycles and obf_injection<>::descr
+	constexpr OBFCYCLES obf_flat_own_min_cycles(size_t which, size_t sz, ObfFlatContext ctx, bool fixed_costs) {
+		ObfCycleCost cost = fixed_costs ? obf_fixed_cycle_cost(ObfCycleCostKind::injection_version, which, sz) : obf_cycle_cost(ObfCycleCostKind::injection_version, which, sz);
+		OBFCYCLES inj = cost.injection + (which == 4 ? obf_flat_literal_cycles(sz, ctx) : 0);
+		OBFCYCLES cc = obf_flat_context_cycles(sz, ctx);
+		return (which == 5 ? 2 * cc : cc) + obf_flat_calc_cycles(ctx, inj, cost.surjection);
+	}
+	constexpr std::array<ObfDescriptor, 8> obf_flat_injection_descr(size_t sz, ObfFlatContext ctx, bool fixed_costs) {
+		std::array<ObfDescriptor, 8> ret = {
+			ObfDescriptor(false, obf_flat_own_min_cycles(0, sz, ctx, fixed_costs), 1),
+			ObfDescriptor(true, obf_flat_own_min_cycles(1, sz, ctx, fixed_costs), 100),
+			ObfDescriptor(false, 0, 0),
+			ObfDescriptor(false, 0, 0),
+			ObfDescriptor(true, obf_flat_own_min_cycles(4, sz, ctx, fixed_costs), 100),
+			ObfDescriptor(false, 0, 0),
+			ObfDescriptor(false, 0, 0),
+			ObfDescriptor(true, obf_flat_own_min_cycles(7, sz, ctx, fixed_costs), 100),
+		};
+		if (sz > 1) {
+			ret[2] = ObfDescriptor(true, obf_flat_own_min_cycles(2, sz, ctx, fixed_costs), 100);
+			ret[3] = ObfDescriptor(true, obf_flat_own_min_cycles(3, sz, ctx, fixed_costs), 100);
+			ret[5] = ObfDescriptor(true, obf_flat_own_min_cycles(5, sz, ctx, fixed_costs), 100);
+			ret[6] = ObfDescriptor(true, obf_flat_own_min_cycles(6, sz, ctx, fixed_costs), 100);
+		}
+		return ret;
+	}
+
+	struct ObfFlatNode {
+		size_t which = 0;//injection version
+		uint64_t c = 0;//versions 1,4,7: C
+		uint64_t cinv = 0;//version 4: CINV
+		bool neg = false;//version 1
+		size_t fwhich = 0;//version 2: non-reversible function version
+		size_t lo = 0;//versions 3,5,6: chain for lower half; version 4: chain for the literal
+		size_t hi = 0;//versions 3,5: chain for higher half
+		size_t ctx_which = 0;//version 0: ObfLiteralContext_version<> (0 for all the identity contexts)
+		OBFSEED ctx_seed = 0;//version 0: seed for ObfLiteralContext_version<>
+	};
+
+	constexpr bool obf_flat_node_equal(const ObfFlatNode& a, const ObfFlatNode& b) {
+		return a.which == b.which && a.c == b.c && a.cinv == b.cinv && a.neg == b.neg && a.fwhich == b.fwhich
+			&& a.lo == b.lo && a.hi == b.hi && a.ctx_which == b.ctx_which && a.ctx_seed == b.ctx_seed;
+	}
+
+	struct ObfFlatRequest {//parameters of obf_injection<>, with T replaced with sizeof(T)
+		size_t sz = 0;
+		ObfFlatContext ctx = {};
+		OBFSEED seed = 0;
+		OBFCYCLES cycles = 0;
+		size_t exclude_version = size_t(-1);
+		uint32_t allowed_versions = ~uint32_t(0);//bitmask of versions allowed for this chain (NOT for its sub-chains); obf_array<> restricts it
+		bool fixed_costs = false;//obf_fixed_cycle_cost() instead of obf_cycle_cost(), for this chain AND its sub-chains (see obf_wire<>)
+	};
+
+	struct ObfFlatExpansion {//one node, plus requests for its sub-chains and for the rest of the chain
+		ObfFlatNode node = {};
+		size_t nsub = 0;
+		std::array<ObfFlatRequest, 2> sub = {};
+		bool has_next = false;
+		ObfFlatRequest next = {};
+	};
+
+	constexpr ObfFlatExpansion obf_flat_expand(ObfFlatRequest rq) {
+		//MUST make exactly the same choices as obf_injection<rq...> and obf_injection_version<which,rq...>
+		size_t sz = rq.sz;
+		size_t halfSz = sz / 2;
+		ObfFlatContext ctx = rq.ctx;
+		OBFSEED seed = rq.seed;
+		OBFCYCLES cc = obf_flat_context_cycles(sz, ctx);
+		assert(!rq.fixed_costs || ctx.kind == ObfFlatContextKind::zero);
+		auto descr = obf_flat_injection_descr(sz, ctx, rq.fixed_costs);
+		assert((rq.allowed_versions & 1) != 0);//version 0 is the only non-recursive one
+		for (size_t i = 1; i < descr.size(); ++i)
+			if ((rq.allowed_versions & (uint32_t(1) << i)) == 0)
+				descr[i] = ObfDescriptor(true, 0, 0);
+		size_t which = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), rq.cycles, descr, rq.exclude_version);
+		OBFCYCLES availCycles = rq.cycles - obf_flat_own_min_cycles(which, sz, ctx, rq.fixed_costs);
+		assert(availCycles >= 0);
+
+		ObfFlatExpansion ret = {};
+		ret.node.which = which;
+		switch (which) {
+			case 0: {
+				if (ctx.kind == ObfFlatContextKind::literal) {
+					ret.node.ctx_which = obf_flat_literal_context_which(sz, ctx);
+					ret.node.ctx_seed = ret.node.ctx_which ? ctx.seed : 0;
+				}
+				break;
+			}
+			case 1: {
+				constexpr std::array<uint64_t, 5> consts = { 0,1,OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+				ret.node.c = obf_flat_truncate(sz, obf_random_const<uint64_t>(obf_compile_time_prng(seed, 2), consts));
+				ret.node.neg = ret.node.c == 0 ? true : obf_weak_random(obf_compile_time_prng(seed, 3), 2) == 0;
+				ret.has_next = true;
+				ret.next = ObfFlatRequest{ sz, ctx, obf_compile_time_prng(seed, 1), availCycles + cc, 1 };
+				break;
+			}
+			case 2: {
+				constexpr std::array<ObfDescriptor, 2> split{ ObfDescriptor(true,0,100), ObfDescriptor(true,0,100) };
+				auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+				auto fDescr = obf_flat_non_reversible_function_descr(halfSz, rq.fixed_costs);
+				OBFCYCLES maxCyclesThatMakeSense = obf_max_min_descr(fDescr);
+				OBFCYCLES deltaF = splitCycles[0] > maxCyclesThatMakeSense ? splitCycles[0] - maxCyclesThatMakeSense : 0;
+				OBFCYCLES cyclesF = splitCycles[0] - deltaF;
+				OBFCYCLES cyclesRInj = splitCycles[1] + deltaF;
+				ret.node.fwhich = obf_random_obf_from_list(obf_compile_time_prng(obf_compile_time_prng(seed, 3), 1), cyclesF, fDescr);
+				ret.has_next = true;
+				ret.next = ObfFlatRequest{ sz, ctx, obf_compile_time_prng(seed, 2), cyclesRInj + cc };
+				break;
+			}
+			case 3: {
+				constexpr std::array<ObfDescriptor, 3> split{ ObfDescriptor(true,0,200), ObfDescriptor(true,0,100), ObfDescriptor(true,0,100) };
+				constexpr std::array<ObfDescriptor, 2> splitHalf{ ObfDescriptor(true,0,100), ObfDescriptor(true,0,100) };
+				auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+				auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 2), splitCycles[1], splitHalf);
+				ObfFlatContext loCtx = obf_flat_recursive_context(ctx, obf_compile_time_prng(seed, 3), splitCyclesLo[0], true);
+				auto splitCyclesHi = obf_random_split(obf_compile_time_prng(seed, 5), splitCycles[2], splitHalf);
+				ObfFlatContext hiCtx = obf_flat_recursive_context(ctx, obf_compile_time_prng(seed, 6), splitCyclesHi[0], true);
+				ret.nsub = 2;
+				ret.sub[0] = ObfFlatRequest{ halfSz, loCtx, obf_compile_time_prng(seed, 4), splitCyclesLo[1] + obf_flat_context_cycles(halfSz, loCtx) };
+				ret.sub[1] = ObfFlatRequest{ halfSz, hiCtx, obf_compile_time_prng(seed, 7), splitCyclesHi[1] + obf_flat_context_cycles(halfSz, hiCtx) };
+				ret.has_next = true;
+				ret.next = ObfFlatRequest{ sz, ctx, obf_compile_time_prng(seed, 2), splitCycles[0] + cc };
+				break;
+			}
+			case 4: {
+				constexpr std::array<uint64_t, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+				ret.node.c = obf_flat_truncate(sz, obf_random_const<uint64_t>(obf_compile_time_prng(seed, 2), consts));
+				assert((ret.node.c & 1) == 1);
+				ret.node.cinv = obf_flat_mul_inverse_mod2n(sz, ret.node.c);
+				ret.nsub = 1;
+				ret.sub[0] = ObfFlatRequest{ sz, obf_flat_literal_literal_context(sz, ctx), obf_compile_time_prng(obf_compile_time_prng(seed, 3), 1), obf_flat_literal_cycles(sz, ctx) };
+				ret.has_next = true;
+				ret.next = ObfFlatRequest{ sz, ctx, obf_compile_time_prng(seed, 1), availCycles + cc, 4 };
+				break;
+			}
+			case 5: {
+				constexpr std::array<ObfDescriptor, 2> splitHalf{ ObfDescriptor(true,0,100), ObfDescriptor(true,0,100) };
+				auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, splitHalf);
+				auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 2), splitCycles[0], splitHalf);
+				ObfFlatContext loCtx = obf_flat_recursive_context(ctx, obf_compile_time_prng(seed, 3), splitCyclesLo[0] + cc, false);
+				auto splitCyclesHi = obf_random_split(obf_compile_time_prng(seed, 5), splitCycles[1], splitHalf);
+				ObfFlatContext hiCtx = obf_flat_recursive_context(ctx, obf_compile_time_prng(seed, 6), splitCyclesHi[0] + cc, false);
+				ret.nsub = 2;
+				ret.sub[0] = ObfFlatRequest{ halfSz, loCtx, obf_compile_time_prng(seed, 4), splitCyclesLo[1] + obf_flat_context_cycles(halfSz, loCtx) };
+				ret.sub[1] = ObfFlatRequest{ halfSz, hiCtx, obf_compile_time_prng(seed, 7), splitCyclesHi[1] + obf_flat_context_cycles(halfSz, hiCtx) };
+				break;
+			}
+			case 6: {
+				constexpr std::array<ObfDescriptor, 2> split{ ObfDescriptor(true,0,200), ObfDescriptor(true,0,100) };
+				constexpr std::array<ObfDescriptor, 2> splitHalf{ ObfDescriptor(true,0,100), ObfDescriptor(true,0,100) };
+				auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 1), availCycles, split);
+				auto splitCyclesLo = obf_random_split(obf_compile_time_prng(seed, 3), splitCycles[1], splitHalf);
+				ObfFlatContext loCtx = obf_flat_recursive_context(ctx, obf_compile_time_prng(seed, 4), splitCyclesLo[0], true);
+				ret.nsub = 1;
+				ret.sub[0] = ObfFlatRequest{ halfSz, loCtx, obf_compile_time_prng(seed, 5), splitCyclesLo[1] + obf_flat_context_cycles(halfSz, loCtx) };
+				ret.has_next = true;
+				ret.next = ObfFlatRequest{ sz, ctx, obf_compile_time_prng(seed, 2), splitCycles[0] + cc };
+				break;
+			}
+			case 7: {
+				constexpr std::array<uint64_t, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
+				ret.node.c = obf_flat_truncate(sz, obf_random_const<uint64_t>(obf_compile_time_prng(seed, 2), consts));
+				ret.has_next = true;
+				ret.next = ObfFlatRequest{ sz, ctx, obf_compile_time_prng(seed, 1), availCycles + cc, 7 };
+				break;
+			}
+			default:
+				assert(false);
+		}
+		ret.next.allowed_versions = rq.allowed_versions;
+		ret.next.fixed_costs = rq.fixed_costs;
+		for (size_t i = 0; i < ret.nsub; ++i)
+			ret.sub[i].fixed_costs = rq.fixed_costs;
+		return ret;
+	}
+
+	struct ObfFlatCount {
+		size_t nodes = 0;
+		size_t chains = 0;
+	};
+	constexpr ObfFlatCount obf_flat_count(ObfFlatRequest rq) {//upper bound (i.e. w/o hash-consing)
+		ObfFlatCount ret = { 0, 1 };
+		for (;;) {
+			ObfFlatExpansion e = obf_flat_expand(rq);
+			++ret.nodes;
+			for (size_t i = 0; i < e.nsub; ++i) {
+				ObfFlatCount sub = obf_flat_count(e.sub[i]);
+				ret.nodes += sub.nodes;
+				ret.chains += sub.chains;
+			}
+			if (!e.has_next)
+				return ret;
+			rq = e.next;
+		}
+	}
+
+	struct ObfFlatChain {//nodes [begin,end) of the plan, applied in this order for injection (and in reverse order for surjection)
+		size_t sz = 0;
+		size_t begin = 0;
+		size_t end = 0;
+		bool complete = false;
+	};
+
+	template<size_t NN, size_t NC>
+	struct ObfFlatPlan {
+		std::array<ObfFlatNode, NN> nodes = {};
+		size_t n_nodes = 0;
+		std::array<ObfFlatChain, NC> chains = {};
+		size_t n_chains = 0;
+	};
+
+	template<size_t NN, size_t NC>
+	constexpr bool obf_flat_chain_equal(const ObfFlatPlan<NN, NC>& plan, size_t a, size_t b) {
+		const ObfFlatChain& ca = plan.chains[a];
+		const ObfFlatChain& cb = plan.chains[b];
+		if (ca.sz != cb.sz || ca.end - ca.begin != cb.end - cb.begin)
+			return false;
+		for (size_t i = 0; i < ca.end - ca.begin; ++i)
+			if (!obf_flat_node_equal(plan.nodes[ca.begin + i], plan.nodes[cb.begin + i]))
+				return false;
+		return true;
+	}
+
+	template<size_t NN, size_t NC>
+	constexpr size_t obf_flat_build_chain(ObfFlatPlan<NN, NC>& plan, ObfFlatRequest rq) {
+		//chain nodes go first (so they're contiguous), sub-chains are appended after them
+		size_t idx = plan.n_chains++;
+		size_t begin = plan.n_nodes;
+		ObfFlatRequest r = rq;
+		for (;;) {
+			ObfFlatExpansion e = obf_flat_expand(r);
+			plan.nodes[plan.n_nodes++] = e.node;
+			if (!e.has_next)
+				break;
+			r = e.next;
+		}
+		size_t end = plan.n_nodes;
+		plan.chains[idx] = ObfFlatChain{ rq.sz, begin, end, false };
+
+		r = rq;
+		for (size_t i = begin; i < end; ++i) {
+			ObfFlatExpansion e = obf_flat_expand(r);
+			if (e.nsub > 0)
+				plan.nodes[i].lo = obf_flat_build_chain(plan, e.sub[0]);
+			if (e.nsub > 1)
+				plan.nodes[i].hi = obf_flat_build_chain(plan, e.sub[1]);
+			r = e.next;
+		}
+
+		//hash-consing: if there is an identical complete chain, we're rolling back everything added since idx
+		//  (if we're identical, all our sub-chains have been already rolled back to pre-existing ones)
+		for (size_t k = 0; k < idx; ++k) {
+			if (plan.chains[k].complete && obf_flat_chain_equal(plan, k, idx)) {
+				plan.n_nodes = begin;
+				plan.n_chains = idx;
+				return k;
+			}
+		}
+		plan.chains[idx].complete = true;
+		return idx;
+	}
+
+	template<size_t NN, size_t NC>
+	constexpr ObfFlatPlan<NN, NC> obf_flat_build(ObfFlatRequest rq) {
+		ObfFlatPlan<NN, NC> ret = {};
+		size_t root = obf_flat_build_chain(ret, rq);
+		assert(root == 0);
+		(void)root;//used only in assert()
+		return ret;
+	}
+
+	template<size_t sz, ObfFlatContextKind ctxKind, OBFSEED ctxSeed, OBFCYCLES ctxCycles, OBFSEED seed, OBFCYCLES cycles, size_t exclude_version, uint32_t allowed_versions = ~uint32_t(0), bool fixed_costs = false>
+	struct obf_flat_plan {
+		static constexpr ObfFlatRequest root = { sz, ObfFlatContext{ ctxKind, ctxSeed, ctxCycles }, seed, cycles, exclude_version, allowed_versions, fixed_costs };
+		static constexpr ObfFlatCount count = obf_flat_count(root);
+		static constexpr ObfFlatPlan<count.nodes, count.chains> plan = obf_flat_build<count.nodes, count.chains>(root);
+	};
+
+	//shared building blocks
+	template<class T, size_t ctx_which, OBFSEED ctx_seed>
+	struct obf_flat_leaf {//version 0
+		using Context = ObfLiteralContext_version<ctx_which, T, ctx_seed>;
+		ITHARE_OBF_FORCEINLINE constexpr static T injection(T x) {
+			return Context::final_injection(x);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(T y) {
+			return Context::final_surjection(y);
+		}
+		constexpr static ObfAffine<T> affine() {
+			return Context::final_affine();
+		}
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfJsonResources resources() {
+			return Context::resources();
+		}
+#endif
+	};
+	template<class T>
+	struct obf_flat_leaf<T, 0, 0> {//identity; the most common one by far
+		ITHARE_OBF_FORCEINLINE constexpr static T injection(T x) {
+			return x;
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(T y) {
+			return y;
+		}
+		constexpr static ObfAffine<T> affine() {
+			return ObfAffine<T>{ true, 1, 0 };
+		}
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static constexpr ObfJsonResources resources() {
+			return ObfJsonResources();
+		}
+#endif
+	};
+
+	template<class T, T C, bool neg>
+	struct obf_flat_add {//version 1
+		using U = typename ObfAffine<T>::U;//as in obf_injection_version<1>
+		ITHARE_OBF_FORCEINLINE constexpr static T injection(T x) {
+			if constexpr(neg)
+				return T(T(U(0) - U(x)) + C);
+			else
+				return T(x + C);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(T y) {
+			T yy = y - C;
+			if constexpr(neg)
+				return T(U(0) - U(yy));
+			else
+				return yy;
+		}
+	};
+
+	template<class T, size_t fwhich>
+	struct obf_flat_feistel {//version 2
+		using halfT = typename obf_half_size_int<T>::value_type;
+		constexpr static int halfTBits = sizeof(halfT) * 8;
+		using FType = obf_randomized_non_reversible_function_version<fwhich, halfT, 0, 0>;
+		ITHARE_OBF_FORCEINLINE constexpr static T injection(T x) {
+			T lo = x >> halfTBits;
+			T hi = x + FType()((halfT)lo);
+			return T((hi << halfTBits) + lo);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(T y) {
+			halfT hi = y >> halfTBits;
+			T lo = y;
+			halfT z = (hi - FType()((halfT)lo));
+			return T(z + (lo << halfTBits));
+		}
+	};
+
+	template<class T, class Plan, size_t chain, class Indexes = std::make_index_sequence<Plan::plan.chains[chain].end - Plan::plan.chains[chain].begin - 1>>
+	struct obf_flat_chain;
+
+	template<class T, class LoReturn, class HiReturn>
+	struct obf_flat_split_return {//same as obf_injection_version<5,...>::return_type
+		using halfT = typename obf_half_size_int<T>::value_type;
+		constexpr static int halfTBits = sizeof(halfT) * 8;
+		LoReturn lo;
+		HiReturn hi;
+
+		constexpr obf_flat_split_return(halfT lo_, halfT hi_)
+			: lo(lo_), hi(hi_) {
+		}
+		constexpr obf_flat_split_return(ObfPiecewise, const LoReturn& lo_, const HiReturn& hi_)
+			: lo(lo_), hi(hi_) {
+		}
+		constexpr obf_flat_split_return(T x)
+			: lo(halfT(x)), hi(halfT(x >> halfTBits)) {
+		}
+		constexpr operator T() {
+			halfT lo1 = halfT(lo);
+			halfT hi1 = halfT(hi);
+			return (T(hi1) << halfTBits) + T(lo1);
+		}
+	};
+
+	template<class T, class Plan, size_t idx, bool is_split = Plan::plan.nodes[idx].which == 5>
+	struct obf_flat_step_return {
+		using type = T;
+	};
+	template<class T, class Plan, size_t idx>
+	struct obf_flat_step_return<T, Plan, idx, true> {
+		using halfT = typename obf_half_size_int<T>::value_type;
+		using type = obf_flat_split_return<T, typename obf_flat_chain<halfT, Plan, Plan::plan.nodes[idx].lo>::return_type, typename obf_flat_chain<halfT, Plan, Plan::plan.nodes[idx].hi>::return_type>;
+	};
+
+	template<class T, class Plan, size_t idx>
+	struct obf_flat_step {
+		static constexpr ObfFlatNode node = Plan::plan.nodes[idx];
+		using halfT = typename obf_half_size_int<T>::value_type;
+		constexpr static int halfTBits = sizeof(halfT) * 8;
+		using return_type = typename obf_flat_step_return<T, Plan, idx>::type;//T for all the versions except for 5
+		using U = typename std::conditional<(sizeof(T) < sizeof(unsigned)), unsigned, T>::type;//avoiding promotion to signed int
+
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			if constexpr(node.which == 0)
+				return obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::injection(x);
+			else if constexpr(node.which == 1)
+				return obf_flat_add<T, T(node.c), node.neg>::injection(x);
+			else if constexpr(node.which == 2)
+				return obf_flat_feistel<T, node.fwhich>::injection(x);
+			else if constexpr(node.which == 3) {
+				halfT lo = halfT(LoHalf::injection(halfT(x >> halfTBits)));
+				halfT hi = halfT(HiHalf::injection(halfT(x)));
+				return T((T(hi) << halfTBits) + T(lo));
+			}
+			else if constexpr(node.which == 4) {
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+				if (ITHARE_OBF_IS_CONSTANT_EVALUATED())
+					return T(U(x) * U(T(node.cinv)));
+#endif
+				constexpr typename Literal::return_type val = Literal::injection(T(node.cinv));
+				return T(U(x) * U(Literal::surjection(val)));//using CINV in injection to hide literals a bit better...
+			}
+			else if constexpr(node.which == 5) {
+				return_type ret{ LoHalf::injection(halfT(x)), HiHalf::injection(halfT(x >> halfTBits)) };
+				return ret;
+			}
+			else if constexpr(node.which == 7)
+				return T(x ^ T(node.c));
+			else {
+				static_assert(node.which == 6);
+				halfT lo0 = halfT(x);
+				halfT lo = halfT(LoHalf::injection(lo0));
+				return T(x - T(lo0) + lo);
+			}
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			if constexpr(node.which == 0)
+				return obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::surjection(y);
+			else if constexpr(node.which == 1)
+				return obf_flat_add<T, T(node.c), node.neg>::surjection(y);
+			else if constexpr(node.which == 2)
+				return obf_flat_feistel<T, node.fwhich>::surjection(y);
+			else if constexpr(node.which == 3) {
+				halfT hi = HiHalf::surjection(typename HiHalf::return_type(halfT(y >> halfTBits)));
+				halfT lo = LoHalf::surjection(typename LoHalf::return_type(halfT(y)));
+				return T(T(hi) + (T(lo) << halfTBits));
+			}
+			else if constexpr(node.which == 4)
+				return T(U(y) * U(node.c));
+			else if constexpr(node.which == 5) {
+				halfT hi = HiHalf::surjection(y.hi);
+				halfT lo = LoHalf::surjection(y.lo);
+				return T(T(lo) + (T(hi) << halfTBits));
+			}
+			else if constexpr(node.which == 7)
+				return T(y ^ T(node.c));
+			else {
+				halfT lo0 = halfT(y);
+				halfT lo = LoHalf::surjection(typename LoHalf::return_type(lo0));
+				return T(y - T(lo0) + lo);
+			}
+		}
+		constexpr static ObfAffine<T> affine() {//same as obf_injection_version<>::affine() for this node alone
+			using ST = typename std::make_signed<T>::type;
+			if constexpr(node.which == 0)
+				return obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::affine();
+			else if constexpr(node.which == 1)
+				return ObfAffine<T>{ true, node.neg ? T(-ST(1)) : T(1), T(node.c) };
+			else if constexpr(node.which == 4)
+				return ObfAffine<T>{ true, T(node.cinv), 0 };
+			else
+				return ObfAffine<T>();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {//same as obf_injection_version<>::xor_mask() for this node alone
+			if constexpr(node.which == 0) {
+				constexpr ObfAffine<T> aff = obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::affine();
+				return aff.is_affine && aff.a == 1 && aff.b == 0 ? ObfXorMask<T>{ true, 0 } : ObfXorMask<T>();
+			}
+			else if constexpr(node.which == 7)
+				return ObfXorMask<T>{ true, T(node.c) };
+			else
+				return ObfXorMask<T>();
+		}
+
+	private:
+		//NB: only versions 3,4,5,6 refer to other chains
+		using LoHalf = obf_flat_chain<halfT, Plan, node.lo>;
+		using HiHalf = obf_flat_chain<halfT, Plan, node.hi>;
+		using Literal = obf_flat_chain<T, Plan, node.lo>;
+	};
+	template<class Plan, size_t idx>
+	struct obf_flat_step<uint8_t, Plan, idx> {//no halves for uint8_t => no versions 2,3,5,6
+		static constexpr ObfFlatNode node = Plan::plan.nodes[idx];
+		using T = uint8_t;
+		using return_type = T;
+		ITHARE_OBF_FORCEINLINE constexpr static T injection(T x) {
+			if constexpr(node.which == 0)
+				return obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::injection(x);
+			else if constexpr(node.which == 1)
+				return obf_flat_add<T, T(node.c), node.neg>::injection(x);
+			else if constexpr(node.which == 7)
+				return T(x ^ T(node.c));
+			else {
+				static_assert(node.which == 4);
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+				if (ITHARE_OBF_IS_CONSTANT_EVALUATED())
+					return T(x * T(node.cinv));
+#endif
+				constexpr typename Literal::return_type val = Literal::injection(T(node.cinv));
+				return T(x * Literal::surjection(val));
+			}
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(T y) {
+			if constexpr(node.which == 0)
+				return obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::surjection(y);
+			else if constexpr(node.which == 1)
+				return obf_flat_add<T, T(node.c), node.neg>::surjection(y);
+			else if constexpr(node.which == 7)
+				return T(y ^ T(node.c));
+			else
+				return T(y * T(node.c));
+		}
+		constexpr static ObfAffine<T> affine() {
+			if constexpr(node.which == 0)
+				return obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::affine();
+			else if constexpr(node.which == 1)
+				return ObfAffine<T>{ true, node.neg ? T(-int8_t(1)) : T(1), T(node.c) };
+			else if constexpr(node.which == 4)
+				return ObfAffine<T>{ true, T(node.cinv), 0 };
+			else
+				return ObfAffine<T>();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			if constexpr(node.which == 0) {
+				constexpr ObfAffine<T> aff = obf_flat_leaf<T, node.ctx_which, node.ctx_seed>::affine();
+				return aff.is_affine && aff.a == 1 && aff.b == 0 ? ObfXorMask<T>{ true, 0 } : ObfXorMask<T>();
+			}
+			else if constexpr(node.which == 7)
+				return ObfXorMask<T>{ true, T(node.c) };
+			else
+				return ObfXorMask<T>();
+		}
+
+	private:
+		using Literal = obf_flat_chain<T, Plan, node.lo>;
+	};
+
+	template<class T, class Plan, size_t chain, size_t... I>
+	struct obf_flat_chain<T, Plan, chain, std::index_sequence<I...>> {
+		//I... enumerate all the nodes except for the last one (which is always either version 0 or version 5)
+		static constexpr size_t begin = Plan::plan.chains[chain].begin;
+		static constexpr size_t n = sizeof...(I);
+		static_assert(Plan::plan.chains[chain].sz == sizeof(T));
+		using Last = obf_flat_step<T, Plan, begin + n>;
+
+		using return_type = typename Last::return_type;
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			((x = obf_flat_step<T, Plan, begin + I>::injection(x)), ...);
+			return Last::injection(x);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			T x = Last::surjection(y);
+			((x = obf_flat_step<T, Plan, begin + n - 1 - I>::surjection(x)), ...);
+			return x;
+		}
+		constexpr static ObfAffine<T> affine() {
+			ObfAffine<T> ret = Last::affine();
+			((ret = ret.compose(obf_flat_step<T, Plan, begin + n - 1 - I>::affine())), ...);
+			return ret;
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			ObfXorMask<T> ret = Last::xor_mask();
+			((ret = ret.compose(obf_flat_step<T, Plan, begin + n - 1 - I>::xor_mask())), ...);
+			return ret;
+		}
+	};
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+	template<class Plan>
+	void obf_flat_dbgPrintChain(size_t chain, size_t offset, const char* prefix) {
+		const ObfFlatChain& ch = Plan::plan.chains[chain];
+		std::cout << std::string(offset, ' ') << prefix << "chain #" << chain << " T(sizeof=" << ch.sz << ")" << std::endl;
+		for (size_t i = ch.begin; i < ch.end; ++i) {
+			const ObfFlatNode& node = Plan::plan.nodes[i];
+			std::cout << std::string(offset + 1, ' ') << "obf_flat_node<" << node.which << ">:";
+			switch (node.which) {
+				case 0: std::cout << " ctx_which=" << node.ctx_which << " ctx_seed=" << node.ctx_seed << std::endl; break;
+				case 1: std::cout << " C=" << node.c << " neg=" << node.neg << std::endl; break;
+				case 2: std::cout << " fwhich=" << node.fwhich << std::endl; break;
+				case 4: std::cout << " C=" << node.c << " CINV=" << node.cinv << std::endl; break;
+				case 7: std::cout << " C=" << node.c << std::endl; break;
+				default: std::cout << std::endl; break;
+			}
+			if (node.which == 3 || node.which == 5 || node.which == 6)
+				obf_flat_dbgPrintChain<Plan>(node.lo, offset + 2, "Lo:");
+			if (node.which == 3 || node.which == 5)
+				obf_flat_dbgPrintChain<Plan>(node.hi, offset + 2, "Hi:");
+			if (node.which == 4)
+				obf_flat_dbgPrintChain<Plan>(node.lo, offset + 2, "literal:");
+		}
+	}
+
+	//obf_flat_dbgJsonChain<>(): walks the plan at compile time (rather than in a loop, as dbgPrint() does),
+	//  so that each version 0 node can ask its context for resources
+	template<class Plan, size_t chain>
+	constexpr void obf_flat_dbgJsonChain(ObfJsonWriter& w, const char* role = "");
+
+	template<class Plan, size_t chain, size_t idx>
+	constexpr void obf_flat_dbgJsonNode(ObfJsonWriter& w) {
+		constexpr ObfFlatNode node = Plan::plan.nodes[idx];
+		w.begin("obf_flat_node");
+		w.unumber("version", node.which);
+		switch (node.which) {
+			case 0: w.unumber("ctx_which", node.ctx_which); w.hex("ctx_seed", node.ctx_seed); break;
+			case 1: w.hex("C", node.c); w.boolean("neg", node.neg); break;
+			case 2: w.unumber("fwhich", node.fwhich); break;
+			case 4: w.hex("C", node.c); w.hex("CINV", node.cinv); break;
+			case 7: w.hex("C", node.c); break;
+			default: break;
+		}
+		if constexpr(node.which == 0)
+			w.resources(obf_flat_leaf<typename obf_flat_uint<Plan::plan.chains[chain].sz>::type, node.ctx_which, node.ctx_seed>::resources());
+		else
+			w.resources(ObfJsonResources());
+		if constexpr(node.which == 3 || node.which == 4 || node.which == 5 || node.which == 6) {
+			w.children();
+			if constexpr(node.which == 4)
+				obf_flat_dbgJsonChain<Plan, node.lo>(w, "literal");
+			else
+				obf_flat_dbgJsonChain<Plan, node.lo>(w, "Lo");
+			if constexpr(node.which == 3 || node.which == 5)
+				obf_flat_dbgJsonChain<Plan, node.hi>(w, "Hi");
+		}
+		w.end();
+	}
+	template<class Plan, size_t chain, size_t... I>
+	constexpr void obf_flat_dbgJsonNodes(ObfJsonWriter& w, std::index_sequence<I...>) {
+		(obf_flat_dbgJsonNode<Plan, chain, Plan::plan.chains[chain].begin + I>(w), ...);
+	}
+	template<class Plan, size_t chain>
+	constexpr void obf_flat_dbgJsonChain(ObfJsonWriter& w, const char* role) {
+		constexpr ObfFlatChain ch = Plan::plan.chains[chain];
+		w.begin("obf_flat_chain", role);
+		w.unumber("chain", chain);
+		w.unumber("size", ch.sz);
+		w.resources(ObfJsonResources());
+		w.children();
+		obf_flat_dbgJsonNodes<Plan, chain>(w, std::make_index_sequence<ch.end - ch.begin>());
+		w.end();
+	}
+#endif
+
+	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles, class InjectionContext>
+	class obf_flat_injection {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+		static constexpr ObfFlatContext ctx = obf_flat_context_of<Context>::value;
+		using Plan = obf_flat_plan<sizeof(T), ctx.kind, ctx.seed, ctx.cycles, seed, cycles, InjectionContext::exclude_version>;
+		using U = typename obf_flat_uint<sizeof(T)>::type;
+		using Root = obf_flat_chain<U, Plan, 0>;
+
+	public:
+		using return_type = typename Root::return_type;
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+			return Root::injection(U(x));
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+			return T(Root::surjection(y));
+		}
+		constexpr static ObfAffine<T> affine() {
+			ObfAffine<U> ret = Root::affine();
+			return ObfAffine<T>{ ret.is_affine, T(ret.a), T(ret.b) };
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			ObfXorMask<U> ret = Root::xor_mask();
+			return ObfXorMask<T>{ ret.is_xor, T(ret.mask) };
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_flat_injection<" << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: nodes=" << Plan::plan.n_nodes << "/" << Plan::count.nodes << " chains=" << Plan::plan.n_chains << "/" << Plan::count.chains << std::endl;
+			obf_flat_dbgPrintChain<Plan>(0, offset + 1, "");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_flat_injection", role);
+			w.number("size", sizeof(T));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.unumber("nodes", Plan::plan.n_nodes);
+			w.unumber("chains", Plan::plan.n_chains);
+			w.resources(ObfJsonResources());
+			w.children();
+			obf_flat_dbgJsonChain<Plan, 0>(w);
+			w.end();
+		}
+#endif
+	};
+
+	//obf_root_injection: injection used by user-level classes (obf_literal_ctx, obf_literal, obf_var, obf_str_literal)
+	//  ITHARE_OBF_FLAT_INJECTIONS makes them use obf_flat_injection<> (same results, less template instantiations)
+#ifdef ITHARE_OBF_FLAT_INJECTIONS
+	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles, class InjectionContext>
+	using obf_root_injection = obf_flat_injection<T, Context, seed, cycles, InjectionContext>;
+#else
+	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles, class InjectionContext>
+	using obf_root_injection = obf_injection<T, Context, seed, cycles, InjectionContext>;
+#endif
+
+	//obf_outlined_injection: Injection behind out-of-line functions (see ITHARE_OBF_CODE_SIZE_BOUNDED)
+	//  the functions are static (local to the TU) and NOT ITHARE_OBF_NOINLINE: the compiler sees all their calls,
+	//  and GCC/Clang inline a local function which is called only once regardless of its size - so a site used once
+	//  stays inlined (outlining it would only add a call), and only sites used more than once share an outlined tree
+	//  they're not constexpr (which would make them inline), so constant evaluation (e.g. obf_literal<>::encoded)
+	//  goes to Injection directly; without ITHARE_OBF_IS_CONSTANT_EVALUATED, it is Injection directly all the time
+	template<class T, class Injection>
+	static typename Injection::return_type obf_outlined_injection_call(T x) {
+		return Injection::injection(x);
+	}
+	template<class T, class Injection>
+	static T obf_outlined_surjection_call(typename Injection::return_type y) {
+		return Injection::surjection(y);
+	}
+
+	template<class T, class Injection>
+	struct obf_outlined_injection {
+		using return_type = typename Injection::return_type;
+		ITHARE_OBF_FORCEINLINE constexpr static return_type injection(T x) {
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+			if (!ITHARE_OBF_IS_CONSTANT_EVALUATED())
+				return obf_outlined_injection_call<T, Injection>(x);
+#endif
+			return Injection::injection(x);
+		}
+		ITHARE_OBF_FORCEINLINE constexpr static T surjection(return_type y) {
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+			if (!ITHARE_OBF_IS_CONSTANT_EVALUATED())
+				return obf_outlined_surjection_call<T, Injection>(y);
+#endif
+			return Injection::surjection(y);
+		}
+		constexpr static ObfAffine<T> affine() {
+			return Injection::affine();
+		}
+		constexpr static ObfXorMask<T> xor_mask() {
+			return Injection::xor_mask();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_outlined_injection<" << obf_dbgPrintT<T>() << ">" << std::endl;
+			Injection::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_outlined_injection", role);
+			w.number("size", sizeof(T));
+			ObfJsonResources res;
+			res.calls = 1;
+			w.resources(res);
+			w.children();
+			Injection::dbgJson(w);
+			w.end();
+		}
+#endif
+	};
+
+	//obf_site_injection: root injection of a user-level site (obf_literal, obf_var, obf_str_literal),
+	//  outlined if the site is over ITHARE_OBF_INLINE_BUDGET in ITHARE_OBF_CODE_SIZE_BOUNDED mode;
+	//  injections within the trees (incl. obf_literal_ctx) are always inlined
+	template<class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+	using obf_site_injection = typename std::conditional<obf_tree_inlined(cycles),
+		obf_root_injection<T, Context, seed, cycles, ObfDefaultInjectionContext>,
+		obf_outlined_injection<T, obf_root_injection<T, Context, seed, cycles, ObfDefaultInjectionContext>>>::type;
+
+	//obf_literal
+	template<class T, T C, class Context, OBFSEED seed, OBFCYCLES cycles>
+	class obf_literal_ctx {
+		static_assert(std::is_integral<T>::value);
+		static_assert(std::is_unsigned<T>::value);
+
+		using Injection = obf_root_injection<T, Context, obf_compile_time_prng(seed, 1), cycles,ObfDefaultInjectionContext>;
+	public:
+		ITHARE_OBF_FORCEINLINE constexpr obf_literal_ctx() : val(Injection::injection(C)) {
+		}
+		ITHARE_OBF_FORCEINLINE constexpr T value() const {
+			return Injection::surjection(val);
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_literal_ctx<" << obf_dbgPrintT<T>() << "," << obf_dbgPrintC(C) << "," << seed << "," << cycles << ">" << std::endl;
+			Injection::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_literal_ctx", role);
+			w.number("size", sizeof(T));
+			w.hex("C", C);
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.resources(ObfJsonResources());
+			w.children();
+			Injection::dbgJson(w);
+			w.end();
+		}
+#endif
+	private:
+		typename Injection::return_type val;
+	};
+
+	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_literal_dbg<>
+	template<class T_, T_ C_, OBFSEED seed, OBFCYCLES cycles>
+	class obf_literal {
+		static_assert(std::is_integral<T_>::value);
+		using T = typename std::make_unsigned<T_>::type;//from this point on, unsigned only
+		static constexpr T C = (T)C_;
+		static constexpr OBFCYCLES site_cycles = obf_site_cycles(seed, cycles);
+		static constexpr OBFSEED tree_seed = obf_tree_seed(seed);
+		static constexpr OBFCYCLES tree_cycles = obf_tree_cycles(site_cycles);
+
+		using Context = ObfLiteralContext<T, obf_compile_time_prng(tree_seed, 1),tree_cycles>;
+		using Injection = obf_site_injection<T, Context, obf_compile_time_prng(tree_seed, 2), tree_cycles>;
+		using Stats = obf_site_stats<obf_literal, ObfSiteKind::literal, sizeof(T), seed, cycles, site_cycles>;
+		static constexpr typename Injection::return_type encoded = Injection::injection(C);//always at compile time, even if Injection is outlined
+	public:
+		ITHARE_OBF_FORCEINLINE constexpr obf_literal(ITHARE_OBF_SITE_LOC_PARAM0) : val(encoded) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+		}
+		ITHARE_OBF_FORCEINLINE T value() const {
+			return Stats::decode([&] { return Injection::surjection(val); });
+		}
+		ITHARE_OBF_FORCEINLINE operator T() const {
+			return value();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_literal<"<<obf_dbgPrintT<T>()<<"," << C << "," << seed << "," << cycles << ">: site_cycles=" << site_cycles << std::endl;
+			Injection::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_literal", role);
+			w.number("size", sizeof(T));
+			w.hex("C", C);
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.number("site_cycles", site_cycles);
+			w.resources(ObfJsonResources());
+			w.children();
+			Injection::dbgJson(w);
+			w.end();
+		}
+#endif
+	private:
+		typename Injection::return_type val;
+	};
+
+	template<class T_, T_ C_, OBFSEED seed, OBFCYCLES cycles>
+	ITHARE_OBF_FORCEINLINE auto obf_expr_value(const obf_literal<T_, C_, seed, cycles>& l) {
+		return l.value();
+	}
+
+	//ObfVarContext
+	template<class T,OBFSEED seed,OBFCYCLES cycles>
+	struct ObfVarContext {
+		constexpr static OBFCYCLES context_cycles = 0;
+		constexpr static OBFCYCLES calc_cycles(OBFCYCLES inj, OBFCYCLES surj) {
+			return inj + surj;//for variables, BOTH injection and surjection are executed in runtime
+		}
+
+		//literal within var injection gets up to half of var cycles, but no more than half of the most expensive literal context
+		//  (otherwise literals would eat up var's cycles on the contexts alone)
+		constexpr static OBFCYCLES literal_cycles = std::min(cycles/2,obf_max_cycle_cost(ObfCycleCostKind::literal_context,sizeof(T))/2);
+		using LiteralContext = ObfLiteralContext<T, seed, literal_cycles>;
+		template<class T2, T2 C, OBFSEED seed2>
+		struct literal {
+			using type = obf_literal_ctx<T2, C, LiteralContext, seed2, literal_cycles>;
+		};
+
+		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
+			return x;
+		}
+		static constexpr ObfAffine<T> final_affine() {
+			return ObfAffine<T>{ true, 1, 0 };
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr T final_surjection(T y) {
+			return y;
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "ObfVarContext<" << obf_dbgPrintT<T>() << ">" << std::endl;
+		}
+		static constexpr ObfJsonResources resources() {//of final_surjection(), for dbgJson()
+			return ObfJsonResources();
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("ObfVarContext", role);
+			w.number("size", sizeof(T));
+			w.number("min_cycles", context_cycles);
+			w.number("literal_cycles", literal_cycles);
+			w.resources(resources());
+			w.end();
+		}
+#endif
+	};
+	template<class T, class T0, OBFSEED seed0, OBFCYCLES cycles0, OBFSEED seed, OBFCYCLES cycles>
+	struct ObfRecursiveContext<T, ObfVarContext<T0,seed0,cycles0>, seed, cycles> {
+		using recursive_context_type = ObfVarContext<T,seed,cycles>;
+		using intermediate_context_type = ObfVarContext<T,seed,cycles>;
+	};
+
+	//obf_encoded_ops: equality and hashing of encoded values (Injection::return_type), w/o surjection;
+	//  as injections are bijections, encoded values of the same Injection are equal iff the original ones are
+	//  pack() concatenates the leaves (these are never padded, so it is a bijection too), and unpack() is its inverse
+	template<class R, bool leaf = std::is_integral<R>::value>
+	struct obf_encoded_ops {
+		static constexpr int bits = sizeof(R) * 8;
+		ITHARE_OBF_FORCEINLINE static constexpr uint64_t pack(R y) {
+			return uint64_t(y);
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr R unpack(uint64_t w) {
+			return R(w);
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr bool equal(R a, R b) {
+			return a == b;
+		}
+	};
+	template<class R>
+	struct obf_encoded_ops<R, false> {//split, see obf_injection_version<5>::return_type
+		using Lo = obf_encoded_ops<decltype(R::lo)>;
+		using Hi = obf_encoded_ops<decltype(R::hi)>;
+		static constexpr int bits = Lo::bits + Hi::bits;
+		ITHARE_OBF_FORCEINLINE static constexpr uint64_t pack(const R& y) {
+			return Lo::pack(y.lo) | (Hi::pack(y.hi) << Lo::bits);
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr R unpack(uint64_t w) {
+			return R(ObfPiecewise(), Lo::unpack(w), Hi::unpack(w >> Lo::bits));
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr bool equal(const R& a, const R& b) {
+			return pack(a) == pack(b);//one comparison instead of one per leaf
+		}
+	};
+
+	//obf_match(): the only x of type T for which x == c (with the usual arithmetic conversions), if there is one
+	//  (conversions of T to the common type are injective, so there can't be more than one)
+	template<class T>
+	struct ObfMatch {
+		bool exists;
+		T x;
+	};
+	template<class T, class T2>
+	constexpr ObfMatch<T> obf_match(T2 c) {
+		using CT = decltype(T() + T2());
+		T x = T(CT(c));
+		return ObfMatch<T>{ CT(x) == CT(c), x };
+	}
+
+	//obf_var
+	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_var_dbg<>
+	template<class T_, OBFSEED seed, OBFCYCLES cycles>
+	class obf_var {
+		static_assert(std::is_integral<T_>::value);
+		using T = typename std::make_unsigned<T_>::type;//from this point on, unsigned only
+		static constexpr OBFCYCLES site_cycles = obf_site_cycles(seed, cycles);
+		static constexpr OBFSEED tree_seed = obf_tree_seed(seed);
+		static constexpr OBFCYCLES tree_cycles = obf_tree_cycles(site_cycles);
+
+		using Context = ObfVarContext<T, obf_compile_time_prng(tree_seed, 1), tree_cycles>;
+		using Injection = obf_site_injection<T, Context, obf_compile_time_prng(tree_seed, 2), tree_cycles>;
+		using Stats = obf_site_stats<obf_var, ObfSiteKind::var, sizeof(T), seed, cycles, site_cycles>;
+
+		//if Injection happens to be affine, +-* by an integer are performed directly on val, without surjection/injection
+		//  (for other T2s, and for /%, we still have to go via value())
+		static constexpr ObfAffine<T> affine = Injection::affine();
+		template<class T2>
+		static constexpr bool encoded_arithmetic = affine.is_affine && std::is_integral<T2>::value;
+		//same for ^ (and ~) with Injection which is a pure xor mask (see ObfXorMask); &|<<>> always go via value()
+		//  (for a pure xor mask, the compiler folds surjection-op-injection at least as well as an encoded form of &|<<>>)
+		static constexpr ObfXorMask<T> xmask = Injection::xor_mask();
+		template<class T2>
+		static constexpr bool encoded_xor = xmask.is_xor && std::is_integral<T2>::value;
+		//x+-*^integer assigned back to the same obf_var<> type (x = x + 1, y = x ^ k, etc.) is calculated on the encoded value, too
+		template<class Op, class L, class R>
+		static constexpr bool encoded_expr = std::is_same<L, obf_var>::value &&
+			(((std::is_same<Op, obf_expr_add>::value || std::is_same<Op, obf_expr_sub>::value || std::is_same<Op, obf_expr_mul>::value) && encoded_arithmetic<R>)
+			|| (std::is_same<Op, obf_expr_xor>::value && encoded_xor<R>));
+		//==/!= with the same obf_var<> type, and with obf_literal<>s (encoded at compile time), compare encoded values
+		using EncodedOps = obf_encoded_ops<typename Injection::return_type>;
+		template<class T2, T2 C2>
+		static constexpr ObfMatch<T_> literal_match = obf_match<T_>(typename std::make_unsigned<T2>::type(C2));//as obf_literal<>::value() is unsigned
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+		template<class T2, T2 C2>
+		static constexpr bool encoded_literal_comparison = true;
+		template<class T2, T2 C2>
+		static constexpr typename Injection::return_type encoded_literal = Injection::injection(T(literal_match<T2, C2>.x));
+#else
+		template<class T2, T2 C2>
+		static constexpr bool encoded_literal_comparison = false;//Injection can't be evaluated at compile time
+		template<class T2, T2 C2>
+		static constexpr typename Injection::return_type encoded_literal = 0;//never used
+#endif
+
+	public:
+		ITHARE_OBF_FORCEINLINE obf_var(T_ t ITHARE_OBF_SITE_LOC_PARAM) : val(Injection::injection(T(t))) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			Stats::encoded();
+		}
+		template<class T2,OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var(obf_var<T2, seed2, cycles2> t ITHARE_OBF_SITE_LOC_PARAM) : val(Injection::injection(T(T_(t.value())))) {//TODO: randomized injection implementation
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			Stats::encoded();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var(obf_literal<T2, C2, seed2, cycles2> t ITHARE_OBF_SITE_LOC_PARAM) : val(Injection::injection(T(T_(t.value())))) {//TODO: randomized injection implementation
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			Stats::encoded();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var(const obf_expr<T2, Op, L, R>& e ITHARE_OBF_SITE_LOC_PARAM) : val(expr_injection(e)) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			Stats::encoded();
+		}
+		ITHARE_OBF_FORCEINLINE obf_var& operator =(T_ t) {
+			Stats::encoded();
+			val = Injection::injection(T(t));//TODO: different implementations of the same injection in different contexts
+			return *this;
+		}
+		template<class T2,OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator =(obf_var<T2, seed2, cycles2> t) {
+			Stats::encoded();
+			val = Injection::injection(T(T_(t.value())));//TODO: different implementations of the same injection in different contexts
+			return *this;
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator =(obf_literal<T2, C2, seed2, cycles2> t) {
+			Stats::encoded();
+			val = Injection::injection(T(T_(t.value())));//TODO: different implementations of the same injection in different contexts
+			return *this;
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator =(const obf_expr<T2, Op, L, R>& e) {
+			Stats::encoded();
+			val = expr_injection(e);
+			return *this;
+		}
+		ITHARE_OBF_FORCEINLINE T_ value() const {
+			return Stats::decode([&] { return T_(Injection::surjection(val)); });
+		}
+
+		ITHARE_OBF_FORCEINLINE operator T_() const { return value(); }
+		ITHARE_OBF_FORCEINLINE obf_var& operator ++() { return *this += 1; }
+		ITHARE_OBF_FORCEINLINE obf_var& operator --() { return *this -= 1; }
+		ITHARE_OBF_FORCEINLINE obf_var operator++(int) { obf_var ret = *this; *this += 1; return ret; }
+		ITHARE_OBF_FORCEINLINE obf_var operator--(int) { obf_var ret = *this; *this -= 1; return ret; }
+
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator <(T2 t) { return value() < t; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator >(T2 t) { return value() > t; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator ==(T2 t) { return value() == t; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator !=(T2 t) { return value() != t; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator <=(T2 t) { return value() <= t; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE bool operator >=(T2 t) { return value() >= t; }
+
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator <(obf_var<T2, seed2, cycles2> t) {
+			return value() < t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator >(obf_var<T2, seed2, cycles2> t) {
+			return value() > t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator ==(obf_var<T2, seed2, cycles2> t) {
+			if constexpr(std::is_same<obf_var<T2, seed2, cycles2>, obf_var>::value)
+				return EncodedOps::equal(val, t.val);
+			else
+				return value() == t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator !=(obf_var<T2, seed2, cycles2> t) {
+			return !(*this == t);
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator <=(obf_var<T2, seed2, cycles2> t) {
+			return value() <= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator >=(obf_var<T2, seed2, cycles2> t) {
+			return value() >= t.value();
+		}
+
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator <(obf_literal<T2, C2, seed2, cycles2> t) {
+			return value() < t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator >(obf_literal<T2, C2, seed2, cycles2> t) {
+			return value() > t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator ==(obf_literal<T2, C2, seed2, cycles2> t) {
+			if constexpr(!encoded_literal_comparison<T2, C2>)
+				return value() == t.value();
+			else if constexpr(!literal_match<T2, C2>.exists)
+				return false;
+			else
+				return EncodedOps::equal(val, encoded_literal<T2, C2>);
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator !=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return !(*this == t);
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator <=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return value() <= t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE bool operator >=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return value() >= t.value();
+		}
+
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator +=(T2 t) {
+			if constexpr(encoded_arithmetic<T2>) {
+				Stats::encoded();
+				val = affine.encoded_add(val, T(t));
+			}
+			else
+				*this = value() + t;
+			return *this;
+		}
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator -=(T2 t) {
+			if constexpr(encoded_arithmetic<T2>) {
+				Stats::encoded();
+				val = affine.encoded_sub(val, T(t));
+			}
+			else
+				*this = value() - t;
+			return *this;
+		}
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator *=(T2 t) {
+			if constexpr(encoded_arithmetic<T2>) {
+				Stats::encoded();
+				val = affine.encoded_mul(val, T(t));
+			}
+			else
+				*this = value() * t;
+			return *this;
+		}
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator /=(T2 t) { *this = value() / t; return *this; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator %=(T2 t) { *this = value() % t; return *this; }
+
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator +=(obf_var<T2, seed2, cycles2> t) {
+			return *this += t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator -=(obf_var<T2, seed2, cycles2> t) {
+			return *this -= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator *=(obf_var<T2, seed2, cycles2> t) {
+			return *this *= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator /=(obf_var<T2, seed2, cycles2> t) {
+			return *this /= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator %=(obf_var<T2, seed2, cycles2> t) {
+			return *this %= t.value();
+		}
+
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator +=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this += t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator -=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this -= t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator *=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this *= t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator /=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this /= t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator %=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this %= t.value();
+		}
+
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator +=(const obf_expr<T2, Op, L, R>& e) {
+			return *this += e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator -=(const obf_expr<T2, Op, L, R>& e) {
+			return *this -= e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator *=(const obf_expr<T2, Op, L, R>& e) {
+			return *this *= e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator /=(const obf_expr<T2, Op, L, R>& e) {
+			return *this /= e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator %=(const obf_expr<T2, Op, L, R>& e) {
+			return *this %= e.value();
+		}
+
+		//binary operators return obf_expr<> (see above), regardless of Injection; the encoded fast paths (encoded_arithmetic/encoded_xor)
+		//  are in compound assignments, and in assignment of x+-*^integer back to the very same obf_var<> type (see expr_injection())
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_add, obf_var, T2> operator +(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_sub, obf_var, T2> operator -(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_mul, obf_var, T2> operator *(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_div, obf_var, T2> operator /(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_mod, obf_var, T2> operator %(T2 t) const { return { *this, t }; }
 
-	//version 0: identity
-	struct obf_literal_context_version0_descr {
-		static constexpr ObfDescriptor descr = ObfDescriptor(false, 0, 1);
-	};
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator &=(T2 t) { *this = value() & t; return *this; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator |=(T2 t) { *this = value() | t; return *this; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator ^=(T2 t) {
+			if constexpr(encoded_xor<T2>) {
+				Stats::encoded();
+				val = T(val ^ T(t));
+			}
+			else
+				*this = value() ^ t;
+			return *this;
+		}
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator <<=(T2 t) { *this = value() << t; return *this; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator >>=(T2 t) { *this = value() >> t; return *this; }
 
-	template<class T,OBFSEED seed>
-	struct ObfLiteralContext_version<0,T,seed> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		constexpr static OBFCYCLES context_cycles = obf_literal_context_version0_descr::descr.min_cycles;
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator &=(obf_var<T2, seed2, cycles2> t) {
+			return *this &= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator |=(obf_var<T2, seed2, cycles2> t) {
+			return *this |= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator ^=(obf_var<T2, seed2, cycles2> t) {
+			return *this ^= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator <<=(obf_var<T2, seed2, cycles2> t) {
+			return *this <<= t.value();
+		}
+		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator >>=(obf_var<T2, seed2, cycles2> t) {
+			return *this >>= t.value();
+		}
 
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return x;
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator &=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this &= t.value();
 		}
-		ITHARE_OBF_FORCEINLINE static constexpr T final_surjection(T y) {
-			return y;
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator |=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this |= t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator ^=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this ^= t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator <<=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this <<= t.value();
+		}
+		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
+		ITHARE_OBF_FORCEINLINE obf_var& operator >>=(obf_literal<T2, C2, seed2, cycles2> t) {
+			return *this >>= t.value();
 		}
 
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "ObfLiteralContext_version<0/*identity*/," << obf_dbgPrintT<T>() << ">" << std::endl;
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator &=(const obf_expr<T2, Op, L, R>& e) {
+			return *this &= e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator |=(const obf_expr<T2, Op, L, R>& e) {
+			return *this |= e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator ^=(const obf_expr<T2, Op, L, R>& e) {
+			return *this ^= e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator <<=(const obf_expr<T2, Op, L, R>& e) {
+			return *this <<= e.value();
+		}
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE obf_var& operator >>=(const obf_expr<T2, Op, L, R>& e) {
+			return *this >>= e.value();
 		}
-#endif
-	};
 
-	//version 1: global volatile constant
-	struct obf_literal_context_version1_descr {
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, 6, 100);
-	};
+		//for obf_var, obf_literal, obf_expr, and raw T2s alike (obf_expr_value() decodes them)
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_and, obf_var, T2> operator &(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_or, obf_var, T2> operator |(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_xor, obf_var, T2> operator ^(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_shl, obf_var, T2> operator <<(T2 t) const { return { *this, t }; }
+		template<class T2>
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_shr, obf_var, T2> operator >>(T2 t) const { return { *this, t }; }
+		ITHARE_OBF_FORCEINLINE obf_expr<T_, obf_expr_xor, obf_var, T_> operator ~() const { return { *this, T_(~T_(0)) }; }
 
-	template<class T, OBFSEED seed>
-	struct ObfLiteralContext_version<1,T,seed> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		constexpr static OBFCYCLES context_cycles = obf_literal_context_version1_descr::descr.min_cycles;
+		//hash of the encoded value (see std::hash<obf_var<>> below); consistent with ==, and needs no surjection
+		//  (mixed, as std::hash<> of an integer is the identity with libstdc++)
+		ITHARE_OBF_FORCEINLINE size_t encoded_hash() const {
+			return size_t(obf_hash_mix(EncodedOps::pack(val)));
+		}
 
-		//static constexpr T CC = obf_gen_const<T>(obf_compile_time_prng(seed, 1));
-		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
-		constexpr static T CC = obf_random_const<T>(obf_compile_time_prng(seed, 1), consts);
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return x + CC;
+		//wire transcoding (see obf_wire_writer<>/obf_wire_reader<>): from Injection straight to Wire's injection and back,
+		//  within one inlined expression
+		static constexpr size_t wire_size = sizeof(T);
+		template<class Wire>
+		ITHARE_OBF_FORCEINLINE void wire_store(uint8_t* p) const {
+			Stats::decode([&] { Wire::template store<T>(p, Injection::surjection(val)); });
 		}
-		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
-			return y - c;
+		template<class Wire>
+		ITHARE_OBF_FORCEINLINE void wire_load(const uint8_t* p) {
+			Stats::encoded();
+			val = Injection::injection(Wire::template load<T>(p));
 		}
 
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "ObfLiteralContext_version<1/*global volatile*/," << obf_dbgPrintT<T>() << "," << seed << ">: CC=" << obf_dbgPrintC(CC) << std::endl;
+			std::cout << std::string(offset, ' ') << prefix << "obf_var<" << obf_dbgPrintT<T>() << "," << seed <<","<<cycles<<">: site_cycles=" << site_cycles << std::endl;
+			Injection::dbgPrint(offset+1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_var", role);
+			w.number("size", sizeof(T));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.number("site_cycles", site_cycles);
+			w.resources(ObfJsonResources());
+			w.children();
+			Injection::dbgJson(w);
+			w.end();
 		}
 #endif
-	private:
-		static volatile T c;
-	};
 
-	template<class T, OBFSEED seed>
-	volatile T ObfLiteralContext_version<1, T, seed>::c = CC;
+	private:
+		template<class T2, class Op, class L, class R>
+		ITHARE_OBF_FORCEINLINE static typename Injection::return_type expr_injection(const obf_expr<T2, Op, L, R>& e) {
+			if constexpr(encoded_expr<Op, L, R>) {
+				auto y = e.left().val;
+				T k = T(e.right());
+				if constexpr(std::is_same<Op, obf_expr_add>::value)
+					return affine.encoded_add(y, k);
+				else if constexpr(std::is_same<Op, obf_expr_sub>::value)
+					return affine.encoded_sub(y, k);
+				else if constexpr(std::is_same<Op, obf_expr_mul>::value)
+					return affine.encoded_mul(y, k);
+				else
+					return T(y ^ k);
+			}
+			else
+				return Injection::injection(T(T_(e.value())));
+		}
 
-	//version 2: aliased pointers
-	struct obf_literal_context_version2_descr {
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, 20, 100);
+		typename Injection::return_type val;
 	};
 
-	template<class T>//TODO: randomize contents of the function
-	ITHARE_OBF_NOINLINE T obf_aliased_zero(T* x, T* y) {
-		*x = 0;
-		*y = 1;
-		return *x;
+	template<class T_, OBFSEED seed, OBFCYCLES cycles>
+	ITHARE_OBF_FORCEINLINE T_ obf_expr_value(const obf_var<T_, seed, cycles>& v) {
+		return v.value();
 	}
 
-	template<class T, OBFSEED seed>
-	struct ObfLiteralContext_version<2,T,seed> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		constexpr static OBFCYCLES context_cycles = obf_literal_context_version2_descr::descr.min_cycles;
+	//obf_array: N integers sharing one injection, which is applied lane-wise
+	//  the injection is a flat plan (see obf_flat_injection) with its main chain restricted to versions which vectorize directly:
+	//  0 (identity in var context), 1 (add), 2 (Feistel), 4 (mul by odd), 7 (xor); version 4 literals are decoded (in scalar) once per bulk call
+	//  get()/set() go via scalar obf_flat_chain<>, load_range()/store_range() - via SIMD kernels (with exactly the same results)
+	constexpr uint32_t obf_array_versions = (uint32_t(1) << 0) | (uint32_t(1) << 1) | (uint32_t(1) << 2) | (uint32_t(1) << 4) | (uint32_t(1) << 7);
 
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return x;
+	ITHARE_OBF_SIMD_DIAGNOSTIC_PUSH
+#ifdef ITHARE_OBF_SIMD
+	//SIMD primitives; all ops are lane-wise, with lanes of T
+	template<class T>
+	struct obf_simd_sse2 {
+		using vec = __m128i;
+		static constexpr size_t lanes = sizeof(vec) / sizeof(T);
+
+		ITHARE_OBF_SIMD_INLINE static vec load(const void* p) {
+			return _mm_loadu_si128((const __m128i*)p);
 		}
-		ITHARE_OBF_FORCEINLINE static /*non-constexpr*/ T final_surjection(T y) {
-			T x, yy;
-			T z = obf_aliased_zero(&x, &yy);
-			return y - z;
+		//lane by lane: unlike load(), doesn't stall on store forwarding right after p[] has been written element by element
+		ITHARE_OBF_SIMD_INLINE static vec load_lanes(const T* p) {
+			static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+			if constexpr(sizeof(T) == 4)
+				return _mm_setr_epi32(int(p[0]), int(p[1]), int(p[2]), int(p[3]));
+			else
+				return _mm_set_epi64x((long long)p[1], (long long)p[0]);
 		}
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "ObfLiteralContext_version<2/*func with aliased pointers*/," << obf_dbgPrintT<T>() << "," << seed << ">:" << std::endl;
+		ITHARE_OBF_SIMD_INLINE static void store(void* p, vec x) {
+			_mm_storeu_si128((__m128i*)p, x);
+		}
+		ITHARE_OBF_SIMD_INLINE static vec set1(T c) {
+			if constexpr(sizeof(T) == 1)
+				return _mm_set1_epi8(char(c));
+			else if constexpr(sizeof(T) == 2)
+				return _mm_set1_epi16(short(c));
+			else if constexpr(sizeof(T) == 4)
+				return _mm_set1_epi32(int(c));
+			else
+				return _mm_set1_epi64x((long long)c);
+		}
+		ITHARE_OBF_SIMD_INLINE static vec and_(vec a, vec b) {
+			return _mm_and_si128(a, b);
+		}
+		ITHARE_OBF_SIMD_INLINE static vec xor_(vec a, vec b) {
+			return _mm_xor_si128(a, b);
+		}
+		ITHARE_OBF_SIMD_INLINE static vec add(vec a, vec b) {
+			if constexpr(sizeof(T) == 1)
+				return _mm_add_epi8(a, b);
+			else if constexpr(sizeof(T) == 2)
+				return _mm_add_epi16(a, b);
+			else if constexpr(sizeof(T) == 4)
+				return _mm_add_epi32(a, b);
+			else
+				return _mm_add_epi64(a, b);
+		}
+		ITHARE_OBF_SIMD_INLINE static vec sub(vec a, vec b) {
+			if constexpr(sizeof(T) == 1)
+				return _mm_sub_epi8(a, b);
+			else if constexpr(sizeof(T) == 2)
+				return _mm_sub_epi16(a, b);
+			else if constexpr(sizeof(T) == 4)
+				return _mm_sub_epi32(a, b);
+			else
+				return _mm_sub_epi64(a, b);
+		}
+		ITHARE_OBF_SIMD_INLINE static vec mul(vec a, vec b) {//modulo 2^bits, as for unsigned T
+			if constexpr(sizeof(T) == 1) {//no 8-bit multiplication in SSE2; even and odd bytes separately
+				vec even = _mm_mullo_epi16(a, b);
+				vec odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+				return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0xFF)), _mm_slli_epi16(odd, 8));
+			}
+			else if constexpr(sizeof(T) == 2)
+				return _mm_mullo_epi16(a, b);
+			else if constexpr(sizeof(T) == 4) {//no _mm_mullo_epi32() in SSE2
+				vec p02 = _mm_mul_epu32(a, b);
+				vec p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+				return _mm_unpacklo_epi32(_mm_shuffle_epi32(p02, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(p13, _MM_SHUFFLE(0, 0, 2, 0)));
+			}
+			else {
+				vec cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+				return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+			}
+		}
+		template<int bits>
+		ITHARE_OBF_SIMD_INLINE static vec sll(vec x) {
+			static_assert(sizeof(T) > 1);
+			if constexpr(sizeof(T) == 2)
+				return _mm_slli_epi16(x, bits);
+			else if constexpr(sizeof(T) == 4)
+				return _mm_slli_epi32(x, bits);
+			else
+				return _mm_slli_epi64(x, bits);
+		}
+		template<int bits>
+		ITHARE_OBF_SIMD_INLINE static vec srl(vec x) {
+			static_assert(sizeof(T) > 1);
+			if constexpr(sizeof(T) == 2)
+				return _mm_srli_epi16(x, bits);
+			else if constexpr(sizeof(T) == 4)
+				return _mm_srli_epi32(x, bits);
+			else
+				return _mm_srli_epi64(x, bits);
+		}
+		//for x < 2^(bits/2): halfT(x*x) and halfT(abs(signed halfT(x))), as in obf_randomized_non_reversible_function_version<>
+		ITHARE_OBF_SIMD_INLINE static vec square_half(vec x) {
+			static_assert(sizeof(T) > 1);
+			if constexpr(sizeof(T) == 2)
+				return _mm_and_si128(_mm_mullo_epi16(x, x), _mm_set1_epi16(0xFF));
+			else if constexpr(sizeof(T) == 4)
+				return _mm_mullo_epi16(x, x);//upper 16-bit halves are 0*0
+			else
+				return _mm_and_si128(_mm_mul_epu32(x, x), _mm_set1_epi64x(0xFFFFFFFF));
+		}
+		ITHARE_OBF_SIMD_INLINE static vec abs_half(vec x) {//as upper halves are zeros, half-sized ops leave them alone
+			static_assert(sizeof(T) > 1);
+			vec zero = _mm_setzero_si128();
+			if constexpr(sizeof(T) == 2) {
+				vec m = _mm_cmpgt_epi8(zero, x);
+				return _mm_sub_epi8(_mm_xor_si128(x, m), m);
+			}
+			else if constexpr(sizeof(T) == 4) {
+				vec m = _mm_cmpgt_epi16(zero, x);
+				return _mm_sub_epi16(_mm_xor_si128(x, m), m);
+			}
+			else {
+				vec m = _mm_cmpgt_epi32(zero, x);
+				return _mm_sub_epi32(_mm_xor_si128(x, m), m);
+			}
 		}
-#endif
 	};
 
-	//version 3: Windows/PEB
-	struct obf_literal_context_version3_descr {
-#if defined(_MSC_VER) && defined(ITHARE_OBF_INIT) && !defined(ITHARE_OBF_NO_ANTI_DEBUG)
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, 10, 100);
-#else
-		static constexpr ObfDescriptor descr = ObfDescriptor(false, 0, 0);
-#endif
+#ifndef ITHARE_OBF_NO_AVX2
+	//IMPORTANT: semantics MUST be the same as for obf_simd_sse2<>
+	template<class T>
+	struct obf_simd_avx2 {
+		using vec = __m256i;
+		static constexpr size_t lanes = sizeof(vec) / sizeof(T);
+
+		ITHARE_OBF_AVX2_INLINE static vec load(const void* p) {
+			return _mm256_loadu_si256((const __m256i*)p);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec load_lanes(const T* p) {
+			static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+			if constexpr(sizeof(T) == 4)
+				return _mm256_setr_epi32(int(p[0]), int(p[1]), int(p[2]), int(p[3]), int(p[4]), int(p[5]), int(p[6]), int(p[7]));
+			else
+				return _mm256_setr_epi64x((long long)p[0], (long long)p[1], (long long)p[2], (long long)p[3]);
+		}
+		ITHARE_OBF_AVX2_INLINE static void store(void* p, vec x) {
+			_mm256_storeu_si256((__m256i*)p, x);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec set1(T c) {
+			if constexpr(sizeof(T) == 1)
+				return _mm256_set1_epi8(char(c));
+			else if constexpr(sizeof(T) == 2)
+				return _mm256_set1_epi16(short(c));
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_set1_epi32(int(c));
+			else
+				return _mm256_set1_epi64x((long long)c);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec and_(vec a, vec b) {
+			return _mm256_and_si256(a, b);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec xor_(vec a, vec b) {
+			return _mm256_xor_si256(a, b);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec add(vec a, vec b) {
+			if constexpr(sizeof(T) == 1)
+				return _mm256_add_epi8(a, b);
+			else if constexpr(sizeof(T) == 2)
+				return _mm256_add_epi16(a, b);
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_add_epi32(a, b);
+			else
+				return _mm256_add_epi64(a, b);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec sub(vec a, vec b) {
+			if constexpr(sizeof(T) == 1)
+				return _mm256_sub_epi8(a, b);
+			else if constexpr(sizeof(T) == 2)
+				return _mm256_sub_epi16(a, b);
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_sub_epi32(a, b);
+			else
+				return _mm256_sub_epi64(a, b);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec mul(vec a, vec b) {
+			if constexpr(sizeof(T) == 1) {
+				vec even = _mm256_mullo_epi16(a, b);
+				vec odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+				return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0xFF)), _mm256_slli_epi16(odd, 8));
+			}
+			else if constexpr(sizeof(T) == 2)
+				return _mm256_mullo_epi16(a, b);
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_mullo_epi32(a, b);
+			else {//no 64-bit multiplication before AVX-512
+				vec cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+				return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+			}
+		}
+		template<int bits>
+		ITHARE_OBF_AVX2_INLINE static vec sll(vec x) {
+			static_assert(sizeof(T) > 1);
+			if constexpr(sizeof(T) == 2)
+				return _mm256_slli_epi16(x, bits);
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_slli_epi32(x, bits);
+			else
+				return _mm256_slli_epi64(x, bits);
+		}
+		template<int bits>
+		ITHARE_OBF_AVX2_INLINE static vec srl(vec x) {
+			static_assert(sizeof(T) > 1);
+			if constexpr(sizeof(T) == 2)
+				return _mm256_srli_epi16(x, bits);
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_srli_epi32(x, bits);
+			else
+				return _mm256_srli_epi64(x, bits);
+		}
+		ITHARE_OBF_AVX2_INLINE static vec square_half(vec x) {
+			static_assert(sizeof(T) > 1);
+			if constexpr(sizeof(T) == 2)
+				return _mm256_and_si256(_mm256_mullo_epi16(x, x), _mm256_set1_epi16(0xFF));
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_mullo_epi16(x, x);
+			else
+				return _mm256_and_si256(_mm256_mul_epu32(x, x), _mm256_set1_epi64x(0xFFFFFFFF));
+		}
+		ITHARE_OBF_AVX2_INLINE static vec abs_half(vec x) {
+			static_assert(sizeof(T) > 1);
+			if constexpr(sizeof(T) == 2)
+				return _mm256_abs_epi8(x);
+			else if constexpr(sizeof(T) == 4)
+				return _mm256_abs_epi16(x);
+			else
+				return _mm256_abs_epi32(x);
+		}
 	};
 
+	inline bool obf_cpu_has_avx2_detect() {
 #ifdef _MSC_VER
-	extern volatile uint8_t* obf_peb;
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)//OSXSAVE, AVX
+			return false;
+		if ((_xgetbv(0) & 6) != 6)//XMM and YMM states are saved by OS
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+	inline bool obf_cpu_has_avx2() {
+		static const bool ret = obf_cpu_has_avx2_detect();
+		return ret;
+	}
+#endif//ITHARE_OBF_NO_AVX2
+
+	template<class T, class Plan, size_t idx>
+	struct obf_array_step {//lane-wise obf_flat_step<>
+		static constexpr ObfFlatNode node = Plan::plan.nodes[idx];
+		static_assert(node.which == 0 || node.which == 1 || node.which == 2 || node.which == 4 || node.which == 7);
+		static_assert(node.which != 0 || node.ctx_which == 0);//var context => identity
+		constexpr static int halfTBits = sizeof(T) * 4;
+		constexpr static T halfMask = T((T(1) << halfTBits) - 1);
+
+		ITHARE_OBF_FORCEINLINE static T multiplier() {//version 4: x * multiplier() is the same as obf_flat_step<>::injection(x)
+			if constexpr(node.which == 4) {
+				using Literal = obf_flat_chain<T, Plan, node.lo>;
+				constexpr typename Literal::return_type val = Literal::injection(T(node.cinv));
+				return Literal::surjection(val);
+			}
+			else
+				return 0;
+		}
 
-	template<class T, OBFSEED seed>
-	struct ObfLiteralContext_version<3,T,seed> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		constexpr static OBFCYCLES context_cycles = obf_literal_context_version3_descr::descr.min_cycles;
+		//NB: in place (via references): a non-target("avx2") function which takes or returns __m256i by value is an ABI change,
+		//  reported by GCC (-Wpsabi) at the very end of translation unit, where no diagnostic push/pop can reach it
+		template<class V>
+		ITHARE_OBF_SIMD_INLINE static void injection(typename V::vec& x, const typename V::vec& mul) {
+			if constexpr(node.which == 0)
+				return;
+			else if constexpr(node.which == 1) {
+				if constexpr(node.neg)
+					x = V::sub(V::set1(T(node.c)), x);
+				else
+					x = V::add(x, V::set1(T(node.c)));
+			}
+			else if constexpr(node.which == 2) {
+				typename V::vec lo = V::template srl<halfTBits>(x);
+				typename V::vec flo = lo;
+				f<V>(flo);
+				typename V::vec hi = V::add(x, flo);
+				x = V::add(V::template sll<halfTBits>(hi), lo);
+			}
+			else if constexpr(node.which == 7)
+				x = V::xor_(x, V::set1(T(node.c)));
+			else
+				x = V::mul(x, mul);
+		}
+		template<class V>
+		ITHARE_OBF_SIMD_INLINE static void surjection(typename V::vec& y) {
+			if constexpr(node.which == 0)
+				return;
+			else if constexpr(node.which == 1) {
+				if constexpr(node.neg)
+					y = V::sub(V::set1(T(node.c)), y);
+				else
+					y = V::sub(y, V::set1(T(node.c)));
+			}
+			else if constexpr(node.which == 2) {
+				typename V::vec mask = V::set1(halfMask);
+				typename V::vec flo = V::and_(y, mask);
+				f<V>(flo);
+				typename V::vec z = V::and_(V::sub(V::template srl<halfTBits>(y), flo), mask);
+				y = V::add(z, V::template sll<halfTBits>(y));
+			}
+			else if constexpr(node.which == 7)
+				y = V::xor_(y, V::set1(T(node.c)));
+			else
+				mul_const<V, T(node.c)>(y);
+		}
 
-		//static constexpr T CC = obf_gen_const<T>(obf_compile_time_prng(seed, 1));
-		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
-		constexpr static T CC = obf_random_const<T>(obf_compile_time_prng(seed, 1), consts);
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return x + CC;
+	private:
+		static constexpr int log2_exact(T c) {//-1 if c is not a power of 2
+			for (int i = 0; i < int(sizeof(T) * 8); ++i)
+				if (c == T(T(1) << i))
+					return i;
+			return -1;
 		}
-		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
-#ifdef ITHARE_OBF_DEBUG_ANTI_DEBUG_ALWAYS_FALSE
-			return y - CC;
+		template<class V, T C>
+		ITHARE_OBF_SIMD_INLINE static void mul_const(typename V::vec& x) {
+			//all OBF_CONST_X are of the form 2^k+-1, or their products (and SIMD multiplications are expensive, especially in SSE2)
+			if constexpr(sizeof(T) == 1)//no 8-bit shifts either
+				x = V::mul(x, V::set1(C));
+			else if constexpr(log2_exact(T(C - 1)) > 0)
+				x = V::add(V::template sll<log2_exact(T(C - 1))>(x), x);
+			else if constexpr(log2_exact(T(C + 1)) > 0)
+				x = V::sub(V::template sll<log2_exact(T(C + 1))>(x), x);
+			else if constexpr(C % 5 == 0) {
+				mul_const<V, T(5)>(x);
+				mul_const<V, T(C / 5)>(x);
+			}
+			else if constexpr(C % 3 == 0) {
+				mul_const<V, T(3)>(x);
+				mul_const<V, T(C / 3)>(x);
+			}
+			else
+				x = V::mul(x, V::set1(C));
+		}
+		template<class V>
+		ITHARE_OBF_SIMD_INLINE static void f(typename V::vec& lo) {//obf_randomized_non_reversible_function_version<node.fwhich,halfT>
+			if constexpr(node.fwhich == 0)
+				return;
+			else if constexpr(node.fwhich == 1)
+				lo = V::square_half(lo);
+			else {
+				static_assert(node.fwhich == 2);
+				lo = V::abs_half(lo);
+			}
+		}
+	};
+#endif//ITHARE_OBF_SIMD
+
+	template<class T, class Plan, class Indexes = std::make_index_sequence<Plan::plan.chains[0].end - Plan::plan.chains[0].begin>>
+	struct obf_array_kernel;
+
+	template<class T, class Plan, size_t... I>
+	struct obf_array_kernel<T, Plan, std::index_sequence<I...>> {
+		static constexpr size_t begin = Plan::plan.chains[0].begin;
+		static constexpr size_t n = sizeof...(I);
+		using Scalar = obf_flat_chain<T, Plan, 0>;
+		static_assert(std::is_same<typename Scalar::return_type, T>::value);
+
+		//Src and Dst are T or its signed counterpart (which are loaded/stored by SIMD ops in exactly the same way)
+		template<class Src, class Dst>
+		ITHARE_OBF_FORCEINLINE static void injection_range(const Src* src, Dst* dst, size_t count) {
+#ifdef ITHARE_OBF_SIMD
+#ifndef ITHARE_OBF_NO_AVX2
+			if (obf_cpu_has_avx2()) {
+				injection_range_avx2(src, dst, count);
+				return;
+			}
+#endif
+			injection_range_sse2(src, dst, count);
 #else
-			return y - CC * (1 + obf_peb[2]);
+			injection_range_scalar(src, dst, count);
 #endif
 		}
-
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "ObfLiteralContext_version<3/*PEB*/," << obf_dbgPrintT<T>() << "," << seed << ">: CC=" << obf_dbgPrintC(CC) << std::endl;
-		}
+		template<class Src, class Dst>
+		ITHARE_OBF_FORCEINLINE static void surjection_range(const Src* src, Dst* dst, size_t count) {
+#ifdef ITHARE_OBF_SIMD
+#ifndef ITHARE_OBF_NO_AVX2
+			if (obf_cpu_has_avx2()) {
+				surjection_range_avx2(src, dst, count);
+				return;
+			}
 #endif
-	};
+			surjection_range_sse2(src, dst, count);
+#else
+			surjection_range_scalar(src, dst, count);
 #endif
+		}
 
-	//version 4: global var-with-invariant
-	struct obf_literal_context_version4_descr {
-		static constexpr ObfDescriptor descr = ObfDescriptor(true, 100, 100);
-			//yes, it is up 100+ cycles now (due to worst-case MT caching issues)
-			//TODO: move invariant to thread_local, something else?
-	};
-
-	template<class T, OBFSEED seed>
-	struct ObfLiteralContext_version<4, T, seed> {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		constexpr static OBFCYCLES context_cycles = obf_literal_context_version4_descr::descr.min_cycles;
-
-		static constexpr std::array<T, 3> consts = { OBF_CONST_A,OBF_CONST_B,OBF_CONST_C };
-		static constexpr T PREMODRNDCONST = obf_random_const<T>(obf_compile_time_prng(seed, 2), consts);//TODO: check which constants we want
-		static constexpr T PREMODMASK = (T(1) << (sizeof(T) * 4)) - 1;
-		static constexpr T PREMOD = PREMODRNDCONST & PREMODMASK;
-		static constexpr T MOD = PREMOD == 0 ? 100 : PREMOD;//remapping 'bad value' 0 to 'something'
-		static constexpr T CC = obf_weak_random(obf_compile_time_prng(seed, 2),MOD);
-
-		static constexpr T MAXMUL1 = T(-1)/MOD;
-		static constexpr auto MAXMUL1_ADJUSTED0 = obf_sqrt_very_rough_approximation(MAXMUL1);
-		static_assert(MAXMUL1_ADJUSTED0 < T(-1));
-		static constexpr T MAXMUL1_ADJUSTED = (T)MAXMUL1_ADJUSTED0;
-		static constexpr T MUL1 = MAXMUL1 > 2 ? 1+obf_weak_random(obf_compile_time_prng(seed, 2), MAXMUL1_ADJUSTED) : 1;
-		static constexpr T DELTA = MUL1 * MOD;
-		static_assert(DELTA / MUL1 == MOD);//overflow check
+		//each of the paths on its own (injection_range()/surjection_range() dispatch between them);
+		//  public for checks of the SIMD paths against the scalar one (see test/seeds/seed_sweep.cpp)
+		template<class Src, class Dst>
+		ITHARE_OBF_FORCEINLINE static void injection_range_scalar(const Src* src, Dst* dst, size_t count) {
+			for (size_t i = 0; i < count; ++i)
+				dst[i] = Dst(Scalar::injection(T(src[i])));
+		}
+		template<class Src, class Dst>
+		ITHARE_OBF_FORCEINLINE static void surjection_range_scalar(const Src* src, Dst* dst, size_t count) {
+			for (size_t i = 0; i < count; ++i)
+				dst[i] = Dst(Scalar::surjection(T(src[i])));
+		}
 
-		static constexpr T MAXMUL2 = T(-1) / DELTA;
-		static constexpr T MUL2 = MAXMUL2 > 2 ? 1+obf_weak_random(obf_compile_time_prng(seed, 3), MAXMUL2) : 1;
-		static constexpr T DELTAMOD = MUL2 * MOD;
-		static_assert(DELTAMOD / MUL2 == MOD);//overflow check
+#ifdef ITHARE_OBF_SIMD
+		//single-vector in-place surjection; to be called from within ITHARE_OBF_SIMD_ENTRY/ITHARE_OBF_AVX2_ENTRY functions only
+		template<class V>
+		ITHARE_OBF_SIMD_INLINE static void surjection_vec(typename V::vec& y) {
+			(obf_array_step<T, Plan, begin + n - 1 - I>::template surjection<V>(y), ...);
+		}
+		//in-place injection/surjection of N vectors at once, step by step (so that N independent chains are interleaved),
+		//  with version 4 literals decoded once per call; same restrictions as for surjection_vec()
+		template<class V, size_t N>
+		ITHARE_OBF_SIMD_INLINE static void injection_vecs(typename V::vec (&x)[N]) {
+			typename V::vec muls[n] = { V::set1(obf_array_step<T, Plan, begin + I>::multiplier())... };
+			(injection_step_vecs<V, begin + I>(x, muls[I], std::make_index_sequence<N>()), ...);
+		}
+		template<class V, size_t N>
+		ITHARE_OBF_SIMD_INLINE static void surjection_vecs(typename V::vec (&y)[N]) {
+			(surjection_step_vecs<V, begin + n - 1 - I>(y, std::make_index_sequence<N>()), ...);
+		}
 
-		static constexpr T PREMUL3 = obf_weak_random(obf_compile_time_prng(seed, 3), MUL2);
-		static constexpr T MUL3 = PREMUL3 > 0 ? PREMUL3 : 1;
-		static constexpr T CC0 = ( CC + MUL3 * MOD ) % DELTAMOD;
+	private:
+		template<class V, size_t idx, size_t N, size_t... J>
+		ITHARE_OBF_SIMD_INLINE static void injection_step_vecs(typename V::vec (&x)[N], const typename V::vec& mul, std::index_sequence<J...>) {
+			(obf_array_step<T, Plan, idx>::template injection<V>(x[J], mul), ...);
+		}
+		template<class V, size_t idx, size_t N, size_t... J>
+		ITHARE_OBF_SIMD_INLINE static void surjection_step_vecs(typename V::vec (&y)[N], std::index_sequence<J...>) {
+			(obf_array_step<T, Plan, idx>::template surjection<V>(y[J]), ...);
+		}
 
-		static_assert((CC0 + DELTA) % MOD == CC);
-		static constexpr bool test_n_iterations(T x, int n) {
-			assert(x%MOD == CC);
-			if (n == 0)
-				return true;
-			T newC = (x + DELTA) % DELTAMOD;
-			assert(newC%MOD == CC);
-			return test_n_iterations(newC,n-1);
+		template<class V, class Src, class Dst>
+		ITHARE_OBF_SIMD_INLINE static void injection_lanes(const Src* src, Dst* dst, size_t count) {
+			typename V::vec muls[n] = { V::set1(obf_array_step<T, Plan, begin + I>::multiplier())... };
+			size_t i = 0;
+			for (; i + V::lanes <= count; i += V::lanes) {
+				typename V::vec x = V::load(src + i);
+				(obf_array_step<T, Plan, begin + I>::template injection<V>(x, muls[I]), ...);
+				V::store(dst + i, x);
+			}
+			for (; i < count; ++i)
+				dst[i] = Dst(Scalar::injection(T(src[i])));
+		}
+		template<class V, class Src, class Dst>
+		ITHARE_OBF_SIMD_INLINE static void surjection_lanes(const Src* src, Dst* dst, size_t count) {
+			size_t i = 0;
+			for (; i + V::lanes <= count; i += V::lanes) {
+				typename V::vec y = V::load(src + i);
+				surjection_vec<V>(y);
+				V::store(dst + i, y);
+			}
+			for (; i < count; ++i)
+				dst[i] = Dst(Scalar::surjection(T(src[i])));
 		}
-		static_assert(test_n_iterations(CC0, ITHARE_OBF_COMPILE_TIME_TESTS));//test only
 
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return x + CC;
+	public:
+		template<class Src, class Dst>
+		ITHARE_OBF_SIMD_ENTRY static void injection_range_sse2(const Src* src, Dst* dst, size_t count) {
+			injection_lanes<obf_simd_sse2<T>>(src, dst, count);
 		}
-		ITHARE_OBF_FORCEINLINE static T final_surjection(T y) {
-			//{MT-related:
-			T newC = (c+DELTA)%DELTAMOD;
-			c = newC;
-			//}MT-related
-			assert(c%MOD == CC);
-			return y - (c%MOD);
+		template<class Src, class Dst>
+		ITHARE_OBF_SIMD_ENTRY static void surjection_range_sse2(const Src* src, Dst* dst, size_t count) {
+			surjection_lanes<obf_simd_sse2<T>>(src, dst, count);
 		}
-
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "ObfLiteralContext_version<4/*global volatile var-with-invariant*/," << obf_dbgPrintT<T>() << "," << seed << ">: CC=" << obf_dbgPrintC(CC) << std::endl;
+#ifndef ITHARE_OBF_NO_AVX2
+		template<class Src, class Dst>
+		ITHARE_OBF_AVX2_ENTRY static void injection_range_avx2(const Src* src, Dst* dst, size_t count) {
+			injection_lanes<obf_simd_avx2<T>>(src, dst, count);
+		}
+		template<class Src, class Dst>
+		ITHARE_OBF_AVX2_ENTRY static void surjection_range_avx2(const Src* src, Dst* dst, size_t count) {
+			surjection_lanes<obf_simd_avx2<T>>(src, dst, count);
 		}
 #endif
-	private:
-#ifdef ITHARE_OBF_STRICT_MT
-		static std::atomic<T> c;
-#else
-		static volatile T c;
-#endif
+#endif//ITHARE_OBF_SIMD
 	};
+	ITHARE_OBF_SIMD_DIAGNOSTIC_POP
 
-#ifdef ITHARE_OBF_STRICT_MT
-	template<class T, OBFSEED seed>
-	std::atomic<T> ObfLiteralContext_version<4, T, seed>::c = CC0;
-#else
-	template<class T, OBFSEED seed>
-	volatile T ObfLiteralContext_version<4, T, seed>::c = CC0;
-#endif
+	//obf_array
+	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_array_dbg<>
+	template<class T_, size_t N, OBFSEED seed, OBFCYCLES cycles>
+	class obf_array {
+		static_assert(std::is_integral<T_>::value);
+		static_assert(N > 0);
+		using T = typename std::make_unsigned<T_>::type;//from this point on, unsigned only
+		using U = typename obf_flat_uint<sizeof(T)>::type;
+		static constexpr OBFCYCLES site_cycles = obf_site_cycles(seed, cycles);
 
-	//ObfZeroLiteralContext
-	template<class T>
-	struct ObfZeroLiteralContext {
-		//same as ObfLiteralContext_version<0,...> but with additional stuff to make it suitable for use as Context parameter to injections
-		constexpr static OBFCYCLES context_cycles = 0;
-		constexpr static OBFCYCLES calc_cycles(OBFCYCLES inj, OBFCYCLES surj) {
-			return surj;//for literals, ONLY surjection costs apply in runtime (as injection applies in compile-time)
+		using Context = ObfVarContext<T, obf_compile_time_prng(seed, 1), site_cycles>;
+		static constexpr ObfFlatContext ctx = obf_flat_context_of<Context>::value;
+		using Plan = obf_flat_plan<sizeof(T), ctx.kind, ctx.seed, ctx.cycles, obf_compile_time_prng(seed, 2), site_cycles, size_t(-1), obf_array_versions>;
+		using Kernel = obf_array_kernel<U, Plan>;
+		using Injection = typename Kernel::Scalar;
+		using Stats = obf_site_stats<obf_array, ObfSiteKind::array, sizeof(T), seed, cycles, site_cycles>;
+
+	public:
+		using kernel_type = Kernel;//encoded elements are typename kernel_type::Scalar::return_type; not in obf_array_dbg<>
+		ITHARE_OBF_FORCEINLINE obf_array(ITHARE_OBF_SITE_LOC_PARAM0) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			fill(0);
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr size_t size() {
+			return N;
+		}
+		ITHARE_OBF_FORCEINLINE T_ get(size_t i) const {
+			assert(i < N);
+			return Stats::decode([&] { return T_(Injection::surjection(vals[i])); });
+		}
+		ITHARE_OBF_FORCEINLINE void set(size_t i, T_ t) {
+			assert(i < N);
+			Stats::encoded();
+			vals[i] = Injection::injection(U(T(t)));
+		}
+		ITHARE_OBF_FORCEINLINE T_ operator[](size_t i) const {
+			return get(i);
+		}
+		ITHARE_OBF_FORCEINLINE void fill(T_ t) {
+			Stats::encoded();
+			vals.fill(Injection::injection(U(T(t))));
 		}
-		constexpr static OBFCYCLES literal_cycles = 0;
-		template<class T,T C,OBFSEED seed>
-		struct literal {
-			using type = obf_literal_ctx<T, C, ObfZeroLiteralContext<T>, seed, literal_cycles>;
-		};
 
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return x;
+		//bulk operations: [first,first+count) elements of the array <-> dst[0..count) / src[0..count)
+		ITHARE_OBF_FORCEINLINE void load_range(size_t first, size_t count, T_* dst) const {
+			assert(first <= N && count <= N - first);
+			Stats::decode([&] { Kernel::surjection_range(vals.data() + first, dst, count); }, count);
 		}
-		ITHARE_OBF_FORCEINLINE static constexpr T final_surjection(T y) {
-			return y;
+		ITHARE_OBF_FORCEINLINE void store_range(size_t first, size_t count, const T_* src) {
+			assert(first <= N && count <= N - first);
+			Stats::encoded(count);
+			Kernel::injection_range(src, vals.data() + first, count);
 		}
 
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "ObfZeroContext<" << obf_dbgPrintT<T>() << ">" << std::endl;
+			std::cout << std::string(offset, ' ') << prefix << "obf_array<" << obf_dbgPrintT<T>() << "," << N << "," << seed << "," << cycles << ">: site_cycles=" << site_cycles << " nodes=" << Plan::plan.n_nodes << "/" << Plan::count.nodes << " chains=" << Plan::plan.n_chains << "/" << Plan::count.chains << std::endl;
+			obf_flat_dbgPrintChain<Plan>(0, offset + 1, "");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_array", role);
+			w.number("size", sizeof(T));
+			w.unumber("N", N);
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.number("site_cycles", site_cycles);
+			w.unumber("nodes", Plan::plan.n_nodes);
+			w.unumber("chains", Plan::plan.n_chains);
+			w.resources(ObfJsonResources());
+			w.children();
+			obf_flat_dbgJsonChain<Plan, 0>(w);
+			w.end();
 		}
 #endif
-	};
-	template<class T, class T0, OBFSEED seed, OBFCYCLES cycles>
-	struct ObfRecursiveContext<T, ObfZeroLiteralContext<T0>, seed, cycles> {
-		using recursive_context_type = ObfZeroLiteralContext<T>;
-		using intermediate_context_type = ObfZeroLiteralContext<T>;
+
+	private:
+		std::array<U, N> vals;
 	};
 
-	//ObfLiteralContext
-	template<class T, OBFSEED seed, OBFCYCLES cycles>
-	class ObfLiteralContext {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
-		constexpr static std::array<ObfDescriptor, 5> descr{
-			obf_literal_context_version0_descr::descr,
-			obf_literal_context_version1_descr::descr,
-			obf_literal_context_version2_descr::descr,
-			obf_literal_context_version3_descr::descr,
-			obf_literal_context_version4_descr::descr,
+	//obf_vector_columns: storage of obf_vector<>, one dense std::vector<> per integral leaf of Injection::return_type
+	//  i.e. lo/hi halves of obf_injection_version<5> (and of its flat counterpart) go to separate arrays, recursively
+	template<class R, bool leaf = std::is_integral<R>::value>
+	struct obf_vector_columns {
+		std::vector<R> col;
+
+		//raw pointers, for bulk loops (so that std::vector<>'s pointers are not re-read after each store)
+		struct reader {
+			const R* p;
+			ITHARE_OBF_FORCEINLINE R get(size_t i) const { return p[i]; }
 		};
-		constexpr static size_t which = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
-		using WhichType = ObfLiteralContext_version<which, T, seed>;
+		struct writer {
+			R* p;
+			ITHARE_OBF_FORCEINLINE void set(size_t i, R r) const { p[i] = r; }
+		};
+		ITHARE_OBF_FORCEINLINE reader read() const { return reader{ col.data() }; }
+		ITHARE_OBF_FORCEINLINE writer write() { return writer{ col.data() }; }
+
+		ITHARE_OBF_FORCEINLINE R get(size_t i) const { return col[i]; }
+		ITHARE_OBF_FORCEINLINE void set(size_t i, R r) { col[i] = r; }
+		ITHARE_OBF_FORCEINLINE void push_back(R r) { col.push_back(r); }
+		void pop_back() { col.pop_back(); }
+		void resize(size_t n, R r) { col.resize(n, r); }
+		void fill(R r) { std::fill(col.begin(), col.end(), r); }
+		void reserve(size_t n) { col.reserve(n); }
+		void shrink_to_fit() { col.shrink_to_fit(); }
+		void clear() { col.clear(); }
+		void swap(obf_vector_columns& other) { col.swap(other.col); }
+		size_t size() const { return col.size(); }
+		size_t capacity() const { return col.capacity(); }
+		static constexpr size_t columns = 1;
+	};
+	template<class R>
+	struct obf_vector_columns<R, false> {
+		using Lo = decltype(R::lo);
+		using Hi = decltype(R::hi);
+		obf_vector_columns<Lo> lo;
+		obf_vector_columns<Hi> hi;
+
+		struct reader {
+			typename obf_vector_columns<Lo>::reader lo;
+			typename obf_vector_columns<Hi>::reader hi;
+			ITHARE_OBF_FORCEINLINE R get(size_t i) const { return R(ObfPiecewise(), lo.get(i), hi.get(i)); }
+		};
+		struct writer {
+			typename obf_vector_columns<Lo>::writer lo;
+			typename obf_vector_columns<Hi>::writer hi;
+			ITHARE_OBF_FORCEINLINE void set(size_t i, const R& r) const { lo.set(i, r.lo); hi.set(i, r.hi); }
+		};
+		ITHARE_OBF_FORCEINLINE reader read() const { return reader{ lo.read(), hi.read() }; }
+		ITHARE_OBF_FORCEINLINE writer write() { return writer{ lo.write(), hi.write() }; }
+
+		ITHARE_OBF_FORCEINLINE R get(size_t i) const { return R(ObfPiecewise(), lo.get(i), hi.get(i)); }
+		ITHARE_OBF_FORCEINLINE void set(size_t i, const R& r) { lo.set(i, r.lo); hi.set(i, r.hi); }
+		ITHARE_OBF_FORCEINLINE void push_back(const R& r) { lo.push_back(r.lo); hi.push_back(r.hi); }
+		void pop_back() { lo.pop_back(); hi.pop_back(); }
+		void resize(size_t n, const R& r) { lo.resize(n, r.lo); hi.resize(n, r.hi); }
+		void fill(const R& r) { lo.fill(r.lo); hi.fill(r.hi); }
+		void reserve(size_t n) { lo.reserve(n); hi.reserve(n); }
+		void shrink_to_fit() { lo.shrink_to_fit(); hi.shrink_to_fit(); }
+		void clear() { lo.clear(); hi.clear(); }
+		void swap(obf_vector_columns& other) { lo.swap(other.lo); hi.swap(other.hi); }
+		size_t size() const { return lo.size(); }
+		size_t capacity() const { return std::min(lo.capacity(), hi.capacity()); }
+		static constexpr size_t columns = obf_vector_columns<Lo>::columns + obf_vector_columns<Hi>::columns;
+	};
+
+	//obf_vector: dynamic counterpart of obf_array<>, with the same injection as obf_var<> (i.e. w/o restrictions on the tree);
+	//  encoded values are stored column-wise (see obf_vector_columns<>), so there is no per-element padding,
+	//  and elements are accessed via get()/set(), proxy references, or bulk load_range()/store_range()
+	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_vector_dbg<>
+	template<class T_, OBFSEED seed, OBFCYCLES cycles>
+	class obf_vector {
+		static_assert(std::is_integral<T_>::value);
+		using T = typename std::make_unsigned<T_>::type;//from this point on, unsigned only
+		static constexpr OBFCYCLES site_cycles = obf_site_cycles(seed, cycles);
+		static constexpr OBFSEED tree_seed = obf_tree_seed(seed);
+		static constexpr OBFCYCLES tree_cycles = obf_tree_cycles(site_cycles);
+
+		using Context = ObfVarContext<T, obf_compile_time_prng(tree_seed, 1), tree_cycles>;
+		using Injection = obf_site_injection<T, Context, obf_compile_time_prng(tree_seed, 2), tree_cycles>;
+		using Encoded = typename Injection::return_type;
+		using Stats = obf_site_stats<obf_vector, ObfSiteKind::vector, sizeof(T), seed, cycles, site_cycles>;
+
+		//same as for obf_var<>
+		static constexpr ObfAffine<T> affine = Injection::affine();
+		template<class T2>
+		static constexpr bool encoded_arithmetic = affine.is_affine && std::is_integral<T2>::value;
 
 	public:
-		constexpr static OBFCYCLES context_cycles = WhichType::context_cycles;
-		constexpr static OBFCYCLES calc_cycles(OBFCYCLES inj, OBFCYCLES surj) {
-			return surj;//for literals, ONLY surjection costs apply in runtime (as injection applies in compile-time)
-		}
+		using value_type = T_;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using const_reference = T_;
 
-		constexpr static OBFCYCLES literal_cycles = 0;
-		template<class T, T C, OBFSEED seed>
-		struct literal {
-			using type = obf_literal_ctx<T, C, ObfZeroLiteralContext<T>, seed, literal_cycles>;
+		class reference {//proxy for v[i]
+			friend class obf_vector;
+
+		public:
+			ITHARE_OBF_FORCEINLINE operator T_() const { return v->get(i); }
+			ITHARE_OBF_FORCEINLINE reference& operator =(T_ t) { v->set(i, t); return *this; }
+			ITHARE_OBF_FORCEINLINE reference& operator =(const reference& other) { v->set(i, T_(other)); return *this; }
+
+			template<class T2>
+			ITHARE_OBF_FORCEINLINE reference& operator +=(T2 t) {
+				if constexpr(encoded_arithmetic<T2>) {
+					Stats::encoded();
+					v->columns.set(i, affine.encoded_add(v->columns.get(i), T(t)));
+				}
+				else
+					v->set(i, T_(v->get(i) + t));
+				return *this;
+			}
+			template<class T2>
+			ITHARE_OBF_FORCEINLINE reference& operator -=(T2 t) {
+				if constexpr(encoded_arithmetic<T2>) {
+					Stats::encoded();
+					v->columns.set(i, affine.encoded_sub(v->columns.get(i), T(t)));
+				}
+				else
+					v->set(i, T_(v->get(i) - t));
+				return *this;
+			}
+			template<class T2>
+			ITHARE_OBF_FORCEINLINE reference& operator *=(T2 t) {
+				if constexpr(encoded_arithmetic<T2>) {
+					Stats::encoded();
+					v->columns.set(i, affine.encoded_mul(v->columns.get(i), T(t)));
+				}
+				else
+					v->set(i, T_(v->get(i) * t));
+				return *this;
+			}
+			template<class T2>
+			ITHARE_OBF_FORCEINLINE reference& operator /=(T2 t) { v->set(i, T_(v->get(i) / t)); return *this; }
+			template<class T2>
+			ITHARE_OBF_FORCEINLINE reference& operator %=(T2 t) { v->set(i, T_(v->get(i) % t)); return *this; }
+			ITHARE_OBF_FORCEINLINE reference& operator ++() { return *this += 1; }
+			ITHARE_OBF_FORCEINLINE reference& operator --() { return *this -= 1; }
+			ITHARE_OBF_FORCEINLINE T_ operator ++(int) { T_ ret = *this; *this += 1; return ret; }
+			ITHARE_OBF_FORCEINLINE T_ operator --(int) { T_ ret = *this; *this -= 1; return ret; }
+
+			//swaps encoded values, w/o decoding (for std::sort() & co.)
+			ITHARE_OBF_FORCEINLINE friend void swap(reference a, reference b) {
+				swap_encoded(a, b);
+			}
+
+		private:
+			ITHARE_OBF_FORCEINLINE reference(obf_vector* v_, size_t i_) : v(v_), i(i_) {
+			}
+			ITHARE_OBF_FORCEINLINE static void swap_encoded(reference a, reference b) {
+				Encoded tmp = a.v->columns.get(a.i);
+				a.v->columns.set(a.i, b.v->columns.get(b.i));
+				b.v->columns.set(b.i, tmp);
+			}
+
+			obf_vector* v;
+			size_t i;
 		};
+		using iterator = obf_index_iterator<obf_vector, T_>;
+		using const_iterator = obf_index_iterator<const obf_vector, T_>;
 
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return WhichType::final_injection(x);
+		ITHARE_OBF_FORCEINLINE obf_vector(ITHARE_OBF_SITE_LOC_PARAM0) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
 		}
-		ITHARE_OBF_FORCEINLINE static /*non-constexpr*/ T final_surjection(T y) {
-			return WhichType::final_surjection(y);
+		ITHARE_OBF_FORCEINLINE explicit obf_vector(size_t n, T_ t = 0 ITHARE_OBF_SITE_LOC_PARAM) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			resize(n, t);
 		}
-
-
-	public:
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			size_t dbgWhich = obf_random_obf_from_list(obf_compile_time_prng(seed, 1), cycles, descr);
-			std::cout << std::string(offset, ' ') << prefix << "ObfLiteralContext<" << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: which=" << which << " dbgWhich=" << dbgWhich << std::endl;
-			WhichType::dbgPrint(offset + 1);
+		ITHARE_OBF_FORCEINLINE obf_vector(std::initializer_list<T_> il ITHARE_OBF_SITE_LOC_PARAM) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			resize(il.size());
+			store_range(0, il.size(), il.begin());
 		}
-#endif
-	};
 
-	template<class T, class T0, OBFSEED seed, OBFSEED seed0, OBFCYCLES cycles0,OBFCYCLES cycles>
-	struct ObfRecursiveContext<T, ObfLiteralContext<T0, seed0,cycles0>, seed, cycles> {
-		using recursive_context_type = ObfLiteralContext<T, obf_compile_time_prng(seed, 1),cycles>;//@@
-		using intermediate_context_type = typename ObfLiteralContext<T, obf_compile_time_prng(seed, 2), cycles>;//whenever cycles is low (which is very often), will fallback to version0
-	};
+		ITHARE_OBF_FORCEINLINE size_t size() const {
+			return columns.size();
+		}
+		ITHARE_OBF_FORCEINLINE bool empty() const {
+			return size() == 0;
+		}
+		size_t capacity() const {
+			return columns.capacity();
+		}
+		void reserve(size_t n) {
+			columns.reserve(n);
+		}
+		void shrink_to_fit() {
+			columns.shrink_to_fit();
+		}
+		void resize(size_t n, T_ t = 0) {
+			if (n > size())
+				Stats::encoded();
+			columns.resize(n, Injection::injection(T(t)));
+		}
+		void clear() {
+			columns.clear();
+		}
+		void swap(obf_vector& other) {
+			columns.swap(other.columns);
+		}
 
-	//obf_literal
-	template<class T, T C, class Context, OBFSEED seed, OBFCYCLES cycles>
-	class obf_literal_ctx {
-		static_assert(std::is_integral<T>::value);
-		static_assert(std::is_unsigned<T>::value);
+		ITHARE_OBF_FORCEINLINE T_ get(size_t i) const {
+			assert(i < size());
+			return Stats::decode([&] { return T_(Injection::surjection(columns.get(i))); });
+		}
+		ITHARE_OBF_FORCEINLINE void set(size_t i, T_ t) {
+			assert(i < size());
+			Stats::encoded();
+			columns.set(i, Injection::injection(T(t)));
+		}
+		ITHARE_OBF_FORCEINLINE T_ operator[](size_t i) const {
+			return get(i);
+		}
+		ITHARE_OBF_FORCEINLINE reference operator[](size_t i) {
+			assert(i < size());
+			return reference(this, i);
+		}
+		ITHARE_OBF_FORCEINLINE T_ front() const {
+			return get(0);
+		}
+		ITHARE_OBF_FORCEINLINE T_ back() const {
+			return get(size() - 1);
+		}
+		ITHARE_OBF_FORCEINLINE void push_back(T_ t) {
+			Stats::encoded();
+			columns.push_back(Injection::injection(T(t)));
+		}
+		void pop_back() {
+			assert(!empty());
+			columns.pop_back();
+		}
+		ITHARE_OBF_FORCEINLINE void fill(T_ t) {
+			Stats::encoded();
+			columns.fill(Injection::injection(T(t)));
+		}
 
-		using Injection = obf_injection<T, Context, obf_compile_time_prng(seed, 1), cycles,ObfDefaultInjectionContext>;
-	public:
-		ITHARE_OBF_FORCEINLINE constexpr obf_literal_ctx() : val(Injection::injection(C)) {
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, size()); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, size()); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+
+		//bulk operations: [first,first+count) elements of the vector <-> dst[0..count) / src[0..count)
+		//  (to append, resize() first)
+		void load_range(size_t first, size_t count, T_* dst) const {
+			assert(first <= size() && count <= size() - first);
+			Stats::decode([&] {
+				auto src = columns.read();
+				for (size_t i = 0; i < count; ++i)
+					dst[i] = T_(Injection::surjection(src.get(first + i)));
+			}, count);
 		}
-		ITHARE_OBF_FORCEINLINE constexpr T value() const {
-			return Injection::surjection(val);
+		void store_range(size_t first, size_t count, const T_* src) {
+			assert(first <= size() && count <= size() - first);
+			Stats::encoded(count);
+			auto dst = columns.write();
+			for (size_t i = 0; i < count; ++i)
+				dst.set(first + i, Injection::injection(T(src[i])));
 		}
 
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_literal_ctx<" << obf_dbgPrintT<T>() << "," << obf_dbgPrintC(C) << "," << seed << "," << cycles << ">" << std::endl;
+			std::cout << std::string(offset, ' ') << prefix << "obf_vector<" << obf_dbgPrintT<T>() << "," << seed << "," << cycles << ">: site_cycles=" << site_cycles << " columns=" << obf_vector_columns<Encoded>::columns << std::endl;
 			Injection::dbgPrint(offset + 1);
 		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_vector", role);
+			w.number("size", sizeof(T));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.number("site_cycles", site_cycles);
+			w.unumber("columns", obf_vector_columns<Encoded>::columns);
+			w.resources(ObfJsonResources());
+			w.children();
+			Injection::dbgJson(w);
+			w.end();
+		}
 #endif
+
 	private:
-		typename Injection::return_type val;
+		obf_vector_columns<Encoded> columns;
 	};
 
-	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_literal_dbg<>
-	template<class T_, T_ C_, OBFSEED seed, OBFCYCLES cycles>
-	class obf_literal {
-		static_assert(std::is_integral<T_>::value);
-		using T = typename std::make_unsigned<T_>::type;//from this point on, unsigned only
-		static constexpr T C = (T)C_;
+	//obf_map_values: how obf_unordered_map<> stores its values - as is, or (integral ones only) encoded under a tree of their own
+	template<class V, bool encode, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_map_values {
+		static constexpr bool encoded = false;
+		using stored_type = V;
+		ITHARE_OBF_FORCEINLINE static const V& encode_value(const V& v) {
+			return v;
+		}
+		ITHARE_OBF_FORCEINLINE static const V& decode_value(const V& s) {
+			return s;
+		}
 
-		using Context = ObfLiteralContext<T, obf_compile_time_prng(seed, 1),cycles>;
-		using Injection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles,ObfDefaultInjectionContext>;
-	public:
-		ITHARE_OBF_FORCEINLINE constexpr obf_literal() : val(Injection::injection(C)) {
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t = 0) {
 		}
-		ITHARE_OBF_FORCEINLINE T value() const {
-			return Injection::surjection(val);
+		static constexpr void dbgJson(ObfJsonWriter&) {
 		}
-		ITHARE_OBF_FORCEINLINE operator T() const {
-			return value();
+#endif
+	};
+	template<class V_, OBFSEED seed, OBFCYCLES cycles>
+	struct obf_map_values<V_, true, seed, cycles> {
+		static_assert(std::is_integral<V_>::value);
+		using V = typename std::make_unsigned<V_>::type;
+		using Context = ObfVarContext<V, obf_compile_time_prng(seed, 1), cycles>;
+		using Injection = obf_site_injection<V, Context, obf_compile_time_prng(seed, 2), cycles>;
+
+		using EncodedOps = obf_encoded_ops<typename Injection::return_type>;
+
+		static constexpr bool encoded = true;
+		using stored_type = typename obf_flat_uint<sizeof(V)>::type;//packed, as split return_types are not default-constructible
+		ITHARE_OBF_FORCEINLINE static stored_type encode_value(V_ v) {
+			return stored_type(EncodedOps::pack(Injection::injection(V(v))));
+		}
+		ITHARE_OBF_FORCEINLINE static V_ decode_value(stored_type s) {
+			return V_(Injection::surjection(EncodedOps::unpack(s)));
 		}
 
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
-		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_literal<"<<obf_dbgPrintT<T>()<<"," << C << "," << seed << "," << cycles << ">" << std::endl;
-			Injection::dbgPrint(offset + 1);
+		static void dbgPrint(size_t offset = 0) {
+			Injection::dbgPrint(offset, "Values:");
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w) {
+			Injection::dbgJson(w, "Values");
 		}
 #endif
-	private:
-		typename Injection::return_type val;
 	};
 
-	//ObfVarContext
-	template<class T,OBFSEED seed,OBFCYCLES cycles>
-	struct ObfVarContext {
-		constexpr static OBFCYCLES context_cycles = 0;
-		constexpr static OBFCYCLES calc_cycles(OBFCYCLES inj, OBFCYCLES surj) {
-			return inj + surj;//for variables, BOTH injection and surjection are executed in runtime
+	//obf_unordered_map: open-addressing hash map with integral keys stored encoded, under the same injection as obf_var<K>;
+	//  a lookup encodes the query key once, and probing compares encoded words (see obf_encoded_ops<>) - no surjections at all
+	//  layout: one control byte per slot (0 - empty, otherwise 7 bits of the hash), plus a flat array of {encoded key, value} slots;
+	//  linear probing, power-of-2 capacity, load factor <= 3/4, and backward-shift erase() (no tombstones)
+	//  with encode_values, (integral) values are encoded too - under a separate tree, so they're not comparable to the keys
+	//  NB: no iterators (slots hold no decoded pairs to point to), use for_each() instead; V has to be default-constructible
+	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_unordered_map_dbg<>
+	template<class K_, class V, OBFSEED seed, OBFCYCLES cycles, bool encode_values = false>
+	class obf_unordered_map {
+		static_assert(std::is_integral<K_>::value);
+		using K = typename std::make_unsigned<K_>::type;//from this point on, unsigned only
+		static constexpr OBFCYCLES site_cycles = obf_site_cycles(seed, cycles);
+		static constexpr OBFSEED tree_seed = obf_tree_seed(seed);
+		static constexpr OBFCYCLES tree_cycles = obf_tree_cycles(site_cycles);
+
+		using Context = ObfVarContext<K, obf_compile_time_prng(tree_seed, 1), tree_cycles>;
+		using Injection = obf_site_injection<K, Context, obf_compile_time_prng(tree_seed, 2), tree_cycles>;
+		using EncodedOps = obf_encoded_ops<typename Injection::return_type>;
+		using Values = obf_map_values<V, encode_values, obf_compile_time_prng(tree_seed, 3), tree_cycles>;
+		using Stats = obf_site_stats<obf_unordered_map, ObfSiteKind::map, sizeof(K), seed, cycles, site_cycles>;
+
+		using KeyWord = typename obf_flat_uint<sizeof(K)>::type;//packed encoded key
+		struct Slot {
+			KeyWord key;
+			typename Values::stored_type val;
+		};
+		static constexpr uint64_t hash_salt = obf_compile_time_prng(tree_seed, 4);
+		static constexpr size_t min_capacity = 16;
+
+	public:
+		using key_type = K_;
+		using mapped_type = V;
+		using size_type = size_t;
+
+		ITHARE_OBF_FORCEINLINE obf_unordered_map(ITHARE_OBF_SITE_LOC_PARAM0) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
 		}
 
-		constexpr static OBFCYCLES literal_cycles = std::min(cycles/2,50);//TODO: justify (or define?)
-		using LiteralContext = ObfLiteralContext<T, seed, literal_cycles>;
-		template<class T, T C, OBFSEED seed>
-		struct literal {
-			using type = obf_literal_ctx<T, C, LiteralContext, seed, literal_cycles>;
-		};
+		ITHARE_OBF_FORCEINLINE size_t size() const {
+			return count_;
+		}
+		ITHARE_OBF_FORCEINLINE bool empty() const {
+			return count_ == 0;
+		}
+		size_t capacity() const {//number of slots
+			return ctrl.size();
+		}
+		void reserve(size_t n) {
+			size_t cap = min_capacity;
+			while (cap / 4 * 3 < n)
+				cap *= 2;
+			if (cap > capacity())
+				rehash(cap);
+		}
+		void clear() {
+			ctrl.assign(ctrl.size(), uint8_t(0));
+			count_ = 0;
+		}
+		void swap(obf_unordered_map& other) {
+			ctrl.swap(other.ctrl);
+			slots.swap(other.slots);
+			std::swap(count_, other.count_);
+		}
 
-		ITHARE_OBF_FORCEINLINE static constexpr T final_injection(T x) {
-			return x;
+		//insert(): only if k is not there yet; insert_or_assign(): overwrites the value if it is; both return true if inserted
+		bool insert(K_ k, const V& v) {
+			return emplace(k, v, false);
 		}
-		ITHARE_OBF_FORCEINLINE static constexpr T final_surjection(T y) {
-			return y;
+		bool insert_or_assign(K_ k, const V& v) {
+			return emplace(k, v, true);
+		}
+		ITHARE_OBF_FORCEINLINE bool contains(K_ k) const {
+			return locate(k).found;
+		}
+		ITHARE_OBF_FORCEINLINE size_t count(K_ k) const {
+			return contains(k) ? 1 : 0;
+		}
+		ITHARE_OBF_FORCEINLINE bool find(K_ k, V& v) const {
+			ObfMapPos pos = locate(k);
+			if (!pos.found)
+				return false;
+			v = decode_value(slots[pos.i].val);
+			return true;
+		}
+		ITHARE_OBF_FORCEINLINE V get(K_ k, const V& def = V()) const {
+			V ret;
+			return find(k, ret) ? ret : def;
+		}
+		bool erase(K_ k) {
+			ObfMapPos pos = locate(k);
+			if (!pos.found)
+				return false;
+			size_t mask = capacity() - 1;
+			size_t hole = pos.i;
+			for (size_t j = (hole + 1) & mask; ctrl[j]; j = (j + 1) & mask) {
+				size_t home = size_t(hash(slots[j].key)) & mask;
+				if (((j - home) & mask) >= ((j - hole) & mask)) {//home is not within (hole,j], so j can be moved to the hole
+					ctrl[hole] = ctrl[j];
+					slots[hole] = std::move(slots[j]);
+					hole = j;
+				}
+			}
+			ctrl[hole] = 0;
+			--count_;
+			return true;
+		}
+
+		//f(K_ key, V value) for each element, in no particular order
+		template<class F>
+		void for_each(F f) const {
+			Stats::decode([&] {
+				for (size_t i = 0; i < ctrl.size(); ++i) {
+					if (ctrl[i])
+						f(K_(Injection::surjection(EncodedOps::unpack(slots[i].key))), decode_value(slots[i].val));
+				}
+			}, count_);
 		}
 
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "ObfVarContext<" << obf_dbgPrintT<T>() << ">" << std::endl;
+			std::cout << std::string(offset, ' ') << prefix << "obf_unordered_map<" << obf_dbgPrintT<K>() << "," << seed << "," << cycles << "," << encode_values << ">: site_cycles=" << site_cycles << std::endl;
+			Injection::dbgPrint(offset + 1, "Keys:");
+			Values::dbgPrint(offset + 1);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_unordered_map", role);
+			w.number("size", sizeof(K));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.number("site_cycles", site_cycles);
+			w.boolean("encode_values", encode_values);
+			w.resources(ObfJsonResources());
+			w.children();
+			Injection::dbgJson(w, "Keys");
+			Values::dbgJson(w);
+			w.end();
 		}
 #endif
-	};
-	template<class T, class T0, OBFSEED seed0, OBFCYCLES cycles0, OBFSEED seed, OBFCYCLES cycles>
-	struct ObfRecursiveContext<T, ObfVarContext<T0,seed0,cycles0>, seed, cycles> {
-		using recursive_context_type = ObfVarContext<T,seed,cycles>;
-		using intermediate_context_type = ObfVarContext<T,seed,cycles>;
-	};
-
-	//obf_var
-	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_var_dbg<>
-	template<class T_, OBFSEED seed, OBFCYCLES cycles>
-	class obf_var {
-		static_assert(std::is_integral<T_>::value);
-		using T = typename std::make_unsigned<T_>::type;//from this point on, unsigned only
 
-		using Context = ObfVarContext<T, obf_compile_time_prng(seed, 1), cycles>;
-		using Injection = obf_injection<T, Context, obf_compile_time_prng(seed, 2), cycles, ObfDefaultInjectionContext>;
+	private:
+		struct ObfMapPos {
+			size_t i;//of the key if found, otherwise of the empty slot where it goes
+			bool found;
+			KeyWord key;
+			uint8_t tag;
+		};
 
-	public:
-		ITHARE_OBF_FORCEINLINE obf_var(T_ t) : val(Injection::injection(T(t))) {
+		ITHARE_OBF_FORCEINLINE static uint64_t hash(KeyWord key) {
+			return obf_hash_mix(uint64_t(key) ^ hash_salt);
 		}
-		template<class T2,OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var(obf_var<T2, seed2, cycles2> t) : val(Injection::injection(T(T_(t.value())))) {//TODO: randomized injection implementation
+		ITHARE_OBF_FORCEINLINE static auto decode_value(const typename Values::stored_type& s) {
+			if constexpr(Values::encoded)
+				return Stats::decode([&] { return Values::decode_value(s); });
+			else
+				return Values::decode_value(s);
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var(obf_literal<T2, C2, seed2, cycles2> t) : val(Injection::injection(T(T_(t.value())))) {//TODO: randomized injection implementation
+
+		ITHARE_OBF_FORCEINLINE ObfMapPos locate(K_ k) const {
+			Stats::encoded();
+			ObfMapPos pos;
+			pos.key = KeyWord(EncodedOps::pack(Injection::injection(K(k))));
+			uint64_t h = hash(pos.key);
+			pos.tag = uint8_t(h >> 57) | 0x80;
+			pos.found = false;
+			if (ctrl.empty()) {
+				pos.i = 0;
+				return pos;
+			}
+			size_t mask = capacity() - 1;
+			for (pos.i = size_t(h) & mask; ctrl[pos.i]; pos.i = (pos.i + 1) & mask) {
+				if (ctrl[pos.i] == pos.tag && slots[pos.i].key == pos.key) {
+					pos.found = true;
+					break;
+				}
+			}
+			return pos;
 		}
-		ITHARE_OBF_FORCEINLINE obf_var& operator =(T_ t) {
-			val = Injection::injection(T(t));//TODO: different implementations of the same injection in different contexts
-			return *this;
+		bool emplace(K_ k, const V& v, bool assign) {
+			ObfMapPos pos = locate(k);
+			if (pos.found) {
+				if (assign) {
+					if constexpr(Values::encoded)
+						Stats::encoded();
+					slots[pos.i].val = Values::encode_value(v);
+				}
+				return false;
+			}
+			if ((count_ + 1) * 4 > capacity() * 3) {
+				rehash(capacity() ? capacity() * 2 : min_capacity);
+				pos.i = free_slot(pos.key);
+			}
+			if constexpr(Values::encoded)
+				Stats::encoded();
+			ctrl[pos.i] = pos.tag;
+			slots[pos.i].key = pos.key;
+			slots[pos.i].val = Values::encode_value(v);
+			++count_;
+			return true;
 		}
-		template<class T2,OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator =(obf_var<T2, seed2, cycles2> t) {
-			val = Injection::injection(T(T_(t.value())));//TODO: different implementations of the same injection in different contexts
-			return *this;
+		size_t free_slot(KeyWord key) const {
+			size_t mask = capacity() - 1;
+			size_t i = size_t(hash(key)) & mask;
+			while (ctrl[i])
+				i = (i + 1) & mask;
+			return i;
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator =(obf_literal<T2, C2, seed2, cycles2> t) {
-			val = Injection::injection(T(T_(t.value())));//TODO: different implementations of the same injection in different contexts
-			return *this;
+		void rehash(size_t cap) {//keys are moved as encoded words, w/o decoding
+			assert((cap & (cap - 1)) == 0 && cap / 4 * 3 >= count_);
+			std::vector<uint8_t> old_ctrl(cap, uint8_t(0));
+			std::vector<Slot> old_slots(cap);
+			old_ctrl.swap(ctrl);
+			old_slots.swap(slots);
+			for (size_t j = 0; j < old_ctrl.size(); ++j) {
+				if (old_ctrl[j]) {
+					size_t i = free_slot(old_slots[j].key);
+					ctrl[i] = old_ctrl[j];
+					slots[i] = std::move(old_slots[j]);
+				}
+			}
 		}
-		ITHARE_OBF_FORCEINLINE T_ value() const {
-			return T_(Injection::surjection(val));
+
+		std::vector<uint8_t> ctrl;
+		std::vector<Slot> slots;
+		size_t count_ = 0;
+	};
+
+	//obf_record: several integral fields under one site (one seed, one OBF?R() macro), decoded/encoded in one fused pass
+	//  all the fields share one injection, which is lane-wise (the same restricted flat plan as for obf_array<>):
+	//  each field is a uint32_t lane (64-bit ones - two lanes), and lane #i is injected as Injection(lane + K[i]),
+	//  so that equal fields are not encoded the same way; each lane is as deep as an obf_var<> of the same OBF level
+	//  load()/store() decode/encode all the lanes at once, as SSE2/AVX2 vectors going through the chain step by step
+	//    (so the chains of 2+ vectors interleave too), with version 4 literals decoded once per store();
+	//    w/o ITHARE_OBF_SIMD, lanes are decoded/encoded one by one
+	//  get<I>()/set<I>() decode/re-encode lanes of field I only (via scalar obf_flat_chain<>, with exactly the same results)
+	//  the price: fields take whole lanes (plus padding lanes up to 4, or up to a multiple of 8), and there is one tree
+	//    for all of them, restricted to versions which vectorize (no literal contexts, no splits into halves)
+	//  in ITHARE_OBF_CODE_SIZE_BOUNDED mode, get<I>()/set<I>() of a record over the budget go via obf_outlined_injection<>
+	//  typical use: enum { X, Y, HEALTH }; OBF3R(int32_t, int32_t, uint16_t) p; p.set<X>(x); auto [x, y, health] = p.load();
+	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_record_dbg<>
+	template<OBFSEED seed, OBFCYCLES cycles, class... T_>
+	class obf_record {
+		static_assert(sizeof...(T_) > 0);
+		static_assert((std::is_integral<T_>::value && ...));
+		static_assert(((sizeof(T_) <= sizeof(uint64_t)) && ...));
+		static constexpr OBFCYCLES site_cycles = obf_site_cycles(seed, cycles);
+		static constexpr OBFSEED tree_seed = obf_tree_seed(seed);//for the injection only; lane constants are per-site
+		static constexpr OBFCYCLES tree_cycles = obf_tree_cycles(site_cycles);
+
+		using Context = ObfVarContext<uint32_t, obf_compile_time_prng(tree_seed, 1), tree_cycles>;
+		static constexpr ObfFlatContext ctx = obf_flat_context_of<Context>::value;
+		using Plan = obf_flat_plan<sizeof(uint32_t), ctx.kind, ctx.seed, ctx.cycles, obf_compile_time_prng(tree_seed, 2), tree_cycles, size_t(-1), obf_array_versions>;
+		using Kernel = obf_array_kernel<uint32_t, Plan>;
+		static constexpr bool record_inlined = obf_tree_inlined(tree_cycles);
+		using Injection = typename std::conditional<record_inlined, typename Kernel::Scalar, obf_outlined_injection<uint32_t, typename Kernel::Scalar>>::type;
+		using Stats = obf_site_stats<obf_record, ObfSiteKind::record, (sizeof(T_) + ...), seed, cycles, site_cycles>;
+
+		//field #i takes field_lanes(i) lanes, starting from first_lane(i)
+		static constexpr size_t field_lanes(size_t i) {
+			constexpr size_t sizes[] = { sizeof(T_)... };
+			return sizes[i] > sizeof(uint32_t) ? 2 : 1;
+		}
+		static constexpr size_t first_lane(size_t i) {
+			size_t ret = 0;
+			for (size_t j = 0; j < i; ++j)
+				ret += field_lanes(j);
+			return ret;
 		}
+		static constexpr size_t n_lanes = first_lane(sizeof...(T_));
+		static constexpr size_t szc = n_lanes <= 4 ? 4 : (n_lanes + 7) / 8 * 8;//lanes in c, padded up to SSE2/AVX2 vectors
 
-		ITHARE_OBF_FORCEINLINE operator T_() const { return value(); }
-		ITHARE_OBF_FORCEINLINE obf_var& operator ++() { *this = value() + 1; return *this; }
-		ITHARE_OBF_FORCEINLINE obf_var& operator --() { *this = value() - 1; return *this; }
-		ITHARE_OBF_FORCEINLINE obf_var operator++(int) { obf_var ret = obf_var(value());  *this = value() + 1; return ret; }
-		ITHARE_OBF_FORCEINLINE obf_var operator--(int) { obf_var ret = obf_var(value());  *this = value() + 1; return ret; }
+		static constexpr std::array<uint32_t, szc> lane_consts() {
+			std::array<uint32_t, szc> ret = {};
+			for (size_t i = 0; i < szc; ++i)
+				ret[i] = uint32_t(obf_compile_time_prng(seed, 11 + int(i)));
+			return ret;
+		}
+		static constexpr std::array<uint32_t, szc> K = lane_consts();
 
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE bool operator <(T2 t) { return value() < t; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE bool operator >(T2 t) { return value() > t; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE bool operator ==(T2 t) { return value() == t; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE bool operator !=(T2 t) { return value() != t; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE bool operator <=(T2 t) { return value() <= t; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE bool operator >=(T2 t) { return value() >= t; }
+	public:
+		template<size_t I>
+		using field_type = std::tuple_element_t<I, std::tuple<T_...>>;
+		static constexpr size_t fields = sizeof...(T_);
+
+		ITHARE_OBF_FORCEINLINE obf_record(ITHARE_OBF_SITE_LOC_PARAM0) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			Stats::encoded(sizeof...(T_));
+			encode_all(T_(0)...);
+		}
+		ITHARE_OBF_FORCEINLINE obf_record(T_... t ITHARE_OBF_SITE_LOC_PARAM) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+			Stats::encoded(sizeof...(T_));
+			encode_all(t...);
+		}
 
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator <(obf_var<T2, seed2, cycles2> t) {
-			return value() < t.value();
+		template<size_t I>
+		ITHARE_OBF_FORCEINLINE field_type<I> get() const {
+			return Stats::decode([&] {
+				constexpr size_t l = first_lane(I);
+				uint32_t w[2] = { decode_lane(l), 0 };
+				if constexpr(field_lanes(I) > 1)
+					w[1] = decode_lane(l + 1);
+				return from_lanes<I>(w);
+			});
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator >(obf_var<T2, seed2, cycles2> t) {
-			return value() > t.value();
+		template<size_t I>
+		ITHARE_OBF_FORCEINLINE void set(field_type<I> t) {
+			Stats::encoded();
+			encode_field<I>(t);
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator ==(obf_var<T2, seed2, cycles2> t) {
-			return value() == t.value();
+
+		//whole-record decode/encode
+		ITHARE_OBF_FORCEINLINE std::tuple<T_...> load() const {
+			return Stats::decode([&] {
+				uint32_t buf[szc];
+				decode_all(buf);
+				return unpack(buf, std::index_sequence_for<T_...>());
+			}, sizeof...(T_));
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator !=(obf_var<T2, seed2, cycles2> t) {
-			return value() != t.value();
+		ITHARE_OBF_FORCEINLINE void load(T_&... t) const {
+			std::tie(t...) = load();
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator <=(obf_var<T2, seed2, cycles2> t) {
-			return value() <= t.value();
+		ITHARE_OBF_FORCEINLINE void store(T_... t) {
+			Stats::encoded(sizeof...(T_));
+			encode_all(t...);
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator >=(obf_var<T2, seed2, cycles2> t) {
-			return value() >= t.value();
+		ITHARE_OBF_FORCEINLINE void store(const std::tuple<T_...>& t) {
+			std::apply([this](T_... t_) { store(t_...); }, t);
 		}
 
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator <(obf_literal<T2, C2, seed2, cycles2> t) {
-			return value() < t.value();
+		//wire transcoding, same as for obf_var<>; fields go one after another, w/o padding
+		static constexpr size_t wire_size = (sizeof(T_) + ...);
+		template<class Wire>
+		ITHARE_OBF_FORCEINLINE void wire_store(uint8_t* p) const {
+			Stats::decode([&] {
+				uint32_t buf[szc];
+				decode_all(buf);
+				wire_store_fields<Wire>(p, buf, std::index_sequence_for<T_...>());
+			}, sizeof...(T_));
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator >(obf_literal<T2, C2, seed2, cycles2> t) {
-			return value() > t.value();
+		template<class Wire>
+		ITHARE_OBF_FORCEINLINE void wire_load(const uint8_t* p) {
+			Stats::encoded(sizeof...(T_));
+			wire_load_fields<Wire>(p, std::index_sequence_for<T_...>());
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator ==(obf_literal<T2, C2, seed2, cycles2> t) {
-			return value() == t.value();
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_record<" << seed << "," << cycles << ">: fields=" << sizeof...(T_) << " lanes=" << n_lanes << "/" << szc << " site_cycles=" << site_cycles << " inlined=" << record_inlined << " nodes=" << Plan::plan.n_nodes << "/" << Plan::count.nodes << " chains=" << Plan::plan.n_chains << "/" << Plan::count.chains << std::endl;
+			obf_flat_dbgPrintChain<Plan>(0, offset + 1, "");
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator !=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return value() != t.value();
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_record", role);
+			w.number("size", (sizeof(T_) + ...));
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.number("site_cycles", site_cycles);
+			w.unumber("fields", sizeof...(T_));
+			w.unumber("lanes", n_lanes);
+			w.boolean("inlined", record_inlined);
+			w.unumber("nodes", Plan::plan.n_nodes);
+			w.unumber("chains", Plan::plan.n_chains);
+			w.resources(ObfJsonResources());
+			w.children();
+			obf_flat_dbgJsonChain<Plan, 0>(w);
+			w.end();
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator <=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return value() <= t.value();
+#endif
+
+	private:
+		ITHARE_OBF_FORCEINLINE uint32_t decode_lane(size_t l) const {
+			return uint32_t(Injection::surjection(c[l]) - K[l]);
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE bool operator >=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return value() >= t.value();
+		ITHARE_OBF_FORCEINLINE static uint32_t encode_lane(size_t l, uint32_t x) {
+			return Injection::injection(uint32_t(x + K[l]));
 		}
 
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator +=(T2 t) { *this = value() + t; return *this; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator -=(T2 t) { *this = value() - t; return *this; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator *=(T2 t) { *this = value() * t; return *this; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator /=(T2 t) { *this = value() / t; return *this; }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator %=(T2 t) { *this = value() % t; return *this; }
+		template<size_t I>
+		ITHARE_OBF_FORCEINLINE void encode_field(field_type<I> t) {
+			constexpr size_t l = first_lane(I);
+			uint32_t w[2] = {};
+			to_lanes<I>(w, t);
+			c[l] = encode_lane(l, w[0]);
+			if constexpr(field_lanes(I) > 1)
+				c[l + 1] = encode_lane(l + 1, w[1]);
+		}
 
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator +=(obf_var<T2, seed2, cycles2> t) {
-			return *this += t.value();
+		//field <-> its lanes (w[0] is the first lane of the field); bits of the narrower fields' lanes above the field are zero
+		template<size_t I>
+		ITHARE_OBF_FORCEINLINE static void to_lanes(uint32_t* w, field_type<I> t) {
+			using T = typename std::make_unsigned<field_type<I>>::type;
+			w[0] = uint32_t(T(t));
+			if constexpr(sizeof(T) > sizeof(uint32_t))
+				w[1] = uint32_t(uint64_t(T(t)) >> 32);
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator -=(obf_var<T2, seed2, cycles2> t) {
-			return *this -= t.value();
+		template<size_t I>
+		ITHARE_OBF_FORCEINLINE static field_type<I> from_lanes(const uint32_t* w) {
+			using T = typename std::make_unsigned<field_type<I>>::type;
+			if constexpr(sizeof(T) > sizeof(uint32_t))
+				return field_type<I>(T(w[0]) | (T(w[1]) << 32));
+			else
+				return field_type<I>(T(w[0]));
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator *=(obf_var<T2, seed2, cycles2> t) {
-			return *this *= t.value();
+		template<size_t... I>
+		ITHARE_OBF_FORCEINLINE static std::tuple<T_...> unpack(const uint32_t* buf, std::index_sequence<I...>) {
+			return std::tuple<T_...>(from_lanes<I>(buf + first_lane(I))...);
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator /=(obf_var<T2, seed2, cycles2> t) {
-			return *this /= t.value();
+
+		//all the lanes (incl. padding ones) in one pass; AVX2 for decoding only: encoding starts from fields which have just been
+		//  written lane by lane, and a 256-bit reload of them would stall on store forwarding (so the SSE2 entry takes the fields
+		//  themselves, to make the lanes in registers, whether it is inlined or not)
+		ITHARE_OBF_FORCEINLINE void decode_all(uint32_t* buf) const {
+#ifdef ITHARE_OBF_SIMD
+#ifndef ITHARE_OBF_NO_AVX2
+			if constexpr(szc % 8 == 0) {
+				if (obf_cpu_has_avx2()) {
+					decode_avx2(c.data(), buf);
+					return;
+				}
+			}
+#endif
+			decode_sse2(c.data(), buf);
+#else
+			for (size_t i = 0; i < n_lanes; ++i)
+				buf[i] = decode_lane(i);
+#endif
 		}
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator %=(obf_var<T2, seed2, cycles2> t) {
-			return *this %= t.value();
+#ifdef ITHARE_OBF_SIMD
+		ITHARE_OBF_SIMD_ENTRY static void decode_sse2(const uint32_t* y, uint32_t* buf) {
+			using V = obf_simd_sse2<uint32_t>;
+			constexpr size_t nv = szc / V::lanes;
+			typename V::vec v[nv];
+			for (size_t j = 0; j < nv; ++j)
+				v[j] = V::load(y + j * V::lanes);
+			Kernel::template surjection_vecs<V>(v);
+			for (size_t j = 0; j < nv; ++j)
+				V::store(buf + j * V::lanes, V::sub(v[j], V::load(K.data() + j * V::lanes)));
+		}
+		template<size_t... I>
+		ITHARE_OBF_SIMD_ENTRY static void encode_sse2(uint32_t* y, std::index_sequence<I...>, T_... t) {
+			using V = obf_simd_sse2<uint32_t>;
+			constexpr size_t nv = szc / V::lanes;
+			uint32_t lanes[szc] = {};//padding lanes are encoded zeros
+			(to_lanes<I>(lanes + first_lane(I), t), ...);
+			typename V::vec v[nv];
+			for (size_t j = 0; j < nv; ++j)
+				v[j] = V::add(V::load_lanes(lanes + j * V::lanes), V::load(K.data() + j * V::lanes));
+			Kernel::template injection_vecs<V>(v);
+			for (size_t j = 0; j < nv; ++j)
+				V::store(y + j * V::lanes, v[j]);
 		}
+#ifndef ITHARE_OBF_NO_AVX2
+		ITHARE_OBF_AVX2_ENTRY static void decode_avx2(const uint32_t* y, uint32_t* buf) {
+			using V = obf_simd_avx2<uint32_t>;
+			constexpr size_t nv = szc / V::lanes;
+			typename V::vec v[nv];
+			for (size_t j = 0; j < nv; ++j)
+				v[j] = V::load(y + j * V::lanes);
+			Kernel::template surjection_vecs<V>(v);
+			for (size_t j = 0; j < nv; ++j)
+				V::store(buf + j * V::lanes, V::sub(v[j], V::load(K.data() + j * V::lanes)));
+		}
+#endif
+#endif
+		ITHARE_OBF_FORCEINLINE void encode_all(T_... t) {
+#ifdef ITHARE_OBF_SIMD
+			encode_sse2(c.data(), std::index_sequence_for<T_...>(), t...);
+#else
+			encode_fields(std::index_sequence_for<T_...>(), t...);
+#endif
+		}
+#ifndef ITHARE_OBF_SIMD
+		template<size_t... I>
+		ITHARE_OBF_FORCEINLINE void encode_fields(std::index_sequence<I...>, T_... t) {
+			(encode_field<I>(t), ...);
+			for (size_t i = n_lanes; i < szc; ++i)//padding lanes are encoded zeros
+				c[i] = encode_lane(i, 0);
+		}
+#endif
 
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator +=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return *this += t.value();
+		static constexpr size_t wire_offset(size_t i) {
+			constexpr size_t sizes[] = { sizeof(T_)... };
+			size_t ret = 0;
+			for (size_t j = 0; j < i; ++j)
+				ret += sizes[j];
+			return ret;
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator -=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return *this -= t.value();
+		template<class Wire, size_t... I>
+		ITHARE_OBF_FORCEINLINE static void wire_store_fields(uint8_t* p, const uint32_t* buf, std::index_sequence<I...>) {
+			(Wire::template store<typename std::make_unsigned<field_type<I>>::type>(p + wire_offset(I), typename std::make_unsigned<field_type<I>>::type(from_lanes<I>(buf + first_lane(I)))), ...);
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator *=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return *this *= t.value();
+		template<class Wire, size_t... I>
+		ITHARE_OBF_FORCEINLINE void wire_load_fields(const uint8_t* p, std::index_sequence<I...>) {
+			encode_all(field_type<I>(Wire::template load<typename std::make_unsigned<field_type<I>>::type>(p + wire_offset(I)))...);
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator /=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return *this /= t.value();
+
+		std::array<uint32_t, szc> c;
+	};
+
+	//obf_flat_plan_fingerprint(): folds all the chains and nodes of Plan into h
+	template<class Plan>
+	constexpr uint64_t obf_flat_plan_fingerprint(uint64_t h) {
+		for (size_t i = 0; i < Plan::plan.n_chains; ++i) {
+			const ObfFlatChain& ch = Plan::plan.chains[i];
+			h = obf_hash_mix(h ^ uint64_t(ch.sz) ^ (uint64_t(ch.begin) << 8) ^ (uint64_t(ch.end) << 32));
 		}
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var& operator %=(obf_literal<T2, C2, seed2, cycles2> t) {
-			return *this %= t.value();
+		for (size_t i = 0; i < Plan::plan.n_nodes; ++i) {
+			const ObfFlatNode& node = Plan::plan.nodes[i];
+			h = obf_hash_mix(h ^ uint64_t(node.which) ^ (uint64_t(node.fwhich) << 8) ^ (uint64_t(node.neg) << 16) ^ (uint64_t(node.ctx_which) << 24));
+			h = obf_hash_mix(h ^ uint64_t(node.lo) ^ (uint64_t(node.hi) << 32));
+			h = obf_hash_mix(h ^ node.c);
+			h = obf_hash_mix(h ^ node.cinv);
+			h = obf_hash_mix(h ^ node.ctx_seed);
 		}
+		return h;
+	}
 
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var operator +(T2 t) { return obf_var(value()+t); }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var operator -(T2 t) { return obf_var(value() - t); }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var operator *(T2 t) { return obf_var(value() * t); }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var operator /(T2 t) { return obf_var(value() / t); }
-		template<class T2>
-		ITHARE_OBF_FORCEINLINE obf_var operator %(T2 t) { return obf_var(value() % t); }
-		
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator +(obf_var<T2,seed2,cycles2> t) { return obf_var(value() + t.value()); }
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator -(obf_var<T2, seed2, cycles2> t) { return obf_var(value() - t.value()); }
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator *(obf_var<T2, seed2, cycles2> t) { return obf_var(value() * t.value()); }
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator /(obf_var<T2, seed2, cycles2> t) { return obf_var(value() / t.value()); }
-		template<class T2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator %(obf_var<T2, seed2, cycles2> t) { return obf_var(value() % t.value()); }
+	//obf_wire: wire format for obf_wire_writer<>/obf_wire_reader<> - an injection per integral size, its leaves packed as for
+	//  obf_unordered_map<> (see obf_encoded_ops<>); both ends have to use the same wire_seed and cycles
+	//  (OBF?W(id) with the same id), AND have to be built with the same ITHARE_OBF_SEED (the trees depend on it too)
+	//  unlike all the other trees, wire ones MUST NOT depend on the compiler and build options, so they're built by obf_flat_plan<>
+	//    with fixed costs (obf_fixed_cycle_cost(), i.e. w/o ITHARE_OBF_CYCLE_COSTS_HEADER), w/o literal contexts (some of them
+	//    are compiler-specific), and w/o per-site adjustments (profile-guided cycles, ITHARE_OBF_CODE_SIZE_BOUNDED)
+	//  fingerprint identifies the format (all the nodes of all the 4 trees); obf_wire_writer<>::write_fingerprint() puts it
+	//    into the stream, for obf_wire_reader<>::read_fingerprint() to check; alternatively, static_assert() it on both ends
+	template<OBFSEED wire_seed, OBFCYCLES cycles>
+	struct obf_wire {
+		template<class T>
+		struct Type {
+			static_assert(std::is_unsigned<T>::value);
+			static constexpr OBFSEED seed = obf_compile_time_prng(wire_seed, int(sizeof(T)));
+			using Word = typename obf_flat_uint<sizeof(T)>::type;
+			using Plan = obf_flat_plan<sizeof(T), ObfFlatContextKind::zero, 0, 0, obf_compile_time_prng(seed, 2), cycles, size_t(-1), ~uint32_t(0), true>;
+			using Injection = obf_flat_chain<Word, Plan, 0>;
+			using EncodedOps = obf_encoded_ops<typename Injection::return_type>;
+		};
 
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator +(obf_literal<T2, C2, seed2, cycles2> t) { return obf_var(value() + t.value()); }
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator -(obf_literal<T2, C2, seed2, cycles2> t) { return obf_var(value() - t.value()); }
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator *(obf_literal<T2, C2, seed2, cycles2> t) { return obf_var(value() * t.value()); }
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator /(obf_literal<T2, C2, seed2, cycles2> t) { return obf_var(value() / t.value()); }
-		template<class T2, T2 C2, OBFSEED seed2, OBFCYCLES cycles2>
-		ITHARE_OBF_FORCEINLINE obf_var operator %(obf_literal<T2, C2, seed2, cycles2> t) { return obf_var(value() % t.value()); }
+		static constexpr uint64_t format_version = 2;//to be incremented on any change of the way wire trees are built or evaluated
+		static constexpr uint64_t fingerprint = obf_flat_plan_fingerprint<typename Type<uint64_t>::Plan>(obf_flat_plan_fingerprint<typename Type<uint32_t>::Plan>(
+			obf_flat_plan_fingerprint<typename Type<uint16_t>::Plan>(obf_flat_plan_fingerprint<typename Type<uint8_t>::Plan>(obf_hash_mix(format_version)))));
 
-		//TODO: bitwise
+		template<class T>
+		ITHARE_OBF_FORCEINLINE static void store(uint8_t* p, T x) {
+			using W = Type<T>;
+			obf_wire_store_le(p, typename W::Word(W::EncodedOps::pack(W::Injection::injection(typename W::Word(x)))));
+		}
+		template<class T>
+		ITHARE_OBF_FORCEINLINE static T load(const uint8_t* p) {
+			using W = Type<T>;
+			return T(W::Injection::surjection(W::EncodedOps::unpack(obf_wire_load_le<typename W::Word>(p))));
+		}
 
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_var<" << obf_dbgPrintT<T>() << "," << seed <<","<<cycles<<">" << std::endl;
-			Injection::dbgPrint(offset+1);
+			std::cout << std::string(offset, ' ') << prefix << "obf_wire<" << wire_seed << "," << cycles << ">: fingerprint=" << fingerprint << std::endl;
+			obf_flat_dbgPrintChain<typename Type<uint8_t>::Plan>(0, offset + 1, "uint8:");
+			obf_flat_dbgPrintChain<typename Type<uint16_t>::Plan>(0, offset + 1, "uint16:");
+			obf_flat_dbgPrintChain<typename Type<uint32_t>::Plan>(0, offset + 1, "uint32:");
+			obf_flat_dbgPrintChain<typename Type<uint64_t>::Plan>(0, offset + 1, "uint64:");
 		}
 #endif
-
-	private:
-		typename Injection::return_type val;
 	};
+	constexpr OBFSEED obf_wire_seed(uint64_t id) {//independent of the site, but not of ITHARE_OBF_SEED
+		return obf_compile_time_prng(ITHARE_OBF_SEED ^ UINT64_C(0x3c6ef372fe94f82b) ^ id, 1);
+	}
 
 	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_str_literal_dbg<>
 	template<OBFSEED seed, OBFCYCLES cycles, char... C>//TODO! - wchar_t
@@ -1659,6 +6861,10 @@ namespace obf {
 		static_assert(sz4 > 0);
 		static_assert(sz4 <= 8);//corresponds to max literal = 32, TODO: more later
 		static constexpr uint32_t FILLER = uint32_t(obf_compile_time_prng(seed,1));
+		static constexpr OBFSEED tree_seed = obf_tree_seed(seed);//for injections (and their split) only; the rest is per-site
+
+#ifndef ITHARE_OBF_SIMD_STR_LITERALS
+		static constexpr size_t szc = sz4;//words in c
 
 		constexpr static std::array<ObfDescriptor, 8> split{
 			ObfDescriptor(true,0,100),//Injection0
@@ -1670,7 +6876,7 @@ namespace obf {
 			ObfDescriptor(true,0,sz4>6 ? 100 : 0),//Injection6
 			ObfDescriptor(true,0,sz4>7 ? 100 : 0),//Injection7
 		};
-		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(seed, 2), cycles, split);
+		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(tree_seed, 2), cycles, split);
 		static constexpr OBFCYCLES split0 = splitCycles[0];
 		static constexpr OBFCYCLES split1 = splitCycles[1];
 		static constexpr OBFCYCLES split2 = splitCycles[2];
@@ -1680,26 +6886,49 @@ namespace obf {
 		static constexpr OBFCYCLES split6 = splitCycles[6];
 		static constexpr OBFCYCLES split7 = splitCycles[7];
 
-		using Injection0 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 3), std::max(split0,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection0::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
-		using Injection1 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 4), std::max(split1,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection1::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
-		using Injection2 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 5), std::max(split2,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection2::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
-		using Injection3 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 6), std::max(split3,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection3::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
-		using Injection4 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 7), std::max(split4,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection4::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
-		using Injection5 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 8), std::max(split5,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection5::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
-		using Injection6 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 9), std::max(split6,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection6::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
-		using Injection7 = obf_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(seed, 10), std::max(split7,2), ObfDefaultInjectionContext>;
-		static_assert(sizeof(Injection7::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection0 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 3), obf_tree_cycles(std::max(split0,2))>;
+		static_assert(sizeof(typename Injection0::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection1 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 4), obf_tree_cycles(std::max(split1,2))>;
+		static_assert(sizeof(typename Injection1::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection2 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 5), obf_tree_cycles(std::max(split2,2))>;
+		static_assert(sizeof(typename Injection2::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection3 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 6), obf_tree_cycles(std::max(split3,2))>;
+		static_assert(sizeof(typename Injection3::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection4 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 7), obf_tree_cycles(std::max(split4,2))>;
+		static_assert(sizeof(typename Injection4::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection5 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 8), obf_tree_cycles(std::max(split5,2))>;
+		static_assert(sizeof(typename Injection5::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection6 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 9), obf_tree_cycles(std::max(split6,2))>;
+		static_assert(sizeof(typename Injection6::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+		using Injection7 = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 10), obf_tree_cycles(std::max(split7,2))>;
+		static_assert(sizeof(typename Injection7::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+#else
+		//ITHARE_OBF_SIMD_STR_LITERALS: word #i is injected as Injection(word + K[i]), with one Injection for all the words,
+		//  which is lane-wise (see obf_array<>), so value() decodes all the words in one SSE2/AVX2 pass over c
+		//  Injection gets the same cycles as each of Injection0..7 would get on average; then it is as deep per word,
+		//  and all the words together cost about as much as one of them (giving it all the cycles would make it sz4 times deeper instead)
+		static constexpr size_t szc = sz4 > 4 ? 8 : 4;//words in c, padded up to SSE2/AVX2 vector
+		using Plan = obf_flat_plan<sizeof(uint32_t), ObfFlatContextKind::zero, 0, 0, obf_compile_time_prng(tree_seed, 3), obf_tree_cycles(std::max(OBFCYCLES(cycles / sz4), 2)), size_t(-1), obf_array_versions>;
+		using Kernel = obf_array_kernel<uint32_t, Plan>;
+		//a single word has nothing to gain from lanes, so it gets an unrestricted injection (same as Injection0 in scalar mode)
+		using Injection = typename std::conditional<sz4 == 1,
+			obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 3), obf_tree_cycles(std::max(cycles, 2))>,
+			obf_flat_chain<uint32_t, Plan, 0>>::type;
+		static_assert(sizeof(typename Injection::return_type) == sizeof(uint32_t));//MUST be bijection
+
+		static constexpr std::array<uint32_t, szc> lane_consts() {
+			std::array<uint32_t, szc> ret = {};
+			for (size_t i = 0; i < szc; ++i)
+				ret[i] = uint32_t(obf_compile_time_prng(seed, 11 + int(i)));
+			return ret;
+		}
+		static constexpr std::array<uint32_t, szc> K = lane_consts();
+#endif
 
 		ITHARE_OBF_FORCEINLINE static constexpr uint32_t little_endian4(const char* str, size_t offset) {//TODO: BIG-ENDIAN
 			//replacement for non-constexpr return *(uint32_t*)(str + offset);
-			return str[offset] | (uint32_t(str[offset + 1]) << 8) | (uint32_t(str[offset + 2]) << 16) | (uint32_t(str[offset + 3]) << 24);
+			//NB: via uint8_t, otherwise chars >= 0x80 are sign-extended over the upper bytes
+			return uint32_t(uint8_t(str[offset])) | (uint32_t(uint8_t(str[offset + 1])) << 8) | (uint32_t(uint8_t(str[offset + 2])) << 16) | (uint32_t(uint8_t(str[offset + 3])) << 24);
 		}
 		ITHARE_OBF_FORCEINLINE static constexpr uint32_t last4(char const str[origSz], size_t offset, uint32_t filler) {
 			assert(origSz > offset);
@@ -1723,8 +6952,9 @@ namespace obf {
 			else
 				return last4(str, offset,FILLER);
 		}
-		ITHARE_OBF_FORCEINLINE static constexpr std::array<uint32_t, sz4> str_obf() {
-			std::array<uint32_t, sz4> ret = {};
+#ifndef ITHARE_OBF_SIMD_STR_LITERALS
+		ITHARE_OBF_FORCEINLINE static constexpr std::array<uint32_t, szc> str_obf() {
+			std::array<uint32_t, szc> ret = {};
 			ret[0] = Injection0::injection(get4(str,0));
 			if constexpr(sz4 > 1)
 				ret[1] = Injection1::injection(get4(str, 4));
@@ -1742,12 +6972,22 @@ namespace obf {
 				ret[7] = Injection7::injection(get4(str, 28));
 			return ret;
 		}
+#else
+		ITHARE_OBF_FORCEINLINE static constexpr std::array<uint32_t, szc> str_obf() {
+			std::array<uint32_t, szc> ret = {};
+			for (size_t i = 0; i < szc; ++i)//padding words are mere filler
+				ret[i] = Injection::injection(uint32_t((i < sz4 ? get4(str, i * 4) : FILLER) + K[i]));
+			return ret;
+		}
+#endif
 
-		static constexpr std::array<uint32_t, sz4> strC = str_obf();
+		static constexpr std::array<uint32_t, szc> strC = str_obf();
 
-		static std::array<uint32_t, sz4> c;//TODO: volatile
-		ITHARE_OBF_FORCEINLINE std::string value() const {
-			char buf[sz4 * 4];
+		static std::array<uint32_t, szc> c;//TODO: volatile
+		static constexpr size_t buf_size = szc * 4;//decode() writes whole words, including padding
+
+#ifndef ITHARE_OBF_SIMD_STR_LITERALS
+		ITHARE_OBF_FORCEINLINE static void decode_words(char* buf) {
 			*(uint32_t*)(buf + 0) = Injection0::surjection(c[0]);
 			if constexpr(sz4 > 1)
 				*(uint32_t*)(buf + 4) = Injection1::surjection(c[1]);
@@ -1763,36 +7003,326 @@ namespace obf {
 				*(uint32_t*)(buf + 24) = Injection6::surjection(c[6]);
 			if constexpr(sz4 > 7)
 				*(uint32_t*)(buf + 28) = Injection7::surjection(c[7]);
-			return std::string(buf,sz);
+		}
+#else
+		ITHARE_OBF_FORCEINLINE static void decode_words(char* buf) {
+#ifdef ITHARE_OBF_SIMD
+			if constexpr(sz4 == 1)
+				*(uint32_t*)buf = uint32_t(Injection::surjection(c[0]) - K[0]);
+			else {
+#ifndef ITHARE_OBF_NO_AVX2
+				if constexpr(szc == 8) {
+					if (obf_cpu_has_avx2()) {
+						decode_avx2(buf);
+						return;
+					}
+				}
+#endif
+				decode_sse2(buf);
+			}
+#else
+			for (size_t i = 0; i < sz4; ++i)
+				*(uint32_t*)(buf + i * 4) = uint32_t(Injection::surjection(c[i]) - K[i]);
+#endif
+		}
+#endif
+
+		using Stats = obf_site_stats<obf_str_literal, ObfSiteKind::str_literal, sz, seed, cycles, cycles>;
+		ITHARE_OBF_FORCEINLINE static void decode(char* buf) {
+			Stats::decode([buf] { decode_words(buf); });
+		}
+
+		ITHARE_OBF_FORCEINLINE obf_str_literal(ITHARE_OBF_SITE_LOC_PARAM0) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr size_t size() {
+			return sz;
+		}
+		ITHARE_OBF_FORCEINLINE std::string value() const {
+			char buf[buf_size];
+			decode(buf);
+			return std::string(buf, sz);
+		}
+		ITHARE_OBF_FORCEINLINE operator std::string() const {
+			return value();
+		}
+
+		//zero-allocation access
+		//value_to(): writes sz chars and '\0' to dst; returns sz
+		//  as with snprintf(), a return value >= dstSz means that dst was too small: then nothing is decoded into it,
+		//  and dst gets just '\0' (unless dstSz == 0)
+		ITHARE_OBF_FORCEINLINE size_t value_to(char* dst, size_t dstSz) const {
+			if (dstSz <= sz) {
+				if (dstSz)
+					dst[0] = 0;
+				return sz;
+			}
+			if (dstSz >= buf_size)
+				decode(dst);
+			else {
+				char buf[buf_size];
+				decode(buf);
+				memcpy(dst, buf, sz);
+				obf_wipe(buf, buf_size);
+			}
+			dst[sz] = 0;
+			return sz;
+		}
+		template<size_t N>
+		ITHARE_OBF_FORCEINLINE size_t value_to(char(&dst)[N]) const {
+			static_assert(N > sz);
+			return value_to(dst, N);
+		}
+		//value_buf(): decoded string on stack (wiped when it goes out of scope)
+		ITHARE_OBF_FORCEINLINE obf_str_buf<buf_size + 1> value_buf() const {
+			return obf_str_buf<buf_size + 1>(*this);
+		}
+		friend std::ostream& operator <<(std::ostream& os, const obf_str_literal& s) {
+			return os << s.value_buf();
+		}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+			std::cout << std::string(offset, ' ') << prefix << "obf_str_literal<'" << str << "'," << seed << "," << cycles << ">" << std::endl;
+#ifdef ITHARE_OBF_SIMD_STR_LITERALS
+			if constexpr(sz4 == 1)
+				Injection::dbgPrint(offset + 1, "Injection:");
+			else {
+				std::cout << std::string(offset + 1, ' ') << "Injection: nodes=" << Plan::plan.n_nodes << " chains=" << Plan::plan.n_chains << std::endl;
+				obf_flat_dbgPrintChain<Plan>(0, offset + 2, "");
+			}
+#else
+			Injection0::dbgPrint(offset + 1, "Injection0:");
+			if constexpr(sz4 > 1)
+				Injection1::dbgPrint(offset+1,"Injection1:");
+			if constexpr(sz4 > 2)
+				Injection2::dbgPrint(offset + 1, "Injection2:");
+			if constexpr(sz4 > 3)
+				Injection3::dbgPrint(offset + 1, "Injection3:");
+			if constexpr(sz4 > 4)
+				Injection4::dbgPrint(offset + 1, "Injection4:");
+			if constexpr(sz4 > 5)
+				Injection5::dbgPrint(offset + 1, "Injection5:");
+			if constexpr(sz4 > 6)
+				Injection6::dbgPrint(offset + 1, "Injection6:");
+			if constexpr(sz4 > 7)
+				Injection7::dbgPrint(offset + 1, "Injection7:");
+#endif
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_str_literal", role);
+			w.string("str", str, sz);
+			w.unumber("size", sz);
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.resources(ObfJsonResources{ int(szc), 0, sizeof(c), 0 });//encoded words are global
+			w.children();
+#ifdef ITHARE_OBF_SIMD_STR_LITERALS
+			if constexpr(sz4 == 1)
+				Injection::dbgJson(w, "Injection");
+			else
+				obf_flat_dbgJsonChain<Plan, 0>(w, "Injection");
+#else
+			Injection0::dbgJson(w, "Injection0");
+			if constexpr(sz4 > 1)
+				Injection1::dbgJson(w, "Injection1");
+			if constexpr(sz4 > 2)
+				Injection2::dbgJson(w, "Injection2");
+			if constexpr(sz4 > 3)
+				Injection3::dbgJson(w, "Injection3");
+			if constexpr(sz4 > 4)
+				Injection4::dbgJson(w, "Injection4");
+			if constexpr(sz4 > 5)
+				Injection5::dbgJson(w, "Injection5");
+			if constexpr(sz4 > 6)
+				Injection6::dbgJson(w, "Injection6");
+			if constexpr(sz4 > 7)
+				Injection7::dbgJson(w, "Injection7");
+#endif
+			w.end();
+		}
+#endif
+
+#if defined(ITHARE_OBF_SIMD_STR_LITERALS) && defined(ITHARE_OBF_SIMD)
+	private:
+		ITHARE_OBF_SIMD_ENTRY static void decode_sse2(char* buf) {
+			using V = obf_simd_sse2<uint32_t>;
+			for (size_t i = 0; i < szc; i += V::lanes) {
+				typename V::vec y = V::load(c.data() + i);
+				Kernel::template surjection_vec<V>(y);
+				V::store(buf + i * 4, V::sub(y, V::load(K.data() + i)));
+			}
+		}
+#ifndef ITHARE_OBF_NO_AVX2
+		ITHARE_OBF_AVX2_ENTRY static void decode_avx2(char* buf) {
+			using V = obf_simd_avx2<uint32_t>;
+			static_assert(szc == V::lanes);
+			typename V::vec y = V::load(c.data());
+			Kernel::template surjection_vec<V>(y);
+			V::store(buf, V::sub(y, V::load(K.data())));
+		}
+#endif
+#endif
+	};
+
+	template<OBFSEED seed, OBFCYCLES cycles, char... C>
+	std::array<uint32_t, obf_str_literal<seed,cycles,C...>::szc> obf_str_literal<seed,cycles,C...>::c = strC;
+
+#ifdef ITHARE_OBF_FIXED_STR
+	//obf_fixed_str_literal: same as obf_str_literal<>, but for literals of any length
+	//  words are split into up to 8 chunks of adjacent words, each chunk having its own injection (so for up to 32 chars it is one injection per word,
+	//  exactly as in obf_str_literal<>); word #i is injected as Injection<chunk>(word + K[i]), so that equal words within one chunk are not encoded the same way
+	//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_fixed_str_literal_dbg<>
+	template<OBFSEED seed, OBFCYCLES cycles, obf_fixed_str S>
+	struct obf_fixed_str_literal {
+		static constexpr size_t sz = S.size();
+		static_assert(sz > 0);
+		static constexpr size_t sz4 = (sz + 3) / 4;
+		static constexpr size_t maxChunks = 8;
+		static constexpr size_t chunkWords = (sz4 + maxChunks - 1) / maxChunks;
+		static constexpr size_t nChunks = (sz4 + chunkWords - 1) / chunkWords;
+		static constexpr uint32_t FILLER = uint32_t(obf_compile_time_prng(seed, 1));
+		static constexpr OBFSEED tree_seed = obf_tree_seed(seed);//for injections (and their split) only; the rest is per-site
+
+		template<size_t... J>
+		static constexpr std::array<ObfDescriptor, nChunks> split_descr(std::index_sequence<J...>) {
+			return { ((void)J, ObfDescriptor(true, 0, 100))... };
+		}
+		static constexpr auto splitCycles = obf_random_split(obf_compile_time_prng(tree_seed, 2), cycles, split_descr(std::make_index_sequence<nChunks>()));
+
+		template<size_t j>
+		using Injection = obf_site_injection<uint32_t, ObfZeroLiteralContext<uint32_t>, obf_compile_time_prng(tree_seed, 3 + int(j)), obf_tree_cycles(std::max(OBFCYCLES(splitCycles[j] / OBFCYCLES(chunkWords)), 2))>;
+
+		static constexpr std::array<uint32_t, sz4> word_consts() {
+			std::array<uint32_t, sz4> ret = {};
+			if constexpr(chunkWords > 1) {
+				for (size_t i = 0; i < sz4; ++i)
+					ret[i] = uint32_t(obf_compile_time_prng(seed, 3 + int(maxChunks + i)));
+			}
+			return ret;
+		}
+		static constexpr std::array<uint32_t, sz4> K = word_consts();
+
+		ITHARE_OBF_FORCEINLINE static constexpr uint32_t get4(size_t offset) {//TODO: BIG-ENDIAN
+			uint32_t ret = 0;
+			for (size_t i = 0; i < 4; ++i) {
+				uint8_t ch = offset + i < sz ? uint8_t(S.data[offset + i]) : uint8_t(FILLER >> (i * 8));
+				ret |= uint32_t(ch) << (i * 8);
+			}
+			return ret;
+		}
+		template<size_t j>
+		ITHARE_OBF_FORCEINLINE static constexpr void chunk_obf(std::array<uint32_t, sz4>& ret) {
+			static_assert(sizeof(typename Injection<j>::return_type) == sizeof(uint32_t));//MUST be bijection, TODO: enforce
+			for (size_t i = j * chunkWords; i < sz4 && i < (j + 1) * chunkWords; ++i)
+				ret[i] = Injection<j>::injection(uint32_t(get4(i * 4) + K[i]));
+		}
+		template<size_t... J>
+		ITHARE_OBF_FORCEINLINE static constexpr std::array<uint32_t, sz4> str_obf(std::index_sequence<J...>) {
+			std::array<uint32_t, sz4> ret = {};
+			(chunk_obf<J>(ret), ...);
+			return ret;
+		}
+
+		static constexpr std::array<uint32_t, sz4> strC = str_obf(std::make_index_sequence<nChunks>());
+
+		static std::array<uint32_t, sz4> c;//TODO: volatile
+		static constexpr size_t buf_size = sz4 * 4;
+		using Stats = obf_site_stats<obf_fixed_str_literal, ObfSiteKind::str_literal, sz, seed, cycles, cycles>;
+
+		ITHARE_OBF_FORCEINLINE obf_fixed_str_literal(ITHARE_OBF_SITE_LOC_PARAM0) {
+			Stats::locate(ITHARE_OBF_SITE_LOC);
+		}
+		ITHARE_OBF_FORCEINLINE static constexpr size_t size() {
+			return sz;
+		}
+		ITHARE_OBF_FORCEINLINE std::string value() const {
+			char buf[buf_size];
+			decode(buf, std::make_index_sequence<nChunks>());
+			return std::string(buf, sz);
 		}
 		ITHARE_OBF_FORCEINLINE operator std::string() const {
 			return value();
 		}
 
+		//zero-allocation access, same as in obf_str_literal<>
+		ITHARE_OBF_FORCEINLINE size_t value_to(char* dst, size_t dstSz) const {
+			if (dstSz <= sz) {//see obf_str_literal<>::value_to()
+				if (dstSz)
+					dst[0] = 0;
+				return sz;
+			}
+			if (dstSz >= buf_size)
+				decode(dst, std::make_index_sequence<nChunks>());
+			else {
+				char buf[buf_size];
+				decode(buf, std::make_index_sequence<nChunks>());
+				memcpy(dst, buf, sz);
+				obf_wipe(buf, buf_size);
+			}
+			dst[sz] = 0;
+			return sz;
+		}
+		template<size_t N>
+		ITHARE_OBF_FORCEINLINE size_t value_to(char(&dst)[N]) const {
+			static_assert(N > sz);
+			return value_to(dst, N);
+		}
+		ITHARE_OBF_FORCEINLINE obf_str_buf<buf_size + 1> value_buf() const {
+			return obf_str_buf<buf_size + 1>(*this);
+		}
+		friend std::ostream& operator <<(std::ostream& os, const obf_fixed_str_literal& s) {
+			return os << s.value_buf();
+		}
+
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		static void dbgPrint(size_t offset = 0, const char* prefix = "") {
-			std::cout << std::string(offset, ' ') << prefix << "obf_str_literal<'" << str << "'," << seed << "," << cycles << ">" << std::endl;
-			Injection0::dbgPrint(offset + 1, "Injection0:");
-			if constexpr(sz4 > 1)
-				Injection1::dbgPrint(offset+1,"Injection1:");
-			if constexpr(sz4 > 2)
-				Injection2::dbgPrint(offset + 1, "Injection2:");
-			if constexpr(sz4 > 3)
-				Injection3::dbgPrint(offset + 1, "Injection3:");
-			if constexpr(sz4 > 4)
-				Injection4::dbgPrint(offset + 1, "Injection4:");
-			if constexpr(sz4 > 5)
-				Injection5::dbgPrint(offset + 1, "Injection5:");
-			if constexpr(sz4 > 6)
-				Injection6::dbgPrint(offset + 1, "Injection6:");
-			if constexpr(sz4 > 7)
-				Injection7::dbgPrint(offset + 1, "Injection7:");
+			std::cout << std::string(offset, ' ') << prefix << "obf_fixed_str_literal<'" << S.data << "'," << seed << "," << cycles << ">: chunks=" << nChunks << "x" << chunkWords << std::endl;
+			dbgPrintChunks(offset + 1, std::make_index_sequence<nChunks>());
+		}
+		template<size_t... J>
+		static void dbgPrintChunks(size_t offset, std::index_sequence<J...>) {
+			(Injection<J>::dbgPrint(offset, ("Injection" + std::to_string(J) + ":").c_str()), ...);
+		}
+		static constexpr void dbgJson(ObfJsonWriter& w, const char* role = "") {
+			w.begin("obf_fixed_str_literal", role);
+			w.string("str", S.data, sz);
+			w.unumber("size", sz);
+			w.hex("seed", seed);
+			w.number("cycles", cycles);
+			w.unumber("chunks", nChunks);
+			w.unumber("chunk_words", chunkWords);
+			w.resources(ObfJsonResources{ int(sz4), 0, sizeof(c), 0 });//encoded words are global
+			w.children();
+			dbgJsonChunks(w, std::make_index_sequence<nChunks>());//children are chunks, in order
+			w.end();
+		}
+		template<size_t... J>
+		static constexpr void dbgJsonChunks(ObfJsonWriter& w, std::index_sequence<J...>) {
+			(Injection<J>::dbgJson(w, "Injection"), ...);
 		}
 #endif
+
+	private:
+		template<size_t j>
+		ITHARE_OBF_FORCEINLINE static void chunk_decode(char* buf) {
+			for (size_t i = j * chunkWords; i < sz4 && i < (j + 1) * chunkWords; ++i)
+				*(uint32_t*)(buf + i * 4) = uint32_t(Injection<j>::surjection(c[i]) - K[i]);
+		}
+		template<size_t... J>
+		ITHARE_OBF_FORCEINLINE static void decode(char* buf, std::index_sequence<J...>) {
+			Stats::decode([buf] {
+				if constexpr(chunkWords == 1)//straight-line, same as obf_str_literal<> (K is all-zero then)
+					((*(uint32_t*)(buf + J * 4) = uint32_t(Injection<J>::surjection(c[J]))), ...);
+				else
+					(chunk_decode<J>(buf), ...);
+			});
+		}
 	};
 
-	template<OBFSEED seed, OBFCYCLES cycles, char... C>
-	std::array<uint32_t, obf_str_literal<seed,cycles,C...>::sz4> obf_str_literal<seed,cycles,C...>::c = strC;
+	template<OBFSEED seed, OBFCYCLES cycles, obf_fixed_str S>
+	std::array<uint32_t, obf_fixed_str_literal<seed, cycles, S>::sz4> obf_fixed_str_literal<seed, cycles, S>::c = strC;
+#endif
 
 	//USER-LEVEL:
 	/*think about it further //  obfN<> templates
@@ -1825,7 +7355,19 @@ namespace obf {
 }//namespace obf
 }//namespace ithare
 
+namespace std {
+	template<class T_, ithare::obf::OBFSEED seed, ithare::obf::OBFCYCLES cycles>
+	struct hash<ithare::obf::obf_var<T_, seed, cycles>> {
+		size_t operator()(const ithare::obf::obf_var<T_, seed, cycles>& v) const {
+			return v.encoded_hash();
+		}
+	};
+}//namespace std
+
  //macros; DON'T belong to the namespace...
+#ifdef ITHARE_OBF_FIXED_STR
+#define ITHARE_OBFS_HELPER(seed,cycles,s) ithare::obf::obf_fixed_str_literal<seed,cycles,ithare::obf::obf_fixed_str(s)>
+#else
 #define ITHARE_OBFS_HELPER(seed,cycles,s) obf_str_literal<seed,cycles,(sizeof(s)>0?s[0]:'\0'),(sizeof(s)>1?s[1]:'\0'),(sizeof(s)>2?s[2]:'\0'),(sizeof(s)>3?s[3]:'\0'),\
 							(sizeof(s)>4?s[4]:'\0'),(sizeof(s)>5?s[5]:'\0'),(sizeof(s)>6?s[6]:'\0'),(sizeof(s)>7?s[7]:'\0'),\
 							(sizeof(s)>8?s[8]:'\0'),(sizeof(s)>9?s[9]:'\0'),(sizeof(s)>10?s[10]:'\0'),(sizeof(s)>11?s[11]:'\0'),\
@@ -1835,6 +7377,7 @@ namespace obf {
 							(sizeof(s)>24?s[24]:'\0'),(sizeof(s)>25?s[25]:'\0'),(sizeof(s)>26?s[26]:'\0'),(sizeof(s)>27?s[27]:'\0'),\
 							(sizeof(s)>28?s[28]:'\0'),(sizeof(s)>29?s[29]:'\0'),(sizeof(s)>30?s[30]:'\0'),(sizeof(s)>31?s[31]:'\0'),\
 							(sizeof(s)>32?s[32]:'\0')/*one extra to generate an error if we're over*/>
+#endif
 
 #ifdef _MSC_VER
  //direct use of __LINE__ doesn't count as constexpr in MSVC - don't ask why...
@@ -1860,6 +7403,55 @@ namespace obf {
 #define ITHARE_OBF5I(c) obf_literal<decltype(c),c,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>()
 #define ITHARE_OBF6I(c) obf_literal<decltype(c),c,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>()
 
+#define ITHARE_OBF0A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0)>
+#define ITHARE_OBF1A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1)>
+#define ITHARE_OBF2A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2)>
+#define ITHARE_OBF3A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3)>
+#define ITHARE_OBF4A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4)>
+#define ITHARE_OBF5A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>
+#define ITHARE_OBF6A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>
+
+#define ITHARE_OBF0V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0)>
+#define ITHARE_OBF1V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1)>
+#define ITHARE_OBF2V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2)>
+#define ITHARE_OBF3V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3)>
+#define ITHARE_OBF4V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4)>
+#define ITHARE_OBF5V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>
+#define ITHARE_OBF6V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>
+
+#define ITHARE_OBF0M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0)>
+#define ITHARE_OBF1M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1)>
+#define ITHARE_OBF2M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2)>
+#define ITHARE_OBF3M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3)>
+#define ITHARE_OBF4M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4)>
+#define ITHARE_OBF5M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>
+#define ITHARE_OBF6M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>
+
+#define ITHARE_OBF0MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),true>
+#define ITHARE_OBF1MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),true>
+#define ITHARE_OBF2MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),true>
+#define ITHARE_OBF3MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3),true>
+#define ITHARE_OBF4MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4),true>
+#define ITHARE_OBF5MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),true>
+#define ITHARE_OBF6MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),true>
+
+#define ITHARE_OBF0R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),__VA_ARGS__>
+#define ITHARE_OBF1R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),__VA_ARGS__>
+#define ITHARE_OBF2R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),__VA_ARGS__>
+#define ITHARE_OBF3R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3),__VA_ARGS__>
+#define ITHARE_OBF4R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4),__VA_ARGS__>
+#define ITHARE_OBF5R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),__VA_ARGS__>
+#define ITHARE_OBF6R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),__VA_ARGS__>
+
+//NB: no ITHARE_OBF_SCALE for wire formats: both ends have to agree on them
+#define ITHARE_OBF0W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(0)>
+#define ITHARE_OBF1W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(1)>
+#define ITHARE_OBF2W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(2)>
+#define ITHARE_OBF3W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(3)>
+#define ITHARE_OBF4W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(4)>
+#define ITHARE_OBF5W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(5)>
+#define ITHARE_OBF6W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(6)>
+
 #define ITHARE_OBF0S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),s)()
 #define ITHARE_OBF1S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),s)()
 #define ITHARE_OBF2S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),s)()
@@ -1868,6 +7460,15 @@ namespace obf {
 #define ITHARE_OBF5S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),s)()
 #define ITHARE_OBF6S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),s)()
 
+//OBF?SL(): string literal object itself (w/o decoding it into std::string), for zero-allocation value_to()/value_buf()/operator <<
+#define ITHARE_OBF0SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),s)()
+#define ITHARE_OBF1SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),s)()
+#define ITHARE_OBF2SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),s)()
+#define ITHARE_OBF3SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3),s)()
+#define ITHARE_OBF4SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4),s)()
+#define ITHARE_OBF5SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),s)()
+#define ITHARE_OBF6SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(ITHARE_OBF_LOCATION,0,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),s)()
+
 #else//_MSC_VER
 #define ITHARE_OBF0(type) ithare::obf::obf_var<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0)>
 #define ITHARE_OBF1(type) ithare::obf::obf_var<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1)>
@@ -1885,6 +7486,55 @@ namespace obf {
 #define ITHARE_OBF5I(c) obf_literal<decltype(c),c,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>()
 #define ITHARE_OBF6I(c) obf_literal<decltype(c),c,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>()
 
+#define ITHARE_OBF0A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0)>
+#define ITHARE_OBF1A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1)>
+#define ITHARE_OBF2A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2)>
+#define ITHARE_OBF3A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3)>
+#define ITHARE_OBF4A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4)>
+#define ITHARE_OBF5A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>
+#define ITHARE_OBF6A(type,n) ithare::obf::obf_array<type,n,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>
+
+#define ITHARE_OBF0V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0)>
+#define ITHARE_OBF1V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1)>
+#define ITHARE_OBF2V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2)>
+#define ITHARE_OBF3V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3)>
+#define ITHARE_OBF4V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4)>
+#define ITHARE_OBF5V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>
+#define ITHARE_OBF6V(type) ithare::obf::obf_vector<type,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>
+
+#define ITHARE_OBF0M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0)>
+#define ITHARE_OBF1M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1)>
+#define ITHARE_OBF2M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2)>
+#define ITHARE_OBF3M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3)>
+#define ITHARE_OBF4M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4)>
+#define ITHARE_OBF5M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5)>
+#define ITHARE_OBF6M(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6)>
+
+#define ITHARE_OBF0MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),true>
+#define ITHARE_OBF1MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),true>
+#define ITHARE_OBF2MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),true>
+#define ITHARE_OBF3MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3),true>
+#define ITHARE_OBF4MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4),true>
+#define ITHARE_OBF5MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),true>
+#define ITHARE_OBF6MV(key,value) ithare::obf::obf_unordered_map<key,value,ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),true>
+
+#define ITHARE_OBF0R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),__VA_ARGS__>
+#define ITHARE_OBF1R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),__VA_ARGS__>
+#define ITHARE_OBF2R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),__VA_ARGS__>
+#define ITHARE_OBF3R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3),__VA_ARGS__>
+#define ITHARE_OBF4R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4),__VA_ARGS__>
+#define ITHARE_OBF5R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),__VA_ARGS__>
+#define ITHARE_OBF6R(...) ithare::obf::obf_record<ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),__VA_ARGS__>
+
+//NB: no ITHARE_OBF_SCALE for wire formats: both ends have to agree on them
+#define ITHARE_OBF0W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(0)>
+#define ITHARE_OBF1W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(1)>
+#define ITHARE_OBF2W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(2)>
+#define ITHARE_OBF3W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(3)>
+#define ITHARE_OBF4W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(4)>
+#define ITHARE_OBF5W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(5)>
+#define ITHARE_OBF6W(id) ithare::obf::obf_wire<ithare::obf::obf_wire_seed(id),ithare::obf::obf_exp_cycles(6)>
+
 #define ITHARE_OBF0S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),s)().value()
 #define ITHARE_OBF1S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),s)().value()
 #define ITHARE_OBF2S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),s)().value()
@@ -1893,18 +7543,26 @@ namespace obf {
 #define ITHARE_OBF5S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),s)().value()
 #define ITHARE_OBF6S(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),s)().value()
 
+#define ITHARE_OBF0SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+0),s)()
+#define ITHARE_OBF1SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+1),s)()
+#define ITHARE_OBF2SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+2),s)()
+#define ITHARE_OBF3SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+3),s)()
+#define ITHARE_OBF4SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+4),s)()
+#define ITHARE_OBF5SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+5),s)()
+#define ITHARE_OBF6SL(s) ITHARE_OBFS_HELPER(ithare::obf::obf_seed_from_file_line_counter(__FILE__,__LINE__,__COUNTER__),ithare::obf::obf_exp_cycles((ITHARE_OBF_SCALE)+6),s)()
+
 #endif
 
 #else//ITHARE_OBF_SEED
 namespace ithare {
 	namespace obf {
-#ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		constexpr size_t obf_strlen(const char* s) {
 			for (size_t ret = 0; ; ++ret, ++s)
 				if (*s == 0)
 					return ret;
 		}
 
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
 		//dbgPrint helpers
 		template<class T>
 		std::string obf_dbgPrintT() {
@@ -1918,14 +7576,15 @@ namespace ithare {
 		//obf_literal_dbg
 		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_literal<>
 		template<class T, T C>
-		class obf_literal_dbg {
+		class obf_literal_dbg : private obf_dbg_site<ObfSiteKind::literal, sizeof(T)> {
 			static_assert(std::is_integral<T>::value);
+			using Site = obf_dbg_site<ObfSiteKind::literal, sizeof(T)>;
 
 		public:
-			constexpr obf_literal_dbg() : val(C) {
+			constexpr obf_literal_dbg(ITHARE_OBF_SITE_LOC_PARAM0) : Site(ITHARE_OBF_SITE_LOC), val(C) {
 			}
 			T value() const {
-				return val;
+				return this->decode([&] { return val; });
 			}
 			operator T() const {
 				return value();
@@ -1943,42 +7602,72 @@ namespace ithare {
 		//obf_var_dbg
 		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_var<>
 		template<class T>
-		class obf_var_dbg {
+		class obf_var_dbg : private obf_dbg_site<ObfSiteKind::var, sizeof(T)> {
 			static_assert(std::is_integral<T>::value);
+			using Site = obf_dbg_site<ObfSiteKind::var, sizeof(T)>;
 
 		public:
-			obf_var_dbg(T t) : val(t) {
+			obf_var_dbg(T t ITHARE_OBF_SITE_LOC_PARAM) : Site(ITHARE_OBF_SITE_LOC), val(t) {
+				this->encoded();
 			}
 			template<class T2>
-			obf_var_dbg(obf_var_dbg<T2> t) : val(T(t.value())) {
+			obf_var_dbg(obf_var_dbg<T2> t ITHARE_OBF_SITE_LOC_PARAM) : Site(ITHARE_OBF_SITE_LOC), val(T(t.value())) {
+				this->encoded();
 			}
 			template<class T2,T2 C2>
-			obf_var_dbg(obf_literal_dbg<T2,C2> t) : val(T(t.value())) {
+			obf_var_dbg(obf_literal_dbg<T2,C2> t ITHARE_OBF_SITE_LOC_PARAM) : Site(ITHARE_OBF_SITE_LOC), val(T(t.value())) {
+				this->encoded();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg(const obf_expr<T2, Op, L, R>& e ITHARE_OBF_SITE_LOC_PARAM) : Site(ITHARE_OBF_SITE_LOC), val(T(e.value())) {
+				this->encoded();
 			}
 			obf_var_dbg& operator =(T t) {
+				this->encoded();
 				val = t;
 				return *this;
 			}
 			template<class T2>
 			obf_var_dbg& operator =(obf_var_dbg<T2> t) {
+				this->encoded();
 				val = T(t.value());
 				return *this;
 			}
 			template<class T2, T2 C2>
 			obf_var_dbg& operator =(obf_literal_dbg<T2,C2> t) {
+				this->encoded();
 				val = T(t.value());
 				return *this;
 			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator =(const obf_expr<T2, Op, L, R>& e) {
+				this->encoded();
+				val = T(e.value());
+				return *this;
+			}
 
 			T value() const {
-				return val;
+				return this->decode([&] { return val; });
 			}
 			operator T() const { return value(); }
+			size_t encoded_hash() const {
+				return size_t(obf_hash_mix(uint64_t(val)));
+			}
+
+			static constexpr size_t wire_size = sizeof(T);
+			template<class Wire>
+			void wire_store(uint8_t* p) const {
+				Wire::template store<typename std::make_unsigned<T>::type>(p, value());
+			}
+			template<class Wire>
+			void wire_load(const uint8_t* p) {
+				*this = T(Wire::template load<typename std::make_unsigned<T>::type>(p));
+			}
 			
 			obf_var_dbg& operator ++() { *this = value() + 1; return *this; }
 			obf_var_dbg& operator --() { *this = value() - 1; return *this; }
-			obf_var_dbg operator++(int) { obf_var_dbg ret = obf_var_dbg(value());  *this = value() + 1; return ret; }
-			obf_var_dbg operator--(int) { obf_var_dbg ret = obf_var_dbg(value());  *this = value() + 1; return ret; }
+			obf_var_dbg operator++(int) { obf_var_dbg ret = *this;  *this = value() + 1; return ret; }
+			obf_var_dbg operator--(int) { obf_var_dbg ret = *this;  *this = value() - 1; return ret; }
 
 			template<class T2>
 			bool operator <(T2 t) { return value() < t; }
@@ -2096,40 +7785,124 @@ namespace ithare {
 				return *this %= t.value();
 			}
 
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator +=(const obf_expr<T2, Op, L, R>& e) {
+				return *this += e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator -=(const obf_expr<T2, Op, L, R>& e) {
+				return *this -= e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator *=(const obf_expr<T2, Op, L, R>& e) {
+				return *this *= e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator /=(const obf_expr<T2, Op, L, R>& e) {
+				return *this /= e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator %=(const obf_expr<T2, Op, L, R>& e) {
+				return *this %= e.value();
+			}
+
+			//for obf_var_dbg, obf_literal_dbg, and raw T2s alike (obf_expr_value() decodes them)
+			template<class T2>
+			obf_expr<T, obf_expr_add, obf_var_dbg, T2> operator +(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_sub, obf_var_dbg, T2> operator -(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_mul, obf_var_dbg, T2> operator *(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_div, obf_var_dbg, T2> operator /(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_mod, obf_var_dbg, T2> operator %(T2 t) const { return { *this, t }; }
+
 			template<class T2>
-			obf_var_dbg operator +(T2 t) { return obf_var_dbg(value() + t); }
+			obf_var_dbg& operator &=(T2 t) { *this = value() & t; return *this; }
 			template<class T2>
-			obf_var_dbg operator -(T2 t) { return obf_var_dbg(value() - t); }
+			obf_var_dbg& operator |=(T2 t) { *this = value() | t; return *this; }
 			template<class T2>
-			obf_var_dbg operator *(T2 t) { return obf_var_dbg(value() * t); }
+			obf_var_dbg& operator ^=(T2 t) { *this = value() ^ t; return *this; }
 			template<class T2>
-			obf_var_dbg operator /(T2 t) { return obf_var_dbg(value() / t); }
+			obf_var_dbg& operator <<=(T2 t) { *this = value() << t; return *this; }
 			template<class T2>
-			obf_var_dbg operator %(T2 t) { return obf_var_dbg(value() % t); }
+			obf_var_dbg& operator >>=(T2 t) { *this = value() >> t; return *this; }
 
-			template<class T2>//TODO: template<obf_literal_dbg>(for ALL binary operations)
-			obf_var_dbg operator +(obf_var_dbg<T2> t) { return obf_var_dbg(value() + t.value()); }
 			template<class T2>
-			obf_var_dbg operator -(obf_var_dbg<T2> t) { return obf_var_dbg(value() - t.value()); }
+			obf_var_dbg& operator &=(obf_var_dbg<T2> t) {
+				return *this &= t.value();
+			}
+			template<class T2>
+			obf_var_dbg& operator |=(obf_var_dbg<T2> t) {
+				return *this |= t.value();
+			}
 			template<class T2>
-			obf_var_dbg operator *(obf_var_dbg<T2> t) { return obf_var_dbg(value() * t.value()); }
+			obf_var_dbg& operator ^=(obf_var_dbg<T2> t) {
+				return *this ^= t.value();
+			}
 			template<class T2>
-			obf_var_dbg operator /(obf_var_dbg<T2> t) { return obf_var_dbg(value() / t.value()); }
+			obf_var_dbg& operator <<=(obf_var_dbg<T2> t) {
+				return *this <<= t.value();
+			}
 			template<class T2>
-			obf_var_dbg operator %(obf_var_dbg<T2> t) { return obf_var_dbg(value() % t.value()); }
+			obf_var_dbg& operator >>=(obf_var_dbg<T2> t) {
+				return *this >>= t.value();
+			}
 
 			template<class T2, T2 C2>
-			ITHARE_OBF_FORCEINLINE obf_var_dbg operator +(obf_literal_dbg<T2, C2> t) { return obf_var_dbg(value() + t.value()); }
+			obf_var_dbg& operator &=(obf_literal_dbg<T2, C2> t) {
+				return *this &= t.value();
+			}
 			template<class T2, T2 C2>
-			ITHARE_OBF_FORCEINLINE obf_var_dbg operator -(obf_literal_dbg<T2, C2> t) { return obf_var_dbg(value() - t.value()); }
+			obf_var_dbg& operator |=(obf_literal_dbg<T2, C2> t) {
+				return *this |= t.value();
+			}
 			template<class T2, T2 C2>
-			ITHARE_OBF_FORCEINLINE obf_var_dbg operator *(obf_literal_dbg<T2, C2> t) { return obf_var_dbg(value() * t.value()); }
+			obf_var_dbg& operator ^=(obf_literal_dbg<T2, C2> t) {
+				return *this ^= t.value();
+			}
 			template<class T2, T2 C2>
-			ITHARE_OBF_FORCEINLINE obf_var_dbg operator /(obf_literal_dbg<T2, C2> t) { return obf_var_dbg(value() / t.value()); }
+			obf_var_dbg& operator <<=(obf_literal_dbg<T2, C2> t) {
+				return *this <<= t.value();
+			}
 			template<class T2, T2 C2>
-			ITHARE_OBF_FORCEINLINE obf_var_dbg operator %(obf_literal_dbg<T2, C2> t) { return obf_var_dbg(value() % t.value()); }
+			obf_var_dbg& operator >>=(obf_literal_dbg<T2, C2> t) {
+				return *this >>= t.value();
+			}
+
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator &=(const obf_expr<T2, Op, L, R>& e) {
+				return *this &= e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator |=(const obf_expr<T2, Op, L, R>& e) {
+				return *this |= e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator ^=(const obf_expr<T2, Op, L, R>& e) {
+				return *this ^= e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator <<=(const obf_expr<T2, Op, L, R>& e) {
+				return *this <<= e.value();
+			}
+			template<class T2, class Op, class L, class R>
+			obf_var_dbg& operator >>=(const obf_expr<T2, Op, L, R>& e) {
+				return *this >>= e.value();
+			}
 
-			//TODO: bitwise
+			template<class T2>
+			obf_expr<T, obf_expr_and, obf_var_dbg, T2> operator &(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_or, obf_var_dbg, T2> operator |(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_xor, obf_var_dbg, T2> operator ^(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_shl, obf_var_dbg, T2> operator <<(T2 t) const { return { *this, t }; }
+			template<class T2>
+			obf_expr<T, obf_expr_shr, obf_var_dbg, T2> operator >>(T2 t) const { return { *this, t }; }
+			obf_expr<T, obf_expr_xor, obf_var_dbg, T> operator ~() const { return { *this, T(~T(0)) }; }
 
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 			static void dbgPrint(size_t offset = 0,const char* prefix="") {
@@ -2138,7 +7911,409 @@ namespace ithare {
 #endif
 
 		private:
-			typename T val;
+			T val;
+		};
+
+		template<class T>
+		T obf_expr_value(const obf_var_dbg<T>& v) {
+			return v.value();
+		}
+		template<class T, T C>
+		T obf_expr_value(const obf_literal_dbg<T, C>& l) {
+			return l.value();
+		}
+
+		//obf_array_dbg
+		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_array<>
+		template<class T, size_t N>
+		class obf_array_dbg : private obf_dbg_site<ObfSiteKind::array, sizeof(T)> {
+			static_assert(std::is_integral<T>::value);
+			static_assert(N > 0);
+			using Site = obf_dbg_site<ObfSiteKind::array, sizeof(T)>;
+
+		public:
+			obf_array_dbg(ITHARE_OBF_SITE_LOC_PARAM0) : Site(ITHARE_OBF_SITE_LOC) {
+				fill(0);
+			}
+			static constexpr size_t size() {
+				return N;
+			}
+			T get(size_t i) const {
+				assert(i < N);
+				return this->decode([&] { return vals[i]; });
+			}
+			void set(size_t i, T t) {
+				assert(i < N);
+				this->encoded();
+				vals[i] = t;
+			}
+			T operator[](size_t i) const {
+				return get(i);
+			}
+			void fill(T t) {
+				this->encoded();
+				vals.fill(t);
+			}
+
+			void load_range(size_t first, size_t count, T* dst) const {
+				assert(first <= N && count <= N - first);
+				this->decode([&] {
+					for (size_t i = 0; i < count; ++i)
+						dst[i] = vals[first + i];
+				}, count);
+			}
+			void store_range(size_t first, size_t count, const T* src) {
+				assert(first <= N && count <= N - first);
+				this->encoded(count);
+				for (size_t i = 0; i < count; ++i)
+					vals[first + i] = src[i];
+			}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+			static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+				std::cout << std::string(offset, ' ') << prefix << "obf_array_dbg<" << obf_dbgPrintT<T>() << "," << N << ">" << std::endl;
+			}
+#endif
+
+		private:
+			std::array<T, N> vals;
+		};
+
+		//obf_vector_dbg
+		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_vector<>
+		template<class T>
+		class obf_vector_dbg : private obf_dbg_site<ObfSiteKind::vector, sizeof(T)> {
+			static_assert(std::is_integral<T>::value);
+			using Site = obf_dbg_site<ObfSiteKind::vector, sizeof(T)>;
+
+		public:
+			using value_type = T;
+			using size_type = size_t;
+			using difference_type = ptrdiff_t;
+			using const_reference = T;
+
+			class reference {
+				friend class obf_vector_dbg;
+
+			public:
+				operator T() const { return v->get(i); }
+				reference& operator =(T t) { v->set(i, t); return *this; }
+				reference& operator =(const reference& other) { v->set(i, T(other)); return *this; }
+
+				template<class T2>
+				reference& operator +=(T2 t) { v->set(i, T(v->get(i) + t)); return *this; }
+				template<class T2>
+				reference& operator -=(T2 t) { v->set(i, T(v->get(i) - t)); return *this; }
+				template<class T2>
+				reference& operator *=(T2 t) { v->set(i, T(v->get(i) * t)); return *this; }
+				template<class T2>
+				reference& operator /=(T2 t) { v->set(i, T(v->get(i) / t)); return *this; }
+				template<class T2>
+				reference& operator %=(T2 t) { v->set(i, T(v->get(i) % t)); return *this; }
+				reference& operator ++() { return *this += 1; }
+				reference& operator --() { return *this -= 1; }
+				T operator ++(int) { T ret = *this; *this += 1; return ret; }
+				T operator --(int) { T ret = *this; *this -= 1; return ret; }
+
+				friend void swap(reference a, reference b) {
+					swap_vals(a, b);
+				}
+
+			private:
+				reference(obf_vector_dbg* v_, size_t i_) : v(v_), i(i_) {
+				}
+				static void swap_vals(reference a, reference b) {
+					std::swap(a.v->vals[a.i], b.v->vals[b.i]);
+				}
+
+				obf_vector_dbg* v;
+				size_t i;
+			};
+			using iterator = obf_index_iterator<obf_vector_dbg, T>;
+			using const_iterator = obf_index_iterator<const obf_vector_dbg, T>;
+
+			obf_vector_dbg(ITHARE_OBF_SITE_LOC_PARAM0) : Site(ITHARE_OBF_SITE_LOC) {
+			}
+			explicit obf_vector_dbg(size_t n, T t = 0 ITHARE_OBF_SITE_LOC_PARAM) : Site(ITHARE_OBF_SITE_LOC) {
+				resize(n, t);
+			}
+			obf_vector_dbg(std::initializer_list<T> il ITHARE_OBF_SITE_LOC_PARAM) : Site(ITHARE_OBF_SITE_LOC) {
+				resize(il.size());
+				store_range(0, il.size(), il.begin());
+			}
+
+			size_t size() const {
+				return vals.size();
+			}
+			bool empty() const {
+				return vals.empty();
+			}
+			size_t capacity() const {
+				return vals.capacity();
+			}
+			void reserve(size_t n) {
+				vals.reserve(n);
+			}
+			void shrink_to_fit() {
+				vals.shrink_to_fit();
+			}
+			void resize(size_t n, T t = 0) {
+				if (n > size())
+					this->encoded();
+				vals.resize(n, t);
+			}
+			void clear() {
+				vals.clear();
+			}
+			void swap(obf_vector_dbg& other) {
+				vals.swap(other.vals);
+			}
+
+			T get(size_t i) const {
+				assert(i < size());
+				return this->decode([&] { return vals[i]; });
+			}
+			void set(size_t i, T t) {
+				assert(i < size());
+				this->encoded();
+				vals[i] = t;
+			}
+			T operator[](size_t i) const {
+				return get(i);
+			}
+			reference operator[](size_t i) {
+				assert(i < size());
+				return reference(this, i);
+			}
+			T front() const {
+				return get(0);
+			}
+			T back() const {
+				return get(size() - 1);
+			}
+			void push_back(T t) {
+				this->encoded();
+				vals.push_back(t);
+			}
+			void pop_back() {
+				assert(!empty());
+				vals.pop_back();
+			}
+			void fill(T t) {
+				this->encoded();
+				std::fill(vals.begin(), vals.end(), t);
+			}
+
+			iterator begin() { return iterator(this, 0); }
+			iterator end() { return iterator(this, size()); }
+			const_iterator begin() const { return const_iterator(this, 0); }
+			const_iterator end() const { return const_iterator(this, size()); }
+			const_iterator cbegin() const { return begin(); }
+			const_iterator cend() const { return end(); }
+
+			void load_range(size_t first, size_t count, T* dst) const {
+				assert(first <= size() && count <= size() - first);
+				this->decode([&] {
+					for (size_t i = 0; i < count; ++i)
+						dst[i] = vals[first + i];
+				}, count);
+			}
+			void store_range(size_t first, size_t count, const T* src) {
+				assert(first <= size() && count <= size() - first);
+				this->encoded(count);
+				for (size_t i = 0; i < count; ++i)
+					vals[first + i] = src[i];
+			}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+			static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+				std::cout << std::string(offset, ' ') << prefix << "obf_vector_dbg<" << obf_dbgPrintT<T>() << ">" << std::endl;
+			}
+#endif
+
+		private:
+			std::vector<T> vals;
+		};
+
+		//obf_unordered_map_dbg
+		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_unordered_map<>
+		template<class K, class V, bool encode_values = false>
+		class obf_unordered_map_dbg : private obf_dbg_site<ObfSiteKind::map, sizeof(K)> {
+			static_assert(std::is_integral<K>::value);
+			static_assert(!encode_values || std::is_integral<V>::value);
+			using Site = obf_dbg_site<ObfSiteKind::map, sizeof(K)>;
+
+		public:
+			using key_type = K;
+			using mapped_type = V;
+			using size_type = size_t;
+
+			obf_unordered_map_dbg(ITHARE_OBF_SITE_LOC_PARAM0) : Site(ITHARE_OBF_SITE_LOC) {
+			}
+
+			size_t size() const {
+				return vals.size();
+			}
+			bool empty() const {
+				return vals.empty();
+			}
+			size_t capacity() const {
+				return vals.bucket_count();
+			}
+			void reserve(size_t n) {
+				vals.reserve(n);
+			}
+			void clear() {
+				vals.clear();
+			}
+			void swap(obf_unordered_map_dbg& other) {
+				vals.swap(other.vals);
+			}
+
+			bool insert(K k, const V& v) {
+				this->encoded(encode_values ? 2 : 1);//key (and value)
+				return vals.insert(std::make_pair(k, v)).second;
+			}
+			bool insert_or_assign(K k, const V& v) {
+				this->encoded(encode_values ? 2 : 1);//key (and value)
+				return vals.insert_or_assign(k, v).second;
+			}
+			bool contains(K k) const {
+				this->encoded();
+				return vals.find(k) != vals.end();
+			}
+			size_t count(K k) const {
+				return contains(k) ? 1 : 0;
+			}
+			bool find(K k, V& v) const {
+				this->encoded();
+				auto it = vals.find(k);
+				if (it == vals.end())
+					return false;
+				if constexpr(encode_values)
+					v = this->decode([&] { return it->second; });
+				else
+					v = it->second;
+				return true;
+			}
+			V get(K k, const V& def = V()) const {
+				V ret;
+				return find(k, ret) ? ret : def;
+			}
+			bool erase(K k) {
+				this->encoded();
+				return vals.erase(k) != 0;
+			}
+
+			template<class F>
+			void for_each(F f) const {
+				this->decode([&] {
+					for (auto& kv : vals)
+						f(kv.first, kv.second);
+				}, vals.size());
+			}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+			static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+				std::cout << std::string(offset, ' ') << prefix << "obf_unordered_map_dbg<" << obf_dbgPrintT<K>() << "," << encode_values << ">" << std::endl;
+			}
+#endif
+
+		private:
+			std::unordered_map<K, V> vals;
+		};
+
+		//obf_record_dbg
+		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_record<>
+		template<class... T>
+		class obf_record_dbg : private obf_dbg_site<ObfSiteKind::record, (sizeof(T) + ...)> {
+			static_assert(sizeof...(T) > 0);
+			static_assert((std::is_integral<T>::value && ...));
+			using Site = obf_dbg_site<ObfSiteKind::record, (sizeof(T) + ...)>;
+
+		public:
+			template<size_t I>
+			using field_type = std::tuple_element_t<I, std::tuple<T...>>;
+			static constexpr size_t fields = sizeof...(T);
+
+			obf_record_dbg(ITHARE_OBF_SITE_LOC_PARAM0) : Site(ITHARE_OBF_SITE_LOC), vals(T(0)...) {
+				this->encoded(sizeof...(T));
+			}
+			obf_record_dbg(T... t ITHARE_OBF_SITE_LOC_PARAM) : Site(ITHARE_OBF_SITE_LOC), vals(t...) {
+				this->encoded(sizeof...(T));
+			}
+
+			template<size_t I>
+			field_type<I> get() const {
+				return this->decode([&] { return std::get<I>(vals); });
+			}
+			template<size_t I>
+			void set(field_type<I> t) {
+				this->encoded();
+				std::get<I>(vals) = t;
+			}
+
+			std::tuple<T...> load() const {
+				return this->decode([&] { return vals; }, sizeof...(T));
+			}
+			void load(T&... t) const {
+				std::tie(t...) = load();
+			}
+			void store(T... t) {
+				this->encoded(sizeof...(T));
+				vals = std::tuple<T...>(t...);
+			}
+			void store(const std::tuple<T...>& t) {
+				this->encoded(sizeof...(T));
+				vals = t;
+			}
+
+			static constexpr size_t wire_size = (sizeof(T) + ...);
+			template<class Wire>
+			void wire_store(uint8_t* p) const {
+				std::apply([p](T... t) {
+					size_t offset = 0;
+					((Wire::template store<typename std::make_unsigned<T>::type>(p + offset, t), offset += sizeof(T)), ...);
+				}, load());
+			}
+			template<class Wire>
+			void wire_load(const uint8_t* p) {
+				size_t offset = 0;
+				std::tuple<T...> t;
+				std::apply([&](T&... t_) {
+					((t_ = T(Wire::template load<typename std::make_unsigned<T>::type>(p + offset)), offset += sizeof(T)), ...);
+				}, t);
+				store(t);
+			}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+			static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+				std::cout << std::string(offset, ' ') << prefix << "obf_record_dbg<>: fields=" << sizeof...(T) << std::endl;
+			}
+#endif
+
+		private:
+			std::tuple<T...> vals;
+		};
+
+		//obf_wire_dbg: plain little-endian values
+		struct obf_wire_dbg {
+			static constexpr uint64_t fingerprint = 0;//never matches obf_wire<>::fingerprint (barring 2^-64 chance)
+
+			template<class T>
+			static void store(uint8_t* p, T x) {
+				obf_wire_store_le(p, x);
+			}
+			template<class T>
+			static T load(const uint8_t* p) {
+				return obf_wire_load_le<T>(p);
+			}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+			static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+				std::cout << std::string(offset, ' ') << prefix << "obf_wire_dbg" << std::endl;
+			}
+#endif
 		};
 
 		inline void obf_init() {
@@ -2146,20 +8321,53 @@ namespace ithare {
 
 		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_str_literal
 		template<char... C>
-		struct obf_str_literal_dbg {
+		constexpr size_t obf_str_literal_dbg_size() {
+			constexpr char const str[sizeof...(C)+1] = { C...,'\0'};
+			return obf_strlen(str);
+		}
+		template<char... C>
+		struct obf_str_literal_dbg : private obf_dbg_site<ObfSiteKind::str_literal, obf_str_literal_dbg_size<C...>()> {
 			static constexpr size_t origSz = sizeof...(C);
 			static constexpr char const str[sizeof...(C)+1] = { C...,'\0'};
 			static constexpr size_t sz = obf_strlen(str);
 			static_assert(sz > 0);
 			static_assert(sz <= 32);
+			using Site = obf_dbg_site<ObfSiteKind::str_literal, sz>;
 
+			ITHARE_OBF_FORCEINLINE obf_str_literal_dbg(ITHARE_OBF_SITE_LOC_PARAM0) : Site(ITHARE_OBF_SITE_LOC) {
+			}
+			ITHARE_OBF_FORCEINLINE static constexpr size_t size() {
+				return sz;
+			}
 			ITHARE_OBF_FORCEINLINE std::string value() const {
-				return std::string(str, origSz);
+				return this->decode([&] { return std::string(str, sz); });
 			}
 			ITHARE_OBF_FORCEINLINE operator std::string() const {
 				return value();
 			}
 
+			ITHARE_OBF_FORCEINLINE size_t value_to(char* dst, size_t dstSz) const {
+				if (dstSz <= sz) {//see obf_str_literal<>::value_to()
+					if (dstSz)
+						dst[0] = 0;
+					return sz;
+				}
+				this->decode([&] { memcpy(dst, str, sz); });
+				dst[sz] = 0;
+				return sz;
+			}
+			template<size_t N>
+			ITHARE_OBF_FORCEINLINE size_t value_to(char(&dst)[N]) const {
+				static_assert(N > sz);
+				return value_to(dst, N);
+			}
+			ITHARE_OBF_FORCEINLINE obf_str_buf<sz + 1> value_buf() const {
+				return obf_str_buf<sz + 1>(*this);
+			}
+			friend std::ostream& operator <<(std::ostream& os, const obf_str_literal_dbg& s) {
+				return os << s.value_buf();
+			}
+
 #ifdef ITHARE_OBF_ENABLE_DBGPRINT
 			static void dbgPrint(size_t offset = 0, const char* prefix = "") {
 				std::cout << std::string(offset, ' ') << prefix << "obf_str_literal_dbg<'" << str << "'>" << std::endl;
@@ -2167,9 +8375,68 @@ namespace ithare {
 #endif
 		};
 
+#ifdef ITHARE_OBF_FIXED_STR
+		//IMPORTANT: ANY API CHANGES MUST BE MIRRORED in obf_fixed_str_literal
+		template<obf_fixed_str S>
+		struct obf_fixed_str_literal_dbg : private obf_dbg_site<ObfSiteKind::str_literal, S.size()> {
+			static constexpr size_t sz = S.size();
+			static_assert(sz > 0);
+			using Site = obf_dbg_site<ObfSiteKind::str_literal, S.size()>;
+
+			ITHARE_OBF_FORCEINLINE obf_fixed_str_literal_dbg(ITHARE_OBF_SITE_LOC_PARAM0) : Site(ITHARE_OBF_SITE_LOC) {
+			}
+			ITHARE_OBF_FORCEINLINE static constexpr size_t size() {
+				return sz;
+			}
+			ITHARE_OBF_FORCEINLINE std::string value() const {
+				return this->decode([&] { return std::string(S.data, sz); });
+			}
+			ITHARE_OBF_FORCEINLINE operator std::string() const {
+				return value();
+			}
+
+			ITHARE_OBF_FORCEINLINE size_t value_to(char* dst, size_t dstSz) const {
+				if (dstSz <= sz) {//see obf_str_literal<>::value_to()
+					if (dstSz)
+						dst[0] = 0;
+					return sz;
+				}
+				this->decode([&] { memcpy(dst, S.data, sz); });
+				dst[sz] = 0;
+				return sz;
+			}
+			template<size_t N>
+			ITHARE_OBF_FORCEINLINE size_t value_to(char(&dst)[N]) const {
+				static_assert(N > sz);
+				return value_to(dst, N);
+			}
+			ITHARE_OBF_FORCEINLINE obf_str_buf<sz + 1> value_buf() const {
+				return obf_str_buf<sz + 1>(*this);
+			}
+			friend std::ostream& operator <<(std::ostream& os, const obf_fixed_str_literal_dbg& s) {
+				return os << s.value_buf();
+			}
+
+#ifdef ITHARE_OBF_ENABLE_DBGPRINT
+			static void dbgPrint(size_t offset = 0, const char* prefix = "") {
+				std::cout << std::string(offset, ' ') << prefix << "obf_fixed_str_literal_dbg<'" << S.data << "'>" << std::endl;
+			}
+#endif
+		};
+#endif
+
 	}//namespace obf
 }//namespace ithare
 
+namespace std {
+	template<class T>
+	struct hash<ithare::obf::obf_var_dbg<T>> {
+		size_t operator()(const ithare::obf::obf_var_dbg<T>& v) const {
+			return v.encoded_hash();
+		}
+	};
+}//namespace std
+
 #define ITHARE_OBF0(type) ithare::obf::obf_var_dbg<type>
 #define ITHARE_OBF1(type) ithare::obf::obf_var_dbg<type>
 #define ITHARE_OBF2(type) ithare::obf::obf_var_dbg<type>
@@ -2186,6 +8453,57 @@ namespace ithare {
 #define ITHARE_OBF5I(c) obf_literal_dbg<decltype(c),c>()
 #define ITHARE_OBF6I(c) obf_literal_dbg<decltype(c),c>()
 
+#define ITHARE_OBF0A(type,n) ithare::obf::obf_array_dbg<type,n>
+#define ITHARE_OBF1A(type,n) ithare::obf::obf_array_dbg<type,n>
+#define ITHARE_OBF2A(type,n) ithare::obf::obf_array_dbg<type,n>
+#define ITHARE_OBF3A(type,n) ithare::obf::obf_array_dbg<type,n>
+#define ITHARE_OBF4A(type,n) ithare::obf::obf_array_dbg<type,n>
+#define ITHARE_OBF5A(type,n) ithare::obf::obf_array_dbg<type,n>
+#define ITHARE_OBF6A(type,n) ithare::obf::obf_array_dbg<type,n>
+
+#define ITHARE_OBF0V(type) ithare::obf::obf_vector_dbg<type>
+#define ITHARE_OBF1V(type) ithare::obf::obf_vector_dbg<type>
+#define ITHARE_OBF2V(type) ithare::obf::obf_vector_dbg<type>
+#define ITHARE_OBF3V(type) ithare::obf::obf_vector_dbg<type>
+#define ITHARE_OBF4V(type) ithare::obf::obf_vector_dbg<type>
+#define ITHARE_OBF5V(type) ithare::obf::obf_vector_dbg<type>
+#define ITHARE_OBF6V(type) ithare::obf::obf_vector_dbg<type>
+
+#define ITHARE_OBF0M(key,value) ithare::obf::obf_unordered_map_dbg<key,value>
+#define ITHARE_OBF1M(key,value) ithare::obf::obf_unordered_map_dbg<key,value>
+#define ITHARE_OBF2M(key,value) ithare::obf::obf_unordered_map_dbg<key,value>
+#define ITHARE_OBF3M(key,value) ithare::obf::obf_unordered_map_dbg<key,value>
+#define ITHARE_OBF4M(key,value) ithare::obf::obf_unordered_map_dbg<key,value>
+#define ITHARE_OBF5M(key,value) ithare::obf::obf_unordered_map_dbg<key,value>
+#define ITHARE_OBF6M(key,value) ithare::obf::obf_unordered_map_dbg<key,value>
+
+#define ITHARE_OBF0MV(key,value) ithare::obf::obf_unordered_map_dbg<key,value,true>
+#define ITHARE_OBF1MV(key,value) ithare::obf::obf_unordered_map_dbg<key,value,true>
+#define ITHARE_OBF2MV(key,value) ithare::obf::obf_unordered_map_dbg<key,value,true>
+#define ITHARE_OBF3MV(key,value) ithare::obf::obf_unordered_map_dbg<key,value,true>
+#define ITHARE_OBF4MV(key,value) ithare::obf::obf_unordered_map_dbg<key,value,true>
+#define ITHARE_OBF5MV(key,value) ithare::obf::obf_unordered_map_dbg<key,value,true>
+#define ITHARE_OBF6MV(key,value) ithare::obf::obf_unordered_map_dbg<key,value,true>
+
+#define ITHARE_OBF0R(...) ithare::obf::obf_record_dbg<__VA_ARGS__>
+#define ITHARE_OBF1R(...) ithare::obf::obf_record_dbg<__VA_ARGS__>
+#define ITHARE_OBF2R(...) ithare::obf::obf_record_dbg<__VA_ARGS__>
+#define ITHARE_OBF3R(...) ithare::obf::obf_record_dbg<__VA_ARGS__>
+#define ITHARE_OBF4R(...) ithare::obf::obf_record_dbg<__VA_ARGS__>
+#define ITHARE_OBF5R(...) ithare::obf::obf_record_dbg<__VA_ARGS__>
+#define ITHARE_OBF6R(...) ithare::obf::obf_record_dbg<__VA_ARGS__>
+
+#define ITHARE_OBF0W(id) ithare::obf::obf_wire_dbg
+#define ITHARE_OBF1W(id) ithare::obf::obf_wire_dbg
+#define ITHARE_OBF2W(id) ithare::obf::obf_wire_dbg
+#define ITHARE_OBF3W(id) ithare::obf::obf_wire_dbg
+#define ITHARE_OBF4W(id) ithare::obf::obf_wire_dbg
+#define ITHARE_OBF5W(id) ithare::obf::obf_wire_dbg
+#define ITHARE_OBF6W(id) ithare::obf::obf_wire_dbg
+
+#ifdef ITHARE_OBF_FIXED_STR
+#define ITHARE_OBFS_DBG_HELPER(s) ithare::obf::obf_fixed_str_literal_dbg<ithare::obf::obf_fixed_str(s)>
+#else
 #define ITHARE_OBFS_DBG_HELPER(s) obf_str_literal_dbg<(sizeof(s)>0?s[0]:'\0'),(sizeof(s)>1?s[1]:'\0'),(sizeof(s)>2?s[2]:'\0'),(sizeof(s)>3?s[3]:'\0'),\
 							(sizeof(s)>4?s[4]:'\0'),(sizeof(s)>5?s[5]:'\0'),(sizeof(s)>6?s[6]:'\0'),(sizeof(s)>7?s[7]:'\0'),\
 							(sizeof(s)>8?s[8]:'\0'),(sizeof(s)>9?s[9]:'\0'),(sizeof(s)>10?s[10]:'\0'),(sizeof(s)>11?s[11]:'\0'),\
@@ -2195,6 +8513,7 @@ namespace ithare {
 							(sizeof(s)>24?s[24]:'\0'),(sizeof(s)>25?s[25]:'\0'),(sizeof(s)>26?s[26]:'\0'),(sizeof(s)>27?s[27]:'\0'),\
 							(sizeof(s)>28?s[28]:'\0'),(sizeof(s)>29?s[29]:'\0'),(sizeof(s)>30?s[30]:'\0'),(sizeof(s)>31?s[31]:'\0'),\
 							(sizeof(s)>32?s[32]:'\0')/*one extra to generate an error if we're over*/>
+#endif
 
 #define ITHARE_OBF0S(s) ITHARE_OBFS_DBG_HELPER(s)()
 #define ITHARE_OBF1S(s) ITHARE_OBFS_DBG_HELPER(s)()
@@ -2204,6 +8523,14 @@ namespace ithare {
 #define ITHARE_OBF5S(s) ITHARE_OBFS_DBG_HELPER(s)()
 #define ITHARE_OBF6S(s) ITHARE_OBFS_DBG_HELPER(s)()
 
+#define ITHARE_OBF0SL(s) ITHARE_OBFS_DBG_HELPER(s)()
+#define ITHARE_OBF1SL(s) ITHARE_OBFS_DBG_HELPER(s)()
+#define ITHARE_OBF2SL(s) ITHARE_OBFS_DBG_HELPER(s)()
+#define ITHARE_OBF3SL(s) ITHARE_OBFS_DBG_HELPER(s)()
+#define ITHARE_OBF4SL(s) ITHARE_OBFS_DBG_HELPER(s)()
+#define ITHARE_OBF5SL(s) ITHARE_OBFS_DBG_HELPER(s)()
+#define ITHARE_OBF6SL(s) ITHARE_OBFS_DBG_HELPER(s)()
+
 #endif //ITHARE_OBF_SEED
 
 #ifndef ITHARE_OBF_NO_SHORT_DEFINES//#define to avoid polluting global namespace w/o prefix
@@ -2223,6 +8550,54 @@ namespace ithare {
 #define OBF5I ITHARE_OBF5I
 #define OBF6I ITHARE_OBF6I
 
+#define OBF0A ITHARE_OBF0A
+#define OBF1A ITHARE_OBF1A
+#define OBF2A ITHARE_OBF2A
+#define OBF3A ITHARE_OBF3A
+#define OBF4A ITHARE_OBF4A
+#define OBF5A ITHARE_OBF5A
+#define OBF6A ITHARE_OBF6A
+
+#define OBF0V ITHARE_OBF0V
+#define OBF1V ITHARE_OBF1V
+#define OBF2V ITHARE_OBF2V
+#define OBF3V ITHARE_OBF3V
+#define OBF4V ITHARE_OBF4V
+#define OBF5V ITHARE_OBF5V
+#define OBF6V ITHARE_OBF6V
+
+#define OBF0M ITHARE_OBF0M
+#define OBF1M ITHARE_OBF1M
+#define OBF2M ITHARE_OBF2M
+#define OBF3M ITHARE_OBF3M
+#define OBF4M ITHARE_OBF4M
+#define OBF5M ITHARE_OBF5M
+#define OBF6M ITHARE_OBF6M
+
+#define OBF0MV ITHARE_OBF0MV
+#define OBF1MV ITHARE_OBF1MV
+#define OBF2MV ITHARE_OBF2MV
+#define OBF3MV ITHARE_OBF3MV
+#define OBF4MV ITHARE_OBF4MV
+#define OBF5MV ITHARE_OBF5MV
+#define OBF6MV ITHARE_OBF6MV
+
+#define OBF0R ITHARE_OBF0R
+#define OBF1R ITHARE_OBF1R
+#define OBF2R ITHARE_OBF2R
+#define OBF3R ITHARE_OBF3R
+#define OBF4R ITHARE_OBF4R
+#define OBF5R ITHARE_OBF5R
+#define OBF6R ITHARE_OBF6R
+
+#define OBF0W ITHARE_OBF0W
+#define OBF1W ITHARE_OBF1W
+#define OBF2W ITHARE_OBF2W
+#define OBF3W ITHARE_OBF3W
+#define OBF4W ITHARE_OBF4W
+#define OBF5W ITHARE_OBF5W
+#define OBF6W ITHARE_OBF6W
+
 #define OBF0S ITHARE_OBF0S
 #define OBF1S ITHARE_OBF1S
 #define OBF2S ITHARE_OBF2S
@@ -2230,6 +8605,14 @@ namespace ithare {
 #define OBF4S ITHARE_OBF4S
 #define OBF5S ITHARE_OBF5S
 #define OBF6S ITHARE_OBF6S
+
+#define OBF0SL ITHARE_OBF0SL
+#define OBF1SL ITHARE_OBF1SL
+#define OBF2SL ITHARE_OBF2SL
+#define OBF3SL ITHARE_OBF3SL
+#define OBF4SL ITHARE_OBF4SL
+#define OBF5SL ITHARE_OBF5SL
+#define OBF6SL ITHARE_OBF6SL
 #endif
 
 #endif//ithare_obf_obfuscate_h_included
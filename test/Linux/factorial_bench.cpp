@@ -0,0 +1,107 @@
+//factorial_bench.cpp: run-time overhead of obfuscation on the factorial() workload from test/MSVC/ConsoleApplication1.cpp
+//Usage:
+//  make -C test/Linux bench [CXX=clang++] [OBF_SEED=0x<64-bit-seed>] [X=20]
+//Prints nanoseconds per factorial(X) call, for a plain int64_t version and for versions where all the variables are OBF<level>
+//  numbers depend on the seed (which may easily shuffle injections between 'cheap' and 'expensive' ones),
+//  so compare compilers with the same OBF_SEED, and look at more than one seed before drawing conclusions
+
+#include "stdafx.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x2d7c91e4a06b3f58)
+#endif
+#include "../../src/obfuscate.h"
+
+using namespace ithare::obf;
+
+static constexpr int obf_bench_calls = 100000;
+static constexpr int obf_bench_repetitions = 5;
+
+static volatile int64_t obf_bench_sink;
+
+class MyException {
+public:
+	MyException(std::string msg)
+		: message(msg) {
+	}
+	virtual const char* what() const {
+		return message.c_str();
+	}
+
+private:
+	std::string message;
+};
+
+ITHARE_OBF_NOINLINE int64_t factorial_plain(int64_t x) {
+	if (x < 0)
+		throw MyException("Negative argument to factorial!");
+	int64_t ret = 1;
+	for (int64_t i = 1; i <= x; ++i) {
+		ret *= i;
+	}
+	return ret;
+}
+
+template<int level>
+struct obf_bench_level {
+	template<int n>
+	using var = obf_var<int64_t, obf_compile_time_prng(ITHARE_OBF_SEED^UINT64_C(0x6a09e667f3bcc908), 4 * level + n), obf_exp_cycles(level)>;
+
+	ITHARE_OBF_NOINLINE static var<1> factorial(var<2> x) {
+		if (x < 0)
+			throw MyException(OBF5S("Negative argument to factorial!"));
+		var<3> ret = 1;
+		for (var<4> i = 1; i <= x; ++i) {
+			ret *= i;
+		}
+		return ret;
+	}
+};
+
+template<class F>
+double obf_bench_ns(F f, int64_t x) {
+	double best = 1e30;
+	for (int rep = 0; rep < obf_bench_repetitions; ++rep) {
+		int64_t total = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < obf_bench_calls; ++i)
+			total += f(x);
+		auto t1 = std::chrono::steady_clock::now();
+		obf_bench_sink = total;
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(obf_bench_calls));
+	}
+	return best;
+}
+
+template<int level>
+void obf_bench_print(int64_t x, int64_t expected) {
+	int64_t f = obf_bench_level<level>::factorial(x);
+	double ns = obf_bench_ns([](int64_t x) { return int64_t(obf_bench_level<level>::factorial(x)); }, x);
+	printf("OBF%d: %.2f ns/call%s\n", level, ns, f == expected ? "" : " MISMATCH");
+}
+
+template<int... levels>
+void obf_bench_levels(int64_t x, int64_t expected, std::integer_sequence<int, levels...>) {
+	(obf_bench_print<levels>(x, expected), ...);
+}
+
+int main(int argc, char** argv) {
+	obf_init();
+	int64_t x = argc > 1 ? atoi(argv[1]) : 20;
+	try {
+		int64_t expected = factorial_plain(x);
+		printf("factorial(%lld) = %lld\n", (long long)x, (long long)expected);
+		printf("plain: %.2f ns/call\n", obf_bench_ns(factorial_plain, x));
+		obf_bench_levels(x, expected, std::make_integer_sequence<int, 7>());
+	}
+	catch (MyException& e) {
+		printf("exception:%s\n", e.what());
+	}
+	return 0;
+}
@@ -0,0 +1 @@
+//stdafx.h: stand-in for MSVC precompiled header included by src/obfuscate.cpp
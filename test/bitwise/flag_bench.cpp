@@ -0,0 +1,126 @@
+//flag_bench.cpp: flag-word loop over obf_var<uint32_t> (bitwise operators) vs plain uint32_t
+//Usage:
+//  compile in Release mode and run; exit code is 1 if any of the obf_var<> loops gives a result different from the plain one
+//Prints nanoseconds per iteration of a loop doing flags ^= bit; if(flags & x) ++cnt; flags |= bit >> 3; flags = flags & mask;
+//  for several obfuscation levels, over OBF_FLAG_BENCH_SEEDS different seeds (average, min and max):
+//  operators - obf_var<> bitwise operators (^ on the encoded value where the site's injection is a pure xor mask, see ObfXorMask;
+//    everything else via value());
+//  value() - the same written as flags = flags.value() ^ bit; etc. (i.e. always decoding and re-encoding)
+//At OBF0, the flag loop costs about the same as plain; from OBF1 on, each iteration pays at least
+//  a surjection and an injection of flags (even for a pure xor mask, it is 2 more ops on the loop-carried dependency)
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x4c1d7a92e53f08b6)
+#endif
+#include "../common/obf_bench.h"
+
+#ifndef OBF_FLAG_BENCH_SEEDS
+#define OBF_FLAG_BENCH_SEEDS 16
+#endif
+#ifndef OBF_FLAG_BENCH_ITERATIONS
+#define OBF_FLAG_BENCH_ITERATIONS 2000000
+#endif
+
+static constexpr int64_t obf_bench_iterations = OBF_FLAG_BENCH_ITERATIONS;
+static constexpr int obf_bench_repetitions = 5;
+
+static volatile uint32_t obf_bench_input = 0x5a;
+static volatile uint32_t obf_bench_mask = 0xfffeffff;
+
+//f() returns cnt + final flags, which is checked against the plain loop
+template<class F>
+double obf_bench_ns(F f, uint64_t& result) {
+	result = f();
+	return obf_bench_ns(obf_bench_repetitions, size_t(obf_bench_iterations), f);
+}
+
+static uint64_t obf_bench_plain_result;
+
+static double obf_bench_plain() {
+	return obf_bench_ns([] {
+		uint32_t flags = obf_bench_input, x = obf_bench_input, mask = obf_bench_mask;
+		uint64_t cnt = 0;
+		for (int64_t i = 0; i < obf_bench_iterations; ++i) {
+			uint32_t bit = uint32_t(1) << (i & 31);
+			flags ^= bit;
+			if (flags & x)
+				++cnt;
+			flags |= bit >> 3;
+			flags = flags & mask;
+		}
+		return cnt + flags;
+	}, obf_bench_plain_result);
+}
+
+template<OBFSEED seed, OBFCYCLES cycles>
+double obf_bench_operators() {
+	uint64_t result = 0;
+	double ret = obf_bench_ns([] {
+		obf_var<uint32_t, seed, cycles> flags = obf_bench_input;
+		uint32_t x = obf_bench_input, mask = obf_bench_mask;
+		uint64_t cnt = 0;
+		for (int64_t i = 0; i < obf_bench_iterations; ++i) {
+			uint32_t bit = uint32_t(1) << (i & 31);
+			flags ^= bit;
+			if (flags & x)
+				++cnt;
+			flags |= bit >> 3;
+			flags = flags & mask;
+		}
+		return cnt + flags;
+	}, result);
+	obf_bench_check(result == obf_bench_plain_result, "flag loop result", seed);
+	return ret;
+}
+
+template<OBFSEED seed, OBFCYCLES cycles>
+double obf_bench_value() {
+	uint64_t result = 0;
+	double ret = obf_bench_ns([] {
+		obf_var<uint32_t, seed, cycles> flags = obf_bench_input;
+		uint32_t x = obf_bench_input, mask = obf_bench_mask;
+		uint64_t cnt = 0;
+		for (int64_t i = 0; i < obf_bench_iterations; ++i) {
+			uint32_t bit = uint32_t(1) << (i & 31);
+			flags = flags.value() ^ bit;
+			if (flags.value() & x)
+				++cnt;
+			flags = flags.value() | (bit >> 3);
+			flags = flags.value() & mask;
+		}
+		return cnt + flags.value();
+	}, result);
+	obf_bench_check(result == obf_bench_plain_result, "flag loop result", seed);
+	return ret;
+}
+
+static void obf_bench_print(const char* name, const double* ns, size_t n) {
+	double sum = 0.;
+	for (size_t i = 0; i < n; ++i)
+		sum += ns[i];
+	printf("%8.2f %8.2f %8.2f %s", sum / double(n), *std::min_element(ns, ns + n), *std::max_element(ns, ns + n), name);
+}
+
+template<int level, size_t... I>
+void obf_bench_row(std::index_sequence<I...>) {
+	double ops[] = { obf_bench_operators<obf_bench_seed(level, int(I)), obf_exp_cycles(level)>()... };
+	double val[] = { obf_bench_value<obf_bench_seed(level, int(I)), obf_exp_cycles(level)>()... };
+	printf("OBF%d ", level);
+	obf_bench_print(" |", ops, sizeof...(I));
+	obf_bench_print("\n", val, sizeof...(I));
+}
+
+template<int level>
+void obf_bench_row() {
+	obf_bench_row<level>(std::make_index_sequence<OBF_FLAG_BENCH_SEEDS>());
+}
+
+int main() {
+	printf("%d seeds, plain: %.2f ns/iteration\n", OBF_FLAG_BENCH_SEEDS, obf_bench_plain());
+	printf("%-4s %8s %8s %8s  | %8s %8s %8s\n", "ns", "ops:avg", "min", "max", "val:avg", "min", "max");
+	obf_bench_row<0>();
+	obf_bench_row<1>();
+	obf_bench_row<2>();
+	obf_bench_row<3>();
+	return obf_bench_exit("flag loop result");
+}
@@ -0,0 +1,158 @@
+//obf_calibrate.cpp: measures cycle costs of ithare::obf building blocks on the build machine
+//  (injection versions, literal contexts, and non-reversible functions - for each integer width),
+//  and prints them in the format expected by ITHARE_OBF_CYCLE_COSTS_HEADER (see obfuscate.h)
+//Usage:
+//  1. compile in Release mode (with the same compiler and optimization flags as your project)
+//     if using ITHARE_OBF_INIT - define it here too, and link with src/obfuscate.cpp
+//  2. obf_calibrate > obf_cycle_costs.h
+//  3. compile your project with -DITHARE_OBF_CYCLE_COSTS_HEADER="\"obf_cycle_costs.h\""
+//NB: costs are measured as latencies in TSC ticks; on CPUs where TSC frequency differs from the core one
+//    (turbo etc.), it is only an approximation of 'real' cycles - but then, so is the whole cycle budget
+//NB: literal contexts which write global state (version 4, and versions 5-8 under ITHARE_OBF_NO_THREAD_LOCAL) are NOT measured:
+//    a single-threaded loop sees an uncontended cache line, while their default costs are deliberately charged
+//    for cache line bouncing between cores (see test/mt/literal_context_mt_bench.cpp); they keep their defaults
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <utility>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x3ad9e1c0f8b2746d)//seed doesn't really matter for calibration
+#endif
+#include "../../src/obfuscate.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#error obf_calibrate relies on TSC, which is available only on x86/x64 (yet?)
+#endif
+
+using namespace ithare::obf;
+
+static constexpr size_t obf_calibrate_iterations = 1000000;
+static constexpr int obf_calibrate_repetitions = 10;
+
+static inline uint64_t obf_calibrate_rdtsc() {
+	return __rdtsc();
+}
+
+//measures latency (in TSC ticks) of x=f(x), with x going via a volatile to prevent compile-time folding of the whole loop;
+//  the cost of the volatile round-trip is the same for all the measurements, and is subtracted as a baseline
+template<class T, class F>
+double obf_calibrate_ticks(F f) {
+	volatile T x = T(UINT64_C(0x5a3c96e1d2b4f087));
+	double best = 1e30;
+	for (int rep = 0; rep < obf_calibrate_repetitions; ++rep) {
+		uint64_t t0 = obf_calibrate_rdtsc();
+		for (size_t i = 0; i < obf_calibrate_iterations; ++i)
+			x = f(x);
+		uint64_t t1 = obf_calibrate_rdtsc();
+		best = std::min(best, double(t1 - t0) / double(obf_calibrate_iterations));
+	}
+	return best;
+}
+
+static OBFCYCLES obf_calibrate_cycles(double ticks, double baseline, size_t which) {
+	if (which == 0)
+		return 0;//identities are free by definition
+	OBFCYCLES ret = OBFCYCLES(ticks - baseline + 0.5);
+	return std::max(ret, 1);//anything which is not an identity, is not free
+}
+
+//descriptors to calculate minimal cycles for injection_version<which> (so that all the children are identities)
+template<size_t which, class T>
+struct obf_calibrate_injection_descr;
+template<class T>
+struct obf_calibrate_injection_descr<0, T> : obf_injection_version0_descr<T, ObfZeroLiteralContext<T>> {};
+template<class T>
+struct obf_calibrate_injection_descr<1, T> : obf_injection_version1_descr<T, ObfZeroLiteralContext<T>> {};
+template<class T>
+struct obf_calibrate_injection_descr<2, T> : obf_injection_version2_descr<T, ObfZeroLiteralContext<T>> {};
+template<class T>
+struct obf_calibrate_injection_descr<3, T> : obf_injection_version3_descr<T, ObfZeroLiteralContext<T>> {};
+template<class T>
+struct obf_calibrate_injection_descr<4, T> : obf_injection_version4_descr<T, ObfZeroLiteralContext<T>> {};
+template<class T>
+struct obf_calibrate_injection_descr<5, T> : obf_injection_version5_descr<T, ObfZeroLiteralContext<T>> {};
+template<class T>
+struct obf_calibrate_injection_descr<6, T> : obf_injection_version6_descr<T, ObfZeroLiteralContext<T>> {};
+template<class T>
+struct obf_calibrate_injection_descr<7, T> : obf_injection_version7_descr<T, ObfZeroLiteralContext<T>> {};
+
+static constexpr OBFSEED obf_calibrate_seed = obf_compile_time_prng(ITHARE_OBF_SEED, 1);
+
+template<class T, size_t which>
+void obf_calibrate_injection(double baseline) {
+	if constexpr(which == 0 || which == 1 || which == 4 || which == 7 || sizeof(T) > 1) {//versions 2,3,5,6 are disabled for 1-byte types
+		using Context = ObfZeroLiteralContext<T>;
+		using Injection = obf_injection_version<which, T, Context, obf_calibrate_seed, obf_calibrate_injection_descr<which, T>::own_min_cycles>;
+		using RT = typename Injection::return_type;
+		double inj = obf_calibrate_ticks<T>([](T x) { return T(RT(Injection::injection(x))); });
+		double surj = obf_calibrate_ticks<T>([](T y) { return T(Injection::surjection(RT(y))); });
+		printf("ObfCycleCost(ObfCycleCostKind::injection_version, %d, %d, %d, %d),\n", int(which), int(sizeof(T)),
+			int(obf_calibrate_cycles(inj, baseline, which)), int(obf_calibrate_cycles(surj, baseline, which)));
+	}
+}
+
+constexpr bool obf_calibrate_shared_state(size_t which) {//literal contexts which write global state
+#ifdef ITHARE_OBF_NO_THREAD_LOCAL
+	return which >= 4 && which <= 8;
+#else
+	return which == 4;
+#endif
+}
+
+template<class T, size_t which>
+void obf_calibrate_literal_context(double baseline) {
+#if !(defined(_MSC_VER) && defined(ITHARE_OBF_INIT) && !defined(ITHARE_OBF_NO_ANTI_DEBUG))
+	if constexpr(which == 3)//PEB is not available
+		return;
+	else
+#endif
+	if constexpr(obf_calibrate_shared_state(which))
+		printf("//literal_context %d: writes global state, keeping the default (MT) cost\n", int(which));
+	else {
+		using Context = ObfLiteralContext_version<which, T, obf_calibrate_seed>;
+		double surj = obf_calibrate_ticks<T>([](T y) { return T(Context::final_surjection(y)); });
+		printf("ObfCycleCost(ObfCycleCostKind::literal_context, %d, %d, 0, %d),\n", int(which), int(sizeof(T)),
+			int(obf_calibrate_cycles(surj, baseline, which)));
+	}
+}
+
+template<class T, size_t which>
+void obf_calibrate_non_reversible_function(double baseline) {
+	using F = obf_randomized_non_reversible_function_version<which, T, obf_calibrate_seed, 0>;
+	double f = obf_calibrate_ticks<T>([](T x) { return T(F()(x)); });
+	OBFCYCLES cycles = obf_calibrate_cycles(f, baseline, which);
+	printf("ObfCycleCost(ObfCycleCostKind::non_reversible_function, %d, %d, %d, %d),\n", int(which), int(sizeof(T)), int(cycles), int(cycles));
+}
+
+template<class T, size_t... InjectionVersions, size_t... LiteralContextVersions, size_t... FunctionVersions>
+void obf_calibrate_width(std::index_sequence<InjectionVersions...>, std::index_sequence<LiteralContextVersions...>, std::index_sequence<FunctionVersions...>) {
+	double baseline = obf_calibrate_ticks<T>([](T x) { return x; });
+	printf("//sizeof(T)=%d: baseline=%.2f ticks\n", int(sizeof(T)), baseline);
+	(obf_calibrate_injection<T, InjectionVersions>(baseline), ...);
+	(obf_calibrate_literal_context<T, LiteralContextVersions>(baseline), ...);
+	(obf_calibrate_non_reversible_function<T, FunctionVersions>(baseline), ...);
+}
+
+template<class T>
+void obf_calibrate_width() {
+	obf_calibrate_width<T>(std::make_index_sequence<8>(), std::make_index_sequence<11>(), std::make_index_sequence<3>());
+}
+
+int main() {
+#if defined(_MSC_VER) && defined(ITHARE_OBF_INIT)
+	obf_init();
+#endif
+	printf("//obf_cycle_costs.h: GENERATED by obf_calibrate, DO NOT EDIT\n");
+	printf("//  to be used as -DITHARE_OBF_CYCLE_COSTS_HEADER=\"\\\"obf_cycle_costs.h\\\"\" (see obfuscate.h)\n");
+	obf_calibrate_width<uint8_t>();
+	obf_calibrate_width<uint16_t>();
+	obf_calibrate_width<uint32_t>();
+	obf_calibrate_width<uint64_t>();
+	return 0;
+}
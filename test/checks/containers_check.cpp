@@ -0,0 +1,329 @@
+//containers_check.cpp: round-trip checks of obf_vector<>, obf_unordered_map<>, obf_record<> and obf_wire_writer<>/obf_wire_reader<>
+//Usage:
+//  compile and run (it is a part of 'make check'); exit code is 1 if any of the checks fails
+//Each container is checked against its plain counterpart over OBF_CHECK_SEEDS different seeds per obfuscation level
+
+#include <string.h>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x2f6b90d13ce87a45)
+#endif
+#include "../common/obf_bench.h"
+
+#ifndef OBF_CHECK_SEEDS
+#define OBF_CHECK_SEEDS 4
+#endif
+
+template<class T>
+T obf_check_value(size_t i) {
+	return T(i * UINT64_C(0x9e3779b97f4a7c15) >> 7);
+}
+
+using ObfCheckWire = obf_wire<obf_wire_seed(0x77697265), obf_exp_cycles(3)>;//what OBF3W(0x77697265) gives
+
+template<class T, OBFSEED seed, OBFCYCLES cycles>
+void obf_check_vector() {
+	using Vector = obf_vector<T, seed, cycles>;
+	constexpr size_t n = 4096;
+	constexpr size_t chunk = 256;
+	std::vector<T> plain(n);
+	for (size_t i = 0; i < n; ++i)
+		plain[i] = obf_check_value<T>(i);
+
+	Vector vec(n);
+	vec.store_range(0, n, plain.data());
+	T buf[chunk];
+	for (size_t i = 0; i < n; i += chunk) {
+		vec.load_range(i, chunk, buf);
+		obf_bench_check(memcmp(buf, &plain[i], sizeof(buf)) == 0, "vector: load_range()", i);
+	}
+	for (size_t i = 0; i < n; i += 97)
+		obf_bench_check(vec.get(i) == plain[i] && T(vec[i]) == plain[i], "vector: get()/operator[]", i);
+
+	//proxies, iterators, and sort() which swaps encoded values
+	Vector small;
+	for (size_t i = 0; i < 1000; ++i)
+		small.push_back(obf_check_value<T>(i));
+	small[7] += 3;
+	++small[8];
+	obf_bench_check(small[7] == T(obf_check_value<T>(7) + 3) && small.get(8) == T(obf_check_value<T>(8) + 1), "vector: proxy +=/++");
+	std::sort(small.begin(), small.end());
+	obf_bench_check(std::is_sorted(small.cbegin(), small.cend()), "vector: sort()");
+	small.resize(1001, 42);
+	obf_bench_check(small.back() == 42 && small.size() == 1001, "vector: resize()");
+}
+
+//random inserts/assignments/lookups (no erase(), see obf_check_map_erase() below), checked against std::unordered_map<>
+template<class T, OBFSEED seed, OBFCYCLES cycles, bool encode_values>
+void obf_check_map() {
+	using Map = obf_unordered_map<T, T, seed, cycles, encode_values>;
+	std::unordered_map<T, T> plain;
+	Map map;
+	std::mt19937_64 rng(seed);
+	for (int i = 0; i < 20000; ++i) {
+		T k = T(rng() % 5000);
+		T v = T(rng());
+		switch (rng() % 3) {
+		case 0:
+			obf_bench_check(map.insert(k, v) == plain.insert({ k, v }).second, "map: insert()", k);
+			break;
+		case 1:
+			obf_bench_check(map.insert_or_assign(k, v) == plain.insert_or_assign(k, v).second, "map: insert_or_assign()", k);
+			break;
+		case 2: {
+			auto it = plain.find(k);
+			T found = 0;
+			bool ok = map.find(k, found) == (it != plain.end()) && (it == plain.end() || found == it->second);
+			obf_bench_check(ok, "map: find()", k);
+			break;
+		}
+		}
+	}
+	obf_bench_check(map.size() == plain.size(), "map: size()", map.size());
+	size_t visited = 0;
+	map.for_each([&](T k, T v) {
+		++visited;
+		auto it = plain.find(k);
+		obf_bench_check(it != plain.end() && it->second == v, "map: for_each()", k);
+	});
+	obf_bench_check(visited == plain.size(), "map: for_each() count", visited);
+}
+
+//all the keys of plain have to be found in map, with the same values, and nothing else
+template<class Map, class T>
+bool obf_check_map_equal(const Map& map, const std::unordered_map<T, T>& plain) {
+	if (map.size() != plain.size())
+		return false;
+	for (const auto& kv : plain) {
+		T v = 0;
+		if (!map.find(kv.first, v) || v != kv.second)
+			return false;
+	}
+	size_t visited = 0;
+	bool ok = true;
+	map.for_each([&](T k, T v) {
+		++visited;
+		auto it = plain.find(k);
+		ok = ok && it != plain.end() && it->second == v;
+	});
+	return ok && visited == plain.size();
+}
+
+//erase() (backward shift):
+//  - random inserts/erases/lookups against std::unordered_map<> (incl. erase-then-find of the same key, and erase of missing keys)
+//  - small tables filled up to the max load factor (12 of 16 slots), then emptied in random order, checking all the remaining keys
+//    after each erase(); with that load, most of the tables have a probe chain which wraps around the end of the slot array
+//  - rehash after erase(): growth (and reserve()) after most of the keys are erased, and reuse after clear()
+template<class T, OBFSEED seed, OBFCYCLES cycles, bool encode_values>
+void obf_check_map_erase() {
+	using Map = obf_unordered_map<T, T, seed, cycles, encode_values>;
+	std::mt19937_64 rng(seed ^ 0xe5);
+	{
+		std::unordered_map<T, T> plain;
+		Map map;
+		for (int i = 0; i < 30000; ++i) {
+			T k = T(rng() % 3000);
+			switch (rng() % 4) {
+			case 0:
+			case 1: {
+				T v = T(rng());
+				obf_bench_check(map.insert_or_assign(k, v) == plain.insert_or_assign(k, v).second, "map: insert_or_assign() with erase()", k);
+				break;
+			}
+			case 2:
+				obf_bench_check(map.erase(k) == (plain.erase(k) != 0), "map: erase()", k);
+				obf_bench_check(!map.contains(k) && map.get(k, T(1)) == T(1), "map: find() after erase()", k);
+				break;
+			case 3: {
+				auto it = plain.find(k);
+				T found = 0;
+				obf_bench_check(map.find(k, found) == (it != plain.end()) && (it == plain.end() || found == it->second), "map: find() with erase()", k);
+				break;
+			}
+			}
+		}
+		obf_bench_check(obf_check_map_equal(map, plain), "map: contents after random erase()s");
+	}
+	for (int t = 0; t < 200; ++t) {//small full tables
+		std::unordered_map<T, T> plain;
+		Map map;
+		std::vector<T> keys;
+		while (keys.size() < 12) {
+			T k = T(rng());
+			if (plain.insert({ k, T(keys.size()) }).second) {
+				map.insert(k, T(keys.size()));
+				keys.push_back(k);
+			}
+		}
+		obf_bench_check(map.capacity() == 16, "map: capacity() of 12 keys", map.capacity());
+		std::shuffle(keys.begin(), keys.end(), rng);
+		for (T k : keys) {
+			obf_bench_check(map.erase(k) && !map.erase(k), "map: erase() in a full table", k);
+			plain.erase(k);
+			obf_bench_check(obf_check_map_equal(map, plain), "map: remaining keys after erase() in a full table", t);
+		}
+		obf_bench_check(map.empty() && map.capacity() == 16, "map: empty after erasing all");
+	}
+	{
+		std::unordered_map<T, T> plain;
+		Map map;
+		for (T i = 0; i < 1000; ++i) {
+			map.insert(T(i * 7), i);
+			plain.insert({ T(i * 7), i });
+		}
+		for (T i = 0; i < 1000; ++i) {
+			if (i % 10 != 0) {
+				map.erase(T(i * 7));
+				plain.erase(T(i * 7));
+			}
+		}
+		size_t cap = map.capacity();
+		for (T i = 0; i < 3000; ++i) {//enough to grow (possibly more than once)
+			map.insert(T(i * 7 + 1), T(i + 5));
+			plain.insert({ T(i * 7 + 1), T(i + 5) });
+		}
+		obf_bench_check(map.capacity() > cap, "map: growth after erase()", map.capacity());
+		obf_bench_check(obf_check_map_equal(map, plain), "map: contents after erase() and growth");
+		map.reserve(map.capacity() * 2);
+		obf_bench_check(obf_check_map_equal(map, plain), "map: contents after erase() and reserve()");
+		map.clear();
+		plain.clear();
+		for (T i = 0; i < 100; ++i) {
+			map.insert(i, T(i * 3));
+			plain.insert({ i, T(i * 3) });
+		}
+		map.erase(T(50));
+		plain.erase(T(50));
+		obf_bench_check(obf_check_map_equal(map, plain), "map: contents after clear() and erase()");
+	}
+}
+
+enum { X, Y, HEALTH, AMMO, LEVEL, COOLDOWN };
+
+template<OBFSEED seed, OBFCYCLES cycles>
+void obf_check_record() {
+	using Record = obf_record<seed, cycles, int32_t, int32_t, uint16_t, uint16_t, uint8_t, uint32_t>;
+	constexpr size_t n = 512;
+	std::vector<Record> recs(n);
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t r = (i + 1) * UINT64_C(0x9e3779b97f4a7c15);
+		recs[i].store(int32_t(r), int32_t(r >> 32), uint16_t(r >> 8), uint16_t(r >> 24), uint8_t(r >> 40), uint32_t(r >> 17));
+	}
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t r = (i + 1) * UINT64_C(0x9e3779b97f4a7c15);
+		auto [x, y, health, ammo, level, cooldown] = recs[i].load();
+		obf_bench_check(x == int32_t(r) && y == int32_t(r >> 32) && health == uint16_t(r >> 8) && ammo == uint16_t(r >> 24)
+			&& level == uint8_t(r >> 40) && cooldown == uint32_t(r >> 17), "record: load()", i);
+		obf_bench_check(recs[i].template get<COOLDOWN>() == uint32_t(r >> 17) && recs[i].template get<X>() == int32_t(r), "record: get<I>()", i);
+		recs[i].template set<HEALTH>(uint16_t(i));
+		obf_bench_check(recs[i].template get<HEALTH>() == uint16_t(i) && recs[i].template get<AMMO>() == uint16_t(r >> 24), "record: set<I>()", i);
+	}
+}
+
+//64-bit fields take two lanes each, so this one has 9 lanes: 2 AVX2 vectors (or 4 SSE2 ones), which load()/store() interleave
+template<OBFSEED seed, OBFCYCLES cycles>
+void obf_check_wide_record() {
+	using Record = obf_record<seed, cycles, int64_t, uint64_t, int8_t, int16_t, uint32_t, int64_t>;
+	constexpr size_t n = 512;
+	std::vector<Record> recs(n);
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t r = (i + 1) * UINT64_C(0x9e3779b97f4a7c15);
+		recs[i].store(int64_t(r), ~r, int8_t(r >> 8), int16_t(r >> 24), uint32_t(r >> 17), -int64_t(i));
+	}
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t r = (i + 1) * UINT64_C(0x9e3779b97f4a7c15);
+		auto [a, b, c, d, e, f] = recs[i].load();
+		obf_bench_check(a == int64_t(r) && b == ~r && c == int8_t(r >> 8) && d == int16_t(r >> 24) && e == uint32_t(r >> 17)
+			&& f == -int64_t(i), "wide record: load()", i);
+		obf_bench_check(recs[i].template get<0>() == int64_t(r) && recs[i].template get<3>() == int16_t(r >> 24)
+			&& recs[i].template get<5>() == -int64_t(i), "wide record: get<I>()", i);
+		recs[i].template set<1>(uint64_t(i) << 40);
+		obf_bench_check(std::get<1>(recs[i].load()) == uint64_t(i) << 40 && std::get<2>(recs[i].load()) == int8_t(r >> 8),
+			"wide record: set<I>() then load()", i);
+	}
+}
+
+template<class Item>
+Item obf_check_zero() {//obf_var<> has no default constructor
+	if constexpr(Item::wire_size == sizeof(uint32_t))
+		return Item(0u);
+	else
+		return Item();
+}
+
+//Item is either obf_var<uint32_t> or obf_record<uint32_t x4>
+//  wire bytes written from Items have to be the same as the ones written from plain values (i.e. the format is the same)
+template<class Item>
+void obf_check_wire() {
+	constexpr size_t per_item = Item::wire_size / sizeof(uint32_t);
+	constexpr size_t n = 1000;
+	std::vector<uint32_t> expected(n * per_item);
+	for (size_t i = 0; i < expected.size(); ++i)
+		expected[i] = obf_check_value<uint32_t>(i);
+	std::vector<Item> items(n, obf_check_zero<Item>());
+	std::vector<Item> items2(n, obf_check_zero<Item>());
+	for (size_t i = 0; i < n; ++i) {
+		if constexpr(per_item == 1)
+			items[i] = expected[i];
+		else
+			items[i].store(expected[4 * i], expected[4 * i + 1], expected[4 * i + 2], expected[4 * i + 3]);
+	}
+
+	std::vector<uint8_t> buf;
+	obf_wire_writer<ObfCheckWire>(buf).write_n(items.data(), n);
+	std::vector<uint8_t> plain_buf;
+	obf_wire_writer<ObfCheckWire>(plain_buf).write_n(expected.data(), expected.size());
+	obf_bench_check(buf == plain_buf, "wire: items vs plain values");
+
+	obf_bench_check(obf_wire_reader<ObfCheckWire>(buf).read_n(items2.data(), n), "wire: read_n()");
+	for (size_t i = 0; i < n; ++i) {
+		uint32_t v[per_item];
+		if constexpr(per_item == 1)
+			v[0] = items2[i].value();
+		else
+			std::tie(v[0], v[1], v[2], v[3]) = items2[i].load();
+		obf_bench_check(memcmp(v, &expected[per_item * i], sizeof(v)) == 0, "wire: round trip", i);
+	}
+	std::vector<uint32_t> back(expected.size());
+	obf_bench_check(obf_wire_reader<ObfCheckWire>(buf).read_n(back.data(), back.size()) && back == expected, "wire: read_n() of plain values");
+
+	buf.pop_back();//truncated
+	obf_bench_check(!obf_wire_reader<ObfCheckWire>(buf).read_n(items2.data(), n), "wire: truncated read_n()");
+}
+
+template<OBFSEED seed, OBFCYCLES cycles>
+using ObfCheckWireVar = obf_var<uint32_t, seed, cycles>;
+template<OBFSEED seed, OBFCYCLES cycles>
+using ObfCheckWireRecord = obf_record<seed, cycles, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+template<int level, int i>
+void obf_check_one() {
+	constexpr OBFCYCLES cycles = obf_exp_cycles(level);
+	obf_check_vector<uint16_t, obf_bench_seed(level, i, 2), cycles>();
+	obf_check_vector<uint32_t, obf_bench_seed(level, i, 4), cycles>();
+	obf_check_vector<uint64_t, obf_bench_seed(level, i, 8), cycles>();
+	obf_check_map<uint32_t, obf_bench_seed(level, i, 4), cycles, false>();
+	obf_check_map<uint64_t, obf_bench_seed(level, i, 8), cycles, true>();
+	obf_check_map_erase<uint32_t, obf_bench_seed(level, i, 4), cycles, false>();
+	obf_check_map_erase<uint16_t, obf_bench_seed(level, i, 2), cycles, true>();
+	obf_check_record<obf_bench_seed(level, i), cycles>();
+	obf_check_wide_record<obf_bench_seed(level, i, 8), cycles>();
+	obf_check_wire<ObfCheckWireVar<obf_bench_seed(level, i), cycles>>();
+	obf_check_wire<ObfCheckWireRecord<obf_bench_seed(level, i), cycles>>();
+}
+
+template<int level, size_t... I>
+void obf_check_level(std::index_sequence<I...>) {
+	(obf_check_one<level, int(I)>(), ...);
+	printf("OBF%d: %d seed(s) checked\n", level, int(sizeof...(I)));
+}
+
+int main() {
+	obf_check_level<1>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<2>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<3>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	return obf_bench_exit("container");
+}
@@ -0,0 +1,157 @@
+//str_check.cpp: checks of obfuscated string literals (OBF?S()/OBF?SL()), incl. their zero-allocation access
+//Usage:
+//  compile and run (it is a part of 'make check'); exit code is 1 if any of the checks fails
+//For OBF_CHECK_SEEDS different seeds per obfuscation level, each literal has to decode to the plain string via
+//  value(), value_to(), value_buf() and std::ostream <<; the global operator new is replaced here, to count allocations,
+//  and value_to()/value_buf()/<< have to make none of them; value_to() with too small a buffer has to write nothing beyond it
+//With C++20 (ITHARE_OBF_FIXED_STR, 'make check-cxx20'), literals longer than 32 chars are checked too;
+//  -DOBF_CHECK_FIXED_STR makes it an error if the fixed_str path is not enabled
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <ostream>
+#include <string>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x3c6ef372fe94f82b)
+#endif
+#include "../common/obf_bench.h"
+
+#if defined(OBF_CHECK_FIXED_STR) && !defined(ITHARE_OBF_FIXED_STR)
+#error "OBF_CHECK_FIXED_STR: ITHARE_OBF_FIXED_STR is not enabled (C++20 is required)"
+#endif
+
+#ifndef OBF_CHECK_SEEDS
+#define OBF_CHECK_SEEDS 4
+#endif
+
+static size_t obf_check_allocs = 0;
+
+void* operator new(size_t sz) {
+	++obf_check_allocs;
+	if (void* p = malloc(sz ? sz : 1))
+		return p;
+	throw std::bad_alloc();
+}
+void* operator new[](size_t sz) {
+	return operator new(sz);
+}
+void operator delete(void* p) noexcept {
+	free(p);
+}
+void operator delete[](void* p) noexcept {
+	free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+	free(p);
+}
+
+//std::ostream over a fixed buffer (so that << itself doesn't allocate)
+class ObfCheckStreamBuf : public std::streambuf {
+public:
+	ObfCheckStreamBuf() {
+		reset();
+	}
+	void reset() {
+		setp(buf, buf + sizeof(buf));
+	}
+	std::string_view view() const {
+		return std::string_view(pbase(), size_t(pptr() - pbase()));
+	}
+
+private:
+	char buf[1024];
+};
+
+static ObfCheckStreamBuf obf_check_streambuf;
+static std::ostream obf_check_stream(&obf_check_streambuf);
+
+#define OBF_CHECK_STR_1 "a"
+#define OBF_CHECK_STR_4 "\xe9" "bcd"
+#define OBF_CHECK_STR_7 "abc\xffz!g"
+#define OBF_CHECK_STR_32 "0123456789abcdefghijklmnopqrstuv"
+
+template<OBFSEED seed, OBFCYCLES cycles> using ObfCheckStr1 = ITHARE_OBFS_HELPER(seed, cycles, OBF_CHECK_STR_1);
+template<OBFSEED seed, OBFCYCLES cycles> using ObfCheckStr4 = ITHARE_OBFS_HELPER(seed, cycles, OBF_CHECK_STR_4);
+template<OBFSEED seed, OBFCYCLES cycles> using ObfCheckStr7 = ITHARE_OBFS_HELPER(seed, cycles, OBF_CHECK_STR_7);
+template<OBFSEED seed, OBFCYCLES cycles> using ObfCheckStr32 = ITHARE_OBFS_HELPER(seed, cycles, OBF_CHECK_STR_32);
+#ifdef ITHARE_OBF_FIXED_STR//obf_fixed_str_literal<>: any length
+#define OBF_CHECK_STR_33 "0123456789abcdefghijklmnopqrstuvw"
+#define OBF_CHECK_STR_100 "The quick brown fox jumps over the lazy dog; \xe9\xff\x80 Pack my box with five dozen liquor jugs. 0123456789"
+#define OBF_CHECK_STR_300 OBF_CHECK_STR_100 OBF_CHECK_STR_100 OBF_CHECK_STR_100
+template<OBFSEED seed, OBFCYCLES cycles> using ObfCheckStr33 = ITHARE_OBFS_HELPER(seed, cycles, OBF_CHECK_STR_33);
+template<OBFSEED seed, OBFCYCLES cycles> using ObfCheckStr100 = ITHARE_OBFS_HELPER(seed, cycles, OBF_CHECK_STR_100);
+template<OBFSEED seed, OBFCYCLES cycles> using ObfCheckStr300 = ITHARE_OBFS_HELPER(seed, cycles, OBF_CHECK_STR_300);
+#endif
+
+template<class Literal>
+void obf_check_literal(const char* plain) {
+	Literal lit;
+	std::string_view expected(plain);
+	obf_bench_check(lit.value() == expected && std::string(lit) == expected, "value()", expected.size());
+
+	size_t allocs = obf_check_allocs;
+	char buf[Literal::size() + 1];
+	obf_bench_check(lit.value_to(buf) == expected.size() && std::string_view(buf) == expected, "value_to()", expected.size());
+	char big[Literal::size() + 64];
+	obf_bench_check(lit.value_to(big, sizeof(big)) == expected.size() && std::string_view(big) == expected, "value_to() to a larger buffer", expected.size());
+	{//too small a buffer: snprintf()-like, nothing but '\0' within dstSz, and nothing at all beyond it
+		char small[Literal::size() + 8];
+		memset(small, 'x', sizeof(small));
+		bool ok = lit.value_to(small, Literal::size()) == expected.size() && small[0] == 0;
+		for (size_t i = 1; i < sizeof(small); ++i)
+			ok = ok && small[i] == 'x';
+		small[0] = 'x';
+		ok = ok && lit.value_to(small, 0) == expected.size() && small[0] == 'x';
+		obf_bench_check(ok, "value_to() to a too small buffer", expected.size());
+	}
+	{
+		auto b = lit.value_buf();
+		obf_bench_check(b.view() == expected && strlen(b.c_str()) == expected.size(), "value_buf()", expected.size());
+	}
+	obf_check_streambuf.reset();
+	obf_check_stream << lit;
+	obf_bench_check(obf_check_streambuf.view() == expected, "std::ostream <<", expected.size());
+	obf_bench_check(obf_check_allocs == allocs, "no allocations by value_to()/value_buf()/<<", obf_check_allocs - allocs);
+}
+
+template<OBFSEED seed, OBFCYCLES cycles>
+void obf_check_literals() {
+	obf_check_literal<ObfCheckStr1<seed, cycles>>(OBF_CHECK_STR_1);
+	obf_check_literal<ObfCheckStr4<obf_compile_time_prng(seed, 1), cycles>>(OBF_CHECK_STR_4);
+	obf_check_literal<ObfCheckStr7<obf_compile_time_prng(seed, 2), cycles>>(OBF_CHECK_STR_7);
+	obf_check_literal<ObfCheckStr32<obf_compile_time_prng(seed, 3), cycles>>(OBF_CHECK_STR_32);
+#ifdef ITHARE_OBF_FIXED_STR
+	obf_check_literal<ObfCheckStr33<obf_compile_time_prng(seed, 4), cycles>>(OBF_CHECK_STR_33);
+	obf_check_literal<ObfCheckStr100<obf_compile_time_prng(seed, 5), cycles>>(OBF_CHECK_STR_100);
+	obf_check_literal<ObfCheckStr300<obf_compile_time_prng(seed, 6), cycles>>(OBF_CHECK_STR_300);
+#endif
+}
+
+template<int level, size_t... I>
+void obf_check_level(std::index_sequence<I...>) {
+	(obf_check_literals<obf_bench_seed(level, int(I)), obf_exp_cycles(level)>(), ...);
+#ifdef ITHARE_OBF_FIXED_STR
+	printf("OBF%d: %d seed(s) checked (fixed_str, up to 300 chars)\n", level, OBF_CHECK_SEEDS);
+#else
+	printf("OBF%d: %d seed(s) checked\n", level, OBF_CHECK_SEEDS);
+#endif
+}
+
+int main() {
+	{//the counter itself: a 32-char std::string doesn't fit into SSO
+		size_t allocs = obf_check_allocs;
+		std::string s = ObfCheckStr32<ITHARE_OBF_SEED, 1>().value();
+		obf_bench_sink = s.size();
+		obf_bench_check(obf_check_allocs > allocs, "allocation counter (value() of 32 chars has to allocate)");
+	}
+	obf_check_level<0>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<1>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<2>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<3>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	return obf_bench_exit("string literal");
+}
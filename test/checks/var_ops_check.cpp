@@ -0,0 +1,249 @@
+//var_ops_check.cpp: checks of obf_var<> operators against plain integers, incl. the encoded-domain fast paths (ObfAffine/ObfXorMask)
+//Usage:
+//  compile and run (it is a part of 'make check'); exit code is 1 if any of the checks fails
+//For OBF_CHECK_SEEDS different seeds per obfuscation level and several types:
+//  - where the root injection reports itself affine (or a pure xor mask), injection(x) has to be exactly a*x+b (or x^mask)
+//  - each literal context's final_injection(x) has to be exactly its final_affine() a*x+b (version 0 relies on it)
+//  - a random sequence of +=, -=, *=, ^=, ++/--, x = x op k, and bitwise ops, mixing obf_var<> with plain integers,
+//    with another obf_var<> and with obf_literal<>, has to give the same values as the same sequence over plain integers
+//  - ==/!= with the same obf_var<> type and with obf_literal<>s (compared encoded), incl. literals out of T's range,
+//    and std::hash<obf_var<>> after encoded +=/^=, have to agree with plain integers
+//  - version 4 injections (tree and flat) evaluated at compile time (plain CINV, see ITHARE_OBF_IS_CONSTANT_EVALUATED)
+//    have to give the same encoded value as in runtime
+
+#include <random>
+#include <type_traits>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x6a09e667f3bcc908)
+#endif
+#include "../common/obf_bench.h"
+
+#ifndef OBF_CHECK_SEEDS
+#define OBF_CHECK_SEEDS 6
+#endif
+
+static int obf_check_affines = 0;
+static int obf_check_xors = 0;
+static int obf_check_total = 0;
+static int obf_check_v4_trees = 0;
+static int obf_check_v4_flats = 0;
+static int obf_check_v4_flats8 = 0;//obf_flat_step<uint8_t,...> is a separate specialization
+
+template<class T_, OBFSEED seed, OBFCYCLES cycles>
+void obf_check_descriptors() {
+	using T = typename std::make_unsigned<T_>::type;
+	using Injection = obf_root_injection<T, ObfVarContext<T, obf_compile_time_prng(seed, 1), cycles>, obf_compile_time_prng(seed, 2), cycles, ObfDefaultInjectionContext>;
+	constexpr ObfAffine<T> affine = Injection::affine();
+	constexpr ObfXorMask<T> xmask = Injection::xor_mask();
+	std::mt19937_64 rng(seed);
+	++obf_check_total;
+	if constexpr(affine.is_affine) {
+		++obf_check_affines;
+		for (int i = 0; i < 100; ++i) {
+			T x = T(rng());
+			using U = typename ObfAffine<T>::U;//uint16_t * uint16_t would be a signed int multiplication, overflowing
+			obf_bench_check(T(Injection::injection(x)) == T(U(affine.a) * U(x) + U(affine.b)), "injection() vs ObfAffine", seed);
+		}
+	}
+	if constexpr(xmask.is_xor) {
+		++obf_check_xors;
+		for (int i = 0; i < 100; ++i) {
+			T x = T(rng());
+			obf_bench_check(T(Injection::injection(x)) == T(x ^ xmask.mask), "injection() vs ObfXorMask", seed);
+		}
+	}
+}
+
+template<class T, class Context, OBFSEED seed>
+void obf_check_context_affine() {
+	constexpr ObfAffine<T> affine = Context::final_affine();
+	obf_bench_check(affine.is_affine && (affine.a & 1) == 1, "final_affine() is affine with odd a", seed);
+	std::mt19937_64 rng(seed ^ 0x10);
+	for (int i = 0; i < 20; ++i) {
+		T x = T(rng());
+		obf_bench_check(Context::final_injection(x) == T(uint64_t(affine.a) * x + affine.b), "final_injection() vs final_affine()", seed);
+	}
+}
+
+template<class T, size_t which, OBFSEED seed>
+void obf_check_context_affine_if_used() {
+	if constexpr(obf_literal_context_descr<T>()[which].weight > 0)//e.g. version 3 exists only under MSVC
+		obf_check_context_affine<T, ObfLiteralContext_version<which, T, seed>, seed>();
+}
+
+template<class T, OBFSEED seed, size_t... which>
+void obf_check_context_affines(std::index_sequence<which...>) {
+	(obf_check_context_affine_if_used<T, which, obf_compile_time_prng(seed, int(which) + 1)>(), ...);
+}
+
+template<class T_, OBFSEED seed, OBFCYCLES cycles>
+void obf_check_ops() {
+	using T = typename std::make_unsigned<T_>::type;
+	using U = typename ObfAffine<T>::U;//reference arithmetic: unsigned (and not promoted to int), so that it wraps instead of overflowing
+	std::mt19937_64 rng(seed ^ 0x08);
+	T_ ref = T_(rng());
+	T_ ref2 = T_(rng());
+	obf_var<T_, seed, cycles> v = ref;
+	obf_var<T_, obf_compile_time_prng(seed, 3), cycles> w = ref2;
+	constexpr T_ lit = T_(0x5d);
+	obf_literal<T_, lit, obf_compile_time_prng(seed, 4), cycles> l;
+	for (int i = 0; i < 500; ++i) {
+		uint64_t r = rng();
+		int64_t k = int64_t(r % 2000) - 1000;
+		int sh = int((r >> 16) % (sizeof(T_) * 8));
+		int op = int((r >> 32) % 24);
+		switch (op) {
+		case 0: v += k; ref = T_(U(ref) + U(k)); break;
+		case 1: v -= int(k); ref = T_(U(ref) - U(int(k))); break;
+		case 2: v *= uint8_t(k); ref = T_(U(ref) * U(uint8_t(k))); break;
+		case 3: v ^= uint16_t(r >> 40); ref = T_(ref ^ uint16_t(r >> 40)); break;
+		case 4: ++v; ref = T_(U(ref) + 1); break;
+		case 5: --v; ref = T_(U(ref) - 1); break;
+		case 6: obf_bench_check(T_(v++) == ref, "obf_var<>++ result", seed); ref = T_(U(ref) + 1); break;
+		case 7: obf_bench_check(T_(v--) == ref, "obf_var<>-- result", seed); ref = T_(U(ref) - 1); break;
+		case 8: v = v + short(k); ref = T_(U(ref) + U(short(k))); break;
+		case 9: v = v - T_(k); ref = T_(U(ref) - U(T_(k))); break;
+		case 10: v = v * int(k | 1); ref = T_(U(ref) * U(int(k | 1))); break;
+		case 11: v = v ^ T_(r >> 24); ref = T_(ref ^ T_(r >> 24)); break;
+		//obf_var<> and another obf_var<>
+		case 12: v += w; ref = T_(U(ref) + U(ref2)); break;
+		case 13: v -= w; ref = T_(U(ref) - U(ref2)); break;
+		case 14: v *= w; ref = T_(U(ref) * U(ref2)); break;
+		case 15: v ^= w; ref = T_(ref ^ ref2); break;
+		case 16: w = T_(r >> 3); ref2 = T_(r >> 3); break;
+		//obf_var<> and obf_literal<>
+		case 17: v += l; ref = T_(U(ref) + U(lit)); break;
+		case 18: v -= l; ref = T_(U(ref) - U(lit)); break;
+		case 19: v *= l; ref = T_(U(ref) * U(lit)); break;
+		case 20: v ^= l; ref = T_(ref ^ lit); break;
+		//bitwise
+		case 21: v = (v ^ w) & ~w; ref = T_(T_(ref ^ ref2) & T_(~ref2)); break;
+		case 22://<< of a negative value is UB (before C++20), for plain integers and obf_var<> alike
+			if constexpr(std::is_unsigned<T_>::value) {
+				v <<= sh;
+				ref = T_(U(ref) << sh);
+			}
+			else {
+				v >>= sh;
+				ref = T_(ref >> sh);
+			}
+			break;
+		case 23: v = v | (w >> 3); ref = T_(ref | T_(ref2 >> 3)); break;
+		}
+		if (!obf_bench_check(v.value() == ref && w.value() == ref2, "obf_var<> vs plain", uint64_t(op)))
+			break;
+	}
+}
+
+template<class T_, OBFSEED seed, OBFCYCLES cycles, class V, class T2, T2 C2>
+void obf_check_literal_compare(V& v, T_ ref) {
+	obf_literal<T2, C2, obf_compile_time_prng(seed, 6), cycles> l;
+	using CT = decltype(ref + l.value());//as for plain integers, with the usual arithmetic conversions
+	bool eq = CT(ref) == CT(l.value());
+	obf_bench_check((v == l) == eq, "obf_var<> == obf_literal<>", uint64_t(C2));
+	obf_bench_check((v != l) == !eq, "obf_var<> != obf_literal<>", uint64_t(C2));
+}
+
+template<class T_, OBFSEED seed, OBFCYCLES cycles>
+void obf_check_compare() {
+	using T = typename std::make_unsigned<T_>::type;
+	using U = typename ObfAffine<T>::U;
+	using V = obf_var<T_, seed, cycles>;
+	std::mt19937_64 rng(seed ^ 0x20);
+	const T_ special[] = { T_(0), T_(-1), T_(1), T_(0x5d), T_(300), T_(T(1) << (sizeof(T) * 8 - 1)) };
+	for (int i = 0; i < 40; ++i) {
+		uint64_t r = rng();
+		T_ a = i < 6 ? special[i] : T_(r);
+		T_ b = (r >> 60) < 8 ? a : T_(rng());
+		V v = a;
+		V w = b;
+		obf_bench_check((v == w) == (a == b), "obf_var<> == obf_var<>", uint64_t(i));
+		obf_bench_check((v != w) == (a != b), "obf_var<> != obf_var<>", uint64_t(i));
+
+		//after encoded +=/^= (where Injection allows them), v has to be the very same encoded value as a freshly assigned one
+		int64_t k = int64_t(r % 2000) - 1000;
+		T_ m = T_(r >> 24);
+		v += k;
+		v ^= m;
+		T_ ref = T_(T_(U(a) + U(k)) ^ m);
+		V fresh = ref;
+		obf_bench_check(v == fresh && !(v != fresh), "obf_var<> == obf_var<> after +=/^=", uint64_t(i));
+		obf_bench_check(std::hash<V>()(v) == std::hash<V>()(fresh), "std::hash<obf_var<>> after +=/^=", uint64_t(i));
+
+		//literals of other types, incl. ones out of T_'s range (which never compare equal), and -1 of a signed type
+		obf_check_literal_compare<T_, seed, cycles, V, int, -1>(v, ref);
+		obf_check_literal_compare<T_, seed, cycles, V, int, 300>(v, ref);
+		obf_check_literal_compare<T_, seed, cycles, V, int8_t, -1>(v, ref);
+		obf_check_literal_compare<T_, seed, cycles, V, uint8_t, 0xff>(v, ref);
+		obf_check_literal_compare<T_, seed, cycles, V, T_, T_(0x5d)>(v, ref);
+	}
+}
+
+template<class T, class Injection, OBFSEED seed>
+void obf_check_constant_evaluated() {
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+	using R = typename Injection::return_type;
+	constexpr T c = T(obf_compile_time_prng(seed, 7));
+	constexpr R enc = Injection::injection(c);
+	volatile T x = c;//NOT a constant expression
+	R rt = Injection::injection(x);
+	obf_bench_check(obf_encoded_ops<R>::equal(enc, rt), "compile-time injection() vs runtime one", seed);
+	obf_bench_check(T(Injection::surjection(enc)) == c, "surjection() of compile-time injection()", seed);
+#endif
+}
+
+template<size_t NN, size_t NC>
+constexpr bool obf_check_has_version4(const ObfFlatPlan<NN, NC>& plan) {
+	for (size_t i = 0; i < plan.n_nodes; ++i)
+		if (plan.nodes[i].which == 4)
+			return true;
+	return false;
+}
+
+template<class T_, OBFSEED seed, OBFCYCLES cycles>
+void obf_check_version4() {
+	using T = typename std::make_unsigned<T_>::type;
+	using Context = ObfVarContext<T, obf_compile_time_prng(seed, 1), cycles>;
+	if constexpr(obf_injection_version4_descr<T, Context>::own_min_cycles <= cycles) {
+		++obf_check_v4_trees;
+		obf_check_constant_evaluated<T, obf_injection_version<4, T, Context, obf_compile_time_prng(seed, 2), cycles>, seed>();
+	}
+	//flat ones can't be asked for version 4, so we're checking all the root injections, and counting the ones which have it
+	using Plan = obf_flat_plan<sizeof(T), ObfFlatContextKind::var, obf_compile_time_prng(seed, 1), cycles, obf_compile_time_prng(seed, 2), cycles, ObfDefaultInjectionContext::exclude_version>;
+	if constexpr(obf_check_has_version4(Plan::plan))
+		++(sizeof(T) == 1 ? obf_check_v4_flats8 : obf_check_v4_flats);
+	obf_check_constant_evaluated<T, obf_flat_injection<T, Context, obf_compile_time_prng(seed, 2), cycles, ObfDefaultInjectionContext>, seed>();
+}
+
+template<class T, OBFSEED seed, OBFCYCLES cycles>
+void obf_check_type() {
+	obf_check_descriptors<T, seed, cycles>();
+	obf_check_context_affines<typename std::make_unsigned<T>::type, seed>(std::make_index_sequence<11>());
+	obf_check_ops<T, seed, cycles>();
+	obf_check_compare<T, seed, cycles>();
+	obf_check_version4<T, seed, cycles>();
+}
+
+template<int level, size_t... I>
+void obf_check_level(std::index_sequence<I...>) {
+	((obf_check_type<int64_t, obf_bench_seed(level, int(I), 8), obf_exp_cycles(level)>(),
+		obf_check_type<uint32_t, obf_bench_seed(level, int(I), 4), obf_exp_cycles(level)>(),
+		obf_check_type<int16_t, obf_bench_seed(level, int(I), 2), obf_exp_cycles(level)>(),
+		obf_check_type<uint8_t, obf_bench_seed(level, int(I), 1), obf_exp_cycles(level)>(),
+		obf_check_compare<int8_t, obf_bench_seed(level, int(I), 0x81), obf_exp_cycles(level)>()), ...);
+	printf("OBF%d: %d seed(s) checked\n", level, OBF_CHECK_SEEDS);
+}
+
+int main() {
+	obf_check_level<0>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<1>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<2>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	obf_check_level<3>(std::make_index_sequence<OBF_CHECK_SEEDS>());
+	printf("%d root injection(s): %d affine, %d xor mask\n", obf_check_total, obf_check_affines, obf_check_xors);
+#ifdef ITHARE_OBF_IS_CONSTANT_EVALUATED
+	printf("compile-time vs runtime version 4: %d tree(s), %d+%d (uint8_t) flat root injection(s) with it\n", obf_check_v4_trees, obf_check_v4_flats, obf_check_v4_flats8);
+	obf_bench_check(obf_check_v4_trees > 0 && obf_check_v4_flats > 0 && obf_check_v4_flats8 > 0, "version 4 injections checked", uint64_t(obf_check_v4_flats8));
+#endif
+	return obf_bench_exit("obf_var<> operator");
+}
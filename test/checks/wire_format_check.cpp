@@ -0,0 +1,53 @@
+//wire_format_check.cpp: checks that OBF?W() wire formats don't depend on the build, and of format fingerprints in the stream
+//Usage:
+//  compile and run (it is a part of 'make check'); exit code is 1 if any of the checks fails
+//  built with its own ITHARE_OBF_SEED (wire formats depend on it), both as is and with -DITHARE_OBF_CYCLE_COSTS_HEADER
+//  (see wire_format_costs.h), ITHARE_OBF_CODE_SIZE_BOUNDED etc.; obf_wire<>::fingerprint has to be the same known value,
+//  which can change only together with obf_wire<>::format_version
+
+#include <vector>
+
+#ifdef ITHARE_OBF_SEED
+#error "wire_format_check.cpp uses its own ITHARE_OBF_SEED (the known fingerprints below depend on it)"
+#endif
+#define ITHARE_OBF_SEED UINT64_C(0x5be0cd19137e2179)
+#include "../common/obf_bench.h"
+
+using ObfCheckWire3 = obf_wire<obf_wire_seed(0x77697265), obf_exp_cycles(3)>;//OBF3W(0x77697265)
+using ObfCheckWire6 = obf_wire<obf_wire_seed(0x77697265), obf_exp_cycles(6)>;//OBF6W(0x77697265)
+
+static_assert(ObfCheckWire3::format_version == 2 && ObfCheckWire3::fingerprint == UINT64_C(0x1e8f2bd09cd8b08e), "wire format has changed");
+static_assert(ObfCheckWire6::format_version == 2 && ObfCheckWire6::fingerprint == UINT64_C(0x3b51adb88f38a627), "wire format has changed");
+
+template<class Wire, class WrongWire>
+void obf_check_wire_fingerprint() {
+	std::vector<uint8_t> buf;
+	obf_wire_writer<Wire> writer(buf);
+	writer.write_fingerprint();
+	obf_var<uint32_t, obf_bench_seed(3, 0), obf_exp_cycles(3)> v = 0xdeadbeef;
+	writer.write(v, uint16_t(0x1234));
+	obf_bench_check(buf.size() == sizeof(uint64_t) + 6, "wire: size with fingerprint", buf.size());
+
+	{
+		obf_wire_reader<Wire> reader(buf);
+		obf_var<uint32_t, obf_bench_seed(3, 1), obf_exp_cycles(2)> v2 = 0;
+		uint16_t x = 0;
+		obf_bench_check(reader.read_fingerprint() && reader.read(v2, x) && v2 == 0xdeadbeef && x == 0x1234 && reader.remaining() == 0, "wire: fingerprint and values");
+	}
+	{
+		obf_wire_reader<WrongWire> reader(buf);
+		uint16_t x = 0;
+		obf_bench_check(!reader.read_fingerprint() && !reader.read(x) && reader.remaining() == 0, "wire: fingerprint of another format");
+	}
+	{
+		obf_wire_reader<Wire> reader(buf.data(), sizeof(uint64_t) - 1);
+		obf_bench_check(!reader.read_fingerprint(), "wire: truncated fingerprint");
+	}
+}
+
+int main() {
+	obf_check_wire_fingerprint<ObfCheckWire3, ObfCheckWire6>();
+	obf_check_wire_fingerprint<ObfCheckWire6, ObfCheckWire3>();
+	printf("wire fingerprints: OBF3W 0x%016llx, OBF6W 0x%016llx\n", (unsigned long long)ObfCheckWire3::fingerprint, (unsigned long long)ObfCheckWire6::fingerprint);
+	return obf_bench_exit("wire format");
+}
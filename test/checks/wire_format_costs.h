@@ -0,0 +1,9 @@
+//wire_format_costs.h: deliberately skewed cycle costs, in the format of obf_calibrate output
+//  wire_format_check.cpp is built with and without it (see test/Linux/Makefile): wire formats MUST NOT depend on it
+ObfCycleCost(ObfCycleCostKind::injection_version, 1, 0, 9, 9),
+ObfCycleCost(ObfCycleCostKind::injection_version, 2, 0, 2, 2),
+ObfCycleCost(ObfCycleCostKind::injection_version, 4, 0, 1, 1),
+ObfCycleCost(ObfCycleCostKind::injection_version, 7, 0, 5, 5),
+ObfCycleCost(ObfCycleCostKind::literal_context, 9, 0, 0, 50),
+ObfCycleCost(ObfCycleCostKind::literal_context, 10, 0, 0, 1),
+ObfCycleCost(ObfCycleCostKind::non_reversible_function, 1, 0, 20, 20),
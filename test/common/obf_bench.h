@@ -0,0 +1,59 @@
+//obf_bench.h: scaffolding shared by benches and checks under test/ - timing, result sink, failure counting, per-row seeds
+//Usage:
+//  #define ITHARE_OBF_SEED (if the bench has a default of its own) and include this header instead of obfuscate.h;
+//  time with obf_bench_ns(), count failed checks with obf_bench_check(), and return obf_bench_exit() from main()
+//Each .cpp includes it once (it is not meant to be shared across translation units of the same program)
+
+#ifndef ithare_obf_test_obf_bench_h_included
+#define ithare_obf_test_obf_bench_h_included
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "../../src/obfuscate.h"
+
+using namespace ithare::obf;
+
+static volatile uint64_t obf_bench_sink;
+static int obf_bench_fails = 0;
+
+//best of repetitions runs of f() (which returns something to be sunk), in nanoseconds per item
+template<class F>
+double obf_bench_ns(int repetitions, size_t items, F f) {
+	double best = 1e30;
+	for (int rep = 0; rep < repetitions; ++rep) {
+		auto t0 = std::chrono::steady_clock::now();
+		obf_bench_sink = uint64_t(f());
+		auto t1 = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(items));
+	}
+	return best;
+}
+
+//seed of the i-th sample (0-based) of an OBF<level> row; salt tells apart rows of the same level (e.g. sizeof(T))
+constexpr OBFSEED obf_bench_seed(int level, int i, uint64_t salt = 0) {
+	return obf_compile_time_prng(ITHARE_OBF_SEED ^ (uint64_t(level) << 56) ^ salt, i + 1);
+}
+
+//counts a failed check, printing the first few of them
+inline bool obf_bench_check(bool ok, const char* what, uint64_t arg = 0) {
+	if (!ok) {
+		if (obf_bench_fails < 10)
+			printf("FAILED: %s (%llu)\n", what, (unsigned long long)arg);
+		++obf_bench_fails;
+	}
+	return ok;
+}
+
+inline int obf_bench_exit(const char* what) {
+	if (obf_bench_fails) {
+		printf("%d %s check(s) FAILED\n", obf_bench_fails, what);
+		return 1;
+	}
+	return 0;
+}
+
+#endif
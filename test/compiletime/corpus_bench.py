@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+# corpus_bench.py: compile-time scalability benchmark - generates a corpus of N translation units with M OBF sites each
+#   (obf_var, obf_literal and obf_str_literal at every OBF level, via the usual OBF?()/OBF?I()/OBF?S() macros),
+#   compiles them one by one, and records compile time, peak compiler memory, object size,
+#   and the number of ithare::obf instantiations
+# Usage: python3 corpus_bench.py [--cxx g++] [--flags "-std=c++17 -O2 -ftemplate-depth=4096 -fconstexpr-depth=4096"] [--tus 4] [--sites 42] [--levels 0-6] [--kinds var,literal,str]
+#                                [--out corpus] [--generate-only] [--sweep] [--json results.json] [--baseline results.json [--tolerance 10]]
+#   --sweep additionally compiles one TU per OBF level (with all M sites at that level), to see the cost of a site per level,
+#     i.e. to choose site density
+#   --json saves the results; --baseline compares with saved ones, and fails (exit code 1) if compile time, memory
+#     or instantiations went up by more than --tolerance percent - to catch regressions in template-heavy changes to obfuscate.h
+#     (compile time is noisy: compare results from the same box, and use --runs)
+#   time, memory and sizes come from a clean compile; instantiations are counted in a separate compile of the same TU
+#     (so that dumping them doesn't skew the timing), from -fdump-lang-class (GCC) or -ftime-trace (Clang), and they are
+#     not the same thing: GCC counts instantiated classes, Clang - instantiated classes and functions; hence they're
+#     labelled per compiler, and never compared across compilers; they're not available for other compilers
+#   peak memory is ru_maxrss of the compiler driver and its children (Linux/macOS only)
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+KINDS = ('var', 'literal', 'str')
+TYPES = ('uint8_t', 'uint16_t', 'uint32_t', 'uint64_t')
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'src', 'obfuscate.h')
+
+def parse_levels(s):
+	ret = []
+	for part in s.split(','):
+		if '-' in part:
+			lo, hi = part.split('-')
+			ret += list(range(int(lo), int(hi) + 1))
+		else:
+			ret.append(int(part))
+	for level in ret:
+		if level < 0 or level > 6:
+			sys.exit('OBF levels are 0..6')
+	return ret
+
+def gen_site(tu, i, kind, level, t):
+	name = 'obf_corpus_%d_%d' % (tu, i)
+	if kind == 'var':
+		return ('ITHARE_OBF_NOINLINE uint64_t %s(uint64_t x) {\n'
+			'\tOBF%d(%s) v = %s(x);\n'
+			'\tv += %s(%d);\n'
+			'\tv *= 3;\n'
+			'\treturn v;\n'
+			'}\n' % (name, level, t, t, t, i + 1))
+	if kind == 'literal':
+		c = (0x9e3779b97f4a7c15 * (tu * 1000 + i + 1)) & ((1 << (8 << TYPES.index(t))) - 1)#distinct per site, fits into t
+		return ('ITHARE_OBF_NOINLINE uint64_t %s(uint64_t x) {\n'
+			'\treturn x ^ OBF%dI(%s(0x%x));\n'
+			'}\n' % (name, level, t, c))
+	assert kind == 'str'
+	return ('ITHARE_OBF_NOINLINE uint64_t %s(uint64_t x) {\n'
+		'\treturn x + std::string(OBF%dS("corpus site %d/%d")).size();\n'
+		'}\n' % (name, level, tu, i))
+
+def gen_tu(tu, n_sites, kinds, levels):
+	#site #i gets kind #(i % len(kinds)) and level #(i / len(kinds) % len(levels)), so that all the combinations are covered
+	#  as soon as n_sites >= len(kinds)*len(levels); widths rotate over TYPES
+	sites = []
+	for i in range(n_sites):
+		kind = kinds[i % len(kinds)]
+		level = levels[i // len(kinds) % len(levels)]
+		t = TYPES[(i // (len(kinds) * len(levels)) + tu) % len(TYPES)]
+		sites.append(gen_site(tu, i, kind, level, t))
+	body = ''.join('\tret += obf_corpus_%d_%d(x);\n' % (tu, i) for i in range(n_sites))
+	return ('//GENERATED by corpus_bench.py, DO NOT EDIT: TU #%d, %d site(s), kinds=%s, levels=%s\n'
+		'#include <stdint.h>\n'
+		'#include <string>\n'
+		'#include "%s"\n'
+		'using namespace ithare::obf;//OBF?I()/OBF?S() need it\n\n'
+		'%s\n'
+		'uint64_t obf_corpus_%d(uint64_t x) {\n'
+		'\tuint64_t ret = 0;\n'
+		'%s'
+		'\treturn ret;\n'
+		'}\n' % (tu, n_sites, ','.join(kinds), ','.join(str(l) for l in levels), os.path.abspath(HEADER).replace('\\', '/'),
+			'\n'.join(sites), tu, body))
+
+def compiler_kind(cxx):
+	try:
+		out = subprocess.run([cxx, '--version'], stdout=subprocess.PIPE, stderr=subprocess.STDOUT).stdout.decode(errors='replace')
+	except OSError:
+		return None
+	if 'clang' in out:
+		return 'clang'
+	if 'GCC' in out or 'g++' in out or 'Free Software Foundation' in out:
+		return 'gcc'
+	return None
+
+def run_measured(cmd, cwd):
+	#returns (seconds, peak RSS in KB or None, returncode, output)
+	t0 = time.perf_counter()
+	p = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, cwd=cwd)
+	out = p.stdout.read()
+	p.stdout.close()
+	if hasattr(os, 'wait4'):
+		_, status, usage = os.wait4(p.pid, 0)
+		t1 = time.perf_counter()
+		rc = os.waitstatus_to_exitcode(status) if hasattr(os, 'waitstatus_to_exitcode') else (status >> 8)
+		rss = usage.ru_maxrss // 1024 if sys.platform == 'darwin' else usage.ru_maxrss#bytes on macOS, KB on Linux
+		p.returncode = rc
+		return t1 - t0, rss, rc, out
+	rc = p.wait()
+	return time.perf_counter() - t0, None, rc, out
+
+def text_size(obj):
+	if not shutil.which('size'):
+		return None
+	res = subprocess.run(['size', obj], stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+	lines = res.stdout.decode(errors='replace').split('\n')
+	if res.returncode != 0 or len(lines) < 2 or not lines[1].split():
+		return None
+	return int(lines[1].split()[0])#Berkeley format: text data bss dec hex filename
+
+#what count_instantiations() counts, per compiler
+#  (with the column label for print_row())
+INSTANTIATIONS = { 'gcc': ('classes', 'classes'), 'clang': ('classes+functions', 'cls+funcs') }
+
+def count_instantiations(kind, workdir, src, obj):
+	if kind == 'gcc':
+		#-fdump-lang-class writes <dumpbase>.<pass>.class with one 'Class' entry per complete class, incl. all the instantiations
+		base = os.path.splitext(os.path.basename(obj))[0]
+		for f in os.listdir(workdir):
+			if f.startswith(base) and f.endswith('.class'):
+				path = os.path.join(workdir, f)
+				with open(path, errors='replace') as fh:
+					n = sum(1 for line in fh if line.startswith('Class ithare::obf::'))
+				os.remove(path)
+				return n
+		return None
+	if kind == 'clang':
+		trace = os.path.splitext(obj)[0] + '.json'
+		if not os.path.exists(trace):
+			return None
+		with open(trace) as fh:
+			events = json.load(fh).get('traceEvents', [])
+		os.remove(trace)
+		return sum(1 for e in events if e.get('name') in ('InstantiateClass', 'InstantiateFunction') and 'ithare::obf::' in e.get('args', {}).get('detail', ''))
+	return None
+
+def compile_cmd(args, src, obj):
+	#compiled from within the corpus directory, by file name: OBF?() seeds depend on __FILE__, so that the same corpus
+	#  means the same code wherever --out is
+	return [args.cxx] + args.flags.split() + ['-DITHARE_OBF_SEED=UINT64_C(%s)' % args.seed, '-c', os.path.basename(src), '-o', obj]
+
+def run_checked(cmd, cwd):
+	secs, rss, rc, out = run_measured(cmd, cwd)
+	if rc != 0:
+		errors = [line for line in out.decode(errors='replace').split('\n') if 'error' in line]
+		sys.stdout.write('\n'.join(errors[:5]) + '\n')
+		sys.exit('compilation failed: ' + ' '.join(cmd))
+	return secs, rss
+
+def compile_tu(args, kind, workdir, src):
+	#timed runs: exactly --flags, nothing else
+	obj = os.path.splitext(src)[0] + '.o'
+	best = None
+	for _ in range(args.runs):
+		secs, rss = run_checked(compile_cmd(args, src, obj), workdir)
+		if best is None or secs < best['seconds']:
+			best = { 'seconds': secs, 'rss_kb': rss }
+	best['obj_bytes'] = os.path.getsize(obj)
+	best['text_bytes'] = text_size(obj)
+	#untimed run, to a separate object: the same compile with the dump (GCC) or the trace (Clang) on top
+	best['instantiations'] = None
+	if kind in INSTANTIATIONS:
+		dump_obj = os.path.splitext(src)[0] + '.dump.o'
+		cmd = compile_cmd(args, src, dump_obj)
+		if kind == 'gcc':
+			cmd += ['-fdump-lang-class', '-dumpdir', workdir + os.sep]
+		else:
+			cmd += ['-ftime-trace', '-ftime-trace-granularity=0']
+		run_checked(cmd, workdir)
+		best['instantiations'] = count_instantiations(kind, workdir, src, dump_obj)
+		os.remove(dump_obj)
+	return best
+
+def fmt(v, scale=1, spec='%10.1f'):
+	return spec % (v / scale) if v is not None else '%10s' % '-'
+
+def print_row(name, r, n_sites, empty_seconds):
+	#ms/site excludes the time of compiling a TU w/o sites (i.e. parsing obfuscate.h and <string>)
+	per_site = '%9.1f' % (1000 * (r['seconds'] - empty_seconds) / n_sites) if n_sites else '%9s' % '-'
+	print('%-16s %8.2f %10s %10s %10s %10s %s' % (name, r['seconds'], fmt(r['rss_kb'], 1024), fmt(r['obj_bytes'], 1024),
+		fmt(r['text_bytes'], 1024), fmt(r['instantiations'], 1, '%10d'), per_site))
+
+def total(results):
+	def add(key, f):
+		vals = [r[key] for r in results]
+		return None if any(v is None for v in vals) else f(vals)
+	return { 'seconds': sum(r['seconds'] for r in results), 'rss_kb': add('rss_kb', max), 'obj_bytes': add('obj_bytes', sum),
+		'text_bytes': add('text_bytes', sum), 'instantiations': add('instantiations', sum) }
+
+def compare(baseline, current, tolerance):
+	failed = False
+	for key, name in (('seconds', 'compile time'), ('rss_kb', 'peak memory'), ('instantiations', 'instantiations'), ('text_bytes', 'code size')):
+		old, new = baseline['total'].get(key), current['total'].get(key)
+		if not old or new is None:
+			continue
+		if key == 'instantiations' and baseline.get('instantiations_counted') != current['instantiations_counted']:
+			print('%-15s not compared: baseline counted %s, this run counts %s' % (name,
+				baseline.get('instantiations_counted') or 'unknown', current['instantiations_counted']))
+			continue
+		delta = 100. * (new - old) / old
+		bad = delta > tolerance
+		failed = failed or bad
+		print('%-15s %12.1f -> %12.1f (%+.1f%%)%s' % (name, old, new, delta, ' REGRESSION' if bad else ''))
+	return failed
+
+def main():
+	parser = argparse.ArgumentParser()
+	parser.add_argument('--cxx', default='c++')
+	#GCC's default -ftemplate-depth=900 and -fconstexpr-depth=512 are not enough for OBF6 on 8-bit types
+	#  (injection chains there are several hundred levels deep, with 2 nested instantiations per level)
+	parser.add_argument('--flags', default='-std=c++17 -O2 -ftemplate-depth=4096 -fconstexpr-depth=4096')
+	parser.add_argument('--seed', default='0x4f1bbcdcbfa53e0b', help='ITHARE_OBF_SEED')
+	parser.add_argument('--tus', type=int, default=4, help='number of translation units (N)')
+	parser.add_argument('--sites', type=int, default=len(KINDS) * 7 * 2, help='sites per translation unit (M)')
+	parser.add_argument('--levels', default='0-6', help='OBF levels, e.g. 0-6 or 3,5')
+	parser.add_argument('--kinds', default=','.join(KINDS), help='any of ' + ','.join(KINDS))
+	parser.add_argument('--out', default=None, help='directory for the corpus (default: temporary one)')
+	parser.add_argument('--runs', type=int, default=1, help='compile each TU this many times, reporting the fastest')
+	parser.add_argument('--generate-only', action='store_true')
+	parser.add_argument('--sweep', action='store_true', help='also compile one TU per OBF level')
+	parser.add_argument('--json', default=None, help='save results here')
+	parser.add_argument('--baseline', default=None, help='compare with results saved by --json')
+	parser.add_argument('--tolerance', type=float, default=10., help='percent')
+	args = parser.parse_args()
+
+	kinds = args.kinds.split(',')
+	for k in kinds:
+		if k not in KINDS:
+			sys.exit('unknown kind: ' + k)
+	levels = parse_levels(args.levels)
+	workdir = os.path.abspath(args.out or tempfile.mkdtemp(prefix='obf_corpus_'))
+	os.makedirs(workdir, exist_ok=True)
+
+	srcs = []
+	for tu in range(args.tus):
+		src = os.path.join(workdir, 'obf_corpus_%d.cpp' % tu)
+		with open(src, 'w') as f:
+			f.write(gen_tu(tu, args.sites, kinds, levels))
+		srcs.append(src)
+	empty = os.path.join(workdir, 'obf_corpus_empty.cpp')
+	with open(empty, 'w') as f:
+		f.write(gen_tu(999, 0, kinds, levels))
+	sweep = []
+	if args.sweep:
+		for level in levels:
+			src = os.path.join(workdir, 'obf_corpus_level%d.cpp' % level)
+			with open(src, 'w') as f:
+				f.write(gen_tu(1000 + level, args.sites, kinds, [level]))
+			sweep.append((level, src))
+	print('corpus: %d TU(s) x %d site(s) in %s' % (args.tus, args.sites, workdir))
+	if args.generate_only:
+		return
+
+	kind = compiler_kind(args.cxx)
+	print('compiler: %s (%s), flags: %s' % (args.cxx, kind or 'unknown - no instantiation counts', args.flags))
+	counted, label = INSTANTIATIONS.get(kind, (None, 'inst.'))
+	print('%-16s %8s %10s %10s %10s %10s %9s' % ('TU', 'time,s', 'peak,MB', 'obj,KB', 'text,KB', label, 'ms/site'))
+	e = compile_tu(args, kind, workdir, empty)
+	print_row('(no sites)', e, 0, 0)
+	results = []
+	for src in srcs:
+		r = compile_tu(args, kind, workdir, src)
+		results.append(r)
+		print_row(os.path.basename(src), r, args.sites, e['seconds'])
+	tot = total(results)
+	print_row('total', tot, args.sites * len(srcs), e['seconds'] * len(srcs))
+	current = { 'cxx': args.cxx, 'flags': args.flags, 'seed': args.seed, 'tus': args.tus, 'sites': args.sites,
+		'kinds': kinds, 'levels': levels, 'instantiations_counted': counted and '%s (%s)' % (counted, kind),
+		'no_sites': e, 'per_tu': results, 'total': tot }
+	if sweep:
+		print('per OBF level (%d site(s) each):' % args.sites)
+		current['per_level'] = {}
+		for level, src in sweep:
+			r = compile_tu(args, kind, workdir, src)
+			current['per_level'][str(level)] = r
+			print_row('OBF%d' % level, r, args.sites, e['seconds'])
+
+	if args.json:
+		with open(args.json, 'w') as f:
+			json.dump(current, f, indent=1)
+	if args.baseline:
+		with open(args.baseline) as f:
+			baseline = json.load(f)
+		if (baseline.get('tus'), baseline.get('sites'), baseline.get('kinds'), baseline.get('levels')) != (args.tus, args.sites, kinds, levels):
+			sys.exit('baseline was made for a different corpus')
+		print('vs baseline %s:' % args.baseline)
+		if compare(baseline, current, args.tolerance):
+			sys.exit(1)
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,84 @@
+//prng_bench.cpp: compile-time benchmark for compile-time PRNG and related constexpr helpers
+//  NOT intended to be run - what matters is how long it takes to COMPILE; see prng_bench.py
+//OBF_PRNG_BENCH_MODE:
+//  0 - constexpr workload over legacy helpers (LCG looping 'iteration' times, double-based split), as in older obfuscate.h
+//  1 - the same constexpr workload over current obf_compile_time_prng()/obf_random_split()
+//  2 - real-world-like TU with lots of OBF sites (to be compiled with and without ITHARE_OBF_COMPAT_LCG_PRNG)
+
+#include <stdint.h>
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x7b1e03c5d92a4f68)
+#endif
+#include "../../src/obfuscate.h"
+
+#ifndef OBF_PRNG_BENCH_MODE
+#define OBF_PRNG_BENCH_MODE 1
+#endif
+#ifndef OBF_PRNG_BENCH_SEEDS
+#define OBF_PRNG_BENCH_SEEDS 10000//NB: with MSVC, you'll likely need to increase /constexpr:steps
+#endif
+
+using namespace ithare::obf;
+
+#if OBF_PRNG_BENCH_MODE == 0
+constexpr OBFSEED obf_bench_prng(OBFSEED seed, int iteration) {
+	OBFSEED ret = seed;
+	for (int i = 0; i < iteration; ++i)
+		ret = UINT64_C(6364136223846793005) * ret + UINT64_C(1442695040888963407);
+	return ret;
+}
+
+template<size_t N>
+constexpr std::array<OBFCYCLES, N> obf_bench_split(OBFSEED seed, OBFCYCLES cycles, std::array<ObfDescriptor, N> elements) {
+	std::array<OBFCYCLES, N> ret = {};
+	size_t totalWeight = 0;
+	for (size_t i = 0; i < N; ++i) {
+		ret[i] = OBFCYCLES(obf_weak_random(obf_bench_prng(seed, int(i + 1)), elements[i].weight)) + 1;
+		totalWeight += ret[i];
+	}
+	double q = double(cycles) / double(totalWeight);
+	for (size_t i = 0; i < N; ++i)
+		ret[i] = OBFCYCLES(double(ret[i]) * double(q));
+	return ret;
+}
+#elif OBF_PRNG_BENCH_MODE == 1
+//no wrappers: an extra level of constexpr calls would skew the results
+#define obf_bench_prng obf_compile_time_prng
+#define obf_bench_split obf_random_split
+#endif
+
+#if OBF_PRNG_BENCH_MODE == 0 || OBF_PRNG_BENCH_MODE == 1
+constexpr OBFSEED obf_bench_workload() {
+	//mimics what a single obf_injection_version<> does: ~10 PRNG calls with small iterations, plus a split
+	constexpr std::array<ObfDescriptor, 3> split = { ObfDescriptor(true,0,200), ObfDescriptor(true,0,100), ObfDescriptor(true,0,100) };
+	OBFSEED ret = 0;
+	for (OBFSEED seed = 0; seed < OBF_PRNG_BENCH_SEEDS; ++seed) {
+		for (int it = 1; it <= 10; ++it)
+			ret ^= obf_bench_prng(seed, it);
+		auto cycles = obf_bench_split(obf_bench_prng(seed, 1), OBFCYCLES(seed % 1000), split);
+		ret += OBFSEED(cycles[0]) + OBFSEED(cycles[1]) + OBFSEED(cycles[2]);
+	}
+	return ret;
+}
+static_assert(obf_bench_workload() != 0);//forces compile-time evaluation
+
+#else//OBF_PRNG_BENCH_MODE == 2
+#define OBF_BENCH_FUNC(name) \
+	ITHARE_OBF_NOINLINE int64_t name(int64_t x0) {\
+		OBF5(int64_t) x = x0;\
+		OBF4(uint32_t) y = uint32_t(x0);\
+		OBF3(uint16_t) z = uint16_t(x0);\
+		OBF2(uint8_t) w = uint8_t(x0);\
+		return x + y.value() + z.value() + w.value() + OBF4I(12345) + OBF3I(678u);\
+	}
+#define OBF_BENCH_FUNC8(prefix) OBF_BENCH_FUNC(prefix##0) OBF_BENCH_FUNC(prefix##1) OBF_BENCH_FUNC(prefix##2) OBF_BENCH_FUNC(prefix##3) \
+	OBF_BENCH_FUNC(prefix##4) OBF_BENCH_FUNC(prefix##5) OBF_BENCH_FUNC(prefix##6) OBF_BENCH_FUNC(prefix##7)
+OBF_BENCH_FUNC8(obf_bench_f0)
+OBF_BENCH_FUNC8(obf_bench_f1)
+OBF_BENCH_FUNC8(obf_bench_f2)
+OBF_BENCH_FUNC8(obf_bench_f3)
+#endif
+
+int main() {
+	return 0;
+}
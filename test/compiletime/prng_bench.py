@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+# prng_bench.py: measures how long it takes to compile prng_bench.cpp in different modes
+#   (i.e. compile-time cost of compile-time PRNG and related constexpr helpers, per translation unit)
+# Usage: python3 prng_bench.py [--cxx g++] [--flags "-std=c++17 -O2"] [--runs 3] [--seeds 10000]
+#   for MSVC: python3 prng_bench.py --cxx cl --flags "/std:c++latest /O2 /nologo /constexpr:steps100000000" --syntax-only /Zs --define /D
+
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+CONFIGS = [
+	('legacy PRNG+split, constexpr workload', ['OBF_PRNG_BENCH_MODE=0']),
+	('current PRNG+split, constexpr workload', ['OBF_PRNG_BENCH_MODE=1']),
+	('OBF sites, ITHARE_OBF_COMPAT_LCG_PRNG', ['OBF_PRNG_BENCH_MODE=2', 'ITHARE_OBF_COMPAT_LCG_PRNG']),
+	('OBF sites, counter-based PRNG', ['OBF_PRNG_BENCH_MODE=2']),
+]
+
+def compile_once(args, defines):
+	src = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'prng_bench.cpp')
+	defines = defines + ['OBF_PRNG_BENCH_SEEDS=%d' % args.seeds]
+	cmd = [args.cxx] + args.flags.split() + [args.syntax_only] + [args.define + d for d in defines] + [src]
+	t0 = time.perf_counter()
+	res = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+	t1 = time.perf_counter()
+	if res.returncode != 0:
+		sys.stdout.write(res.stdout.decode(errors='replace'))
+		sys.exit('compilation failed: ' + ' '.join(cmd))
+	return t1 - t0
+
+def main():
+	parser = argparse.ArgumentParser()
+	parser.add_argument('--cxx', default='c++')
+	parser.add_argument('--flags', default='-std=c++17 -O2')
+	parser.add_argument('--syntax-only', default='-fsyntax-only')
+	parser.add_argument('--define', default='-D')
+	parser.add_argument('--runs', type=int, default=3)
+	parser.add_argument('--seeds', type=int, default=10000, help='size of constexpr workload')
+	args = parser.parse_args()
+
+	results = []
+	for name, defines in CONFIGS:
+		best = min(compile_once(args, defines) for _ in range(args.runs))
+		results.append(best)
+		print('%-45s %8.3f s' % (name, best))
+	print('constexpr workload speedup: %.2fx' % (results[0] / results[1]))
+	print('OBF sites speedup: %.2fx' % (results[2] / results[3]))
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,154 @@
+//map_bench.cpp: obf_unordered_map<> (open addressing over encoded keys) vs std::unordered_map<> keyed by obf_var<> or by plain keys
+//Usage:
+//  compile in Release mode and run (checks of obf_unordered_map<> against std::unordered_map<> are in ../checks/containers_check.cpp)
+//Prints nanoseconds per lookup (half of them hits, half misses) in a map of OBF_MAP_BENCH_SIZE random keys,
+//  for several key types and obfuscation levels, averaged over OBF_MAP_BENCH_SEEDS different seeds:
+//  plain - std::unordered_map<T,T>;
+//  obf_var(dec) - std::unordered_map<obf_var<>,T> with hash/equality over value(), i.e. surjection of each stored key probed;
+//  obf_var - the same with std::hash<obf_var<>> and obf_var<>::operator==, which hash/compare encoded values;
+//  obf_map - obf_unordered_map<T,T>; obf_map(V) - obf_unordered_map<T,T,...,true>, with encoded values
+//All the obfuscated maps of the same row share the key injection tree (obf_var<T,seed,cycles>), so it is the same
+//  single injection per lookup for all of them (except for obf_var(dec), which also decodes stored keys)
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x58a3c1e97d204b6f)
+#endif
+#include "../common/obf_bench.h"
+
+#ifndef OBF_MAP_BENCH_SEEDS
+#define OBF_MAP_BENCH_SEEDS 4
+#endif
+#ifndef OBF_MAP_BENCH_SIZE
+#define OBF_MAP_BENCH_SIZE (1 << 16)
+#endif
+
+static constexpr size_t obf_bench_size = OBF_MAP_BENCH_SIZE;
+static constexpr int obf_bench_repetitions = 5;
+
+template<class F>
+double obf_bench_ns(size_t n, F f) {
+	return obf_bench_ns(obf_bench_repetitions, n, f);
+}
+
+template<class T>
+T obf_bench_key(size_t i) {//even keys are in the map, odd ones are not
+	return T((i * UINT64_C(0x9e3779b97f4a7c15) >> 11) & ~uint64_t(1)) | T(i & 1);
+}
+
+template<class Var>
+struct ObfBenchDecodingHash {
+	size_t operator()(const Var& v) const { return std::hash<decltype(v.value())>()(v.value()); }
+};
+template<class Var>
+struct ObfBenchDecodingEqual {
+	bool operator()(const Var& a, const Var& b) const { return a.value() == b.value(); }
+};
+
+struct ObfBenchResult {
+	double plain_ns = 0.;
+	double var_dec_ns = 0.;
+	double var_ns = 0.;
+	double map_ns = 0.;
+	double map_v_ns = 0.;
+};
+
+template<class T, OBFSEED seed, OBFCYCLES cycles>
+void obf_bench_one(ObfBenchResult& res) {
+	using Var = obf_var<T, seed, cycles>;
+	using Map = obf_unordered_map<T, T, seed, cycles>;
+	using MapV = obf_unordered_map<T, T, seed, cycles, true>;
+
+	std::unordered_map<T, T> plain;
+	std::unordered_map<Var, T, ObfBenchDecodingHash<Var>, ObfBenchDecodingEqual<Var>> var_dec;
+	std::unordered_map<Var, T> var;
+	Map map;
+	MapV map_v;
+	for (size_t i = 0; i < obf_bench_size; ++i) {
+		T k = obf_bench_key<T>(2 * i);
+		T v = T(i);
+		plain.insert({ k, v });
+		var_dec.insert({ Var(k), v });
+		var.insert({ Var(k), v });
+		map.insert(k, v);
+		map_v.insert(k, v);
+	}
+	std::vector<T> queries(2 * obf_bench_size);
+	for (size_t i = 0; i < queries.size(); ++i)
+		queries[i] = obf_bench_key<T>(i);
+	std::shuffle(queries.begin(), queries.end(), std::mt19937_64(seed));
+
+	res.plain_ns += obf_bench_ns(queries.size(), [&] {
+		uint64_t acc = 0;
+		for (T q : queries) {
+			auto it = plain.find(q);
+			if (it != plain.end())
+				acc += it->second;
+		}
+		return acc;
+	});
+	res.var_dec_ns += obf_bench_ns(queries.size(), [&] {
+		uint64_t acc = 0;
+		for (T q : queries) {
+			auto it = var_dec.find(Var(q));
+			if (it != var_dec.end())
+				acc += it->second;
+		}
+		return acc;
+	});
+	res.var_ns += obf_bench_ns(queries.size(), [&] {
+		uint64_t acc = 0;
+		for (T q : queries) {
+			auto it = var.find(Var(q));
+			if (it != var.end())
+				acc += it->second;
+		}
+		return acc;
+	});
+	res.map_ns += obf_bench_ns(queries.size(), [&] {
+		uint64_t acc = 0;
+		for (T q : queries) {
+			T v;
+			if (map.find(q, v))
+				acc += v;
+		}
+		return acc;
+	});
+	res.map_v_ns += obf_bench_ns(queries.size(), [&] {
+		uint64_t acc = 0;
+		for (T q : queries) {
+			T v;
+			if (map_v.find(q, v))
+				acc += v;
+		}
+		return acc;
+	});
+}
+
+template<class T, int level, size_t... I>
+void obf_bench_row(const char* name, std::index_sequence<I...>) {
+	ObfBenchResult res;
+	(obf_bench_one<T, obf_bench_seed(level, int(I), sizeof(T)), obf_exp_cycles(level)>(res), ...);
+	double n = double(sizeof...(I));
+	printf("%-10s OBF%d %10.2f %12.2f %10.2f %10.2f %11.2f\n", name, level,
+		res.plain_ns / n, res.var_dec_ns / n, res.var_ns / n, res.map_ns / n, res.map_v_ns / n);
+}
+
+template<class T, int level>
+void obf_bench_row(const char* name) {
+	obf_bench_row<T, level>(name, std::make_index_sequence<OBF_MAP_BENCH_SEEDS>());
+}
+
+int main() {
+	printf("%zu keys, %zu lookups (50%% hits), %d seeds\n", obf_bench_size, 2 * obf_bench_size, OBF_MAP_BENCH_SEEDS);
+	printf("%-10s %4s %10s %12s %10s %10s %11s\n", "ns/lookup", "", "plain", "obf_var(dec)", "obf_var", "obf_map", "obf_map(V)");
+	obf_bench_row<uint32_t, 2>("uint32_t");
+	obf_bench_row<uint32_t, 3>("uint32_t");
+	obf_bench_row<uint32_t, 4>("uint32_t");
+	obf_bench_row<uint64_t, 2>("uint64_t");
+	obf_bench_row<uint64_t, 3>("uint64_t");
+	return 0;
+}
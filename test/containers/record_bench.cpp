@@ -0,0 +1,163 @@
+//record_bench.cpp: obf_record<> (fields under one site) vs a struct of separate obf_var<> fields
+//Usage:
+//  compile in Release mode and run (round-trip checks of obf_record<> are in ../checks/containers_check.cpp)
+//Prints nanoseconds per record for reading all the fields of OBF_RECORD_BENCH_SIZE records
+//  (6 fields: int32_t, int32_t, uint16_t, uint16_t, uint8_t, uint32_t), for updating one field of each, and for writing all of them,
+//  for several obfuscation levels, averaged over OBF_RECORD_BENCH_SEEDS different seeds:
+//  plain - plain struct; obf_var - struct of obf_var<>s, read field by field;
+//  get<I>() - obf_record<> read field by field; load() - obf_record<> read as a whole;
+//  set<I>() / obf_var = - one field updated; store() / obf_vars = - all the fields written
+//All the fields of obf_record<> share one lane-wise tree; load()/store() run it over all the lanes at once
+//  (SSE2/AVX2 vectors, so the per-field chains are independent and overlap), while get<I>()/set<I>() run it for one field;
+//  obf_var<>s have per-field trees with all the versions, so get<I>() vs obf_var is about the trees,
+//  and load()/store() vs obf_var/obf_vars = is about the fused pass
+
+#include <vector>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x1b7e4c93a05d26f8)
+#endif
+#include "../common/obf_bench.h"
+
+#ifndef OBF_RECORD_BENCH_SEEDS
+#define OBF_RECORD_BENCH_SEEDS 8
+#endif
+#ifndef OBF_RECORD_BENCH_SIZE
+#define OBF_RECORD_BENCH_SIZE 4096
+#endif
+
+static constexpr size_t obf_bench_size = OBF_RECORD_BENCH_SIZE;
+static constexpr int obf_bench_repetitions = 20;
+
+template<class F>
+double obf_bench_ns(F f) {
+	return obf_bench_ns(obf_bench_repetitions, obf_bench_size, f);
+}
+
+enum { X, Y, HEALTH, AMMO, LEVEL, COOLDOWN };
+
+struct ObfBenchPlain {
+	int32_t x, y;
+	uint16_t health, ammo;
+	uint8_t level;
+	uint32_t cooldown;
+};
+
+template<OBFSEED seed, OBFCYCLES cycles>
+struct ObfBenchVars {
+	obf_var<int32_t, obf_compile_time_prng(seed, X + 1), cycles> x = 0;
+	obf_var<int32_t, obf_compile_time_prng(seed, Y + 1), cycles> y = 0;
+	obf_var<uint16_t, obf_compile_time_prng(seed, HEALTH + 1), cycles> health = 0;
+	obf_var<uint16_t, obf_compile_time_prng(seed, AMMO + 1), cycles> ammo = 0;
+	obf_var<uint8_t, obf_compile_time_prng(seed, LEVEL + 1), cycles> level = 0;
+	obf_var<uint32_t, obf_compile_time_prng(seed, COOLDOWN + 1), cycles> cooldown = 0;
+};
+
+static ObfBenchPlain obf_bench_value(size_t i) {
+	uint64_t r = (i + 1) * UINT64_C(0x9e3779b97f4a7c15);
+	return ObfBenchPlain{ int32_t(r), int32_t(r >> 32), uint16_t(r >> 8), uint16_t(r >> 24), uint8_t(r >> 40), uint32_t(r >> 17) };
+}
+
+struct ObfBenchResult {
+	double plain_ns = 0.;
+	double var_ns = 0.;
+	double get_ns = 0.;
+	double load_ns = 0.;
+	double var_set_ns = 0.;
+	double set_ns = 0.;
+	double vars_store_ns = 0.;
+	double store_ns = 0.;
+};
+
+template<OBFSEED seed, OBFCYCLES cycles>
+void obf_bench_one(ObfBenchResult& res) {
+	using Vars = ObfBenchVars<seed, cycles>;
+	using Record = obf_record<seed, cycles, int32_t, int32_t, uint16_t, uint16_t, uint8_t, uint32_t>;
+
+	std::vector<ObfBenchPlain> plain(obf_bench_size);
+	std::vector<Vars> vars(obf_bench_size);
+	std::vector<Record> recs(obf_bench_size);
+	for (size_t i = 0; i < obf_bench_size; ++i) {
+		ObfBenchPlain p = plain[i] = obf_bench_value(i);
+		vars[i].x = p.x; vars[i].y = p.y; vars[i].health = p.health; vars[i].ammo = p.ammo; vars[i].level = p.level; vars[i].cooldown = p.cooldown;
+		recs[i].store(p.x, p.y, p.health, p.ammo, p.level, p.cooldown);
+	}
+
+	res.plain_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		for (const ObfBenchPlain& p : plain)
+			acc += uint64_t(p.x) + uint64_t(p.y) + p.health + p.ammo + p.level + p.cooldown;
+		return acc;
+	});
+	res.var_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		for (const Vars& v : vars)
+			acc += uint64_t(v.x.value()) + uint64_t(v.y.value()) + v.health.value() + v.ammo.value() + v.level.value() + v.cooldown.value();
+		return acc;
+	});
+	res.get_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		for (const Record& r : recs)
+			acc += uint64_t(r.template get<X>()) + uint64_t(r.template get<Y>()) + r.template get<HEALTH>() + r.template get<AMMO>()
+				+ r.template get<LEVEL>() + r.template get<COOLDOWN>();
+		return acc;
+	});
+	res.load_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		for (const Record& r : recs) {
+			auto [x, y, health, ammo, level, cooldown] = r.load();
+			acc += uint64_t(x) + uint64_t(y) + health + ammo + level + cooldown;
+		}
+		return acc;
+	});
+	res.var_set_ns += obf_bench_ns([&] {
+		for (size_t i = 0; i < obf_bench_size; ++i)
+			vars[i].health = uint16_t(i);
+		return uint64_t(vars[obf_bench_size - 1].health.value());
+	});
+	res.set_ns += obf_bench_ns([&] {
+		for (size_t i = 0; i < obf_bench_size; ++i)
+			recs[i].template set<HEALTH>(uint16_t(i));
+		return uint64_t(recs[obf_bench_size - 1].template get<HEALTH>());
+	});
+	res.vars_store_ns += obf_bench_ns([&] {
+		for (size_t i = 0; i < obf_bench_size; ++i) {
+			ObfBenchPlain p = plain[i];
+			Vars& v = vars[i];
+			v.x = p.x; v.y = p.y; v.health = p.health; v.ammo = p.ammo; v.level = uint8_t(i); v.cooldown = p.cooldown;
+		}
+		return uint64_t(vars[obf_bench_size - 1].level.value());
+	});
+	res.store_ns += obf_bench_ns([&] {
+		for (size_t i = 0; i < obf_bench_size; ++i) {
+			ObfBenchPlain p = plain[i];
+			recs[i].store(p.x, p.y, p.health, p.ammo, uint8_t(i), p.cooldown);
+		}
+		return uint64_t(recs[obf_bench_size - 1].template get<LEVEL>());
+	});
+}
+
+template<int level, size_t... I>
+void obf_bench_row(std::index_sequence<I...>) {
+	ObfBenchResult res;
+	(obf_bench_one<obf_bench_seed(level, int(I)), obf_exp_cycles(level)>(res), ...);
+	double n = double(sizeof...(I));
+	printf("OBF%d %10.2f %10.2f %10.2f %10.2f %14.2f %10.2f %14.2f %10.2f\n", level,
+		res.plain_ns / n, res.var_ns / n, res.get_ns / n, res.load_ns / n, res.var_set_ns / n, res.set_ns / n,
+		res.vars_store_ns / n, res.store_ns / n);
+}
+
+template<int level>
+void obf_bench_row() {
+	obf_bench_row<level>(std::make_index_sequence<OBF_RECORD_BENCH_SEEDS>());
+}
+
+int main() {
+	printf("%zu records, %d seeds\n", obf_bench_size, OBF_RECORD_BENCH_SEEDS);
+	printf("%-4s %10s %10s %10s %10s %14s %10s %14s %10s\n", "ns", "plain", "obf_var", "get<I>()", "load()", "obf_var =", "set<I>()",
+		"obf_vars =", "store()");
+	obf_bench_row<2>();
+	obf_bench_row<3>();
+	obf_bench_row<4>();
+	return 0;
+}
@@ -0,0 +1,113 @@
+//vector_bench.cpp: obf_vector<> (column-wise encoded values) vs std::vector<obf_var<>> vs plain std::vector<>
+//Usage:
+//  compile in Release mode and run (round-trip checks of obf_vector<> are in ../checks/containers_check.cpp)
+//Prints nanoseconds per element for summing OBF_VECTOR_BENCH_SIZE elements, for several types and obfuscation levels,
+//  averaged over OBF_VECTOR_BENCH_SEEDS different seeds:
+//  plain - std::vector<T>; obf_var - value() in a loop over std::vector<obf_var<>>;
+//  get() - the same over obf_vector<>; load_range() - obf_vector<> decoded in chunks to a buffer, then summed
+//obf_vector<T,seed,cycles> and obf_var<T,seed,cycles> share the injection tree, so the difference is down to the layout only
+//  (both take sizeof(T) per element; obf_vector<> can be resized/zeroed in bulk, and keeps split halves in separate arrays)
+
+#include <vector>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x3f8e1a6c5d29b074)
+#endif
+#include "../common/obf_bench.h"
+
+#ifndef OBF_VECTOR_BENCH_SEEDS
+#define OBF_VECTOR_BENCH_SEEDS 8
+#endif
+#ifndef OBF_VECTOR_BENCH_SIZE
+#define OBF_VECTOR_BENCH_SIZE (1 << 20)
+#endif
+
+static constexpr size_t obf_bench_size = OBF_VECTOR_BENCH_SIZE;
+static constexpr size_t obf_bench_chunk = 256;
+static constexpr int obf_bench_repetitions = 5;
+
+template<class F>
+double obf_bench_ns(F f) {
+	return obf_bench_ns(obf_bench_repetitions, obf_bench_size, f);
+}
+
+template<class T>
+T obf_bench_value(size_t i) {
+	return T(i * UINT64_C(0x9e3779b97f4a7c15) >> 7);
+}
+
+struct ObfBenchResult {
+	double plain_ns = 0.;
+	double var_ns = 0.;
+	double get_ns = 0.;
+	double range_ns = 0.;
+};
+
+template<class T, OBFSEED seed, OBFCYCLES cycles>
+void obf_bench_one(ObfBenchResult& res) {
+	using Var = obf_var<T, seed, cycles>;
+	using Vector = obf_vector<T, seed, cycles>;
+	static_assert(sizeof(Var) == sizeof(T));
+
+	std::vector<T> plain(obf_bench_size);
+	for (size_t i = 0; i < obf_bench_size; ++i)
+		plain[i] = obf_bench_value<T>(i);
+	std::vector<Var> vars(plain.begin(), plain.end());
+	Vector vec(obf_bench_size);
+	vec.store_range(0, obf_bench_size, plain.data());
+
+	res.plain_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		for (size_t i = 0; i < obf_bench_size; ++i)
+			acc += plain[i];
+		return acc;
+	});
+	res.var_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		for (size_t i = 0; i < obf_bench_size; ++i)
+			acc += vars[i].value();
+		return acc;
+	});
+	res.get_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		for (size_t i = 0; i < obf_bench_size; ++i)
+			acc += vec.get(i);
+		return acc;
+	});
+	res.range_ns += obf_bench_ns([&] {
+		uint64_t acc = 0;
+		T chunk[obf_bench_chunk];
+		for (size_t i = 0; i < obf_bench_size; i += obf_bench_chunk) {
+			vec.load_range(i, obf_bench_chunk, chunk);
+			for (size_t j = 0; j < obf_bench_chunk; ++j)
+				acc += chunk[j];
+		}
+		return acc;
+	});
+}
+
+template<class T, int level, size_t... I>
+void obf_bench_row(const char* name, std::index_sequence<I...>) {
+	static_assert(obf_bench_size % obf_bench_chunk == 0);
+	ObfBenchResult res;
+	(obf_bench_one<T, obf_bench_seed(level, int(I), sizeof(T)), obf_exp_cycles(level)>(res), ...);
+	double n = double(sizeof...(I));
+	printf("%-10s OBF%d %10.2f %10.2f %10.2f %12.2f\n", name, level, res.plain_ns / n, res.var_ns / n, res.get_ns / n, res.range_ns / n);
+}
+
+template<class T, int level>
+void obf_bench_row(const char* name) {
+	obf_bench_row<T, level>(name, std::make_index_sequence<OBF_VECTOR_BENCH_SEEDS>());
+}
+
+int main() {
+	printf("%zu elements, %d seeds\n", obf_bench_size, OBF_VECTOR_BENCH_SEEDS);
+	printf("%-10s %4s %10s %10s %10s %12s\n", "ns/elem", "", "plain", "obf_var", "get()", "load_range()");
+	obf_bench_row<uint16_t, 2>("uint16_t");
+	obf_bench_row<uint16_t, 3>("uint16_t");
+	obf_bench_row<uint32_t, 2>("uint32_t");
+	obf_bench_row<uint32_t, 3>("uint32_t");
+	obf_bench_row<uint64_t, 2>("uint64_t");
+	obf_bench_row<uint64_t, 3>("uint64_t");
+	return 0;
+}
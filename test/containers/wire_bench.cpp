@@ -0,0 +1,155 @@
+//wire_bench.cpp: snapshot serialization of obf_var<>s/obf_record<>s via obf_wire_writer<>/obf_wire_reader<> vs decode-and-copy
+//Usage:
+//  compile in Release mode and run (round-trip and format checks of obf_wire_writer<>/obf_wire_reader<> are in ../checks/containers_check.cpp)
+//Prints nanoseconds per field for writing a snapshot of 1k and 100k fields into a byte buffer (and for reading it back),
+//  for several obfuscation levels of the fields, averaged over OBF_WIRE_BENCH_SEEDS different seeds:
+//  plain - value() of each field, written as a plain integer (i.e. no wire obfuscation; reading assigns plain integers back);
+//  staged - value()s decoded into a plain buffer first, then wire-encoded with the same OBF3W() as below
+//    (i.e. the decode-serialize-encode sequence we had before, with the plain values going through memory);
+//  wire - obf_wire_writer<OBF3W()>::write_n() / obf_wire_reader<>::read_n(), transcoding each field in registers
+//  "record" rows are obf_record<>s of 4 uint32_t fields, with the same number of fields in total
+
+#include <string.h>
+#include <vector>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x6e2b97d4c1a05f38)
+#endif
+#include "../common/obf_bench.h"
+
+#ifndef OBF_WIRE_BENCH_SEEDS
+#define OBF_WIRE_BENCH_SEEDS 4
+#endif
+
+using ObfBenchWire = obf_wire<obf_wire_seed(0x77697265), obf_exp_cycles(3)>;//what OBF3W(0x77697265) gives
+
+static constexpr int obf_bench_repetitions = 10;
+
+template<class F>
+double obf_bench_ns(size_t fields, F f) {
+	return obf_bench_ns(obf_bench_repetitions, fields, f);
+}
+
+static uint32_t obf_bench_value(size_t i) {
+	return uint32_t(i * UINT64_C(0x9e3779b97f4a7c15) >> 23);
+}
+
+struct ObfBenchResult {
+	double plain_w = 0., staged_w = 0., wire_w = 0.;
+	double plain_r = 0., staged_r = 0., wire_r = 0.;
+};
+
+template<class Item>
+Item obf_bench_zero() {//obf_var<> has no default constructor
+	if constexpr(Item::wire_size == sizeof(uint32_t))
+		return Item(0u);
+	else
+		return Item();
+}
+
+//Item is either obf_var<uint32_t> or obf_record<uint32_t x4>; fields - total number of uint32_t's
+template<class Item>
+void obf_bench_one(size_t fields, ObfBenchResult& res) {
+	constexpr size_t per_item = Item::wire_size / sizeof(uint32_t);
+	size_t n = fields / per_item;
+	std::vector<uint32_t> expected(fields);
+	for (size_t i = 0; i < fields; ++i)
+		expected[i] = obf_bench_value(i);
+	std::vector<Item> items(n, obf_bench_zero<Item>());
+	std::vector<Item> items2(n, obf_bench_zero<Item>());
+	for (size_t i = 0; i < n; ++i) {
+		if constexpr(per_item == 1)
+			items[i] = expected[i];
+		else
+			items[i].store(expected[4 * i], expected[4 * i + 1], expected[4 * i + 2], expected[4 * i + 3]);
+	}
+	auto decode = [](const Item& item, uint32_t* dst) {
+		if constexpr(per_item == 1)
+			dst[0] = item.value();
+		else
+			std::tie(dst[0], dst[1], dst[2], dst[3]) = item.load();
+	};
+	auto encode = [](Item& item, const uint32_t* src) {
+		if constexpr(per_item == 1)
+			item = src[0];
+		else
+			item.store(src[0], src[1], src[2], src[3]);
+	};
+
+	std::vector<uint8_t> buf;
+	buf.reserve(fields * sizeof(uint32_t));
+	std::vector<uint32_t> stage(fields);
+
+	res.plain_w += obf_bench_ns(fields, [&] {
+		buf.clear();
+		buf.resize(fields * sizeof(uint32_t));
+		uint32_t v[per_item];
+		for (size_t i = 0; i < n; ++i) {
+			decode(items[i], v);
+			memcpy(buf.data() + i * sizeof(v), v, sizeof(v));
+		}
+		return uint64_t(buf[fields]);
+	});
+	res.plain_r += obf_bench_ns(fields, [&] {
+		uint32_t v[per_item];
+		for (size_t i = 0; i < n; ++i) {
+			memcpy(v, buf.data() + i * sizeof(v), sizeof(v));
+			encode(items2[i], v);
+		}
+		return uint64_t(n);
+	});
+
+	res.staged_w += obf_bench_ns(fields, [&] {
+		for (size_t i = 0; i < n; ++i)
+			decode(items[i], &stage[per_item * i]);
+		buf.clear();
+		obf_wire_writer<ObfBenchWire>(buf).write_n(stage.data(), fields);
+		return uint64_t(buf[fields]);
+	});
+	res.staged_r += obf_bench_ns(fields, [&] {
+		obf_wire_reader<ObfBenchWire>(buf).read_n(stage.data(), fields);
+		for (size_t i = 0; i < n; ++i)
+			encode(items2[i], &stage[per_item * i]);
+		return uint64_t(n);
+	});
+
+	res.wire_w += obf_bench_ns(fields, [&] {
+		buf.clear();
+		obf_wire_writer<ObfBenchWire>(buf).write_n(items.data(), n);
+		return uint64_t(buf[fields]);
+	});
+	res.wire_r += obf_bench_ns(fields, [&] {
+		obf_wire_reader<ObfBenchWire>(buf).read_n(items2.data(), n);
+		return uint64_t(n);
+	});
+}
+
+template<template<OBFSEED, OBFCYCLES> class Item, int level, size_t... I>
+void obf_bench_row(const char* name, size_t fields, std::index_sequence<I...>) {
+	ObfBenchResult res;
+	(obf_bench_one<Item<obf_bench_seed(level, int(I)), obf_exp_cycles(level)>>(fields, res), ...);
+	double n = double(sizeof...(I));
+	printf("%-8s %7zu OBF%d %8.2f %8.2f %8.2f %10.2f %8.2f %8.2f\n", name, fields, level,
+		res.plain_w / n, res.staged_w / n, res.wire_w / n, res.plain_r / n, res.staged_r / n, res.wire_r / n);
+}
+
+template<OBFSEED seed, OBFCYCLES cycles>
+using ObfBenchVar = obf_var<uint32_t, seed, cycles>;
+template<OBFSEED seed, OBFCYCLES cycles>
+using ObfBenchRecord = obf_record<seed, cycles, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+template<template<OBFSEED, OBFCYCLES> class Item, int level>
+void obf_bench_rows(const char* name) {
+	obf_bench_row<Item, level>(name, 1000, std::make_index_sequence<OBF_WIRE_BENCH_SEEDS>());
+	obf_bench_row<Item, level>(name, 100000, std::make_index_sequence<OBF_WIRE_BENCH_SEEDS>());
+}
+
+int main() {
+	printf("%d seeds, wire: OBF3W()\n", OBF_WIRE_BENCH_SEEDS);
+	printf("%-8s %7s %4s %8s %8s %8s %10s %8s %8s\n", "ns/field", "fields", "", "plain:w", "staged:w", "wire:w", "plain:r", "staged:r", "wire:r");
+	obf_bench_rows<ObfBenchVar, 2>("obf_var");
+	obf_bench_rows<ObfBenchVar, 3>("obf_var");
+	obf_bench_rows<ObfBenchVar, 4>("obf_var");
+	obf_bench_rows<ObfBenchRecord, 3>("record");
+	return 0;
+}
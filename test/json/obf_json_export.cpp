@@ -0,0 +1,43 @@
+//obf_json_export.cpp: injection trees of a few sites as JSON (see dbgJson() and obf_json<>() in obfuscate.h),
+//  taken from compile-time strings - i.e. without running any of the obfuscated code
+//Usage:
+//  make -C test/Linux json [OBF_SEED=0x<64-bit-seed>]
+//    writes build/obf_trees.json; diff it between two seeds (or two compilers/cost tables) to see what has changed
+//  for an app, the same can be done from a separate TU, which names the types of the sites (with the same ITHARE_OBF_SEED)
+//Prints {"seed":...,"sites":[...]}, where each site is a tree with "total" resources (loads, calls, global and thread_local state)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string_view>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x2d7c91e4a06b3f58)
+#endif
+#define ITHARE_OBF_ENABLE_DBGPRINT
+#include "../../src/obfuscate.h"
+
+using namespace ithare::obf;
+
+template<int n>
+static constexpr OBFSEED obf_export_seed = obf_compile_time_prng(ITHARE_OBF_SEED ^ UINT64_C(0x9b05688c2b3e6c1f), n);
+
+template<class Site>
+void obf_export_site(const char* name, bool first) {
+	constexpr std::string_view json = obf_json<Site>();
+	static_assert(json.front() == '{' && json.back() == '}');
+	printf("%s{\"name\":\"%s\",\"tree\":%.*s}", first ? "\n" : ",\n", name, int(json.size()), json.data());
+}
+
+int main() {
+	printf("{\"seed\":\"0x%016llx\",\"sites\":[", (unsigned long long)(ITHARE_OBF_SEED));
+	obf_export_site<obf_var<uint32_t, obf_export_seed<1>, obf_exp_cycles(2)>>("obf_var<uint32_t>/OBF2", true);
+	obf_export_site<obf_var<uint64_t, obf_export_seed<2>, obf_exp_cycles(4)>>("obf_var<uint64_t>/OBF4", false);
+	obf_export_site<obf_literal<uint32_t, 0x1234567, obf_export_seed<3>, obf_exp_cycles(3)>>("obf_literal<uint32_t>/OBF3", false);
+	obf_export_site<obf_array<uint8_t, 64, obf_export_seed<4>, obf_exp_cycles(3)>>("obf_array<uint8_t,64>/OBF3", false);
+	obf_export_site<obf_vector<uint64_t, obf_export_seed<6>, obf_exp_cycles(3)>>("obf_vector<uint64_t>/OBF3", false);
+	obf_export_site<obf_unordered_map<uint32_t, uint16_t, obf_export_seed<7>, obf_exp_cycles(3), true>>("obf_unordered_map<uint32_t,uint16_t,true>/OBF3", false);
+	obf_export_site<obf_record<obf_export_seed<8>, obf_exp_cycles(3), int32_t, uint16_t, uint8_t>>("obf_record<int32_t,uint16_t,uint8_t>/OBF3", false);
+	obf_export_site<obf_str_literal<obf_export_seed<5>, obf_exp_cycles(3), 'j', 's', 'o', 'n', '\0'>>("obf_str_literal/OBF3", false);
+	printf("\n]}\n");
+	return 0;
+}
@@ -0,0 +1,89 @@
+//literal_context_mt_bench.cpp: multithreaded scaling benchmark for literal contexts with run-time state
+//  (ObfLiteralContext_version<4> - global var-with-invariant, vs thread_local ones: ObfLiteralContext_version<5>,
+//  and division-free ObfLiteralContext_version<6..8>)
+//Usage:
+//  compile in Release mode, with and without -DITHARE_OBF_STRICT_MT, and run on a box with as many cores as you care about
+//  (on an N-core box, the numbers for more than N threads show time-slicing rather than scaling)
+//Prints nanoseconds per final_surjection() call, as seen by each of the threads which are running it concurrently;
+//  for a context which scales, it stays flat regardless of the number of threads,
+//  for a context which bounces one cache line between the cores, it grows with the number of threads
+//  version 1 (global volatile constant, read-only) is given for reference
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x71c3a94e05bd28f6)
+#endif
+#include "../../src/obfuscate.h"
+
+#ifndef OBF_MT_BENCH_MAX_THREADS
+#define OBF_MT_BENCH_MAX_THREADS 16
+#endif
+
+using namespace ithare::obf;
+
+static constexpr size_t obf_bench_iterations = 2000000;
+static constexpr int obf_bench_repetitions = 3;
+static constexpr OBFSEED obf_bench_seed = obf_compile_time_prng(ITHARE_OBF_SEED, 1);
+
+static volatile uint32_t obf_bench_sink;
+
+template<class Context>
+void obf_bench_thread(const std::atomic<bool>* go) {
+	while (!go->load(std::memory_order_acquire))
+		;
+	uint32_t x = 0;
+	for (size_t i = 0; i < obf_bench_iterations; ++i)
+		x = Context::final_surjection(x + uint32_t(i));
+	obf_bench_sink = x;
+}
+
+template<class Context>
+double obf_bench_ns(int nThreads) {
+	double best = 1e30;
+	for (int rep = 0; rep < obf_bench_repetitions; ++rep) {
+		std::atomic<bool> go(false);
+		std::vector<std::thread> threads;
+		for (int i = 0; i < nThreads; ++i)
+			threads.emplace_back(obf_bench_thread<Context>, &go);
+		auto t0 = std::chrono::steady_clock::now();
+		go.store(true, std::memory_order_release);
+		for (auto& t : threads)
+			t.join();
+		auto t1 = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(obf_bench_iterations));
+	}
+	return best;
+}
+
+int main() {
+#ifdef ITHARE_OBF_STRICT_MT
+	printf("mode: ITHARE_OBF_STRICT_MT\n");
+#else
+	printf("mode: non-strict MT\n");
+#endif
+	printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	using V1 = ObfLiteralContext_version<1, uint32_t, obf_bench_seed>;
+	using V4 = ObfLiteralContext_version<4, uint32_t, obf_bench_seed>;
+#ifndef ITHARE_OBF_NO_THREAD_LOCAL
+	using V5 = ObfLiteralContext_version<5, uint32_t, obf_bench_seed>;
+#endif
+	using V6 = ObfLiteralContext_version<6, uint32_t, obf_bench_seed>;
+	using V7 = ObfLiteralContext_version<7, uint32_t, obf_bench_seed>;
+	using V8 = ObfLiteralContext_version<8, uint32_t, obf_bench_seed>;
+	for (int n = 1; n <= OBF_MT_BENCH_MAX_THREADS; n *= 2) {
+		printf("%2d thread(s): version 1 (global volatile) %.2f ns, version 4 (global var-with-invariant) %.2f ns", n, obf_bench_ns<V1>(n), obf_bench_ns<V4>(n));
+#ifndef ITHARE_OBF_NO_THREAD_LOCAL
+		printf(", version 5 (thread_local var-with-invariant) %.2f ns", obf_bench_ns<V5>(n));
+#endif
+		printf(", versions 6/7/8 (division-free var-with-invariant) %.2f/%.2f/%.2f ns", obf_bench_ns<V6>(n), obf_bench_ns<V7>(n), obf_bench_ns<V8>(n));
+		printf("\n");
+	}
+	return 0;
+}
@@ -0,0 +1,102 @@
+//profile_bench.cpp: profile-guided per-site cycles (see ITHARE_OBF_PROFILE_HEADER in obfuscate.h) on a workload with one hot and a few cold sites
+//Usage:
+//  make -C test/Linux profile [PROFILE_OVERHEAD=100]
+//    builds and runs a training build (which writes build/obf_profile.h), then builds a profiled one,
+//    and prints the same numbers for unprofiled and profiled builds
+//Prints effective cycles of each site (obf_site_cycles()), and nanoseconds per workload() call,
+//  for OBF_PROFILE_BENCH_SEEDS copies of the workload with different seeds, and their mean
+//  with PROFILE_OVERHEAD=100, the hot site is expected to go down, and cold ones - up, with about the same mean time per call;
+//  with PROFILE_OVERHEAD below 100, mean time per call is expected to go down too
+//  a single seed says little: the tree of the hot site at its profiled cycles is a different random tree,
+//  which can easily be slower than the unprofiled one
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x5be0cd19137e2179)
+#endif
+#include "../../src/obfuscate.h"
+
+using namespace ithare::obf;
+
+#ifndef OBF_PROFILE_BENCH_SEEDS
+#define OBF_PROFILE_BENCH_SEEDS 32
+#endif
+
+static constexpr int obf_bench_calls = 5000;
+static constexpr int obf_bench_repetitions = 5;
+static constexpr size_t obf_bench_data_size = 256;
+static constexpr OBFCYCLES obf_bench_cycles = obf_exp_cycles(4);
+
+//explicit seeds (rather than OBF4() ones), so that main() can print obf_site_cycles() for them
+template<int n>
+static constexpr OBFSEED obf_bench_seed = obf_compile_time_prng(ITHARE_OBF_SEED ^ UINT64_C(0x510e527fade682d1), n);
+template<int n>
+using obf_bench_var = obf_var<uint32_t, obf_bench_seed<n>, obf_bench_cycles>;
+
+static uint8_t obf_bench_data[obf_bench_data_size];
+static volatile uint32_t obf_bench_sink;
+
+//copy #k of the workload has sites 4k+1 (cold) ... 4k+4 (hot)
+template<int k>
+ITHARE_OBF_NOINLINE uint32_t workload(uint32_t key) {
+	//cold: once per call
+	obf_bench_var<4 * k + 1> kk = key;
+	obf_bench_var<4 * k + 2> mask = kk ^ 0x9e3779b9;
+	obf_bench_var<4 * k + 3> rounds = (mask & 3) + 1;
+	//hot: once per byte
+	uint32_t ret = 0;
+	for (uint32_t r = 0; r < rounds; ++r) {
+		for (size_t i = 0; i < obf_bench_data_size; ++i) {
+			obf_bench_var<4 * k + 4> acc = ret * 31 + obf_bench_data[i];
+			ret = acc;
+		}
+	}
+	return ret ^ mask;
+}
+
+template<int k>
+double obf_bench_workload() {
+	printf("seed #%d: cold sites: cycles %d/%d/%d (nominal %d), hot site: cycles %d (nominal %d): ", k,
+		int(obf_site_cycles(obf_bench_seed<4 * k + 1>, obf_bench_cycles)), int(obf_site_cycles(obf_bench_seed<4 * k + 2>, obf_bench_cycles)),
+		int(obf_site_cycles(obf_bench_seed<4 * k + 3>, obf_bench_cycles)), int(obf_bench_cycles),
+		int(obf_site_cycles(obf_bench_seed<4 * k + 4>, obf_bench_cycles)), int(obf_bench_cycles));
+
+	double best = 1e30;
+	uint32_t total = 0;
+	for (int rep = 0; rep < obf_bench_repetitions; ++rep) {
+		total = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < obf_bench_calls; ++i)
+			total += workload<k>(uint32_t(i));
+		auto t1 = std::chrono::steady_clock::now();
+		obf_bench_sink = total;
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(obf_bench_calls));
+	}
+	printf("workload(): %.1f ns/call (checksum %u)\n", best, unsigned(total));
+	return best;
+}
+
+template<size_t... K>
+double obf_bench_workloads(std::index_sequence<K...>) {
+	return (obf_bench_workload<int(K)>() + ...) / double(sizeof...(K));
+}
+
+int main() {
+	for (size_t i = 0; i < obf_bench_data_size; ++i)
+		obf_bench_data[i] = uint8_t(i * 7 + 3);
+#if defined(ITHARE_OBF_PROFILE_TRAINING)
+	printf("training build (overhead target %d%%, profile goes to %s)\n", int(ITHARE_OBF_PROFILE_OVERHEAD_PERCENT), ITHARE_OBF_PROFILE_OUTPUT);
+#elif defined(ITHARE_OBF_PROFILE_HEADER)
+	printf("profiled build\n");
+#else
+	printf("unprofiled build\n");
+#endif
+	double mean = obf_bench_workloads(std::make_index_sequence<OBF_PROFILE_BENCH_SEEDS>());
+	printf("mean over %d seeds: %.1f ns/call\n", OBF_PROFILE_BENCH_SEEDS, mean);
+	return 0;
+}
@@ -0,0 +1,330 @@
+//seed_sweep.cpp: round-trip checks and run-time costs of the trees generated for one ITHARE_OBF_SEED
+//  for each of uint8_t..uint64_t and OBF levels 0..OBF_SWEEP_MAX_LEVEL:
+//    inj     - obf_root_injection<> over ObfZeroLiteralContext: surjection(injection(x))==x
+//    var     - obf_root_injection<> over ObfVarContext (i.e. the one of obf_var<>), same check, plus obf_var<> itself
+//    literal - obf_literal<>: value()==C for edge and random constants
+//    str     - obf_str_literal<>: value() and value_buf() vs plain strings of lengths around SIMD block boundaries
+//    flat    - obf_flat_injection<> vs obf_injection<> (whichever of them is obf_root_injection<>) over var, literal and zero-literal
+//              contexts: injection(x) has to be the same bit-for-bit (and both have to round-trip)
+//    array   - obf_array<>'s SSE2 and AVX2 (where the CPU has it) range kernels vs its scalar one, bit-for-bit both ways
+//  round-trip inputs are edge values (0, 1, all-ones, single bits, ...) plus OBF_SWEEP_RANDOM_INPUTS random ones
+//Usage:
+//  normally run via seed_sweep.py (see there), which builds it for many seeds and flags outliers;
+//  standalone: compile with -DITHARE_OBF_SEED=UINT64_C(<seed>) [-DOBF_SWEEP_MAX_LEVEL=<0..6>], and run
+//Prints one line per kind/type/level: declared cycles, ns of injection and surjection (net of an identity loop), checks, fails;
+//  exit code is 1 if any of the checks has failed
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x71c4e2a95b3d8f06)
+#endif
+#include "../../src/obfuscate.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define OBF_SWEEP_HAS_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define OBF_SWEEP_HAS_TSC
+#endif
+
+#ifndef OBF_SWEEP_MAX_LEVEL
+#define OBF_SWEEP_MAX_LEVEL 5
+#endif
+#ifndef OBF_SWEEP_RANDOM_INPUTS
+#define OBF_SWEEP_RANDOM_INPUTS 1000
+#endif
+
+using namespace ithare::obf;
+
+static constexpr size_t obf_sweep_iterations = 100000;
+static constexpr int obf_sweep_repetitions = 5;
+
+static size_t obf_sweep_total_fails = 0;
+
+template<int n>
+static constexpr OBFSEED obf_sweep_seed = obf_compile_time_prng(ITHARE_OBF_SEED ^ UINT64_C(0x5bd1e9955bd1e995), n);
+
+//run-time inputs: not tied to ITHARE_OBF_SEED on purpose (otherwise two seeds which generate the same tree would be tested the same way)
+static uint64_t obf_sweep_rng_state = UINT64_C(0x9e3779b97f4a7c15);
+static uint64_t obf_sweep_rng() {//splitmix64
+	uint64_t z = (obf_sweep_rng_state += UINT64_C(0x9e3779b97f4a7c15));
+	z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+	return z ^ (z >> 31);
+}
+
+template<class T>
+constexpr T obf_sweep_edge(size_t i) {//0, 1, 2, max, max-1, max/2, max/2+1, 0x55.., 0xaa.., then single bits
+	constexpr T mx = std::numeric_limits<T>::max();
+	constexpr T edges[] = { T(0), T(1), T(2), mx, T(mx - 1), T(mx / 2), T(mx / 2 + 1), T(UINT64_C(0x5555555555555555)), T(UINT64_C(0xaaaaaaaaaaaaaaaa)) };
+	constexpr size_t n = sizeof(edges) / sizeof(edges[0]);
+	return i < n ? edges[i] : T(T(1) << ((i - n) % (sizeof(T) * 8)));
+}
+template<class T>
+constexpr size_t obf_sweep_n_edges = 9 + sizeof(T) * 8;
+
+template<class T, class F>
+size_t obf_sweep_check_all(F check) {//returns number of failed checks
+	size_t fails = 0;
+	for (size_t i = 0; i < obf_sweep_n_edges<T>; ++i)
+		fails += !check(obf_sweep_edge<T>(i));
+	for (size_t i = 0; i < OBF_SWEEP_RANDOM_INPUTS; ++i)
+		fails += !check(T(obf_sweep_rng()));
+	return fails;
+}
+
+//latency of x=f(x), same as in obf_calibrate.cpp (but in nanoseconds)
+template<class T, class F>
+double obf_sweep_ns(F f) {
+	volatile T x = T(UINT64_C(0x5a3c96e1d2b4f087));
+	double best = 1e30;
+	for (int rep = 0; rep < obf_sweep_repetitions; ++rep) {
+		auto t0 = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < obf_sweep_iterations; ++i)
+			x = f(x);
+		auto t1 = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(obf_sweep_iterations));
+	}
+	return best;
+}
+template<class T>
+double obf_sweep_baseline() {
+	static double ret = obf_sweep_ns<T>([](T x) { return x; });
+	return ret;
+}
+static double obf_sweep_net(double ns, double baseline) {
+	return std::max(ns - baseline, 0.);
+}
+
+static double obf_sweep_tsc_per_ns() {//0 if unknown
+#ifdef OBF_SWEEP_HAS_TSC
+	auto t0 = std::chrono::steady_clock::now();
+	uint64_t c0 = __rdtsc();
+	while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(50))
+		;
+	uint64_t c1 = __rdtsc();
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+	return double(c1 - c0) / ns;
+#else
+	return 0;
+#endif
+}
+
+struct obf_sweep_ns_str {//"-" for negative (=not measured)
+	char s[32] = "-";
+	obf_sweep_ns_str(double ns) {
+		if (ns >= 0)
+			snprintf(s, sizeof(s), "%.2f", ns);
+	}
+};
+static void obf_sweep_print(const char* kind, const char* type, int level, OBFCYCLES budget, double inj, double surj, size_t checks, size_t fails) {
+	printf("%-8s %-9s %5d %8d %9s %9s %7d %6d\n", kind, type, level, int(budget), obf_sweep_ns_str(inj).s, obf_sweep_ns_str(surj).s, int(checks), int(fails));
+	obf_sweep_total_fails += fails;
+}
+
+template<class T>
+const char* obf_sweep_type_name() {
+	return sizeof(T) == 1 ? "uint8_t" : sizeof(T) == 2 ? "uint16_t" : sizeof(T) == 4 ? "uint32_t" : "uint64_t";
+}
+
+template<class T, class Injection>
+void obf_sweep_injection(const char* kind, int level, OBFCYCLES budget) {
+	using RT = typename Injection::return_type;
+	size_t fails = obf_sweep_check_all<T>([](T x) { return Injection::surjection(Injection::injection(x)) == x; });
+	double inj = obf_sweep_net(obf_sweep_ns<T>([](T x) { return T(RT(Injection::injection(x))); }), obf_sweep_baseline<T>());
+	double surj = obf_sweep_net(obf_sweep_ns<T>([](T y) { return T(Injection::surjection(RT(y))); }), obf_sweep_baseline<T>());
+	obf_sweep_print(kind, obf_sweep_type_name<T>(), level, budget, inj, surj, obf_sweep_n_edges<T> + OBF_SWEEP_RANDOM_INPUTS, fails);
+}
+
+template<class T, int level>
+void obf_sweep_var() {
+	constexpr OBFCYCLES cycles = obf_exp_cycles(level);
+	constexpr OBFSEED seed = obf_sweep_seed<level * 8 + int(sizeof(T))>;
+	//same Context/Injection as obf_var<T,seed,cycles> (w/o profile-guided site_cycles)
+	using Injection = obf_root_injection<T, ObfVarContext<T, obf_compile_time_prng(seed, 1), cycles>, obf_compile_time_prng(seed, 2), cycles, ObfDefaultInjectionContext>;
+	obf_sweep_injection<T, Injection>("var", level, cycles);
+
+	size_t fails = obf_sweep_check_all<T>([](T x) {
+		obf_var<T, seed, cycles> v(x);
+		if (v.value() != x)
+			return false;
+		v += 1;
+		return v.value() == T(x + 1);
+	});
+	obf_sweep_print("obf_var", obf_sweep_type_name<T>(), level, cycles, -1, -1, obf_sweep_n_edges<T> + OBF_SWEEP_RANDOM_INPUTS, fails);
+}
+
+template<class T, class Context, OBFSEED seed, OBFCYCLES cycles>
+size_t obf_sweep_flat_fails() {
+	using Tree = obf_injection<T, Context, seed, cycles, ObfDefaultInjectionContext>;
+	using Flat = obf_flat_injection<T, Context, seed, cycles, ObfDefaultInjectionContext>;
+	return obf_sweep_check_all<T>([](T x) {
+		T tree = T(typename Tree::return_type(Tree::injection(x)));
+		T flat = T(typename Flat::return_type(Flat::injection(x)));
+		return tree == flat && Tree::surjection(typename Tree::return_type(tree)) == x && Flat::surjection(typename Flat::return_type(flat)) == x;
+	});
+}
+
+template<class T, int level>
+void obf_sweep_flat() {
+	constexpr OBFCYCLES cycles = obf_exp_cycles(level);
+	constexpr OBFSEED seed = obf_sweep_seed<192 + level * 8 + int(sizeof(T))>;
+	size_t fails = obf_sweep_flat_fails<T, ObfVarContext<T, obf_compile_time_prng(seed, 1), cycles>, obf_compile_time_prng(seed, 2), cycles>()
+		+ obf_sweep_flat_fails<T, ObfLiteralContext<T, obf_compile_time_prng(seed, 3), cycles>, obf_compile_time_prng(seed, 4), cycles>()
+		+ obf_sweep_flat_fails<T, ObfZeroLiteralContext<T>, obf_compile_time_prng(seed, 5), cycles>();
+	obf_sweep_print("flat", obf_sweep_type_name<T>(), level, cycles, -1, -1, 3 * (obf_sweep_n_edges<T> + OBF_SWEEP_RANDOM_INPUTS), fails);
+}
+
+//range kernels of obf_array<>: encoded values, and values decoded by the path under test from the scalar-encoded ones,
+//  have to be the same as with the scalar path (counts are not multiples of SIMD lanes, so scalar tails are covered too)
+template<class T, class Kernel, class F>
+size_t obf_sweep_array_path_fails(const std::vector<T>& src, const std::vector<typename Kernel::Scalar::return_type>& encoded, F path) {
+	std::vector<typename Kernel::Scalar::return_type> enc(src.size());
+	std::vector<T> dec(src.size());
+	path(src.data(), enc.data(), dec.data(), src.size());
+	size_t fails = 0;
+	for (size_t i = 0; i < src.size(); ++i)
+		fails += size_t(enc[i] != encoded[i]) + size_t(dec[i] != src[i]);
+	return fails;
+}
+
+template<class T, int level>
+void obf_sweep_array() {
+	constexpr OBFCYCLES cycles = obf_exp_cycles(level);
+	using Kernel = typename obf_array<T, 1, obf_sweep_seed<256 + level * 8 + int(sizeof(T))>, cycles>::kernel_type;
+	using E = typename Kernel::Scalar::return_type;
+	std::vector<T> src;
+	obf_sweep_check_all<T>([&src](T x) { src.push_back(x); return true; });
+	std::vector<E> encoded(src.size());
+	std::vector<T> decoded(src.size());
+	Kernel::injection_range_scalar(src.data(), encoded.data(), src.size());
+	Kernel::surjection_range_scalar(encoded.data(), decoded.data(), src.size());
+	size_t fails = 0, checks = src.size();
+	for (size_t i = 0; i < src.size(); ++i)
+		fails += size_t(decoded[i] != src[i]);
+#ifdef ITHARE_OBF_SIMD
+	const E* enc = encoded.data();
+	fails += obf_sweep_array_path_fails<T, Kernel>(src, encoded, [enc](const T* s, E* e, T* d, size_t n) {
+		Kernel::injection_range_sse2(s, e, n);
+		Kernel::surjection_range_sse2(enc, d, n);
+	});
+	checks += 2 * src.size();
+#ifndef ITHARE_OBF_NO_AVX2
+	if (obf_cpu_has_avx2()) {
+		fails += obf_sweep_array_path_fails<T, Kernel>(src, encoded, [enc](const T* s, E* e, T* d, size_t n) {
+			Kernel::injection_range_avx2(s, e, n);
+			Kernel::surjection_range_avx2(enc, d, n);
+		});
+		checks += 2 * src.size();
+	}
+#endif
+#endif
+	obf_sweep_print("array", obf_sweep_type_name<T>(), level, cycles, -1, -1, checks, fails);
+}
+
+template<class T, int level>
+void obf_sweep_inj() {
+	constexpr OBFCYCLES cycles = obf_exp_cycles(level);
+	using Injection = obf_root_injection<T, ObfZeroLiteralContext<T>, obf_sweep_seed<64 + level * 8 + int(sizeof(T))>, cycles, ObfDefaultInjectionContext>;
+	obf_sweep_injection<T, Injection>("inj", level, cycles);
+}
+
+//literals: edge constants #0..4 (0, 1, 2, max, max-1), and two random ones
+static constexpr size_t obf_sweep_n_literals = 7;
+template<class T, size_t i>
+constexpr T obf_sweep_literal_value() {
+	return i < 5 ? obf_sweep_edge<T>(i) : T(obf_compile_time_prng(ITHARE_OBF_SEED, 1000 + int(i)));
+}
+template<class T, int level, size_t i>
+using obf_sweep_literal = obf_literal<T, obf_sweep_literal_value<T, i>(), obf_sweep_seed<128 + level * 64 + int(sizeof(T)) * 8 + int(i)>, obf_exp_cycles(level)>;
+
+template<class T, int level, size_t... I>
+void obf_sweep_literals(std::index_sequence<I...>) {
+	size_t fails = (0 + ... + size_t(obf_sweep_literal<T, level, I>().value() != obf_sweep_literal_value<T, I>()));
+	//x+C instead of x^C: the same constant twice would cancel out
+	double surj = (0. + ... + obf_sweep_net(obf_sweep_ns<T>([](T x) { return T(x + obf_sweep_literal<T, level, I>().value()); }), obf_sweep_baseline<T>()));
+	obf_sweep_print("literal", obf_sweep_type_name<T>(), level, obf_exp_cycles(level), -1, surj / double(sizeof...(I)), sizeof...(I), fails);
+}
+
+//strings: 1, 3, 15, 16, 17, 31, 32 chars (SIMD blocks are 16 and 32 bytes; empty strings are not supported), incl. non-ASCII bytes
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_sweep_str1 = ITHARE_OBFS_HELPER(seed, cycles, "\xff");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_sweep_str3 = ITHARE_OBFS_HELPER(seed, cycles, "a\x80z");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_sweep_str15 = ITHARE_OBFS_HELPER(seed, cycles, "0123456789abcde");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_sweep_str16 = ITHARE_OBFS_HELPER(seed, cycles, "\x01\x80\x7f\xfe" "456789abcdef");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_sweep_str17 = ITHARE_OBFS_HELPER(seed, cycles, "0123456789abcdefg");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_sweep_str31 = ITHARE_OBFS_HELPER(seed, cycles, "0123456789abcdefghijklmnopqrstu");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_sweep_str32 = ITHARE_OBFS_HELPER(seed, cycles, "0123456789abcdefghijklmnopqrst\xff\x01");
+
+template<template<OBFSEED, OBFCYCLES> class S, int level, int n>
+size_t obf_sweep_str_fails(const char* expected) {
+	using Str = S<obf_sweep_seed<1024 + level * 16 + n>, obf_exp_cycles(level)>;
+	std::string s = Str().value();
+	auto buf = Str().value_buf();
+	std::string_view sv(buf);
+	return size_t(s != expected) + size_t(sv != std::string_view(expected));
+}
+
+static volatile size_t obf_sweep_sink;
+template<int level>
+void obf_sweep_strs() {
+	size_t fails = obf_sweep_str_fails<obf_sweep_str1, level, 1>("\xff") + obf_sweep_str_fails<obf_sweep_str3, level, 3>("a\x80z")
+		+ obf_sweep_str_fails<obf_sweep_str15, level, 15>("0123456789abcde") + obf_sweep_str_fails<obf_sweep_str16, level, 16>("\x01\x80\x7f\xfe" "456789abcdef")
+		+ obf_sweep_str_fails<obf_sweep_str17, level, 17>("0123456789abcdefg") + obf_sweep_str_fails<obf_sweep_str31, level, 31>("0123456789abcdefghijklmnopqrstu")
+		+ obf_sweep_str_fails<obf_sweep_str32, level, 32>("0123456789abcdefghijklmnopqrst\xff\x01");
+	//decoding cost: value_buf() of the 32-char string (value() would be dominated by allocation)
+	using Str = obf_sweep_str32<obf_sweep_seed<1024 + level * 16 + 32>, obf_exp_cycles(level)>;
+	double best = 1e30;
+	for (int rep = 0; rep < obf_sweep_repetitions; ++rep) {
+		size_t acc = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < obf_sweep_iterations; ++i) {
+			auto buf = Str().value_buf();
+			std::string_view sv(buf);
+			acc += size_t(sv[i % sv.size()]);
+		}
+		auto t1 = std::chrono::steady_clock::now();
+		obf_sweep_sink = acc;
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(obf_sweep_iterations));
+	}
+	obf_sweep_print("str", "char[32]", level, obf_exp_cycles(level), -1, best, 14, fails);
+}
+
+template<class T, int level>
+void obf_sweep_type() {
+	obf_sweep_inj<T, level>();
+	obf_sweep_var<T, level>();
+	obf_sweep_literals<T, level>(std::make_index_sequence<obf_sweep_n_literals>());
+	obf_sweep_flat<T, level>();
+	obf_sweep_array<T, level>();
+}
+
+template<int... Levels>
+void obf_sweep_levels(std::integer_sequence<int, Levels...>) {
+	((obf_sweep_type<uint8_t, Levels>(), obf_sweep_type<uint16_t, Levels>(), obf_sweep_type<uint32_t, Levels>(), obf_sweep_type<uint64_t, Levels>(), obf_sweep_strs<Levels>()), ...);
+}
+
+int main() {
+	printf("#seed 0x%016llx tsc_per_ns %.3f\n", (unsigned long long)(ITHARE_OBF_SEED), obf_sweep_tsc_per_ns());
+	printf("#kind    type      level   budget    inj_ns   surj_ns  checks  fails\n");
+	obf_sweep_levels(std::make_integer_sequence<int, OBF_SWEEP_MAX_LEVEL + 1>());
+	printf("#total_fails %d\n", int(obf_sweep_total_fails));
+	return obf_sweep_total_fails ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+# seed_sweep.py: builds and runs seed_sweep.cpp for many ITHARE_OBF_SEEDs, to catch seeds which generate broken or pathological trees
+#   (trees depend on the seed, so a seed which builds and runs fine today, tells nothing about the next one)
+# Usage: python3 seed_sweep.py [--cxx g++] [--flags "..."] [--seeds 8] [--base-seed 0x...] [--seed 0x... [--seed ...]] [--max-level 4]
+#                              [--jobs N] [--runs 3] [--out dir] [--json results.json]
+#                              [--budget-factor 4] [--budget-slack 20] [--outlier-factor 3] [--outlier-slack 3]
+#   seeds are --seed ones if any, otherwise --seeds of them derived from --base-seed (so that a run can be reproduced)
+#   a seed is flagged as:
+#     BUILD   - if seed_sweep.cpp doesn't compile with it
+#     FAIL    - if any of the round-trip checks fails (or the program crashes)
+#     BUDGET  - if run-time cost of a tree exceeds --budget-factor times its declared cycles plus --budget-slack
+#               (costs are measured in ns and converted to TSC ticks; skipped where TSC is not available, and for strings)
+#     OUTLIER - if the cost exceeds --outlier-factor times the median over all the seeds, plus the declared cycles
+#               (converted to ns) or --outlier-slack ns, whichever is more; needs 3+ seeds
+#               (i.e. being 10x slower than the median is fine as long as it is well within the budget - which is common
+#               at low levels, where most of the trees are folded by the compiler into next to nothing)
+#   the cost is surjection for inj/literal/str, and injection+surjection for var (same as calc_cycles() of their contexts);
+#     flat (tree vs flat engine) and array (SIMD vs scalar kernels) rows are bit-for-bit checks only
+#   exit code is 1 if any seed was flagged
+#   each binary is run --runs times, taking the fastest time for each row; still, costs of a few ns are within noise
+#     on a busy box - re-run a seed flagged only as OUTLIER/BUDGET (with --seed) before blaming the tree
+
+import argparse
+import concurrent.futures
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+SRC = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'seed_sweep.cpp')
+
+def splitmix64(state):
+	state = (state + 0x9e3779b97f4a7c15) & 0xffffffffffffffff
+	z = state
+	z = ((z ^ (z >> 30)) * 0xbf58476d1ce4e5b9) & 0xffffffffffffffff
+	z = ((z ^ (z >> 27)) * 0x94d049bb133111eb) & 0xffffffffffffffff
+	return state, z ^ (z >> 31)
+
+def gen_seeds(base, n):
+	ret = []
+	state = base
+	for _ in range(n):
+		state, seed = splitmix64(state)
+		ret.append(seed)
+	return ret
+
+def build(args, workdir, seed):
+	exe = os.path.join(workdir, 'seed_sweep_%016x' % seed)
+	cmd = [args.cxx] + args.flags.split() + ['-DITHARE_OBF_SEED=UINT64_C(0x%016x)' % seed, '-DOBF_SWEEP_MAX_LEVEL=%d' % args.max_level, SRC, '-o', exe]
+	res = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+	if res.returncode != 0:
+		errors = [line for line in res.stdout.decode(errors='replace').split('\n') if 'error' in line]
+		return None, errors[:5] or ['compiler exit code %d' % res.returncode]
+	return exe, None
+
+def parse(out):
+	#see obf_sweep_print() in seed_sweep.cpp
+	tsc_per_ns = 0.
+	rows = []
+	for line in out.split('\n'):
+		f = line.split()
+		if not f:
+			continue
+		if f[0] == '#seed':
+			tsc_per_ns = float(f[3])
+			continue
+		if f[0].startswith('#'):
+			continue
+		ns = lambda s: None if s == '-' else float(s)
+		rows.append({ 'kind': f[0], 'type': f[1], 'level': int(f[2]), 'budget': int(f[3]), 'inj_ns': ns(f[4]), 'surj_ns': ns(f[5]),
+			'checks': int(f[6]), 'fails': int(f[7]) })
+	return tsc_per_ns, rows
+
+def cost_ns(row):
+	if row['surj_ns'] is None:
+		return None
+	if row['kind'] == 'var':
+		return row['inj_ns'] + row['surj_ns']
+	return row['surj_ns']
+
+def key(row):
+	return '%s/%s/OBF%d' % (row['kind'], row['type'], row['level'])
+
+def main():
+	parser = argparse.ArgumentParser()
+	parser.add_argument('--cxx', default='c++')
+	#depth limits: see ../compiletime/corpus_bench.py
+	parser.add_argument('--flags', default='-std=c++17 -O2 -DNDEBUG -ftemplate-depth=4096 -fconstexpr-depth=4096')
+	parser.add_argument('--seeds', type=int, default=8)
+	parser.add_argument('--base-seed', default='0x6a09e667f3bcc908')
+	parser.add_argument('--seed', action='append', default=[], help='explicit seed (repeatable); overrides --seeds')
+	parser.add_argument('--max-level', type=int, default=4, help='OBF levels 0..max-level (5 and 6 take much longer to compile)')
+	parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1, help='parallel builds (runs are always sequential)')
+	parser.add_argument('--runs', type=int, default=3)
+	parser.add_argument('--out', default=None, help='directory for the binaries (default: temporary one)')
+	parser.add_argument('--json', default=None, help='save results here')
+	parser.add_argument('--budget-factor', type=float, default=4.)
+	parser.add_argument('--budget-slack', type=float, default=20., help='TSC ticks')
+	parser.add_argument('--outlier-factor', type=float, default=3.)
+	parser.add_argument('--outlier-slack', type=float, default=3., help='ns')
+	args = parser.parse_args()
+
+	seeds = [int(s, 0) for s in args.seed] if args.seed else gen_seeds(int(args.base_seed, 0), args.seeds)
+	workdir = args.out or tempfile.mkdtemp(prefix='obf_seed_sweep_')
+	os.makedirs(workdir, exist_ok=True)
+	print('%d seed(s), OBF0..%d, %s %s' % (len(seeds), args.max_level, args.cxx, args.flags))
+
+	results = {}#seed -> {'flags': [...], 'tsc_per_ns':..., 'rows': [...]}
+	with concurrent.futures.ThreadPoolExecutor(max_workers=max(args.jobs, 1)) as pool:
+		builds = [pool.submit(build, args, workdir, seed) for seed in seeds]
+		for seed, fut in zip(seeds, builds):
+			exe, errors = fut.result()
+			r = results[seed] = { 'flags': [], 'tsc_per_ns': 0., 'rows': [] }
+			if exe is None:
+				r['flags'].append(('BUILD', '; '.join(errors)))
+				print('0x%016x: BUILD FAILED' % seed)
+				continue
+			exit_code = 0
+			for run in range(max(args.runs, 1)):
+				res = subprocess.run([exe], stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+				exit_code = exit_code or res.returncode
+				tsc_per_ns, rows = parse(res.stdout.decode(errors='replace'))
+				if run == 0 or len(rows) != len(r['rows']):
+					r['tsc_per_ns'], r['rows'] = tsc_per_ns, rows
+					continue
+				for best, row in zip(r['rows'], rows):
+					for k in ('inj_ns', 'surj_ns'):
+						if row[k] is not None:
+							best[k] = min(best[k], row[k])
+					best['fails'] = max(best['fails'], row['fails'])
+			failed = [row for row in r['rows'] if row['fails']]
+			for row in failed:
+				r['flags'].append(('FAIL', '%s: %d of %d checks failed' % (key(row), row['fails'], row['checks'])))
+			if exit_code != 0 and not failed:
+				r['flags'].append(('FAIL', 'exit code %d' % exit_code))
+			print('0x%016x: %d rows, %d failed check(s)' % (seed, len(r['rows']), sum(row['fails'] for row in r['rows'])))
+
+	#per-key costs over all the seeds which ran
+	costs = {}
+	for seed, r in results.items():
+		for row in r['rows']:
+			c = cost_ns(row)
+			if c is not None:
+				costs.setdefault(key(row), []).append((c, seed))
+	medians = { k: statistics.median(c for c, _ in v) for k, v in costs.items() }
+
+	for seed, r in results.items():
+		for row in r['rows']:
+			c = cost_ns(row)
+			if c is None:
+				continue
+			k = key(row)
+			if r['tsc_per_ns'] > 0 and row['kind'] != 'str':
+				ticks = c * r['tsc_per_ns']
+				if ticks > args.budget_factor * row['budget'] + args.budget_slack:
+					r['flags'].append(('BUDGET', '%s: %.0f ticks vs %d declared' % (k, ticks, row['budget'])))
+			budget_ns = row['budget'] / r['tsc_per_ns'] if r['tsc_per_ns'] > 0 and row['kind'] != 'str' else 0.
+			if len(costs[k]) >= 3 and c > args.outlier_factor * medians[k] + max(budget_ns, args.outlier_slack):
+				r['flags'].append(('OUTLIER', '%s: %.2f ns vs median %.2f ns' % (k, c, medians[k])))
+
+	print('%-24s %10s %10s %20s' % ('site', 'median,ns', 'max,ns', 'max at seed'))
+	for k in sorted(costs, key=lambda k: (int(k.split('OBF')[1]), k)):
+		c, seed = max(costs[k])
+		print('%-24s %10.2f %10.2f   0x%016x' % (k, medians[k], c, seed))
+
+	flagged = { seed: r['flags'] for seed, r in results.items() if r['flags'] }
+	for seed, flags in flagged.items():
+		for what, detail in flags:
+			print('0x%016x %-8s %s' % (seed, what, detail))
+	print('%d of %d seed(s) flagged' % (len(flagged), len(seeds)))
+
+	if args.json:
+		with open(args.json, 'w') as f:
+			json.dump({ 'cxx': args.cxx, 'flags': args.flags, 'max_level': args.max_level,
+				'seeds': { '0x%016x' % seed: { 'flags': r['flags'], 'tsc_per_ns': r['tsc_per_ns'], 'rows': r['rows'] } for seed, r in results.items() } }, f, indent=1)
+	if flagged:
+		sys.exit(1)
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,109 @@
+//str_literal_bench.cpp: run-time benchmark for obf_str_literal<>::value() - scalar vs ITHARE_OBF_SIMD_STR_LITERALS
+//Usage:
+//  compile it twice in Release mode, with and without -DITHARE_OBF_SIMD_STR_LITERALS, and compare the output
+//    (NB: scalar and SIMD modes can't coexist within one program, as they're different definitions of the same obf_str_literal<>)
+//  -DITHARE_OBF_NO_AVX2 restricts SIMD mode to SSE2
+//Prints nanoseconds per value() for 4-, 16-, and 32-byte strings at several obfuscation levels, averaged over OBF_STR_BENCH_SEEDS
+//  different seeds (otherwise the numbers are dominated by random length of one particular injection);
+//  'decode' is value() minus the cost of constructing the same std::string from a plain buffer (which involves allocation for 16+ bytes)
+//  'value_buf()' is the zero-allocation alternative to value() (decoding to stack, and wiping it afterwards)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifndef ITHARE_OBF_SEED
+#define ITHARE_OBF_SEED UINT64_C(0x5c2f9a6e31d84b07)
+#endif
+#include "../../src/obfuscate.h"
+
+#ifndef OBF_STR_BENCH_SEEDS
+#define OBF_STR_BENCH_SEEDS 16
+#endif
+
+using namespace ithare::obf;
+
+static constexpr size_t obf_bench_iterations = 200000;
+static constexpr int obf_bench_repetitions = 5;
+
+static volatile size_t obf_bench_sink;
+
+template<class F>
+double obf_bench_ns(F f) {
+	double best = 1e30;
+	for (int rep = 0; rep < obf_bench_repetitions; ++rep) {
+		size_t acc = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < obf_bench_iterations; ++i) {
+			auto s = f();
+			std::string_view sv(s);
+			acc += size_t(sv[i % sv.size()]);
+		}
+		auto t1 = std::chrono::steady_clock::now();
+		obf_bench_sink = acc;
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(obf_bench_iterations));
+	}
+	return best;
+}
+
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_bench_str4 = ITHARE_OBFS_HELPER(seed, cycles, "abcd");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_bench_str16 = ITHARE_OBFS_HELPER(seed, cycles, "0123456789abcdef");
+template<OBFSEED seed, OBFCYCLES cycles>
+using obf_bench_str32 = ITHARE_OBFS_HELPER(seed, cycles, "0123456789abcdefghijklmnopqrstuv");
+
+template<template<OBFSEED, OBFCYCLES> class S, int level, bool buf, size_t... I>
+double obf_bench_avg(std::index_sequence<I...>) {
+	double sum;
+	if constexpr(buf)
+		sum = (0. + ... + obf_bench_ns([]() { return S<obf_compile_time_prng(UINT64_C(0x3e5a7c1b9d02f468) + level, int(I + 1)), obf_exp_cycles(level)>().value_buf(); }));
+	else
+		sum = (0. + ... + obf_bench_ns([]() { return S<obf_compile_time_prng(UINT64_C(0x3e5a7c1b9d02f468) + level, int(I + 1)), obf_exp_cycles(level)>().value(); }));
+	return sum / double(sizeof...(I));
+}
+
+static char obf_bench_plain[33] = "0123456789abcdefghijklmnopqrstuv";
+double obf_bench_baseline(size_t sz) {
+	return obf_bench_ns([sz]() { return std::string(obf_bench_plain, sz); });
+}
+
+template<int level>
+void obf_bench_level(const double (&baseline)[3]) {
+	constexpr auto seeds = std::make_index_sequence<OBF_STR_BENCH_SEEDS>();
+	double ns[3] = { obf_bench_avg<obf_bench_str4, level, false>(seeds), obf_bench_avg<obf_bench_str16, level, false>(seeds), obf_bench_avg<obf_bench_str32, level, false>(seeds) };
+	double nsBuf[3] = { obf_bench_avg<obf_bench_str4, level, true>(seeds), obf_bench_avg<obf_bench_str16, level, true>(seeds), obf_bench_avg<obf_bench_str32, level, true>(seeds) };
+	const char* names[3] = { "4", "16", "32" };
+	printf("OBF%dS value():", level);
+	for (int i = 0; i < 3; ++i)
+		printf(" %s bytes %.2f ns (decode %.2f ns)%s", names[i], ns[i], ns[i] - baseline[i], i < 2 ? "," : "\n");
+	printf("OBF%dS value_buf():", level);
+	for (int i = 0; i < 3; ++i)
+		printf(" %s bytes %.2f ns%s", names[i], nsBuf[i], i < 2 ? "," : "\n");
+}
+
+int main() {
+#ifdef ITHARE_OBF_SIMD_STR_LITERALS
+#if !defined(ITHARE_OBF_SIMD)
+	printf("mode: ITHARE_OBF_SIMD_STR_LITERALS (no SIMD available - scalar fallback)\n");
+#elif defined(ITHARE_OBF_NO_AVX2)
+	printf("mode: ITHARE_OBF_SIMD_STR_LITERALS (SSE2)\n");
+#else
+	printf("mode: ITHARE_OBF_SIMD_STR_LITERALS (%s)\n", obf_cpu_has_avx2() ? "AVX2 for 32-byte strings, SSE2 otherwise" : "SSE2");
+#endif
+#else
+	printf("mode: scalar\n");
+#endif
+	double baseline[3] = { obf_bench_baseline(4), obf_bench_baseline(16), obf_bench_baseline(32) };
+	printf("std::string construction: 4 bytes %.2f ns, 16 bytes %.2f ns, 32 bytes %.2f ns\n", baseline[0], baseline[1], baseline[2]);
+	obf_bench_level<2>(baseline);
+	obf_bench_level<3>(baseline);
+	obf_bench_level<4>(baseline);
+	obf_bench_level<5>(baseline);
+	return 0;
+}
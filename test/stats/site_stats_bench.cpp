@@ -0,0 +1,66 @@
+//site_stats_bench.cpp: per-site encode/decode stats (see ITHARE_OBF_ENABLE_SITE_STATS in obfuscate.h) on a workload with one hot and a few cold sites
+//Usage:
+//  make -C test/Linux stats
+//    builds and runs seeded and unseeded (obf_var_dbg<> etc.) versions, each with -DITHARE_OBF_ENABLE_SITE_STATS,
+//    and the seeded one with -DITHARE_OBF_ENABLE_DBGPRINT too (so that injection trees are printed)
+//Prints nanoseconds per workload() call, then obf_site_stats_dump() - with the hot site (the one inside the inner loop) at the top
+//  per-call time of a build w/o ITHARE_OBF_ENABLE_SITE_STATS is printed by profile_bench, for the same kind of workload
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "../../src/obfuscate.h"
+
+using namespace ithare::obf;
+
+static constexpr int obf_bench_calls = 20000;
+static constexpr int obf_bench_repetitions = 5;
+static constexpr size_t obf_bench_data_size = 256;
+
+static OBF2A(uint8_t, obf_bench_data_size) obf_bench_data;
+static volatile uint32_t obf_bench_sink;
+
+ITHARE_OBF_NOINLINE uint32_t workload(uint32_t key) {
+	//cold: once per call
+	OBF3(uint32_t) k = key;
+	OBF3(uint32_t) mask = k ^ OBF3I(0x9e3779b9);
+	uint32_t rounds = (mask & 3) + 1;
+	//hot: once per byte
+	uint32_t ret = 0;
+	for (uint32_t r = 0; r < rounds; ++r) {
+		for (size_t i = 0; i < obf_bench_data_size; ++i) {
+			OBF2(uint32_t) acc = ret * 31 + obf_bench_data.get(i);
+			ret = acc;
+		}
+	}
+	return ret ^ mask;
+}
+
+int main() {
+	for (size_t i = 0; i < obf_bench_data_size; ++i)
+		obf_bench_data.set(i, uint8_t(i * 7 + 3));
+#ifdef ITHARE_OBF_SEED
+	printf("seeded build\n");
+#else
+	printf("unseeded build\n");
+#endif
+
+	double best = 1e30;
+	for (int rep = 0; rep < obf_bench_repetitions; ++rep) {
+		uint32_t total = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < obf_bench_calls; ++i)
+			total += workload(uint32_t(i));
+		auto t1 = std::chrono::steady_clock::now();
+		obf_bench_sink = total;
+		best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(obf_bench_calls));
+	}
+	printf("workload(): %.1f ns/call (checksum %u); %s\n", best, unsigned(obf_bench_sink), std::string(OBF3S("done")).c_str());
+#ifdef ITHARE_OBF_ENABLE_SITE_STATS
+	obf_site_stats_dump();
+#endif
+	return 0;
+}